@@ -0,0 +1,115 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/sensor-publish/BatchFormatter.h"
+#include "../source/sensor-publish/EomMatcher.h"
+#include "BenchmarkUtils.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t BATCH_MESSAGES[] = {1, 10, 100, 1000};
+    constexpr size_t BYTES_PER_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * \brief A JSON sensor reading of about 85 bytes, with quotes to escape in the JSON format
+     */
+    string createMessage(size_t i)
+    {
+        char message[128];
+        snprintf(
+            message,
+            sizeof(message),
+            "{\"ts\":%zu,\"temperature\":%.1f,\"humidity\":%zu,\"pressure\":%zu,\"status\":\"ok\"}",
+            1650000000000 + i * 100,
+            21.0 + static_cast<double>(i % 13) * 0.1,
+            40 + i % 7,
+            101325 + i % 50);
+        return message;
+    }
+
+    void benchmarkBatch(size_t numMessages)
+    {
+        EomMatcher matcher("\\n");
+        string data;
+        vector<size_t> bounds;
+        for (size_t i = 0; i < numMessages; ++i)
+        {
+            data.append(createMessage(i));
+            data.push_back('\n');
+            bounds.push_back(data.size());
+        }
+        const uint8_t *buffer = reinterpret_cast<const uint8_t *>(data.data());
+        size_t iterations = BYTES_PER_SIZE / data.size();
+        size_t batchBytes = 0;
+        char name[128];
+
+        // Raw batches are a cursor over the read buffer, only the boundaries are consumed.
+        snprintf(name, sizeof(name), "raw %zu message batch", numMessages);
+        double rawNanos = Benchmark::run(name, iterations, [&](size_t) {
+            size_t lastEom = 0;
+            for (size_t bound : bounds)
+            {
+                lastEom = bound;
+            }
+            batchBytes = aws_byte_cursor_from_array(buffer, lastEom).len;
+        });
+        printf(
+            "%-60s %12.1f MB/s %12zu bytes\n",
+            "  throughput / batch size",
+            data.size() * 1000.0 / rawNanos,
+            batchBytes);
+
+        struct
+        {
+            const char *name;
+            BatchFormatter::Format format;
+        } formats[] = {
+            {"json", BatchFormatter::Format::Json},
+            {"length-prefixed", BatchFormatter::Format::LengthPrefixed},
+            {"cbor", BatchFormatter::Format::Cbor}};
+        for (const auto &format : formats)
+        {
+            BatchFormatter formatter(format.format);
+            snprintf(name, sizeof(name), "%s %zu message batch", format.name, numMessages);
+            double nanos = Benchmark::run(name, iterations, [&](size_t) {
+                size_t lastEom = 0;
+                formatter.begin(bounds.size());
+                for (size_t bound : bounds)
+                {
+                    size_t messageStart = lastEom;
+                    lastEom = bound;
+                    const char *begin = data.data() + messageStart;
+                    formatter.add(buffer + messageStart, matcher.messageLength(begin, data.data() + lastEom));
+                }
+                batchBytes = formatter.finish().len;
+            });
+            printf(
+                "%-60s %12.1f MB/s %12zu bytes\n",
+                "  throughput / batch size",
+                data.size() * 1000.0 / nanos,
+                batchBytes);
+        }
+    }
+} // namespace
+
+/**
+ * Measures the cost of building a batch of 85 byte JSON messages in each batch format, from the message boundaries
+ * found in the read buffer, and the size of the resulting batch.
+ */
+int main()
+{
+    for (size_t numMessages : BATCH_MESSAGES)
+    {
+        benchmarkBatch(numMessages);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/sensor-publish/Compressor.h"
+#include "BenchmarkUtils.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t BATCH_SIZES[] = {1024, 16 * 1024, 128000};
+    constexpr int LEVELS[] = {1, 6, 9};
+    constexpr size_t BYTES_PER_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * \brief Sensor batches of JSON or CSV lines, with slowly changing readings and an increasing timestamp
+     */
+    string createBatch(size_t size, bool json)
+    {
+        string batch;
+        char line[128];
+        for (int i = 0; batch.size() < size; ++i)
+        {
+            long long timestamp = 1650000000000LL + i * 100;
+            if (json)
+            {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "{\"ts\":%lld,\"temperature\":%.1f,\"humidity\":%d,\"status\":\"ok\"}\n",
+                    timestamp,
+                    21.0 + (i % 13) * 0.1,
+                    40 + i % 7);
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "%lld,%.1f,%d,ok\n", timestamp, 21.0 + (i % 13) * 0.1, 40 + i % 7);
+            }
+            batch.append(line);
+        }
+        batch.resize(size);
+        return batch;
+    }
+
+    void benchmarkFormat(const char *format, bool json)
+    {
+        char name[128];
+        for (size_t size : BATCH_SIZES)
+        {
+            string batch = createBatch(size, json);
+            aws_byte_cursor input = aws_byte_cursor_from_array(batch.data(), batch.size());
+            size_t iterations = BYTES_PER_SIZE / size;
+
+            for (int level : LEVELS)
+            {
+                Compressor compressor(level, size);
+                compressor.init();
+                aws_byte_cursor output;
+
+                snprintf(name, sizeof(name), "Compressor::compress %s level %d %zu byte batch", format, level, size);
+                double nanos = Benchmark::run(name, iterations, [&](size_t) { compressor.compress(input, output); });
+
+                printf(
+                    "%-60s %12.2f ratio %12.2f ms/MB\n",
+                    "  compression ratio / CPU time",
+                    static_cast<double>(size) / static_cast<double>(output.len),
+                    nanos * 1024.0 * 1024.0 / static_cast<double>(size) / 1000000.0);
+            }
+        }
+    }
+} // namespace
+
+/**
+ * Measures the compression ratio and the CPU time spent per MB of sensor data deflating batches of JSON and CSV lines,
+ * for batches of 1 KB up to the default buffer capacity and for the fastest, default and smallest levels.
+ */
+int main()
+{
+    benchmarkFormat("JSON", true);
+    benchmarkFormat("CSV", false);
+    return 0;
+}
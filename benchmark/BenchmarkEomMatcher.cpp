@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/sensor-publish/EomMatcher.h"
+#include "BenchmarkUtils.h"
+
+#include <queue>
+#include <regex>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t READ_SIZES[] = {1024, 4 * 1024, 16 * 1024, 64 * 1024};
+    /**
+     * \brief Length of each simulated sensor message, delimiter excluded
+     */
+    constexpr size_t MESSAGE_LENGTH = 100;
+    constexpr size_t BYTES_PER_SIZE = 64 * 1024 * 1024;
+
+    string createReadData(size_t size, const string &delimiter)
+    {
+        string data;
+        data.reserve(size);
+        while (data.size() < size)
+        {
+            data.append(MESSAGE_LENGTH, 'x');
+            data.append(delimiter);
+        }
+        data.resize(size);
+        return data;
+    }
+
+    void benchmarkPattern(const string &pattern, const string &delimiter)
+    {
+        regex re(pattern);
+        EomMatcher matcher(pattern);
+        queue<size_t> bounds;
+        char name[128];
+
+        for (size_t size : READ_SIZES)
+        {
+            string data = createReadData(size, delimiter);
+            const char *begin = data.data();
+            const char *end = data.data() + data.size();
+            size_t iterations = BYTES_PER_SIZE / size;
+
+            snprintf(name, sizeof(name), "std::cregex_iterator \"%s\" %zu byte read", pattern.c_str(), size);
+            double regexNanos = Benchmark::run(name, iterations / 16, [&](size_t) {
+                for (auto m = cregex_iterator(begin, end, re), mend = cregex_iterator(); m != mend; ++m)
+                {
+                    bounds.emplace((*m).position() + (*m).length());
+                }
+                bounds = queue<size_t>();
+            });
+
+            snprintf(name, sizeof(name), "EomMatcher::findAll \"%s\" %zu byte read", pattern.c_str(), size);
+            size_t matcherIterations = matcher.getKind() == EomMatcher::Kind::Regex ? iterations / 16 : iterations;
+            double matcherNanos = Benchmark::run(name, matcherIterations, [&](size_t) {
+                matcher.findAll(begin, end, 0, bounds);
+                bounds = queue<size_t>();
+            });
+
+            printf(
+                "%-60s %12.1f MB/s %12.1f MB/s\n",
+                "  regex / matcher throughput",
+                static_cast<double>(size) * 1000.0 / regexNanos,
+                static_cast<double>(size) * 1000.0 / matcherNanos);
+        }
+    }
+} // namespace
+
+/**
+ * Measures the cost of scanning a sensor read for end of message boundaries with std::regex, as Sensor did before,
+ * and with the EomMatcher compiled from the same pattern, for reads of 1 KB to 64 KB holding 100 byte messages.
+ */
+int main()
+{
+    benchmarkPattern("\\n", "\n");
+    benchmarkPattern("\\r\\n", "\r\n");
+    benchmarkPattern("[,]+", ",");
+    benchmarkPattern("[\\r\\n]+", "\r\n");
+    benchmarkPattern("\\r?\\n", "\r\n");
+    return 0;
+}
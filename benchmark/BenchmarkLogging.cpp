@@ -0,0 +1,50 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/config/Config.h"
+#include "../source/logging/LoggerFactory.h"
+#include "../source/util/StringUtils.h"
+#include "BenchmarkUtils.h"
+
+#include <chrono>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+namespace
+{
+    constexpr char TAG[] = "BenchmarkLogging.cpp";
+    constexpr size_t ITERATIONS = 10 * 1000 * 1000;
+} // namespace
+
+/**
+ * Measures the cost of a DEBUG log statement while the runtime log level is INFO, which is what every hot path pays
+ * for its debug logging in a production configuration. The statement mirrors the ones found on the read paths of the
+ * sensor publish and secure tunneling features, including argument evaluation that allocates a string.
+ */
+int main()
+{
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::INFO;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_STDOUT;
+    LoggerFactory::reconfigure(config);
+
+    string sensorName = "sensor-name";
+
+    printf("Disabled DEBUG log statement, compiled minimum log level is %d\n", DC_LOG_MIN_LEVEL);
+
+    Benchmark::run("LOGM_DEBUG, level checked before evaluating arguments", ITERATIONS, [&](size_t i) {
+        LOGM_DEBUG(TAG, "Read %zu bytes from %s", i, Sanitize(sensorName).c_str());
+    });
+
+    Benchmark::run("Logger::debug, level checked after evaluating arguments", ITERATIONS, [&](size_t i) {
+        LoggerFactory::getLoggerInstance().get()->debug(
+            TAG, std::chrono::system_clock::now(), "Read %zu bytes from %s", i, Sanitize(sensorName).c_str());
+    });
+
+    LoggerFactory::getLoggerInstance().get()->shutdown();
+    return 0;
+}
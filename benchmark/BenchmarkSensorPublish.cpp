@@ -0,0 +1,386 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/config/Config.h"
+#include "../source/logging/LoggerFactory.h"
+#include "../source/samples/sensor-publish/load-generator/LoadGenerator.h"
+#include "../source/sensor-publish/SensorPublishFeature.h"
+
+#include <aws/common/allocator.h>
+#include <aws/crt/Api.h>
+#include <aws/io/event_loop.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr char SOCKET_PATH[] = "/tmp/benchmark-sensor-publish";
+
+    /**
+     * \brief Time given to the sensors to connect and reach a steady state before measuring
+     */
+    constexpr chrono::seconds WARM_UP{1};
+
+    constexpr chrono::seconds MEASURED{5};
+
+    /**
+     * \brief Traffic generated for each sensor, and how the sensors batch it
+     */
+    struct Scenario
+    {
+        const char *name;
+        unsigned int sensors;
+        double rate;
+        load_generator::size_dist dist;
+        size_t size;
+        size_t sizeMin;
+        size_t sizeMax;
+        int64_t bufferSize;
+        int64_t bufferTimeMs;
+    };
+
+    const Scenario SCENARIOS[] = {
+        {"1 sensor, 128 byte messages unthrottled, batches of 100",
+         1,
+         0,
+         load_generator::size_dist::fixed,
+         128,
+         128,
+         128,
+         100,
+         1000},
+        {"1 sensor, 128 byte messages at 10k/s, each published",
+         1,
+         10000,
+         load_generator::size_dist::fixed,
+         128,
+         128,
+         128,
+         1,
+         0},
+        {"4 sensors, 32-512 byte messages at 20k/s each, 50 ms batches",
+         4,
+         20000,
+         load_generator::size_dist::uniform,
+         0,
+         32,
+         512,
+         0,
+         50},
+        {"8 sensors, 64-1024 byte messages around 256 at 5k/s each, batches of 50",
+         8,
+         5000,
+         load_generator::size_dist::normal,
+         256,
+         64,
+         1024,
+         50,
+         100},
+    };
+
+    /**
+     * \brief Stands in for the shared resource manager, with an event loop per sensor and no MQTT connection
+     */
+    class BenchmarkResourceManager : public SharedCrtResourceManager
+    {
+      public:
+        explicit BenchmarkResourceManager(size_t loopCount)
+        {
+            allocator = aws_default_allocator();
+            aws_event_loop_group_options elgOptions;
+            AWS_ZERO_STRUCT(elgOptions);
+            elgOptions.loop_count = static_cast<uint16_t>(loopCount);
+            eventLoopGroup = aws_event_loop_group_new(allocator, &elgOptions);
+        }
+
+        ~BenchmarkResourceManager() override { aws_event_loop_group_release(eventLoopGroup); }
+
+        shared_ptr<Crt::Mqtt::MqttConnection> getConnection() override { return nullptr; }
+
+        aws_event_loop *getNextEventLoop() override { return aws_event_loop_group_get_next_loop(eventLoopGroup); }
+
+        size_t getEventLoopCount() override { return aws_event_loop_group_get_loop_count(eventLoopGroup); }
+
+        aws_event_loop *getEventLoop(size_t index) override
+        {
+            return aws_event_loop_group_get_loop_at(eventLoopGroup, index);
+        }
+
+        aws_allocator *getAllocator() override { return allocator; }
+
+      private:
+        aws_allocator *allocator;
+        aws_event_loop_group *eventLoopGroup;
+    };
+
+    class BenchmarkNotifier : public ClientBaseNotifier
+    {
+      public:
+        void onEvent(Feature *, ClientBaseEventNotification) override {}
+
+        void onError(Feature *, ClientBaseErrorNotification, const string &) override {}
+    };
+
+    /**
+     * \brief Sensor whose publishes go to an in-process stand-in for the MQTT connection, which acknowledges each
+     * publish at once and measures the latency of every message in it
+     */
+    class MeasuringSensor : public Sensor
+    {
+      public:
+        using Sensor::Sensor;
+
+        void setMeasuring(bool measuring) { mMeasuring = measuring; }
+
+        uint64_t getMessages() const { return mMessages; }
+
+        uint64_t getBytes() const { return mBytes; }
+
+        /**
+         * \brief Append the latencies measured so far, in nanoseconds
+         */
+        void appendLatencies(vector<uint64_t> &latencies)
+        {
+            lock_guard<mutex> lock(mLatenciesLock);
+            latencies.insert(latencies.end(), mLatencies.begin(), mLatencies.end());
+        }
+
+      protected:
+        void publishOneMessage(const aws_byte_cursor *payload) override
+        {
+            uint64_t now = load_generator::now_nanos();
+            const char *p = reinterpret_cast<const char *>(payload->ptr);
+            const char *end = p + payload->len;
+            bool measuring = mMeasuring;
+            uint64_t messages = 0;
+            lock_guard<mutex> lock(mLatenciesLock);
+            while (p < end)
+            {
+                const char *eom = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+                eom = eom == nullptr ? end : eom;
+                uint64_t written;
+                if (measuring && load_generator::parse_timestamp(p, eom, written))
+                {
+                    mLatencies.push_back(now > written ? now - written : 0);
+                }
+                ++messages;
+                p = eom + 1;
+            }
+            mMessages += messages;
+            mBytes += payload->len;
+        }
+
+      private:
+        atomic<bool> mMeasuring{false};
+
+        atomic<uint64_t> mMessages{0};
+
+        atomic<uint64_t> mBytes{0};
+
+        mutex mLatenciesLock;
+
+        vector<uint64_t> mLatencies;
+    };
+
+    class BenchmarkFeature : public SensorPublishFeature
+    {
+      public:
+        vector<MeasuringSensor *> getSensors() const
+        {
+            vector<MeasuringSensor *> sensors;
+            for (const auto &entry : mSensors)
+            {
+                sensors.push_back(static_cast<MeasuringSensor *>(entry.sensor.get()));
+            }
+            return sensors;
+        }
+
+        /**
+         * \brief Stop the sensors from their event loops, where the tasks they scheduled are canceled too, so that
+         * none runs once the sensors are destroyed
+         */
+        void stopOnEventLoops()
+        {
+            for (auto &entry : mSensors)
+            {
+                drainAndStop(entry);
+            }
+        }
+
+      protected:
+        unique_ptr<Sensor> createSensor(
+            const PlainConfig::SensorPublish::SensorSettings &settings,
+            aws_allocator *allocator,
+            shared_ptr<Crt::Mqtt::MqttConnection> connection,
+            aws_event_loop *eventLoop) const override
+        {
+            return unique_ptr<Sensor>(
+                new MeasuringSensor(settings, allocator, connection, eventLoop, make_shared<AwsSocket>()));
+        }
+    };
+
+    /**
+     * \brief Published messages and bytes, and CPU time spent by the process outside of the load generator
+     */
+    struct Sample
+    {
+        uint64_t messages{0};
+        uint64_t bytes{0};
+        uint64_t generated{0};
+        uint64_t cpuNanos{0};
+    };
+
+    uint64_t processCpuNanos()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+               static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+    }
+
+    Sample sample(const BenchmarkFeature &feature, const load_generator::generator &generator)
+    {
+        Sample s;
+        for (MeasuringSensor *sensor : feature.getSensors())
+        {
+            s.messages += sensor->getMessages();
+            s.bytes += sensor->getBytes();
+        }
+        uint64_t generatorCpuNanos = 0;
+        for (unsigned int i = 0; i < generator.get_options().sockets; ++i)
+        {
+            s.generated += generator.get_counters(i).messages;
+            generatorCpuNanos += generator.get_counters(i).cpu_nanos;
+        }
+        uint64_t cpuNanos = processCpuNanos();
+        s.cpuNanos = cpuNanos > generatorCpuNanos ? cpuNanos - generatorCpuNanos : 0;
+        return s;
+    }
+
+    double percentileMs(vector<uint64_t> &latencies, double percentile)
+    {
+        if (latencies.empty())
+        {
+            return 0;
+        }
+        auto nth = latencies.begin() + static_cast<ptrdiff_t>(percentile * static_cast<double>(latencies.size() - 1));
+        nth_element(latencies.begin(), nth, latencies.end());
+        return static_cast<double>(*nth) / 1e6;
+    }
+
+    void benchmarkScenario(const Scenario &scenario)
+    {
+        load_generator::options options;
+        options.path = SOCKET_PATH;
+        options.sockets = scenario.sensors;
+        options.rate = scenario.rate;
+        options.dist = scenario.dist;
+        options.size = scenario.size;
+        options.size_min = scenario.sizeMin;
+        options.size_max = scenario.sizeMax;
+        options.size_stddev = static_cast<double>(scenario.size) / 4;
+        load_generator::generator generator(options);
+        generator.start();
+
+        // The sensors keep a reference to their settings, so the configuration outlives the feature.
+        PlainConfig config;
+        for (unsigned int i = 0; i < scenario.sensors; ++i)
+        {
+            PlainConfig::SensorPublish::SensorSettings settings;
+            settings.name = "benchmark-sensor-" + to_string(i);
+            settings.addr = load_generator::socket_path(SOCKET_PATH, i, scenario.sensors);
+            settings.mqttTopic = "benchmark/sensor-" + to_string(i);
+            settings.eomDelimiter = "\n";
+            settings.bufferSize = scenario.bufferSize;
+            settings.bufferTimeMs = scenario.bufferTimeMs;
+            config.sensorPublish.settings.push_back(settings);
+        }
+
+        auto manager = make_shared<BenchmarkResourceManager>(scenario.sensors);
+        unique_ptr<BenchmarkFeature> feature(new BenchmarkFeature());
+        feature->init(manager, make_shared<BenchmarkNotifier>(), config);
+        feature->start();
+        this_thread::sleep_for(WARM_UP);
+
+        Sample begin = sample(*feature, generator);
+        for (MeasuringSensor *sensor : feature->getSensors())
+        {
+            sensor->setMeasuring(true);
+        }
+        auto start = chrono::steady_clock::now();
+        this_thread::sleep_for(MEASURED);
+        Sample end = sample(*feature, generator);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        vector<uint64_t> latencies;
+        for (MeasuringSensor *sensor : feature->getSensors())
+        {
+            sensor->setMeasuring(false);
+            sensor->appendLatencies(latencies);
+        }
+
+        feature->stopOnEventLoops();
+        generator.stop();
+        feature.reset();
+
+        double messages = static_cast<double>(end.messages - begin.messages);
+        printf(
+            "%-60s %12.0f msg/s %12.0f B/s\n",
+            scenario.name,
+            messages / seconds,
+            static_cast<double>(end.bytes - begin.bytes) / seconds);
+        printf(
+            "%-60s %12.0f msg/s %12.2f ns/msg\n",
+            "  generated / CPU per published message",
+            static_cast<double>(end.generated - begin.generated) / seconds,
+            messages > 0 ? static_cast<double>(end.cpuNanos - begin.cpuNanos) / messages : 0.0);
+        printf(
+            "%-60s %12.3f ms p50 %12.3f ms p99\n",
+            "  write to publish latency",
+            percentileMs(latencies, 0.5),
+            percentileMs(latencies, 0.99));
+    }
+} // namespace
+
+/**
+ * Runs the sensor publish feature end to end against the load generator, for a few sensor counts, rates, message size
+ * distributions and batch settings. Each sensor reads from its own Unix domain socket and publishes to an in-process
+ * stand-in for the MQTT connection, so that the results do not depend on the network or a broker.
+ *
+ * For each scenario, reports the rate and bytes published, the rate the load generator achieved, the CPU time the
+ * process spent per published message outside of the load generator, and the median and 99th percentile latency
+ * from the load generator writing a message to the sensor publishing it. A published rate below the generated rate
+ * means the sensors did not keep up.
+ */
+int main()
+{
+    Crt::ApiHandle apiHandle;
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::WARN;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_STDOUT;
+    Logging::LoggerFactory::reconfigure(config);
+
+    for (const Scenario &scenario : SCENARIOS)
+    {
+        benchmarkScenario(scenario);
+    }
+
+    Logging::LoggerFactory::getLoggerInstance().get()->shutdown();
+    return 0;
+}
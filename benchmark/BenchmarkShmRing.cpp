@@ -0,0 +1,188 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/sensor-publish/ShmRing.h"
+#include "BenchmarkUtils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <sched.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t MESSAGE_SIZES[] = {16, 64, 512};
+    constexpr size_t BYTES_PER_ROUND = 4 * 1024 * 1024;
+    constexpr size_t ROUNDS = 10;
+    constexpr size_t RING_CAPACITY = 1024 * 1024;
+
+    /**
+     * \brief Default buffer capacity of a sensor, the most a read from the socket returns
+     */
+    constexpr size_t READ_BUFFER_SIZE = 128000;
+
+    string createMessage(size_t size)
+    {
+        string message(size - 1, 'x');
+        message.push_back('\n');
+        return message;
+    }
+
+    /**
+     * \brief Counts the message delimiters, standing in for the end of message matching done by the sensor
+     */
+    size_t countMessages(const uint8_t *data, size_t len)
+    {
+        size_t count = 0;
+        const uint8_t *end = data + len;
+        for (const uint8_t *p = data;
+             (p = static_cast<const uint8_t *>(memchr(p, '\n', static_cast<size_t>(end - p)))) != nullptr;
+             ++p)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * \brief Sends messages through a stream socket pair, copied by the kernel into the reader's buffer
+     */
+    void transferSocket(const string &message, size_t messages)
+    {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+        {
+            return;
+        }
+        thread producer([&]() {
+            for (size_t i = 0; i < messages; ++i)
+            {
+                size_t written = 0;
+                while (written < message.size())
+                {
+                    ssize_t count = write(fds[1], message.data() + written, message.size() - written);
+                    if (count < 0 && errno != EINTR)
+                    {
+                        return;
+                    }
+                    written += count > 0 ? static_cast<size_t>(count) : 0;
+                }
+            }
+        });
+
+        vector<uint8_t> buffer(READ_BUFFER_SIZE);
+        size_t received = 0;
+        while (received < messages)
+        {
+            ssize_t count = read(fds[0], buffer.data(), buffer.size());
+            if (count <= 0)
+            {
+                if (count < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            received += countMessages(buffer.data(), static_cast<size_t>(count));
+        }
+        producer.join();
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    /**
+     * \brief Sends messages through a shared memory ring, read in place and waiting on the eventfd when it is empty
+     */
+    void transferRing(const string &message, size_t messages)
+    {
+        dc_shm_ring ring;
+        if (dc_shm_ring_create(&ring, "benchmark", RING_CAPACITY) != 0)
+        {
+            return;
+        }
+        ShmRing consumer;
+        if (!consumer.attach(dup(ring.mem_fd), dup(ring.event_fd)))
+        {
+            dc_shm_ring_destroy(&ring);
+            return;
+        }
+
+        thread producer([&]() {
+            for (size_t i = 0; i < messages; ++i)
+            {
+                while (dc_shm_ring_write(&ring, message.data(), message.size()) != 0)
+                {
+                    sched_yield();
+                }
+            }
+        });
+
+        size_t received = 0;
+        while (received < messages)
+        {
+            size_t bytes;
+            if (!consumer.readable(bytes))
+            {
+                break;
+            }
+            if (bytes == 0)
+            {
+                consumer.requestWakeup();
+                if (consumer.readable(bytes) && bytes == 0)
+                {
+                    struct pollfd fd = {consumer.eventFd(), POLLIN, 0};
+                    poll(&fd, 1, -1);
+                    consumer.clearWakeup();
+                }
+                continue;
+            }
+
+            // Read up to the end of the data, wrapped data is read on the next pass, as the sensor does.
+            size_t index = static_cast<size_t>(consumer.tail() & (consumer.capacity() - 1));
+            size_t len = min(bytes, consumer.capacity() - index);
+            received += countMessages(consumer.data() + index, len);
+            consumer.release(len);
+        }
+        producer.join();
+        consumer.detach();
+        dc_shm_ring_destroy(&ring);
+    }
+} // namespace
+
+/**
+ * Compares the throughput of a producer process sending newline delimited messages to a sensor through a Unix domain
+ * stream socket, and through the shared memory ring, for small and large messages. The producer runs on its own
+ * thread, standing in for the sensor process.
+ */
+int main()
+{
+    char name[128];
+    for (size_t size : MESSAGE_SIZES)
+    {
+        string message = createMessage(size);
+        size_t messages = BYTES_PER_ROUND / size;
+
+        snprintf(name, sizeof(name), "Unix stream socket %zu byte messages", size);
+        double socketNanos = Benchmark::run(name, ROUNDS, [&](size_t) { transferSocket(message, messages); });
+        snprintf(name, sizeof(name), "Shared memory ring %zu byte messages", size);
+        double ringNanos = Benchmark::run(name, ROUNDS, [&](size_t) { transferRing(message, messages); });
+
+        printf(
+            "%-60s %12.2f MB/s %12.2f MB/s\n",
+            "  socket / ring throughput",
+            static_cast<double>(BYTES_PER_ROUND) * 1000.0 / socketNanos,
+            static_cast<double>(BYTES_PER_ROUND) * 1000.0 / ringNanos);
+    }
+    return 0;
+}
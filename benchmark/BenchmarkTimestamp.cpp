@@ -0,0 +1,42 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../source/logging/Logger.h"
+#include "BenchmarkUtils.h"
+
+#include <chrono>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+
+namespace
+{
+    constexpr size_t ITERATIONS = 5 * 1000 * 1000;
+    /**
+     * \brief Spacing between the simulated log entries, a busy logger writes many lines within the same second
+     */
+    constexpr int MICROSECONDS_BETWEEN_ENTRIES = 50;
+} // namespace
+
+/**
+ * Measures the cost of formatting the timestamp of a log line, once through the ostringstream based
+ * LogUtil::generateTimestamp() and once through the cached LogUtil::TimestampFormatter used by the loggers.
+ */
+int main()
+{
+    auto start = std::chrono::system_clock::now();
+    char timeBuffer[LogUtil::TimestampFormatter::BUFFER_SIZE];
+
+    Benchmark::run("LogUtil::generateTimestamp", ITERATIONS, [&](size_t i) {
+        LogUtil::generateTimestamp(
+            start + std::chrono::microseconds(i * MICROSECONDS_BETWEEN_ENTRIES), sizeof(timeBuffer), timeBuffer);
+    });
+
+    LogUtil::TimestampFormatter formatter;
+    Benchmark::run("LogUtil::TimestampFormatter::format", ITERATIONS, [&](size_t i) {
+        formatter.format(start + std::chrono::microseconds(i * MICROSECONDS_BETWEEN_ENTRIES), timeBuffer);
+    });
+
+    printf("Last timestamp: %s\n", timeBuffer);
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BENCHMARKUTILS_H
+#define DEVICE_CLIENT_BENCHMARKUTILS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Benchmark
+            {
+                /**
+                 * \brief Runs an operation repeatedly and prints the average wall clock time spent per call
+                 *
+                 * The operation is run once for every warm up iteration before the measured iterations start, so
+                 * that caches, lazily allocated buffers and background threads have settled.
+                 *
+                 * @param name a short description of the operation, printed alongside the result
+                 * @param iterations the number of measured calls to the operation
+                 * @param operation the operation to measure, called with the iteration index
+                 * @return the average number of nanoseconds spent per call
+                 */
+                template <typename Operation>
+                double run(const char *name, std::size_t iterations, Operation operation)
+                {
+                    std::size_t warmUpIterations = iterations / 10;
+                    for (std::size_t i = 0; i < warmUpIterations; i++)
+                    {
+                        operation(i);
+                    }
+
+                    auto start = std::chrono::steady_clock::now();
+                    for (std::size_t i = 0; i < iterations; i++)
+                    {
+                        operation(i);
+                    }
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+
+                    double nanosPerCall =
+                        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                        static_cast<double>(iterations);
+                    printf("%-60s %12zu calls %12.2f ns/call\n", name, iterations, nanosPerCall);
+                    return nanosPerCall;
+                }
+            } // namespace Benchmark
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BENCHMARKUTILS_H
@@ -10,9 +10,15 @@
 #include "util/Retry.h"
 #include "util/StringUtils.h"
 
+#include <algorithm>
 #include <aws/crt/Api.h>
 #include <aws/crt/io/Pkcs11.h>
+#include <aws/io/event_loop.h>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/stat.h>
+#include <thread>
 
 using namespace std;
 using namespace Aws::Crt;
@@ -227,10 +233,12 @@ int SharedCrtResourceManager::buildClient(const PlainConfig &config)
             "logging::enable-sdk-logging in your configuration file");
     }
 
-    eventLoopGroup = unique_ptr<EventLoopGroup>(
-        new EventLoopGroup(1 // The number of threads used depends on your use-case. IF you have a maximum of less than
-                             // a few hundred connections 1 thread is the ideal threadCount.
-                           ));
+    // The MQTT connection, sensors and other features are spread across the event loop threads, one per core unless
+    // configured otherwise.
+    int threads = config.eventLoop.threads.has_value() ? config.eventLoop.threads.value()
+                                                       : static_cast<int>(std::thread::hardware_concurrency());
+    threads = max(threads, 1);
+    eventLoopGroup = unique_ptr<EventLoopGroup>(new EventLoopGroup(static_cast<uint16_t>(threads)));
     if (!eventLoopGroup)
     {
         // cppcheck-suppress nullPointerRedundantCheck
@@ -239,6 +247,11 @@ int SharedCrtResourceManager::buildClient(const PlainConfig &config)
         // cppcheck-suppress nullPointerRedundantCheck
         return eventLoopGroup->LastError();
     }
+    LOGM_INFO(TAG, "Created event loop group with %d threads", threads);
+    if (!config.eventLoop.cpuAffinity.empty())
+    {
+        pinEventLoops(config.eventLoop.cpuAffinity);
+    }
 
     defaultHostResolver = unique_ptr<DefaultHostResolver>(new DefaultHostResolver(*eventLoopGroup, 2, 30));
     clientBootstrap = unique_ptr<ClientBootstrap>(new ClientBootstrap(*eventLoopGroup, *defaultHostResolver));
@@ -260,6 +273,52 @@ int SharedCrtResourceManager::buildClient(const PlainConfig &config)
     return SharedCrtResourceManager::SUCCESS;
 }
 
+void SharedCrtResourceManager::pinEventLoops(const std::vector<int> &cpus) const
+{
+    struct PinTask
+    {
+        aws_task task;
+        const char *tag;
+        size_t index;
+        int cpu;
+    };
+
+    // The affinity is set from each event loop thread, since the threads are not exposed by the event loop group.
+    aws_event_loop_group *group = eventLoopGroup->GetUnderlyingHandle();
+    size_t count = aws_event_loop_group_get_loop_count(group);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto *pin = new PinTask;
+        pin->tag = TAG;
+        pin->index = i;
+        pin->cpu = cpus[i % cpus.size()];
+        aws_task_init(
+            &pin->task,
+            [](aws_task *, void *arg, aws_task_status status)
+            {
+                unique_ptr<PinTask> pin(static_cast<PinTask *>(arg));
+                if (status != AWS_TASK_STATUS_RUN_READY)
+                {
+                    return;
+                }
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(pin->cpu, &set);
+                int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                if (rc != 0)
+                {
+                    LOGM_WARN(
+                        pin->tag, "Failed to pin event loop %zu to CPU %d: %s", pin->index, pin->cpu, strerror(rc));
+                    return;
+                }
+                LOGM_DEBUG(pin->tag, "Pinned event loop %zu to CPU %d", pin->index, pin->cpu);
+            },
+            pin,
+            "PinEventLoop");
+        aws_event_loop_schedule_task_now(aws_event_loop_group_get_loop_at(group, i), &pin->task);
+    }
+}
+
 void SharedCrtResourceManager::initializeAWSHttpLib()
 {
     if (!initialized)
@@ -518,6 +577,28 @@ aws_event_loop *SharedCrtResourceManager::getNextEventLoop()
     return aws_event_loop_group_get_next_loop(eventLoopGroup->GetUnderlyingHandle());
 }
 
+size_t SharedCrtResourceManager::getEventLoopCount()
+{
+    if (!initialized)
+    {
+        LOG_WARN(TAG, "Tried to get eventLoop count but the SharedCrtResourceManager has not yet been initialized!");
+        return 0;
+    }
+
+    return aws_event_loop_group_get_loop_count(eventLoopGroup->GetUnderlyingHandle());
+}
+
+aws_event_loop *SharedCrtResourceManager::getEventLoop(size_t index)
+{
+    if (!initialized)
+    {
+        LOG_WARN(TAG, "Tried to get eventLoop but the SharedCrtResourceManager has not yet been initialized!");
+        return nullptr;
+    }
+
+    return aws_event_loop_group_get_loop_at(eventLoopGroup->GetUnderlyingHandle(), index);
+}
+
 aws_allocator *SharedCrtResourceManager::getAllocator()
 {
     if (!initialized)
@@ -12,6 +12,7 @@
 #include <aws/crt/Api.h>
 #include <aws/iot/MqttClient.h>
 #include <iostream>
+#include <vector>
 
 namespace Aws
 {
@@ -49,6 +50,11 @@ namespace Aws
 
                 int buildClient(const PlainConfig &config);
 
+                /**
+                 * \brief Pin each event loop thread to a CPU, repeating the list when there are more threads
+                 */
+                void pinEventLoops(const std::vector<int> &cpus) const;
+
                 void loadMemTraceLevelFromEnvironment();
 
               protected:
@@ -94,6 +100,16 @@ namespace Aws
 
                 virtual aws_event_loop *getNextEventLoop();
 
+                /**
+                 * \brief Number of event loops, each run by its own thread
+                 */
+                virtual std::size_t getEventLoopCount();
+
+                /**
+                 * \brief Get an event loop by index, so that work can be placed on a given thread
+                 */
+                virtual aws_event_loop *getEventLoop(std::size_t index);
+
                 virtual aws_allocator *getAllocator();
 
                 virtual Aws::Crt::Io::ClientBootstrap *getClientBootstrap();
@@ -25,12 +25,15 @@
 #include "Version.h"
 
 #include <algorithm>
+#include <arpa/inet.h>
 #include <aws/crt/JsonObject.h>
 #include <aws/io/socket.h>
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <netinet/in.h>
 #include <regex>
+#include <sched.h>
 #include <stdexcept>
 #include <string>
 #include <sys/stat.h>
@@ -55,6 +58,7 @@ constexpr char PlainConfig::JSON_KEY_KEY[];
 constexpr char PlainConfig::JSON_KEY_ROOT_CA[];
 constexpr char PlainConfig::JSON_KEY_THING_NAME[];
 constexpr char PlainConfig::JSON_KEY_LOGGING[];
+constexpr char PlainConfig::JSON_KEY_EVENT_LOOP[];
 constexpr char PlainConfig::JSON_KEY_JOBS[];
 constexpr char PlainConfig::JSON_KEY_TUNNELING[];
 constexpr char PlainConfig::JSON_KEY_DEVICE_DEFENDER[];
@@ -196,6 +200,14 @@ bool PlainConfig::LoadFromJson(const Crt::JsonView &json)
         logConfig = temp;
     }
 
+    jsonKey = JSON_KEY_EVENT_LOOP;
+    if (json.ValueExists(jsonKey))
+    {
+        EventLoop temp;
+        temp.LoadFromJson(json.GetJsonObject(jsonKey));
+        eventLoop = temp;
+    }
+
     jsonKey = JSON_KEY_SAMPLES;
     if (json.ValueExists(jsonKey))
     {
@@ -278,7 +290,7 @@ bool PlainConfig::LoadFromCliArgs(const CliArgs &cliArgs)
     }
 
     bool loadFeatureCliArgs = tunneling.LoadFromCliArgs(cliArgs) && logConfig.LoadFromCliArgs(cliArgs) &&
-                              httpProxyConfig.LoadFromCliArgs(cliArgs);
+                              eventLoop.LoadFromCliArgs(cliArgs) && httpProxyConfig.LoadFromCliArgs(cliArgs);
 #if !defined(DISABLE_MQTT)
     loadFeatureCliArgs = loadFeatureCliArgs && jobs.LoadFromCliArgs(cliArgs) &&
                          deviceDefender.LoadFromCliArgs(cliArgs) && fleetProvisioning.LoadFromCliArgs(cliArgs) &&
@@ -303,7 +315,8 @@ bool PlainConfig::LoadFromEnvironment()
         lockFilePath = lockFilePathStr;
     }
 
-    bool loadFeatureEnvironmentVar = tunneling.LoadFromEnvironment() && logConfig.LoadFromEnvironment();
+    bool loadFeatureEnvironmentVar =
+        tunneling.LoadFromEnvironment() && logConfig.LoadFromEnvironment() && eventLoop.LoadFromEnvironment();
 #if !defined(DISABLE_MQTT)
     loadFeatureEnvironmentVar = loadFeatureEnvironmentVar && jobs.LoadFromEnvironment() &&
                                 deviceDefender.LoadFromEnvironment() && fleetProvisioning.LoadFromEnvironment() &&
@@ -315,7 +328,7 @@ bool PlainConfig::LoadFromEnvironment()
 
 bool PlainConfig::Validate() const
 {
-    if (!logConfig.Validate())
+    if (!logConfig.Validate() || !eventLoop.Validate())
     {
         return false;
     }
@@ -441,6 +454,13 @@ void PlainConfig::SerializeToObject(Crt::JsonObject &object) const
     logConfig.SerializeToObject(loggingObject);
     object.WithObject(JSON_KEY_LOGGING, loggingObject);
 
+    if (eventLoop.threads.has_value() || !eventLoop.cpuAffinity.empty())
+    {
+        Crt::JsonObject eventLoopObject;
+        eventLoop.SerializeToObject(eventLoopObject);
+        object.WithObject(JSON_KEY_EVENT_LOOP, eventLoopObject);
+    }
+
     Crt::JsonObject jobsObject;
     jobs.SerializeToObject(jobsObject);
     object.WithObject(JSON_KEY_JOBS, jobsObject);
@@ -492,14 +512,43 @@ void PlainConfig::SerializeToObject(Crt::JsonObject &object) const
 
 constexpr char PlainConfig::LogConfig::LOG_TYPE_FILE[];
 constexpr char PlainConfig::LogConfig::LOG_TYPE_STDOUT[];
+constexpr char PlainConfig::LogConfig::LOG_TYPE_JOURNALD[];
+constexpr char PlainConfig::LogConfig::LOG_TYPE_SYSLOG[];
+constexpr char PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_NEWEST[];
+constexpr char PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_OLDEST[];
+constexpr char PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_BELOW_LEVEL[];
 
 constexpr char PlainConfig::LogConfig::CLI_LOG_LEVEL[];
 constexpr char PlainConfig::LogConfig::CLI_LOG_TYPE[];
 constexpr char PlainConfig::LogConfig::CLI_LOG_FILE[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_SOCKET[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_FLUSH_INTERVAL_MS[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_FLUSH_THRESHOLD_BYTES[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_BINARY_FORMAT[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_SIZE_BYTES[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_AGE_SECONDS[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_ROTATION_GENERATIONS[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_ROTATION_COMPRESS[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_QUEUE_CAPACITY[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_QUEUE_OVERFLOW_POLICY[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_PER_SECOND[];
+constexpr char PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_BURST[];
 
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_LEVEL[];
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_TYPE[];
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_FILE[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_SOCKET[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_FLUSH_INTERVAL_MS[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_FLUSH_THRESHOLD_BYTES[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_BINARY_FORMAT[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_ROTATION_MAX_SIZE_BYTES[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_ROTATION_MAX_AGE_SECONDS[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_ROTATION_GENERATIONS[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_ROTATION_COMPRESS[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_QUEUE_CAPACITY[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_QUEUE_OVERFLOW_POLICY[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_RATE_LIMIT_PER_SECOND[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_RATE_LIMIT_BURST[];
 
 constexpr char PlainConfig::LogConfig::CLI_ENABLE_SDK_LOGGING[];
 constexpr char PlainConfig::LogConfig::CLI_SDK_LOG_LEVEL[];
@@ -586,16 +635,46 @@ string PlainConfig::LogConfig::ParseDeviceClientLogType(const string &value) con
     {
         return LOG_TYPE_STDOUT;
     }
+    else if (LOG_TYPE_JOURNALD == temp)
+    {
+        return LOG_TYPE_JOURNALD;
+    }
+    else if (LOG_TYPE_SYSLOG == temp)
+    {
+        return LOG_TYPE_SYSLOG;
+    }
     else
     {
         throw std::invalid_argument(FormatMessage(
-            "Provided log type %s is not a known log type. Acceptable values are: [%s, %s]",
+            "Provided log type %s is not a known log type. Acceptable values are: [%s, %s, %s, %s]",
             Sanitize(value).c_str(),
             LOG_TYPE_FILE,
-            LOG_TYPE_STDOUT));
+            LOG_TYPE_STDOUT,
+            LOG_TYPE_JOURNALD,
+            LOG_TYPE_SYSLOG));
     }
 }
 
+string PlainConfig::LogConfig::ParseQueueOverflowPolicy(const string &value) const
+{
+    string temp = value;
+    // Convert to lowercase for comparisons
+    std::transform(temp.begin(), temp.end(), temp.begin(), [](unsigned char c) { return std::tolower(c); });
+    for (const char *policy : {QUEUE_OVERFLOW_DROP_NEWEST, QUEUE_OVERFLOW_DROP_OLDEST, QUEUE_OVERFLOW_DROP_BELOW_LEVEL})
+    {
+        if (policy == temp)
+        {
+            return policy;
+        }
+    }
+    throw std::invalid_argument(FormatMessage(
+        "Provided log queue overflow policy %s is not a known policy. Acceptable values are: [%s, %s, %s]",
+        Sanitize(value).c_str(),
+        QUEUE_OVERFLOW_DROP_NEWEST,
+        QUEUE_OVERFLOW_DROP_OLDEST,
+        QUEUE_OVERFLOW_DROP_BELOW_LEVEL));
+}
+
 string PlainConfig::LogConfig::StringifyDeviceClientLogLevel(int level) const
 {
 
@@ -677,6 +756,94 @@ bool PlainConfig::LogConfig::LoadFromJson(const Crt::JsonView &json)
         }
     }
 
+    jsonKey = JSON_KEY_LOG_SOCKET;
+    if (json.ValueExists(jsonKey))
+    {
+        deviceClientLogSocket = FileUtils::ExtractExpandedPath(json.GetString(jsonKey).c_str());
+    }
+
+    jsonKey = JSON_KEY_FLUSH_INTERVAL_MS;
+    if (json.ValueExists(jsonKey))
+    {
+        flushIntervalMs = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_FLUSH_THRESHOLD_BYTES;
+    if (json.ValueExists(jsonKey))
+    {
+        flushThresholdBytes = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_BINARY_FORMAT;
+    if (json.ValueExists(jsonKey))
+    {
+        binaryFormat = json.GetBool(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_ROTATION_MAX_SIZE_BYTES;
+    if (json.ValueExists(jsonKey))
+    {
+        rotationMaxSizeBytes = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_ROTATION_MAX_AGE_SECONDS;
+    if (json.ValueExists(jsonKey))
+    {
+        rotationMaxAgeSeconds = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_ROTATION_GENERATIONS;
+    if (json.ValueExists(jsonKey))
+    {
+        rotationGenerations = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_ROTATION_COMPRESS;
+    if (json.ValueExists(jsonKey))
+    {
+        rotationCompress = json.GetBool(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_QUEUE_CAPACITY;
+    if (json.ValueExists(jsonKey))
+    {
+        queueCapacity = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_QUEUE_OVERFLOW_POLICY;
+    if (json.ValueExists(jsonKey))
+    {
+        if (!json.GetString(jsonKey).empty())
+        {
+            try
+            {
+                queueOverflowPolicy = ParseQueueOverflowPolicy(json.GetString(jsonKey).c_str());
+            }
+            catch (const std::invalid_argument &e)
+            {
+                LOGM_ERROR(
+                    Config::TAG, "Unable to parse incoming log queue overflow policy passed via JSON: %s", e.what());
+                return false;
+            }
+        }
+        else
+        {
+            LOGM_WARN(Config::TAG, "Key {%s} was provided in the JSON configuration file with an empty value", jsonKey);
+        }
+    }
+
+    jsonKey = JSON_KEY_RATE_LIMIT_PER_SECOND;
+    if (json.ValueExists(jsonKey))
+    {
+        rateLimitPerSecond = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_RATE_LIMIT_BURST;
+    if (json.ValueExists(jsonKey))
+    {
+        rateLimitBurst = json.GetInteger(jsonKey);
+    }
+
     jsonKey = JSON_KEY_ENABLE_SDK_LOGGING;
     if (json.ValueExists(jsonKey))
     {
@@ -753,6 +920,181 @@ bool PlainConfig::LogConfig::LoadFromCliArgs(const CliArgs &cliArgs)
         deviceClientLogFile = FileUtils::ExtractExpandedPath(cliArgs.at(CLI_LOG_FILE).c_str());
     }
 
+    if (cliArgs.count(CLI_LOG_SOCKET))
+    {
+        deviceClientLogSocket = FileUtils::ExtractExpandedPath(cliArgs.at(CLI_LOG_SOCKET).c_str());
+    }
+
+    if (cliArgs.count(CLI_LOG_FLUSH_INTERVAL_MS))
+    {
+        try
+        {
+            flushIntervalMs = stoi(cliArgs.at(CLI_LOG_FLUSH_INTERVAL_MS).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_FLUSH_INTERVAL_MS);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_FLUSH_THRESHOLD_BYTES))
+    {
+        try
+        {
+            flushThresholdBytes = stoi(cliArgs.at(CLI_LOG_FLUSH_THRESHOLD_BYTES).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_FLUSH_THRESHOLD_BYTES);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_BINARY_FORMAT))
+    {
+        binaryFormat = cliArgs.at(CLI_LOG_BINARY_FORMAT).compare("true") == 0;
+    }
+
+    if (cliArgs.count(CLI_LOG_ROTATION_MAX_SIZE_BYTES))
+    {
+        try
+        {
+            rotationMaxSizeBytes = stoi(cliArgs.at(CLI_LOG_ROTATION_MAX_SIZE_BYTES).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_ROTATION_MAX_SIZE_BYTES);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_ROTATION_MAX_AGE_SECONDS))
+    {
+        try
+        {
+            rotationMaxAgeSeconds = stoi(cliArgs.at(CLI_LOG_ROTATION_MAX_AGE_SECONDS).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_ROTATION_MAX_AGE_SECONDS);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_ROTATION_GENERATIONS))
+    {
+        try
+        {
+            rotationGenerations = stoi(cliArgs.at(CLI_LOG_ROTATION_GENERATIONS).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_ROTATION_GENERATIONS);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_ROTATION_COMPRESS))
+    {
+        rotationCompress = cliArgs.at(CLI_LOG_ROTATION_COMPRESS).compare("true") == 0;
+    }
+
+    if (cliArgs.count(CLI_LOG_QUEUE_CAPACITY))
+    {
+        try
+        {
+            queueCapacity = stoi(cliArgs.at(CLI_LOG_QUEUE_CAPACITY).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 1 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_QUEUE_CAPACITY);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_QUEUE_OVERFLOW_POLICY))
+    {
+        try
+        {
+            queueOverflowPolicy = ParseQueueOverflowPolicy(cliArgs.at(CLI_LOG_QUEUE_OVERFLOW_POLICY));
+        }
+        catch (const std::invalid_argument &e)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "Unable to parse incoming log queue overflow policy passed via command line: %s",
+                e.what());
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_RATE_LIMIT_PER_SECOND))
+    {
+        try
+        {
+            rateLimitPerSecond = stoi(cliArgs.at(CLI_LOG_RATE_LIMIT_PER_SECOND).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 0 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_RATE_LIMIT_PER_SECOND);
+            return false;
+        }
+    }
+
+    if (cliArgs.count(CLI_LOG_RATE_LIMIT_BURST))
+    {
+        try
+        {
+            rateLimitBurst = stoi(cliArgs.at(CLI_LOG_RATE_LIMIT_BURST).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 1 and MAX_INT ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_LOG_RATE_LIMIT_BURST);
+            return false;
+        }
+    }
+
     if (cliArgs.count(CLI_ENABLE_SDK_LOGGING))
     {
         sdkLoggingEnabled = true;
@@ -782,6 +1124,47 @@ bool PlainConfig::LogConfig::LoadFromCliArgs(const CliArgs &cliArgs)
 
 bool PlainConfig::LogConfig::Validate() const
 {
+    if (flushIntervalMs < 0)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log flush interval value < 0 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (flushThresholdBytes < 0)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log flush threshold value < 0 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (rotationMaxSizeBytes < 0)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log rotation max size value < 0 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (rotationMaxAgeSeconds < 0)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log rotation max age value < 0 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (rotationGenerations < 1)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log rotation generations value < 1 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (queueCapacity < 1)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log queue capacity value < 1 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (rateLimitPerSecond < 0)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log rate limit per second value < 0 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+    if (rateLimitBurst < 1)
+    {
+        LOGM_ERROR(Config::TAG, "*** %s: Log rate limit burst value < 1 ***", DeviceClient::DC_FATAL_ERROR);
+        return false;
+    }
+
     return true;
 }
 
@@ -790,11 +1173,122 @@ void PlainConfig::LogConfig::SerializeToObject(Crt::JsonObject &object) const
     object.WithString(JSON_KEY_LOG_LEVEL, StringifyDeviceClientLogLevel(deviceClientlogLevel).c_str());
     object.WithString(JSON_KEY_LOG_TYPE, deviceClientLogtype.c_str());
     object.WithString(JSON_KEY_LOG_FILE, deviceClientLogFile.c_str());
+    object.WithString(JSON_KEY_LOG_SOCKET, deviceClientLogSocket.c_str());
+    object.WithInteger(JSON_KEY_FLUSH_INTERVAL_MS, flushIntervalMs);
+    object.WithInteger(JSON_KEY_FLUSH_THRESHOLD_BYTES, flushThresholdBytes);
+    object.WithBool(JSON_KEY_BINARY_FORMAT, binaryFormat);
+    object.WithInteger(JSON_KEY_ROTATION_MAX_SIZE_BYTES, rotationMaxSizeBytes);
+    object.WithInteger(JSON_KEY_ROTATION_MAX_AGE_SECONDS, rotationMaxAgeSeconds);
+    object.WithInteger(JSON_KEY_ROTATION_GENERATIONS, rotationGenerations);
+    object.WithBool(JSON_KEY_ROTATION_COMPRESS, rotationCompress);
+    object.WithInteger(JSON_KEY_QUEUE_CAPACITY, queueCapacity);
+    object.WithString(JSON_KEY_QUEUE_OVERFLOW_POLICY, queueOverflowPolicy.c_str());
+    object.WithInteger(JSON_KEY_RATE_LIMIT_PER_SECOND, rateLimitPerSecond);
+    object.WithInteger(JSON_KEY_RATE_LIMIT_BURST, rateLimitBurst);
     object.WithBool(JSON_KEY_ENABLE_SDK_LOGGING, sdkLoggingEnabled);
     object.WithString(JSON_KEY_SDK_LOG_LEVEL, StringifySDKLogLevel(sdkLogLevel).c_str());
     object.WithString(JSON_KEY_SDK_LOG_FILE, sdkLogFile.c_str());
 }
 
+constexpr char PlainConfig::EventLoop::CLI_EVENT_LOOP_THREADS[];
+constexpr char PlainConfig::EventLoop::JSON_KEY_THREADS[];
+constexpr char PlainConfig::EventLoop::JSON_KEY_CPU_AFFINITY[];
+constexpr int PlainConfig::EventLoop::MAX_THREADS;
+
+bool PlainConfig::EventLoop::LoadFromJson(const Crt::JsonView &json)
+{
+    const char *jsonKey = JSON_KEY_THREADS;
+    if (json.ValueExists(jsonKey))
+    {
+        threads = json.GetInteger(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_CPU_AFFINITY;
+    if (json.ValueExists(jsonKey) && json.GetJsonObject(jsonKey).IsListType())
+    {
+        cpuAffinity.clear();
+        for (const auto &cpu : json.GetArray(jsonKey))
+        {
+            // Anything but an integer is kept as an invalid CPU, so that validation rejects it.
+            cpuAffinity.push_back(cpu.IsIntegerType() ? cpu.AsInteger() : -1);
+        }
+    }
+
+    return true;
+}
+
+bool PlainConfig::EventLoop::LoadFromCliArgs(const CliArgs &cliArgs)
+{
+    if (cliArgs.count(CLI_EVENT_LOOP_THREADS))
+    {
+        try
+        {
+            threads = stoi(cliArgs.at(CLI_EVENT_LOOP_THREADS).c_str());
+        }
+        catch (const invalid_argument &)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Failed to convert CLI argument {%s} to integer, please use a "
+                "valid integer between 1 and %d ***",
+                DeviceClient::DC_FATAL_ERROR,
+                CLI_EVENT_LOOP_THREADS,
+                MAX_THREADS);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool PlainConfig::EventLoop::Validate() const
+{
+    if (threads.has_value() && (threads.value() < 1 || threads.value() > MAX_THREADS))
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Event loop threads value %d is not between 1 and %d ***",
+            DeviceClient::DC_FATAL_ERROR,
+            threads.value(),
+            MAX_THREADS);
+        return false;
+    }
+    for (int cpu : cpuAffinity)
+    {
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Event loop CPU affinity value %d is not between 0 and %d ***",
+                DeviceClient::DC_FATAL_ERROR,
+                cpu,
+                CPU_SETSIZE - 1);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PlainConfig::EventLoop::SerializeToObject(Crt::JsonObject &object) const
+{
+    if (threads.has_value())
+    {
+        object.WithInteger(JSON_KEY_THREADS, threads.value());
+    }
+    if (!cpuAffinity.empty())
+    {
+        Crt::Vector<Crt::JsonObject> cpus;
+        for (int cpu : cpuAffinity)
+        {
+            Crt::JsonObject value;
+            value.AsInteger(cpu);
+            cpus.push_back(value);
+        }
+        object.WithArray(JSON_KEY_CPU_AFFINITY, cpus);
+    }
+}
+
 constexpr char PlainConfig::Jobs::CLI_ENABLE_JOBS[];
 constexpr char PlainConfig::Jobs::CLI_HANDLER_DIR[];
 constexpr char PlainConfig::Jobs::JSON_KEY_ENABLED[];
@@ -2120,9 +2614,44 @@ constexpr char PlainConfig::SensorPublish::JSON_MQTT_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_MQTT_DEAD_LETTER_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_MQTT_HEARTBEAT_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_HEARTBEAT_TIME_SEC[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_DIR[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_MAX_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_DRAIN_BYTES_PER_SEC[];
+constexpr char PlainConfig::SensorPublish::JSON_MAX_IN_FLIGHT[];
+constexpr char PlainConfig::SensorPublish::JSON_COMPRESSION[];
+constexpr char PlainConfig::SensorPublish::JSON_COMPRESSION_LEVEL[];
+constexpr char PlainConfig::SensorPublish::COMPRESSION_NONE[];
+constexpr char PlainConfig::SensorPublish::COMPRESSION_DEFLATE[];
+constexpr char PlainConfig::SensorPublish::JSON_BATCH_FORMAT[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_RAW[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_JSON[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_LENGTH_PREFIXED[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_CBOR[];
+constexpr char PlainConfig::SensorPublish::JSON_TRANSPORT[];
+constexpr char PlainConfig::SensorPublish::JSON_TCP_PORT[];
+constexpr char PlainConfig::SensorPublish::JSON_EVENT_LOOP_WEIGHT[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_DEDUP[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_DEADBAND[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_JSON_KEY[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_CSV_COLUMN[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_KEEP_EVERY[];
+constexpr char PlainConfig::SensorPublish::JSON_FILTER_MIN_INTERVAL_MS[];
+constexpr char PlainConfig::SensorPublish::JSON_ADAPTIVE_LATENCY_MS[];
+constexpr char PlainConfig::SensorPublish::JSON_ADAPTIVE_MAX_PAYLOAD_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_HEARTBEAT_FORMAT[];
+constexpr char PlainConfig::SensorPublish::HEARTBEAT_FORMAT_NAME[];
+constexpr char PlainConfig::SensorPublish::HEARTBEAT_FORMAT_JSON[];
+constexpr char PlainConfig::SensorPublish::HEARTBEAT_FORMAT_BINARY[];
+constexpr char PlainConfig::SensorPublish::TRANSPORT_UNIX_STREAM[];
+constexpr char PlainConfig::SensorPublish::TRANSPORT_UNIX_DATAGRAM[];
+constexpr char PlainConfig::SensorPublish::TRANSPORT_TCP[];
+constexpr char PlainConfig::SensorPublish::TRANSPORT_SHM[];
 
 constexpr int64_t PlainConfig::SensorPublish::BUF_CAPACITY_BYTES;
 constexpr int64_t PlainConfig::SensorPublish::BUF_CAPACITY_BYTES_MIN;
+constexpr int64_t PlainConfig::SensorPublish::SPOOL_MAX_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::SPOOL_DRAIN_BYTES_PER_SEC;
+constexpr int64_t PlainConfig::SensorPublish::COMPRESSION_LEVEL;
 
 bool PlainConfig::SensorPublish::LoadFromJson(const Crt::JsonView &json)
 {
@@ -2159,61 +2688,175 @@ bool PlainConfig::SensorPublish::LoadFromJson(const Crt::JsonView &json)
             jsonKey = JSON_ADDR;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.addr = entry.GetString(jsonKey).c_str();
+                sensorSettings.addr = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_ADDR_POLL_SEC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.addrPollSec = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_BUFFER_TIME_MS;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.bufferTimeMs = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_BUFFER_SIZE;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.bufferSize = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_BUFFER_CAPACITY;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.bufferCapacity = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_EOM_DELIMITER;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.eomDelimiter = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_MQTT_TOPIC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.mqttTopic = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_MQTT_DEAD_LETTER_TOPIC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.mqttDeadLetterTopic = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_MQTT_HEARTBEAT_TOPIC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.mqttHeartbeatTopic = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_HEARTBEAT_TIME_SEC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.heartbeatTimeSec = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_HEARTBEAT_FORMAT;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.heartbeatFormat = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_SPOOL_DIR;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.spoolDir = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_SPOOL_MAX_BYTES;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.spoolMaxBytes = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_SPOOL_DRAIN_BYTES_PER_SEC;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.spoolDrainBytesPerSec = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_MAX_IN_FLIGHT;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.maxInFlight = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_COMPRESSION;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.compression = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_COMPRESSION_LEVEL;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.compressionLevel = entry.GetInt64(jsonKey);
+            }
+
+            jsonKey = JSON_BATCH_FORMAT;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.batchFormat = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_TRANSPORT;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.transport = entry.GetString(jsonKey).c_str();
+            }
+
+            jsonKey = JSON_TCP_PORT;
+            if (entry.ValueExists(jsonKey))
+            {
+                sensorSettings.tcpPort = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_ADDR_POLL_SEC;
+            jsonKey = JSON_EVENT_LOOP_WEIGHT;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.addrPollSec = entry.GetInt64(jsonKey);
+                sensorSettings.eventLoopWeight = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_BUFFER_TIME_MS;
+            jsonKey = JSON_FILTER_DEDUP;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.bufferTimeMs = entry.GetInt64(jsonKey);
+                sensorSettings.filterDedup = entry.GetBool(jsonKey);
             }
 
-            jsonKey = JSON_BUFFER_SIZE;
+            jsonKey = JSON_FILTER_DEADBAND;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.bufferSize = entry.GetInt64(jsonKey);
+                sensorSettings.filterDeadband = entry.GetDouble(jsonKey);
             }
 
-            jsonKey = JSON_BUFFER_CAPACITY;
+            jsonKey = JSON_FILTER_JSON_KEY;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.bufferCapacity = entry.GetInt64(jsonKey);
+                sensorSettings.filterJsonKey = entry.GetString(jsonKey).c_str();
             }
 
-            jsonKey = JSON_EOM_DELIMITER;
+            jsonKey = JSON_FILTER_CSV_COLUMN;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.eomDelimiter = entry.GetString(jsonKey).c_str();
+                sensorSettings.filterCsvColumn = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_MQTT_TOPIC;
+            jsonKey = JSON_FILTER_KEEP_EVERY;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.mqttTopic = entry.GetString(jsonKey).c_str();
+                sensorSettings.filterKeepEvery = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_MQTT_DEAD_LETTER_TOPIC;
+            jsonKey = JSON_FILTER_MIN_INTERVAL_MS;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.mqttDeadLetterTopic = entry.GetString(jsonKey).c_str();
+                sensorSettings.filterMinIntervalMs = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_MQTT_HEARTBEAT_TOPIC;
+            jsonKey = JSON_ADAPTIVE_LATENCY_MS;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.mqttHeartbeatTopic = entry.GetString(jsonKey).c_str();
+                sensorSettings.adaptiveLatencyMs = entry.GetInt64(jsonKey);
             }
 
-            jsonKey = JSON_HEARTBEAT_TIME_SEC;
+            jsonKey = JSON_ADAPTIVE_MAX_PAYLOAD_BYTES;
             if (entry.ValueExists(jsonKey))
             {
-                sensorSettings.heartbeatTimeSec = entry.GetInt64(jsonKey);
+                sensorSettings.adaptiveMaxPayloadBytes = entry.GetInt64(jsonKey);
             }
 
             settings.push_back(sensorSettings);
@@ -2269,8 +2912,69 @@ bool PlainConfig::SensorPublish::Validate() const
             continue; // Skip validation
         }
 
+        // Validate the transport used to read from the sensor.
+        bool tcp = false;
+        if (setting.transport.has_value())
+        {
+            const std::string &transport = setting.transport.value();
+            if (transport == TRANSPORT_TCP)
+            {
+                tcp = true;
+            }
+            else if (
+                transport != TRANSPORT_UNIX_STREAM && transport != TRANSPORT_UNIX_DATAGRAM &&
+                transport != TRANSPORT_SHM)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s is not supported, expected %s, %s, %s or %s",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_TRANSPORT,
+                    Sanitize(transport).c_str(),
+                    TRANSPORT_UNIX_STREAM,
+                    TRANSPORT_UNIX_DATAGRAM,
+                    TRANSPORT_TCP,
+                    TRANSPORT_SHM);
+            }
+        }
+
+        if (tcp)
+        {
+            // Validate the address is a numeric loopback address, so that sensor data is never read from the network.
+            in_addr ipv4;
+            in6_addr ipv6;
+            bool loopback = false;
+            if (inet_pton(AF_INET, setting.addr->c_str(), &ipv4) == 1)
+            {
+                loopback = (ntohl(ipv4.s_addr) >> 24) == 127;
+            }
+            else if (inet_pton(AF_INET6, setting.addr->c_str(), &ipv6) == 1)
+            {
+                loopback = IN6_IS_ADDR_LOOPBACK(&ipv6);
+            }
+            if (!loopback)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s is not a loopback address",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_ADDR,
+                    Sanitize(setting.addr.value()).c_str());
+            }
+            if (!setting.tcpPort.has_value() || setting.tcpPort.value() < 1 || setting.tcpPort.value() > 65535)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s must be between 1 and 65535",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_TCP_PORT);
+            }
+        }
         // Validate the pathname socket path exists and satisfies permissions.
-        if (FileUtils::FileExists(setting.addr.value()))
+        else if (FileUtils::FileExists(setting.addr.value()))
         {
             // If the path points to an existing file,
             // then check the path satisfies permissions.
@@ -2332,7 +3036,9 @@ bool PlainConfig::SensorPublish::Validate() const
         }
 
         // Validate that delimiter is non-empty and valid.
-        if (!setting.eomDelimiter.has_value() || setting.eomDelimiter.value().empty())
+        // A datagram transport reads one message per datagram, so the delimiter is optional.
+        bool datagram = setting.transport.has_value() && setting.transport.value() == TRANSPORT_UNIX_DATAGRAM;
+        if (setting.eomDelimiter.has_value() ? setting.eomDelimiter.value().empty() : !datagram)
         {
             setting.enabled = false;
             LOGM_ERROR(
@@ -2341,7 +3047,7 @@ bool PlainConfig::SensorPublish::Validate() const
                 DeviceClient::DC_FATAL_ERROR,
                 JSON_EOM_DELIMITER);
         }
-        else
+        else if (setting.eomDelimiter.has_value())
         {
             // Validate the regular expression by checking for exceptions when compiling the pattern.
             try
@@ -2401,6 +3107,31 @@ bool PlainConfig::SensorPublish::Validate() const
                 JSON_HEARTBEAT_TIME_SEC,
                 setting.heartbeatTimeSec.value());
         }
+        if (setting.heartbeatFormat.has_value() && setting.heartbeatFormat.value() != HEARTBEAT_FORMAT_NAME &&
+            setting.heartbeatFormat.value() != HEARTBEAT_FORMAT_JSON &&
+            setting.heartbeatFormat.value() != HEARTBEAT_FORMAT_BINARY)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not supported, expected %s, %s or %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_HEARTBEAT_FORMAT,
+                Sanitize(setting.heartbeatFormat.value()).c_str(),
+                HEARTBEAT_FORMAT_NAME,
+                HEARTBEAT_FORMAT_JSON,
+                HEARTBEAT_FORMAT_BINARY);
+        }
+        if (setting.maxInFlight.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_MAX_IN_FLIGHT,
+                setting.maxInFlight.value());
+        }
 
         // Validate the buffer capcity.
         if (setting.bufferCapacity.value() < BUF_CAPACITY_BYTES_MIN)
@@ -2415,6 +3146,225 @@ bool PlainConfig::SensorPublish::Validate() const
                 BUF_CAPACITY_BYTES_MIN);
         }
 
+        // Validate the compression settings.
+        if (setting.compression.has_value() && setting.compression.value() != COMPRESSION_NONE &&
+            setting.compression.value() != COMPRESSION_DEFLATE)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not supported, expected %s or %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_COMPRESSION,
+                Sanitize(setting.compression.value()).c_str(),
+                COMPRESSION_NONE,
+                COMPRESSION_DEFLATE);
+        }
+        if (setting.compressionLevel.value() < 1 || setting.compressionLevel.value() > 9)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be between 1 and 9",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_COMPRESSION_LEVEL,
+                setting.compressionLevel.value());
+        }
+
+        // Validate the weight used to place the sensor on an event loop.
+        if (setting.eventLoopWeight.value() < 1)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be positive",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_EVENT_LOOP_WEIGHT,
+                setting.eventLoopWeight.value());
+        }
+
+        // Validate the filter settings, the deadband is applied to exactly one field.
+        if (setting.filterDeadband.has_value() && !(setting.filterDeadband.value() >= 0))
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %f must not be negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_DEADBAND,
+                setting.filterDeadband.value());
+        }
+        if (setting.filterDeadband.has_value() &&
+            setting.filterJsonKey.has_value() == setting.filterCsvColumn.has_value())
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s requires one of %s or %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_DEADBAND,
+                JSON_FILTER_JSON_KEY,
+                JSON_FILTER_CSV_COLUMN);
+        }
+        if (!setting.filterDeadband.has_value() &&
+            (setting.filterJsonKey.has_value() || setting.filterCsvColumn.has_value()))
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s and %s require %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_JSON_KEY,
+                JSON_FILTER_CSV_COLUMN,
+                JSON_FILTER_DEADBAND);
+        }
+        if (setting.filterJsonKey.has_value() && setting.filterJsonKey->empty())
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG, "*** %s: Config %s must not be empty", DeviceClient::DC_FATAL_ERROR, JSON_FILTER_JSON_KEY);
+        }
+        if (setting.filterCsvColumn.has_value() && setting.filterCsvColumn.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must not be negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_CSV_COLUMN,
+                setting.filterCsvColumn.value());
+        }
+        if (setting.filterKeepEvery.has_value() && setting.filterKeepEvery.value() < 1)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be positive",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_KEEP_EVERY,
+                setting.filterKeepEvery.value());
+        }
+        if (setting.filterMinIntervalMs.has_value() && setting.filterMinIntervalMs.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must not be negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_FILTER_MIN_INTERVAL_MS,
+                setting.filterMinIntervalMs.value());
+        }
+
+        // Validate the adaptive batching settings, which replace buffer_size and buffer_time_ms.
+        if (setting.adaptiveLatencyMs.has_value() && setting.adaptiveLatencyMs.value() < 1)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be positive",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_ADAPTIVE_LATENCY_MS,
+                setting.adaptiveLatencyMs.value());
+        }
+        if (setting.adaptiveMaxPayloadBytes.has_value())
+        {
+            if (!setting.adaptiveLatencyMs.has_value())
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s requires %s",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_ADAPTIVE_MAX_PAYLOAD_BYTES,
+                    JSON_ADAPTIVE_LATENCY_MS);
+            }
+            if (setting.adaptiveMaxPayloadBytes.value() < 1 ||
+                setting.adaptiveMaxPayloadBytes.value() > setting.bufferCapacity.value())
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld must be between 1 and %s %ld",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_ADAPTIVE_MAX_PAYLOAD_BYTES,
+                    setting.adaptiveMaxPayloadBytes.value(),
+                    JSON_BUFFER_CAPACITY,
+                    setting.bufferCapacity.value());
+            }
+        }
+
+        // Validate the batch format.
+        if (setting.batchFormat.has_value() && setting.batchFormat.value() != BATCH_FORMAT_RAW &&
+            setting.batchFormat.value() != BATCH_FORMAT_JSON &&
+            setting.batchFormat.value() != BATCH_FORMAT_LENGTH_PREFIXED &&
+            setting.batchFormat.value() != BATCH_FORMAT_CBOR)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not supported, expected %s, %s, %s or %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BATCH_FORMAT,
+                Sanitize(setting.batchFormat.value()).c_str(),
+                BATCH_FORMAT_RAW,
+                BATCH_FORMAT_JSON,
+                BATCH_FORMAT_LENGTH_PREFIXED,
+                BATCH_FORMAT_CBOR);
+        }
+
+        // Validate the spool settings, only when the spool is enabled.
+        if (setting.spoolDir.has_value() && !setting.spoolDir.value().empty())
+        {
+            if (FileUtils::DirectoryExists(setting.spoolDir.value()))
+            {
+                // If the spool directory exists, then check the directory satisfies permissions.
+                if (!FileUtils::ValidateFilePermissions(
+                        setting.spoolDir.value(), Permissions::SENSOR_PUBLISH_SPOOL_DIR))
+                {
+                    setting.enabled = false;
+                }
+            }
+            else
+            {
+                // If the spool directory does not exist, then check the parent directory exists so it can be
+                // created on startup.
+                auto spoolParentDir = FileUtils::ExtractParentDirectory(setting.spoolDir.value());
+                if (!FileUtils::DirectoryExists(spoolParentDir))
+                {
+                    setting.enabled = false;
+                    LOGM_ERROR(
+                        Config::TAG,
+                        "*** %s: Config %s parent directory %s does not exist",
+                        DeviceClient::DC_FATAL_ERROR,
+                        JSON_SPOOL_DIR,
+                        spoolParentDir.c_str());
+                }
+            }
+
+            // The spool holds at least two batches of the buffer capacity.
+            if (setting.spoolMaxBytes.value() < 2 * setting.bufferCapacity.value())
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld is less than minimum %ld",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_SPOOL_MAX_BYTES,
+                    setting.spoolMaxBytes.value(),
+                    2 * setting.bufferCapacity.value());
+            }
+            if (setting.spoolDrainBytesPerSec.value() <= 0)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld must be positive",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_SPOOL_DRAIN_BYTES_PER_SEC,
+                    setting.spoolDrainBytesPerSec.value());
+            }
+        }
+
         // If at least one sensor is valid, then enable the feature.
         if (setting.enabled)
         {
@@ -2489,6 +3439,101 @@ void PlainConfig::SensorPublish::SerializeToObject(Crt::JsonObject &object) cons
             sensor.WithInt64(JSON_HEARTBEAT_TIME_SEC, entry.heartbeatTimeSec.value());
         }
 
+        if (entry.heartbeatFormat.has_value())
+        {
+            sensor.WithString(JSON_HEARTBEAT_FORMAT, entry.heartbeatFormat->c_str());
+        }
+
+        if (entry.spoolDir.has_value() && entry.spoolDir->c_str())
+        {
+            sensor.WithString(JSON_SPOOL_DIR, entry.spoolDir->c_str());
+        }
+
+        if (entry.spoolMaxBytes.has_value())
+        {
+            sensor.WithInt64(JSON_SPOOL_MAX_BYTES, entry.spoolMaxBytes.value());
+        }
+
+        if (entry.spoolDrainBytesPerSec.has_value())
+        {
+            sensor.WithInt64(JSON_SPOOL_DRAIN_BYTES_PER_SEC, entry.spoolDrainBytesPerSec.value());
+        }
+
+        if (entry.maxInFlight.has_value())
+        {
+            sensor.WithInt64(JSON_MAX_IN_FLIGHT, entry.maxInFlight.value());
+        }
+
+        if (entry.compression.has_value())
+        {
+            sensor.WithString(JSON_COMPRESSION, entry.compression->c_str());
+        }
+
+        if (entry.compressionLevel.has_value())
+        {
+            sensor.WithInt64(JSON_COMPRESSION_LEVEL, entry.compressionLevel.value());
+        }
+
+        if (entry.batchFormat.has_value())
+        {
+            sensor.WithString(JSON_BATCH_FORMAT, entry.batchFormat->c_str());
+        }
+
+        if (entry.transport.has_value())
+        {
+            sensor.WithString(JSON_TRANSPORT, entry.transport->c_str());
+        }
+
+        if (entry.tcpPort.has_value())
+        {
+            sensor.WithInt64(JSON_TCP_PORT, entry.tcpPort.value());
+        }
+
+        if (entry.eventLoopWeight.has_value())
+        {
+            sensor.WithInt64(JSON_EVENT_LOOP_WEIGHT, entry.eventLoopWeight.value());
+        }
+
+        if (entry.filterDedup.has_value())
+        {
+            sensor.WithBool(JSON_FILTER_DEDUP, entry.filterDedup.value());
+        }
+
+        if (entry.filterDeadband.has_value())
+        {
+            sensor.WithDouble(JSON_FILTER_DEADBAND, entry.filterDeadband.value());
+        }
+
+        if (entry.filterJsonKey.has_value())
+        {
+            sensor.WithString(JSON_FILTER_JSON_KEY, entry.filterJsonKey->c_str());
+        }
+
+        if (entry.filterCsvColumn.has_value())
+        {
+            sensor.WithInt64(JSON_FILTER_CSV_COLUMN, entry.filterCsvColumn.value());
+        }
+
+        if (entry.filterKeepEvery.has_value())
+        {
+            sensor.WithInt64(JSON_FILTER_KEEP_EVERY, entry.filterKeepEvery.value());
+        }
+
+        if (entry.filterMinIntervalMs.has_value())
+        {
+            sensor.WithInt64(JSON_FILTER_MIN_INTERVAL_MS, entry.filterMinIntervalMs.value());
+        }
+
+        if (entry.adaptiveLatencyMs.has_value())
+        {
+            sensor.WithInt64(JSON_ADAPTIVE_LATENCY_MS, entry.adaptiveLatencyMs.value());
+        }
+
+        if (entry.adaptiveMaxPayloadBytes.has_value())
+        {
+            sensor.WithInt64(JSON_ADAPTIVE_MAX_PAYLOAD_BYTES, entry.adaptiveMaxPayloadBytes.value());
+        }
+
         sensors.push_back(sensor);
     }
 
@@ -2550,10 +3595,24 @@ bool Config::ParseCliArgs(int argc, char **argv, CliArgs &cliArgs)
         {PlainConfig::LogConfig::CLI_LOG_LEVEL, true, nullptr},
         {PlainConfig::LogConfig::CLI_LOG_TYPE, true, nullptr},
         {PlainConfig::LogConfig::CLI_LOG_FILE, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_SOCKET, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_FLUSH_INTERVAL_MS, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_FLUSH_THRESHOLD_BYTES, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_BINARY_FORMAT, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_SIZE_BYTES, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_AGE_SECONDS, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_ROTATION_GENERATIONS, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_ROTATION_COMPRESS, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_QUEUE_CAPACITY, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_QUEUE_OVERFLOW_POLICY, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_PER_SECOND, true, nullptr},
+        {PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_BURST, true, nullptr},
         {PlainConfig::LogConfig::CLI_ENABLE_SDK_LOGGING, false, nullptr},
         {PlainConfig::LogConfig::CLI_SDK_LOG_LEVEL, true, nullptr},
         {PlainConfig::LogConfig::CLI_SDK_LOG_FILE, true, nullptr},
 
+        {PlainConfig::EventLoop::CLI_EVENT_LOOP_THREADS, true, nullptr},
+
         {PlainConfig::Jobs::CLI_ENABLE_JOBS, true, nullptr},
         {PlainConfig::Jobs::CLI_HANDLER_DIR, true, nullptr},
 
@@ -2918,11 +3977,25 @@ void Config::PrintHelpMessage()
         "program\n"
         "%s <JSON-File-Location>:\t\t\t\t\tTake settings defined in the specified JSON file and start the binary\n"
         "%s <[DEBUG, INFO, WARN, ERROR]>:\t\t\t\tSpecify the log level for the AWS IoT Device Client\n"
-        "%s <[STDOUT, FILE]>:\t\t\t\t\t\tSpecify the logger implementation to use.\n"
+        "%s <[STDOUT, FILE, JOURNALD, SYSLOG]>:\t\t\tSpecify the logger implementation to use.\n"
         "%s <File-Location>:\t\t\t\t\t\tWrite logs to specified log file when using the file logger.\n"
+        "%s <Socket-Location>:\t\t\t\t\tSend logs to this Unix socket when using the journald or syslog logger.\n"
+        "%s <milliseconds>:\t\t\t\tSync the log file to disk at most this often, 0 to disable.\n"
+        "%s <bytes>:\t\t\t\tSync the log file to disk after this many bytes, 0 to disable.\n"
+        "%s [true|false]:\t\t\t\tWrite the log file in the binary log format, decoded with dc-logdecode.\n"
+        "%s <bytes>:\t\t\tRotate the log file once it reaches this size, 0 to disable.\n"
+        "%s <seconds>:\t\t\tRotate the log file once it has been written to for this long, 0 to disable.\n"
+        "%s <count>:\t\t\t\tNumber of rotated log files to keep.\n"
+        "%s [true|false]:\t\t\t\tCompress rotated log files with gzip.\n"
+        "%s <count>:\t\t\t\tNumber of log messages that can be queued before messages are dropped.\n"
+        "%s <[drop-newest, drop-oldest, drop-below-level]>:\tWhich log messages to drop when the log queue is "
+        "full.\n"
+        "%s <count>:\t\t\tLog messages per second allowed for each tag past its burst, 0 to disable.\n"
+        "%s <count>:\t\t\t\tLog messages a tag can log in a row before it is rate limited.\n"
         "%s \t\t\t\t\t\t\tEnable SDK Logging.\n"
         "%s <[Trace, Debug, Info, Warn, Error, Fatal]>:\t\tSpecify the log level for the SDK\n"
         "%s <File-Location>:\t\t\t\t\t\tWrite SDK logs to specified log file.\n"
+        "%s <count>:\t\t\t\tNumber of event loop threads, defaults to the number of cores.\n"
         "%s [true|false]:\t\t\t\t\t\tEnables/Disables Jobs feature\n"
         "%s [true|false]:\t\t\t\t\tEnables/Disables Tunneling feature\n"
         "%s [true|false]:\t\t\t\t\tEnables/Disables Device Defender feature\n"
@@ -2975,9 +4048,22 @@ void Config::PrintHelpMessage()
         PlainConfig::LogConfig::CLI_LOG_LEVEL,
         PlainConfig::LogConfig::CLI_LOG_TYPE,
         PlainConfig::LogConfig::CLI_LOG_FILE,
+        PlainConfig::LogConfig::CLI_LOG_SOCKET,
+        PlainConfig::LogConfig::CLI_LOG_FLUSH_INTERVAL_MS,
+        PlainConfig::LogConfig::CLI_LOG_FLUSH_THRESHOLD_BYTES,
+        PlainConfig::LogConfig::CLI_LOG_BINARY_FORMAT,
+        PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_SIZE_BYTES,
+        PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_AGE_SECONDS,
+        PlainConfig::LogConfig::CLI_LOG_ROTATION_GENERATIONS,
+        PlainConfig::LogConfig::CLI_LOG_ROTATION_COMPRESS,
+        PlainConfig::LogConfig::CLI_LOG_QUEUE_CAPACITY,
+        PlainConfig::LogConfig::CLI_LOG_QUEUE_OVERFLOW_POLICY,
+        PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_PER_SECOND,
+        PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_BURST,
         PlainConfig::LogConfig::CLI_ENABLE_SDK_LOGGING,
         PlainConfig::LogConfig::CLI_SDK_LOG_LEVEL,
         PlainConfig::LogConfig::CLI_SDK_LOG_FILE,
+        PlainConfig::EventLoop::CLI_EVENT_LOOP_THREADS,
         PlainConfig::Jobs::CLI_ENABLE_JOBS,
         PlainConfig::Tunneling::CLI_ENABLE_TUNNELING,
         PlainConfig::DeviceDefender::CLI_ENABLE_DEVICE_DEFENDER,
@@ -3092,7 +4178,26 @@ bool Config::ExportDefaultSetting(const string &file)
             "%s": "<replace>",
             "%s": "<replace>",
             "%s": "<replace>",
-            "%s": replace
+            "%s": replace,
+            "%s": "<replace>",
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": "<replace>",
+            "%s": replace,
+            "%s": "<replace>",
+            "%s": "<replace>",
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": "<replace>",
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": replace,
+            "%s": "<replace>"
         ]
     }
 }
@@ -3169,7 +4274,26 @@ bool Config::ExportDefaultSetting(const string &file)
         PlainConfig::SensorPublish::JSON_MQTT_TOPIC,
         PlainConfig::SensorPublish::JSON_MQTT_DEAD_LETTER_TOPIC,
         PlainConfig::SensorPublish::JSON_MQTT_HEARTBEAT_TOPIC,
-        PlainConfig::SensorPublish::JSON_HEARTBEAT_TIME_SEC);
+        PlainConfig::SensorPublish::JSON_HEARTBEAT_TIME_SEC,
+        PlainConfig::SensorPublish::JSON_SPOOL_DIR,
+        PlainConfig::SensorPublish::JSON_SPOOL_MAX_BYTES,
+        PlainConfig::SensorPublish::JSON_SPOOL_DRAIN_BYTES_PER_SEC,
+        PlainConfig::SensorPublish::JSON_MAX_IN_FLIGHT,
+        PlainConfig::SensorPublish::JSON_COMPRESSION,
+        PlainConfig::SensorPublish::JSON_COMPRESSION_LEVEL,
+        PlainConfig::SensorPublish::JSON_BATCH_FORMAT,
+        PlainConfig::SensorPublish::JSON_TRANSPORT,
+        PlainConfig::SensorPublish::JSON_TCP_PORT,
+        PlainConfig::SensorPublish::JSON_EVENT_LOOP_WEIGHT,
+        PlainConfig::SensorPublish::JSON_FILTER_DEDUP,
+        PlainConfig::SensorPublish::JSON_FILTER_DEADBAND,
+        PlainConfig::SensorPublish::JSON_FILTER_JSON_KEY,
+        PlainConfig::SensorPublish::JSON_FILTER_CSV_COLUMN,
+        PlainConfig::SensorPublish::JSON_FILTER_KEEP_EVERY,
+        PlainConfig::SensorPublish::JSON_FILTER_MIN_INTERVAL_MS,
+        PlainConfig::SensorPublish::JSON_ADAPTIVE_LATENCY_MS,
+        PlainConfig::SensorPublish::JSON_ADAPTIVE_MAX_PAYLOAD_BYTES,
+        PlainConfig::SensorPublish::JSON_HEARTBEAT_FORMAT);
 
     clientConfig.close();
     LOGM_INFO(TAG, "Exported settings to: %s", Sanitize(file).c_str());
@@ -47,6 +47,7 @@ namespace Aws
                 static constexpr int PUBSUB_DIR = 745;
                 static constexpr int PKCS11_LIB_DIR = 700;
                 static constexpr int SENSOR_PUBLISH_ADDR_DIR = 700;
+                static constexpr int SENSOR_PUBLISH_SPOOL_DIR = 700;
 
                 /** Files **/
                 static constexpr int PRIVATE_KEY = 600;
@@ -90,6 +91,7 @@ namespace Aws
                 static constexpr char JSON_KEY_FLEET_PROVISIONING[] = "fleet-provisioning";
                 static constexpr char JSON_KEY_RUNTIME_CONFIG[] = "runtime-config";
                 static constexpr char JSON_KEY_LOGGING[] = "logging";
+                static constexpr char JSON_KEY_EVENT_LOOP[] = "event-loop";
 
                 static constexpr char JSON_KEY_SAMPLES[] = "samples";
                 static constexpr char JSON_KEY_PUB_SUB[] = "pub-sub";
@@ -119,20 +121,50 @@ namespace Aws
                     int ParseDeviceClientLogLevel(const std::string &value) const;
                     Aws::Crt::LogLevel ParseSDKLogLevel(const std::string &value) const;
                     std::string ParseDeviceClientLogType(const std::string &value) const;
+                    std::string ParseQueueOverflowPolicy(const std::string &value) const;
                     std::string StringifyDeviceClientLogLevel(int level) const;
                     std::string StringifySDKLogLevel(Aws::Crt::LogLevel level) const;
                     /** Serialize logging configurations To Json Object **/
                     void SerializeToObject(Crt::JsonObject &object) const;
                     static constexpr char LOG_TYPE_FILE[] = "file";
                     static constexpr char LOG_TYPE_STDOUT[] = "stdout";
+                    static constexpr char LOG_TYPE_JOURNALD[] = "journald";
+                    static constexpr char LOG_TYPE_SYSLOG[] = "syslog";
+                    static constexpr char QUEUE_OVERFLOW_DROP_NEWEST[] = "drop-newest";
+                    static constexpr char QUEUE_OVERFLOW_DROP_OLDEST[] = "drop-oldest";
+                    static constexpr char QUEUE_OVERFLOW_DROP_BELOW_LEVEL[] = "drop-below-level";
 
                     static constexpr char CLI_LOG_LEVEL[] = "--log-level";
                     static constexpr char CLI_LOG_TYPE[] = "--log-type";
                     static constexpr char CLI_LOG_FILE[] = "--log-file";
+                    static constexpr char CLI_LOG_SOCKET[] = "--log-socket";
+                    static constexpr char CLI_LOG_FLUSH_INTERVAL_MS[] = "--log-flush-interval-ms";
+                    static constexpr char CLI_LOG_FLUSH_THRESHOLD_BYTES[] = "--log-flush-threshold-bytes";
+                    static constexpr char CLI_LOG_BINARY_FORMAT[] = "--log-binary-format";
+                    static constexpr char CLI_LOG_ROTATION_MAX_SIZE_BYTES[] = "--log-rotation-max-size-bytes";
+                    static constexpr char CLI_LOG_ROTATION_MAX_AGE_SECONDS[] = "--log-rotation-max-age-seconds";
+                    static constexpr char CLI_LOG_ROTATION_GENERATIONS[] = "--log-rotation-generations";
+                    static constexpr char CLI_LOG_ROTATION_COMPRESS[] = "--log-rotation-compress";
+                    static constexpr char CLI_LOG_QUEUE_CAPACITY[] = "--log-queue-capacity";
+                    static constexpr char CLI_LOG_QUEUE_OVERFLOW_POLICY[] = "--log-queue-overflow-policy";
+                    static constexpr char CLI_LOG_RATE_LIMIT_PER_SECOND[] = "--log-rate-limit-per-second";
+                    static constexpr char CLI_LOG_RATE_LIMIT_BURST[] = "--log-rate-limit-burst";
 
                     static constexpr char JSON_KEY_LOG_LEVEL[] = "level";
                     static constexpr char JSON_KEY_LOG_TYPE[] = "type";
                     static constexpr char JSON_KEY_LOG_FILE[] = "file";
+                    static constexpr char JSON_KEY_LOG_SOCKET[] = "socket";
+                    static constexpr char JSON_KEY_FLUSH_INTERVAL_MS[] = "flush-interval-ms";
+                    static constexpr char JSON_KEY_FLUSH_THRESHOLD_BYTES[] = "flush-threshold-bytes";
+                    static constexpr char JSON_KEY_BINARY_FORMAT[] = "binary-format";
+                    static constexpr char JSON_KEY_ROTATION_MAX_SIZE_BYTES[] = "rotation-max-size-bytes";
+                    static constexpr char JSON_KEY_ROTATION_MAX_AGE_SECONDS[] = "rotation-max-age-seconds";
+                    static constexpr char JSON_KEY_ROTATION_GENERATIONS[] = "rotation-generations";
+                    static constexpr char JSON_KEY_ROTATION_COMPRESS[] = "rotation-compress";
+                    static constexpr char JSON_KEY_QUEUE_CAPACITY[] = "queue-capacity";
+                    static constexpr char JSON_KEY_QUEUE_OVERFLOW_POLICY[] = "queue-overflow-policy";
+                    static constexpr char JSON_KEY_RATE_LIMIT_PER_SECOND[] = "rate-limit-per-second";
+                    static constexpr char JSON_KEY_RATE_LIMIT_BURST[] = "rate-limit-burst";
 
                     static constexpr char CLI_ENABLE_SDK_LOGGING[] = "--enable-sdk-logging";
                     static constexpr char CLI_SDK_LOG_LEVEL[] = "--sdk-log-level";
@@ -145,6 +177,30 @@ namespace Aws
                     int deviceClientlogLevel{3};
                     std::string deviceClientLogtype{LOG_TYPE_STDOUT};
                     std::string deviceClientLogFile{"/var/log/aws-iot-device-client/aws-iot-device-client.log"};
+                    /** Unix datagram socket of the journald and syslog loggers, empty for the system default **/
+                    std::string deviceClientLogSocket;
+                    /** Milliseconds between syncs of the log file to disk, 0 leaves syncing to the OS **/
+                    int flushIntervalMs{0};
+                    /** Bytes written to the log file between syncs to disk, 0 leaves syncing to the OS **/
+                    int flushThresholdBytes{0};
+                    /** Write the log file in the binary log format, decoded with dc-logdecode **/
+                    bool binaryFormat{false};
+                    /** Size in bytes at which the log file is rotated, 0 disables rotation by size **/
+                    int rotationMaxSizeBytes{0};
+                    /** Seconds after which the log file is rotated, 0 disables rotation by age **/
+                    int rotationMaxAgeSeconds{0};
+                    /** Number of rotated log files that are kept **/
+                    int rotationGenerations{5};
+                    /** Compress rotated log files with gzip **/
+                    bool rotationCompress{true};
+                    /** Number of log messages that can be queued for the logger thread **/
+                    int queueCapacity{4096};
+                    /** What to drop when the log queue is full: drop-newest, drop-oldest or drop-below-level **/
+                    std::string queueOverflowPolicy{QUEUE_OVERFLOW_DROP_NEWEST};
+                    /** Log messages per second allowed for each tag once its burst is used up, 0 disables the limit **/
+                    int rateLimitPerSecond{0};
+                    /** Number of log messages a tag can log in a row before the rate limit applies **/
+                    int rateLimitBurst{100};
 
                     bool sdkLoggingEnabled{false};
                     Aws::Crt::LogLevel sdkLogLevel{Aws::Crt::LogLevel::Trace};
@@ -152,6 +208,32 @@ namespace Aws
                 };
                 LogConfig logConfig;
 
+                struct EventLoop : public LoadableFromJsonAndCliAndEnvironment
+                {
+                    bool LoadFromJson(const Crt::JsonView &json) override;
+                    bool LoadFromCliArgs(const CliArgs &cliArgs) override;
+                    bool LoadFromEnvironment() override { return true; }
+                    bool Validate() const override;
+                    /** Serialize event loop configurations To Json Object **/
+                    void SerializeToObject(Crt::JsonObject &object) const;
+
+                    static constexpr char CLI_EVENT_LOOP_THREADS[] = "--event-loop-threads";
+
+                    static constexpr char JSON_KEY_THREADS[] = "threads";
+                    static constexpr char JSON_KEY_CPU_AFFINITY[] = "cpu-affinity";
+
+                    // MAX_THREADS is the maximum number of event loop threads.
+                    static constexpr int MAX_THREADS = 256;
+
+                    /** Number of event loop threads shared by the MQTT connection and features, defaults to the
+                     * number of cores **/
+                    Aws::Crt::Optional<int> threads;
+                    /** CPU each event loop thread is pinned to, the list is repeated when there are more threads,
+                     * empty leaves scheduling to the OS **/
+                    std::vector<int> cpuAffinity;
+                };
+                EventLoop eventLoop;
+
                 struct Jobs : public LoadableFromJsonAndCliAndEnvironment
                 {
                     bool LoadFromJson(const Crt::JsonView &json) override;
@@ -433,12 +515,48 @@ namespace Aws
                     static constexpr char JSON_MQTT_DEAD_LETTER_TOPIC[] = "mqtt_dead_letter_topic";
                     static constexpr char JSON_MQTT_HEARTBEAT_TOPIC[] = "mqtt_heartbeat_topic";
                     static constexpr char JSON_HEARTBEAT_TIME_SEC[] = "heartbeat_time_sec";
+                    static constexpr char JSON_SPOOL_DIR[] = "spool_dir";
+                    static constexpr char JSON_SPOOL_MAX_BYTES[] = "spool_max_bytes";
+                    static constexpr char JSON_SPOOL_DRAIN_BYTES_PER_SEC[] = "spool_drain_bytes_per_sec";
+                    static constexpr char JSON_MAX_IN_FLIGHT[] = "max_in_flight";
+                    static constexpr char JSON_COMPRESSION[] = "compression";
+                    static constexpr char JSON_COMPRESSION_LEVEL[] = "compression_level";
+                    static constexpr char JSON_BATCH_FORMAT[] = "batch_format";
+                    static constexpr char JSON_TRANSPORT[] = "transport";
+                    static constexpr char JSON_TCP_PORT[] = "tcp_port";
+                    static constexpr char JSON_EVENT_LOOP_WEIGHT[] = "event_loop_weight";
+                    static constexpr char JSON_FILTER_DEDUP[] = "filter_dedup";
+                    static constexpr char JSON_FILTER_DEADBAND[] = "filter_deadband";
+                    static constexpr char JSON_FILTER_JSON_KEY[] = "filter_json_key";
+                    static constexpr char JSON_FILTER_CSV_COLUMN[] = "filter_csv_column";
+                    static constexpr char JSON_FILTER_KEEP_EVERY[] = "filter_keep_every";
+                    static constexpr char JSON_FILTER_MIN_INTERVAL_MS[] = "filter_min_interval_ms";
+                    static constexpr char JSON_ADAPTIVE_LATENCY_MS[] = "adaptive_latency_ms";
+                    static constexpr char JSON_ADAPTIVE_MAX_PAYLOAD_BYTES[] = "adaptive_max_payload_bytes";
+                    static constexpr char JSON_HEARTBEAT_FORMAT[] = "heartbeat_format";
+
+                    static constexpr char COMPRESSION_NONE[] = "none";
+                    static constexpr char COMPRESSION_DEFLATE[] = "deflate";
+
+                    static constexpr char BATCH_FORMAT_RAW[] = "raw";
+                    static constexpr char BATCH_FORMAT_JSON[] = "json";
+                    static constexpr char BATCH_FORMAT_LENGTH_PREFIXED[] = "length-prefixed";
+                    static constexpr char BATCH_FORMAT_CBOR[] = "cbor";
+
+                    static constexpr char HEARTBEAT_FORMAT_NAME[] = "name";
+                    static constexpr char HEARTBEAT_FORMAT_JSON[] = "json";
+                    static constexpr char HEARTBEAT_FORMAT_BINARY[] = "binary";
+
+                    static constexpr char TRANSPORT_UNIX_STREAM[] = "unix-stream";
+                    static constexpr char TRANSPORT_UNIX_DATAGRAM[] = "unix-datagram";
+                    static constexpr char TRANSPORT_TCP[] = "tcp";
+                    static constexpr char TRANSPORT_SHM[] = "shm";
 
                     // MAX_SENSOR_SIZE is the maximum number of sensor entries in a valid configuration.
                     //
-                    // Increasing this limit will likely also require a user to increase the 5k limit on
+                    // Increasing this limit will likely also require a user to increase the 16k limit on
                     // the total size of the configuration.
-                    static constexpr std::size_t MAX_SENSOR_SIZE = 10;
+                    static constexpr std::size_t MAX_SENSOR_SIZE = 32;
 
                     // BUF_CAPACITY_BYTES is the default number of bytes buffered for a single sensor.
                     // When this limit is reached, we will publish all buffered complete messages.
@@ -452,6 +570,17 @@ namespace Aws
                     // multiples of buffer_size messages.
                     static constexpr std::int64_t BUF_CAPACITY_BYTES_MIN = 1024;
 
+                    // SPOOL_MAX_BYTES is the default size limit of the spool of a single sensor.
+                    // When this limit is reached, we will delete the oldest spooled batches.
+                    static constexpr std::int64_t SPOOL_MAX_BYTES = 16 * 1024 * 1024;
+
+                    // SPOOL_DRAIN_BYTES_PER_SEC is the default rate at which spooled batches are published
+                    // once publishes are acknowledged again, one batch of the default buffer capacity per second.
+                    static constexpr std::int64_t SPOOL_DRAIN_BYTES_PER_SEC = BUF_CAPACITY_BYTES;
+
+                    // COMPRESSION_LEVEL is the default deflate level, the zlib default which trades speed for size.
+                    static constexpr std::int64_t COMPRESSION_LEVEL = 6;
+
                     bool enabled{false};
 
                     struct SensorSettings
@@ -468,6 +597,25 @@ namespace Aws
                         Aws::Crt::Optional<std::string> mqttDeadLetterTopic;
                         Aws::Crt::Optional<std::string> mqttHeartbeatTopic;
                         Aws::Crt::Optional<int64_t> heartbeatTimeSec{300};
+                        Aws::Crt::Optional<std::string> spoolDir;
+                        Aws::Crt::Optional<int64_t> spoolMaxBytes{SPOOL_MAX_BYTES};
+                        Aws::Crt::Optional<int64_t> spoolDrainBytesPerSec{SPOOL_DRAIN_BYTES_PER_SEC};
+                        Aws::Crt::Optional<int64_t> maxInFlight{0};
+                        Aws::Crt::Optional<std::string> compression;
+                        Aws::Crt::Optional<int64_t> compressionLevel{COMPRESSION_LEVEL};
+                        Aws::Crt::Optional<std::string> batchFormat;
+                        Aws::Crt::Optional<std::string> transport;
+                        Aws::Crt::Optional<int64_t> tcpPort;
+                        Aws::Crt::Optional<int64_t> eventLoopWeight{1};
+                        Aws::Crt::Optional<bool> filterDedup;
+                        Aws::Crt::Optional<double> filterDeadband;
+                        Aws::Crt::Optional<std::string> filterJsonKey;
+                        Aws::Crt::Optional<int64_t> filterCsvColumn;
+                        Aws::Crt::Optional<int64_t> filterKeepEvery;
+                        Aws::Crt::Optional<int64_t> filterMinIntervalMs;
+                        Aws::Crt::Optional<int64_t> adaptiveLatencyMs;
+                        Aws::Crt::Optional<int64_t> adaptiveMaxPayloadBytes;
+                        Aws::Crt::Optional<std::string> heartbeatFormat;
                     };
                     // If any setting associated with a sensor is found invalid during validation,
                     // then we will disable only that sensor. In order to do this we must modify
@@ -521,7 +669,7 @@ namespace Aws
                 /**
                  * \brief Maximum accepted size for the config file.
                  */
-                static constexpr size_t MAX_CONFIG_SIZE = 5000;
+                static constexpr size_t MAX_CONFIG_SIZE = 16384;
 
                 /**
                  * \brief Separator between directories in path.
@@ -0,0 +1,745 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BinaryLogFormat.h"
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+namespace
+{
+    constexpr char ARGUMENT_SIGNED = 'i';
+    constexpr char ARGUMENT_UNSIGNED = 'u';
+    constexpr char ARGUMENT_DOUBLE = 'f';
+    constexpr char ARGUMENT_STRING = 's';
+
+    constexpr char NULL_STRING[] = "(null)";
+    constexpr size_t FORMAT_BUFFER_SIZE = 128;
+
+    /**
+     * \brief A single conversion specification of a printf-style format string, such as "%-8.*lld"
+     */
+    struct Conversion
+    {
+        size_t begin = 0;
+        size_t lengthBegin = 0;
+        size_t end = 0;
+        bool widthFromArgument = false;
+        bool precisionFromArgument = false;
+        int precision = -1;
+        char length[3] = {0, 0, 0};
+        char conversion = 0;
+    };
+
+    enum class ParseResult
+    {
+        CONVERSION,
+        END,
+        INVALID
+    };
+
+    /**
+     * \brief Finds the next conversion specification in the format string, starting at pos
+     */
+    ParseResult nextConversion(const char *format, size_t formatLength, size_t &pos, Conversion &conversion)
+    {
+        const void *percent = memchr(format + pos, '%', formatLength - pos);
+        if (percent == nullptr)
+        {
+            pos = formatLength;
+            return ParseResult::END;
+        }
+
+        conversion = Conversion();
+        conversion.begin = static_cast<const char *>(percent) - format;
+        size_t i = conversion.begin + 1;
+
+        while (i < formatLength && strchr("-+ #0'", format[i]) != nullptr)
+        {
+            i++;
+        }
+
+        if (i < formatLength && format[i] == '*')
+        {
+            conversion.widthFromArgument = true;
+            i++;
+        }
+        while (i < formatLength && format[i] >= '0' && format[i] <= '9')
+        {
+            i++;
+        }
+
+        if (i < formatLength && format[i] == '.')
+        {
+            i++;
+            conversion.precision = 0;
+            if (i < formatLength && format[i] == '*')
+            {
+                conversion.precisionFromArgument = true;
+                i++;
+            }
+            while (i < formatLength && format[i] >= '0' && format[i] <= '9')
+            {
+                conversion.precision = conversion.precision * 10 + (format[i] - '0');
+                i++;
+            }
+        }
+
+        conversion.lengthBegin = i;
+        size_t lengthSize = 0;
+        while (i < formatLength && lengthSize < 2 && strchr("hljztL", format[i]) != nullptr)
+        {
+            conversion.length[lengthSize++] = format[i++];
+        }
+
+        if (i >= formatLength)
+        {
+            return ParseResult::INVALID;
+        }
+        conversion.conversion = format[i];
+        conversion.end = i + 1;
+        pos = conversion.end;
+        return ParseResult::CONVERSION;
+    }
+
+    bool lengthIs(const Conversion &conversion, const char *length)
+    {
+        return strcmp(conversion.length, length) == 0;
+    }
+
+    template <typename T> void appendValue(string &buffer, T value)
+    {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void appendString(string &buffer, const char *value, int precision)
+    {
+        if (value == nullptr)
+        {
+            value = NULL_STRING;
+        }
+        // With a precision the string does not have to be NULL terminated, so never read past it
+        size_t length = precision < 0 ? strlen(value) : strnlen(value, static_cast<size_t>(precision));
+        buffer.push_back(ARGUMENT_STRING);
+        appendValue(buffer, static_cast<uint32_t>(length));
+        buffer.append(value, length);
+    }
+
+    int64_t readSigned(va_list &args, const Conversion &conversion)
+    {
+        if (lengthIs(conversion, "hh"))
+        {
+            return static_cast<signed char>(va_arg(args, int));
+        }
+        if (lengthIs(conversion, "h"))
+        {
+            return static_cast<short>(va_arg(args, int));
+        }
+        if (lengthIs(conversion, "l"))
+        {
+            return va_arg(args, long);
+        }
+        if (lengthIs(conversion, "ll"))
+        {
+            return va_arg(args, long long);
+        }
+        if (lengthIs(conversion, "j"))
+        {
+            return va_arg(args, intmax_t);
+        }
+        if (lengthIs(conversion, "z"))
+        {
+            return va_arg(args, make_signed<size_t>::type);
+        }
+        if (lengthIs(conversion, "t"))
+        {
+            return va_arg(args, ptrdiff_t);
+        }
+        return va_arg(args, int);
+    }
+
+    uint64_t readUnsigned(va_list &args, const Conversion &conversion)
+    {
+        if (lengthIs(conversion, "hh"))
+        {
+            return static_cast<unsigned char>(va_arg(args, unsigned int));
+        }
+        if (lengthIs(conversion, "h"))
+        {
+            return static_cast<unsigned short>(va_arg(args, unsigned int));
+        }
+        if (lengthIs(conversion, "l"))
+        {
+            return va_arg(args, unsigned long);
+        }
+        if (lengthIs(conversion, "ll"))
+        {
+            return va_arg(args, unsigned long long);
+        }
+        if (lengthIs(conversion, "j"))
+        {
+            return va_arg(args, uintmax_t);
+        }
+        if (lengthIs(conversion, "z"))
+        {
+            return va_arg(args, size_t);
+        }
+        if (lengthIs(conversion, "t"))
+        {
+            return va_arg(args, make_unsigned<ptrdiff_t>::type);
+        }
+        return va_arg(args, unsigned int);
+    }
+
+    /**
+     * \brief Sequential reader over encoded arguments
+     */
+    class ArgumentCursor
+    {
+      private:
+        const char *data;
+        size_t remaining;
+
+      public:
+        ArgumentCursor(const char *data, size_t length) : data(data), remaining(length) {}
+
+        template <typename T> bool read(char expectedType, T &value)
+        {
+            if (remaining < 1 + sizeof(T) || *data != expectedType)
+            {
+                return false;
+            }
+            memcpy(&value, data + 1, sizeof(T));
+            data += 1 + sizeof(T);
+            remaining -= 1 + sizeof(T);
+            return true;
+        }
+
+        bool readString(string &value)
+        {
+            uint32_t length = 0;
+            if (!read(ARGUMENT_STRING, length) || remaining < length)
+            {
+                return false;
+            }
+            value.assign(data, length);
+            data += length;
+            remaining -= length;
+            return true;
+        }
+
+        bool atEnd() const { return remaining == 0; }
+    };
+
+    void appendPrintf(string &message, const char *spec, ...)
+    {
+        char buffer[FORMAT_BUFFER_SIZE];
+        va_list args;
+        va_start(args, spec);
+        va_list retryArgs;
+        va_copy(retryArgs, args);
+        int length = vsnprintf(buffer, sizeof(buffer), spec, args);
+        va_end(args);
+
+        if (length >= static_cast<int>(sizeof(buffer)))
+        {
+            size_t offset = message.size();
+            message.resize(offset + length + 1);
+            vsnprintf(&message[offset], length + 1, spec, retryArgs);
+            message.resize(offset + length);
+        }
+        else if (length > 0)
+        {
+            message.append(buffer, length);
+        }
+        va_end(retryArgs);
+    }
+
+    /**
+     * \brief Formats a single value against a conversion specification, passing along the width and precision
+     * arguments if the specification takes them from the argument list
+     */
+    template <typename T>
+    void appendConversion(
+        string &message,
+        const string &spec,
+        const Conversion &conversion,
+        int width,
+        int precision,
+        T value)
+    {
+        if (conversion.widthFromArgument && conversion.precisionFromArgument)
+        {
+            appendPrintf(message, spec.c_str(), width, precision, value);
+        }
+        else if (conversion.widthFromArgument)
+        {
+            appendPrintf(message, spec.c_str(), width, value);
+        }
+        else if (conversion.precisionFromArgument)
+        {
+            appendPrintf(message, spec.c_str(), precision, value);
+        }
+        else
+        {
+            appendPrintf(message, spec.c_str(), value);
+        }
+    }
+    /**
+     * \brief Appends the value of every conversion of the format string, consuming the matching arguments
+     */
+    bool encodeArguments(const char *format, size_t formatLength, va_list &args, string &payload)
+    {
+        size_t pos = 0;
+        Conversion conversion;
+        for (;;)
+        {
+            ParseResult result = nextConversion(format, formatLength, pos, conversion);
+            if (result == ParseResult::END)
+            {
+                return true;
+            }
+            if (result == ParseResult::INVALID)
+            {
+                return false;
+            }
+            if (conversion.conversion == '%')
+            {
+                continue;
+            }
+
+            if (conversion.widthFromArgument)
+            {
+                payload.push_back(ARGUMENT_SIGNED);
+                appendValue(payload, static_cast<int64_t>(va_arg(args, int)));
+            }
+            int precision = conversion.precision;
+            if (conversion.precisionFromArgument)
+            {
+                precision = va_arg(args, int);
+                payload.push_back(ARGUMENT_SIGNED);
+                appendValue(payload, static_cast<int64_t>(precision));
+            }
+
+            switch (conversion.conversion)
+            {
+                case 'd':
+                case 'i':
+                    payload.push_back(ARGUMENT_SIGNED);
+                    appendValue(payload, readSigned(args, conversion));
+                    break;
+                case 'u':
+                case 'o':
+                case 'x':
+                case 'X':
+                    payload.push_back(ARGUMENT_UNSIGNED);
+                    appendValue(payload, readUnsigned(args, conversion));
+                    break;
+                case 'c':
+                    if (conversion.length[0] != 0)
+                    {
+                        return false;
+                    }
+                    payload.push_back(ARGUMENT_SIGNED);
+                    appendValue(payload, static_cast<int64_t>(va_arg(args, int)));
+                    break;
+                case 's':
+                    if (conversion.length[0] != 0)
+                    {
+                        return false;
+                    }
+                    appendString(payload, va_arg(args, const char *), precision);
+                    break;
+                case 'p':
+                    payload.push_back(ARGUMENT_UNSIGNED);
+                    appendValue(payload, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(args, void *))));
+                    break;
+                case 'f':
+                case 'F':
+                case 'e':
+                case 'E':
+                case 'g':
+                case 'G':
+                case 'a':
+                case 'A':
+                    if (lengthIs(conversion, "L"))
+                    {
+                        return false;
+                    }
+                    payload.push_back(ARGUMENT_DOUBLE);
+                    appendValue(payload, va_arg(args, double));
+                    break;
+                default:
+                    // %n and anything unknown can not be replayed later
+                    return false;
+            }
+        }
+    }
+} // namespace
+
+bool BinaryLogFormat::encodeMessage(const char *format, va_list args, string &payload)
+{
+    size_t formatLength = strlen(format);
+    payload.clear();
+    payload.reserve(sizeof(uint32_t) + formatLength + FORMAT_BUFFER_SIZE);
+    appendValue(payload, static_cast<uint32_t>(formatLength));
+    payload.append(format, formatLength);
+
+    // va_list may be an array type, copy it so that it can be handed down by reference
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    bool encoded = encodeArguments(format, formatLength, argsCopy, payload);
+    va_end(argsCopy);
+    return encoded;
+}
+
+bool BinaryLogFormat::formatMessage(const string &payload, string &message)
+{
+    uint32_t formatLength = 0;
+    if (payload.size() < sizeof(formatLength))
+    {
+        return false;
+    }
+    memcpy(&formatLength, payload.data(), sizeof(formatLength));
+    if (payload.size() - sizeof(formatLength) < formatLength)
+    {
+        return false;
+    }
+
+    const char *arguments = payload.data() + sizeof(formatLength) + formatLength;
+    return formatArguments(
+        payload.substr(sizeof(formatLength), formatLength),
+        arguments,
+        payload.size() - sizeof(formatLength) - formatLength,
+        message);
+}
+
+bool BinaryLogFormat::formatArguments(const string &format, const char *arguments, size_t length, string &message)
+{
+    ArgumentCursor cursor(arguments, length);
+    size_t literalBegin = 0;
+    size_t pos = 0;
+    Conversion conversion;
+    string spec;
+    string value;
+    for (;;)
+    {
+        ParseResult result = nextConversion(format.data(), format.size(), pos, conversion);
+        if (result == ParseResult::END)
+        {
+            message.append(format, literalBegin, string::npos);
+            return cursor.atEnd();
+        }
+        if (result == ParseResult::INVALID)
+        {
+            return false;
+        }
+
+        message.append(format, literalBegin, conversion.begin - literalBegin);
+        literalBegin = conversion.end;
+        if (conversion.conversion == '%')
+        {
+            message.push_back('%');
+            continue;
+        }
+
+        int64_t width = 0;
+        int64_t precision = 0;
+        if (conversion.widthFromArgument && !cursor.read(ARGUMENT_SIGNED, width))
+        {
+            return false;
+        }
+        if (conversion.precisionFromArgument && !cursor.read(ARGUMENT_SIGNED, precision))
+        {
+            return false;
+        }
+
+        // Rebuild the conversion specification with a length modifier that matches the decoded value
+        spec.assign(format, conversion.begin, conversion.lengthBegin - conversion.begin);
+        bool ok = true;
+        switch (conversion.conversion)
+        {
+            case 'd':
+            case 'i':
+            {
+                int64_t signedValue = 0;
+                ok = cursor.read(ARGUMENT_SIGNED, signedValue);
+                spec.append("ll").push_back(conversion.conversion);
+                appendConversion(
+                    message, spec, conversion, (int)width, (int)precision, static_cast<long long>(signedValue));
+                break;
+            }
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            {
+                uint64_t unsignedValue = 0;
+                ok = cursor.read(ARGUMENT_UNSIGNED, unsignedValue);
+                spec.append("ll").push_back(conversion.conversion);
+                appendConversion(
+                    message,
+                    spec,
+                    conversion,
+                    (int)width,
+                    (int)precision,
+                    static_cast<unsigned long long>(unsignedValue));
+                break;
+            }
+            case 'c':
+            {
+                int64_t character = 0;
+                ok = cursor.read(ARGUMENT_SIGNED, character);
+                spec.push_back('c');
+                appendConversion(message, spec, conversion, (int)width, (int)precision, static_cast<int>(character));
+                break;
+            }
+            case 's':
+            {
+                ok = cursor.readString(value);
+                spec.push_back('s');
+                appendConversion(message, spec, conversion, (int)width, (int)precision, value.c_str());
+                break;
+            }
+            case 'p':
+            {
+                uint64_t pointer = 0;
+                ok = cursor.read(ARGUMENT_UNSIGNED, pointer);
+                spec.push_back('p');
+                appendConversion(
+                    message,
+                    spec,
+                    conversion,
+                    (int)width,
+                    (int)precision,
+                    reinterpret_cast<void *>(static_cast<uintptr_t>(pointer)));
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                double floatingPoint = 0;
+                ok = cursor.read(ARGUMENT_DOUBLE, floatingPoint);
+                spec.push_back(conversion.conversion);
+                appendConversion(message, spec, conversion, (int)width, (int)precision, floatingPoint);
+                break;
+            }
+            default:
+                ok = false;
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+}
+
+uint32_t BinaryLogFormat::Writer::define(
+    unordered_map<string, uint32_t> &ids,
+    uint8_t recordType,
+    const string &value,
+    string &buffer)
+{
+    auto existing = ids.find(value);
+    if (existing != ids.end())
+    {
+        return existing->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(ids.size());
+    ids.emplace(value, id);
+    buffer.push_back(static_cast<char>(recordType));
+    appendValue(buffer, id);
+    appendValue(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+    return id;
+}
+
+void BinaryLogFormat::Writer::beginSession(string &buffer)
+{
+    formatIds.clear();
+    tagIds.clear();
+    buffer.append(MAGIC, MAGIC_LENGTH);
+    appendValue(buffer, VERSION);
+}
+
+void BinaryLogFormat::Writer::appendMessage(LogMessage &message, string &buffer)
+{
+    static const string EAGER_FORMAT = "%s";
+
+    const string &payload = message.getMessage();
+    uint32_t formatId;
+    const char *arguments;
+    size_t argumentsLength;
+    uint32_t formatLength = 0;
+    if (message.isDeferred() && payload.size() >= sizeof(formatLength))
+    {
+        memcpy(&formatLength, payload.data(), sizeof(formatLength));
+        formatScratch.assign(payload, sizeof(formatLength), formatLength);
+        formatId = define(formatIds, RECORD_FORMAT, formatScratch, buffer);
+        arguments = payload.data() + sizeof(formatLength) + formatScratch.size();
+        argumentsLength = payload.size() - sizeof(formatLength) - formatScratch.size();
+    }
+    else
+    {
+        formatId = define(formatIds, RECORD_FORMAT, EAGER_FORMAT, buffer);
+        arguments = nullptr;
+        argumentsLength = 1 + sizeof(uint32_t) + payload.size();
+    }
+    uint32_t tagId = define(tagIds, RECORD_TAG, message.getTag(), buffer);
+
+    buffer.push_back(static_cast<char>(RECORD_ENTRY));
+    buffer.push_back(static_cast<char>(message.getLevel()));
+    appendValue(
+        buffer,
+        static_cast<int64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(message.getTime().time_since_epoch()).count()));
+    appendValue(buffer, tagId);
+    appendValue(buffer, formatId);
+    appendValue(buffer, static_cast<uint32_t>(argumentsLength));
+    if (arguments != nullptr)
+    {
+        buffer.append(arguments, argumentsLength);
+    }
+    else
+    {
+        buffer.push_back(ARGUMENT_STRING);
+        appendValue(buffer, static_cast<uint32_t>(payload.size()));
+        buffer.append(payload);
+    }
+}
+
+bool BinaryLogFormat::Reader::readSessionHeader()
+{
+    char magic[MAGIC_LENGTH];
+    uint32_t version = 0;
+    if (!input.read(magic, MAGIC_LENGTH) || memcmp(magic, MAGIC, MAGIC_LENGTH) != 0)
+    {
+        error = "Input is not a binary log file";
+        return false;
+    }
+    if (!input.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != VERSION)
+    {
+        error = "Unsupported binary log version " + to_string(version);
+        return false;
+    }
+
+    formats.clear();
+    tags.clear();
+    inSession = true;
+    return true;
+}
+
+bool BinaryLogFormat::Reader::readDefinition(unordered_map<uint32_t, string> &definitions)
+{
+    uint32_t id = 0;
+    uint32_t length = 0;
+    if (!input.read(reinterpret_cast<char *>(&id), sizeof(id)) ||
+        !input.read(reinterpret_cast<char *>(&length), sizeof(length)))
+    {
+        error = "Truncated definition record";
+        return false;
+    }
+
+    string value(length, '\0');
+    if (length > 0 && !input.read(&value[0], length))
+    {
+        error = "Truncated definition record";
+        return false;
+    }
+    definitions[id] = std::move(value);
+    return true;
+}
+
+unique_ptr<LogMessage> BinaryLogFormat::Reader::next()
+{
+    for (;;)
+    {
+        int recordType = input.get();
+        if (recordType == char_traits<char>::eof())
+        {
+            return nullptr;
+        }
+
+        if (recordType == MAGIC[0])
+        {
+            // A new session starts every time the device client reopens the log file
+            input.unget();
+            if (!readSessionHeader())
+            {
+                return nullptr;
+            }
+            continue;
+        }
+        if (!inSession)
+        {
+            error = "Input is not a binary log file";
+            return nullptr;
+        }
+
+        if (recordType == RECORD_FORMAT || recordType == RECORD_TAG)
+        {
+            if (!readDefinition(recordType == RECORD_FORMAT ? formats : tags))
+            {
+                return nullptr;
+            }
+            continue;
+        }
+        if (recordType != RECORD_ENTRY)
+        {
+            error = "Unknown record type " + to_string(recordType);
+            return nullptr;
+        }
+
+        uint8_t level = 0;
+        int64_t nanoseconds = 0;
+        uint32_t tagId = 0;
+        uint32_t formatId = 0;
+        uint32_t length = 0;
+        if (!input.read(reinterpret_cast<char *>(&level), sizeof(level)) ||
+            !input.read(reinterpret_cast<char *>(&nanoseconds), sizeof(nanoseconds)) ||
+            !input.read(reinterpret_cast<char *>(&tagId), sizeof(tagId)) ||
+            !input.read(reinterpret_cast<char *>(&formatId), sizeof(formatId)) ||
+            !input.read(reinterpret_cast<char *>(&length), sizeof(length)))
+        {
+            error = "Truncated log entry record";
+            return nullptr;
+        }
+        arguments.resize(length);
+        if (length > 0 && !input.read(&arguments[0], length))
+        {
+            error = "Truncated log entry record";
+            return nullptr;
+        }
+
+        auto tag = tags.find(tagId);
+        auto format = formats.find(formatId);
+        if (tag == tags.end() || format == formats.end())
+        {
+            error = "Log entry references an undefined tag or format string";
+            return nullptr;
+        }
+
+        string message;
+        if (!formatArguments(format->second, arguments.data(), arguments.size(), message))
+        {
+            error = "Log entry arguments do not match format string \"" + format->second + "\"";
+            return nullptr;
+        }
+
+        chrono::time_point<chrono::system_clock> time(
+            chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(nanoseconds)));
+        return unique_ptr<LogMessage>(
+            new LogMessage(static_cast<LogLevel>(level), tag->second, time, std::move(message), false));
+    }
+}
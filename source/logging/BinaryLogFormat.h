@@ -0,0 +1,166 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BINARYLOGFORMAT_H
+#define DEVICE_CLIENT_BINARYLOGFORMAT_H
+
+#include "LogMessage.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Encoding used by the binary log mode, where printf-style log messages are recorded as their
+                 * format string plus the raw argument values and are only formatted when the log is decoded.
+                 *
+                 * A binary log file is a sequence of sessions. Each session starts with the MAGIC bytes followed by
+                 * the VERSION and is made of records. Format strings and tags are written once per session in a
+                 * definition record and referenced by id from the log entry records. All integers are written in the
+                 * byte order of the device, so a binary log file must be decoded on a machine of the same endianness.
+                 *
+                 *     session    := MAGIC u32:VERSION record*
+                 *     record     := u8:RECORD_FORMAT u32:id u32:length bytes
+                 *                 | u8:RECORD_TAG u32:id u32:length bytes
+                 *                 | u8:RECORD_ENTRY u8:level i64:nanoseconds-since-epoch u32:tag-id u32:format-id
+                 *                   u32:length arguments
+                 *     arguments  := ('i' i64 | 'u' u64 | 'f' f64 | 's' u32:length bytes)*
+                 */
+                namespace BinaryLogFormat
+                {
+                    constexpr char MAGIC[] = "DCBINLOG";
+                    constexpr size_t MAGIC_LENGTH = sizeof(MAGIC) - 1;
+                    constexpr uint32_t VERSION = 1;
+
+                    constexpr uint8_t RECORD_FORMAT = 1;
+                    constexpr uint8_t RECORD_TAG = 2;
+                    constexpr uint8_t RECORD_ENTRY = 3;
+
+                    /**
+                     * \brief Captures the arguments of a printf-style log message without formatting it
+                     *
+                     * The format string and the argument values are copied into the payload, strings included, so
+                     * that the payload stays valid after the caller returns. Formats that can not be captured
+                     * faithfully, such as %n or long double conversions, are rejected and should be formatted
+                     * eagerly instead.
+                     *
+                     * @param format the printf-style format string
+                     * @param args the arguments of the format string, left untouched so that the caller can still
+                     * format them
+                     * @param payload set to the encoded format string and arguments on success
+                     * @return true if the message was encoded, false if the format is not supported
+                     */
+                    bool encodeMessage(const char *format, va_list args, std::string &payload);
+
+                    /**
+                     * \brief Formats a payload produced by encodeMessage() into the text of the log message
+                     *
+                     * @param payload the encoded format string and arguments
+                     * @param message the formatted text is appended to this string
+                     * @return true if the payload was well formed, false otherwise
+                     */
+                    bool formatMessage(const std::string &payload, std::string &message);
+
+                    /**
+                     * \brief Formats a format string against arguments encoded in the binary log format
+                     *
+                     * @param format the printf-style format string
+                     * @param arguments pointer to the encoded arguments
+                     * @param length the number of bytes of encoded arguments
+                     * @param message the formatted text is appended to this string
+                     * @return true if the arguments matched the format string, false otherwise
+                     */
+                    bool formatArguments(
+                        const std::string &format,
+                        const char *arguments,
+                        size_t length,
+                        std::string &message);
+
+                    /**
+                     * \brief Serializes log messages into the records of a binary log session
+                     *
+                     * The writer remembers which format strings and tags have already been defined in the current
+                     * session. It is not thread-safe and is meant to be owned by a single logger thread.
+                     */
+                    class Writer
+                    {
+                      private:
+                        std::unordered_map<std::string, uint32_t> formatIds;
+                        std::unordered_map<std::string, uint32_t> tagIds;
+                        std::string formatScratch;
+
+                        uint32_t define(
+                            std::unordered_map<std::string, uint32_t> &ids,
+                            uint8_t recordType,
+                            const std::string &value,
+                            std::string &buffer);
+
+                      public:
+                        /**
+                         * \brief Starts a new session, forgetting all previously defined format strings and tags
+                         *
+                         * @param buffer the session header is appended to this buffer
+                         */
+                        void beginSession(std::string &buffer);
+
+                        /**
+                         * \brief Appends the records needed to represent the message to the buffer
+                         *
+                         * Messages that were formatted eagerly are recorded with a "%s" format string so that every
+                         * message in the queue can be written in the binary log format.
+                         *
+                         * @param message the message to record
+                         * @param buffer the records are appended to this buffer
+                         */
+                        void appendMessage(LogMessage &message, std::string &buffer);
+                    };
+
+                    /**
+                     * \brief Reads the log messages of a binary log file back
+                     */
+                    class Reader
+                    {
+                      private:
+                        std::istream &input;
+                        std::unordered_map<uint32_t, std::string> formats;
+                        std::unordered_map<uint32_t, std::string> tags;
+                        std::string arguments;
+                        std::string error;
+                        bool inSession = false;
+
+                        bool readSessionHeader();
+                        bool readDefinition(std::unordered_map<uint32_t, std::string> &definitions);
+
+                      public:
+                        explicit Reader(std::istream &input) : input(input) {}
+
+                        /**
+                         * \brief Reads and formats the next log message
+                         *
+                         * @return the next log message, or nullptr at the end of the input or on error
+                         */
+                        std::unique_ptr<LogMessage> next();
+
+                        /**
+                         * \brief Returns a description of the error that stopped the reader, empty if there is none
+                         */
+                        const std::string &getError() const { return error; }
+                    };
+                } // namespace BinaryLogFormat
+            } // namespace Logging
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BINARYLOGFORMAT_H
@@ -4,19 +4,30 @@
 #include "FileLogger.h"
 #include "../util/FileUtils.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
 #include <iostream>
 #include <sys/stat.h> /* mkdir(2) */
 #include <thread>
-
-constexpr int TIMESTAMP_BUFFER_SIZE = 25;
+#include <unistd.h>
+#include <vector>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 using namespace Aws::Iot::DeviceClient::Util;
 
-constexpr int FileLogger::DEFAULT_WAIT_TIME_MILLISECONDS;
+constexpr size_t FileLogger::MAX_BATCH_BYTES;
 constexpr char FileLogger::DEFAULT_LOG_FILE[];
 
+FileLogger::~FileLogger()
+{
+    if (outputFd >= 0)
+    {
+        close(outputFd);
+    }
+}
+
 bool FileLogger::start(const PlainConfig &config)
 {
     setLogLevel(config.logConfig.deviceClientlogLevel);
@@ -24,6 +35,11 @@ bool FileLogger::start(const PlainConfig &config)
     {
         logFile = config.logConfig.deviceClientLogFile;
     }
+    binaryFormat = config.logConfig.binaryFormat;
+    configureQueue(logQueue, config.logConfig);
+    rateLimiter.configure(config.logConfig.rateLimitPerSecond, config.logConfig.rateLimitBurst);
+    flushIntervalMs = config.logConfig.flushIntervalMs;
+    flushThresholdBytes = static_cast<size_t>(config.logConfig.flushThresholdBytes);
 
     struct stat info;
     string logFileDir = FileUtils::ExtractParentDirectory(logFile);
@@ -67,21 +83,23 @@ bool FileLogger::start(const PlainConfig &config)
         }
     }
 
-    outputStream = unique_ptr<ofstream>(new ofstream(logFile, std::fstream::app));
-    if (!outputStream->fail())
+    if (outputFd >= 0)
+    {
+        close(outputFd);
+    }
+    outputFd = openLogFile();
+    if (outputFd >= 0)
     {
-        if (Permissions::LOG_FILE != FileUtils::GetFilePermissions(logFile))
         {
-            chmod(logFile.c_str(), S_IRUSR | S_IWUSR);
-            if (Permissions::LOG_FILE != FileUtils::GetFilePermissions(logFile))
-            {
-                cout << LOGGER_TAG
-                     << FormatMessage(
-                            "Failed to set appropriate permissions for log file %s, permissions should be set to %d",
-                            logFile.c_str(),
-                            Permissions::LOG_FILE);
-            }
+            lock_guard<mutex> batchGuard(batchLock);
+            beginLogFile();
         }
+        rotator.start(logFile, config.logConfig);
+
+        // Mark the logger as running before the thread starts so that an early shutdown still flushes the queue
+        unique_lock<mutex> runLock(isRunningLock);
+        isRunning = true;
+        runLock.unlock();
 
         thread log_thread(&FileLogger::run, this);
         log_thread.detach();
@@ -92,34 +110,206 @@ bool FileLogger::start(const PlainConfig &config)
     return false;
 }
 
-void FileLogger::writeLogMessage(unique_ptr<LogMessage> message) const
+int FileLogger::openLogFile() const
 {
-    char time_buffer[TIMESTAMP_BUFFER_SIZE];
-    LogUtil::generateTimestamp(message->getTime(), TIMESTAMP_BUFFER_SIZE, time_buffer);
+    int fd = open(logFile.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd >= 0 && Permissions::LOG_FILE != FileUtils::GetFilePermissions(logFile))
+    {
+        chmod(logFile.c_str(), S_IRUSR | S_IWUSR);
+        if (Permissions::LOG_FILE != FileUtils::GetFilePermissions(logFile))
+        {
+            cout << LOGGER_TAG
+                 << FormatMessage(
+                        "Failed to set appropriate permissions for log file %s, permissions should be set to %d",
+                        logFile.c_str(),
+                        Permissions::LOG_FILE);
+        }
+    }
+    return fd;
+}
+
+void FileLogger::beginLogFile()
+{
+    struct stat info;
+    fileSize = fstat(outputFd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    fileOpenedAt = chrono::steady_clock::now();
+    bytesSinceSync = 0;
+    lastSync = fileOpenedAt;
 
-    *outputStream << time_buffer << " " << LogLevelMarshaller::ToString(message->getLevel()) << " {"
-                  << message->getTag() << "}: " << message->getMessage() << endl;
-    outputStream->flush();
+    if (binaryFormat)
+    {
+        // Every time the log file is opened a new session starts, with its own format string and tag definitions
+        string header;
+        binaryWriter.beginSession(header);
+        if (writeBatch(header))
+        {
+            fileSize += header.size();
+        }
+    }
 }
 
-void FileLogger::run()
+void FileLogger::rotateIfNeeded()
 {
-    unique_lock<mutex> runLock(isRunningLock);
-    isRunning = true;
-    runLock.unlock();
+    if (!rotator.isEnabled() || !rotator.shouldRotate(fileSize, fileOpenedAt))
+    {
+        return;
+    }
+
+    string rotatedFile = rotator.nextRotatedFile(chrono::system_clock::now());
+    if (rename(logFile.c_str(), rotatedFile.c_str()) != 0)
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to rotate %s, errno: %d", logFile.c_str(), errno) << endl;
+        // Keep writing to the current file and only try again once another full size or age limit is reached
+        fileSize = 0;
+        fileOpenedAt = chrono::steady_clock::now();
+        return;
+    }
+
+    int rotatedFd = outputFd;
+    if (flushIntervalMs > 0 || flushThresholdBytes > 0)
+    {
+        fsync(rotatedFd);
+    }
+    outputFd = openLogFile();
+    if (outputFd < 0)
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to open %s after rotating it", logFile.c_str()) << endl;
+        // The file descriptor still refers to the rotated file, which is better than losing log output
+        outputFd = rotatedFd;
+        fileSize = 0;
+        fileOpenedAt = chrono::steady_clock::now();
+        return;
+    }
+    close(rotatedFd);
+
+    beginLogFile();
+    rotator.notifyRotated();
+}
+
+bool FileLogger::writeBatch(const string &batch) const
+{
+    if (!LogUtil::writeFully(outputFd, batch.data(), batch.size()))
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to write to %s, errno: %d", logFile.c_str(), errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+void FileLogger::syncIfNeeded()
+{
+    if (bytesSinceSync == 0)
+    {
+        return;
+    }
+
+    bool thresholdReached = flushThresholdBytes > 0 && bytesSinceSync >= flushThresholdBytes;
+    bool intervalElapsed = flushIntervalMs > 0 &&
+                           chrono::steady_clock::now() - lastSync >= chrono::milliseconds(flushIntervalMs);
+    if (thresholdReached || intervalElapsed)
+    {
+        fsync(outputFd);
+        bytesSinceSync = 0;
+        lastSync = chrono::steady_clock::now();
+    }
+}
+
+chrono::milliseconds FileLogger::nextWakeup() const
+{
+    // Wake up at least as often as suppression windows are checked, so that reports do not wait for a new message.
+    chrono::milliseconds wait(SUPPRESSION_REPORT_INTERVAL_MS);
+    if (flushIntervalMs > 0 && bytesSinceSync > 0)
+    {
+        auto untilSync = chrono::duration_cast<chrono::milliseconds>(
+            lastSync + chrono::milliseconds(flushIntervalMs) - chrono::steady_clock::now());
+        wait = max(chrono::milliseconds(0), min(wait, untilSync));
+    }
+    return wait;
+}
+
+void FileLogger::appendMessage(LogMessage &message, string &batch)
+{
+    if (binaryFormat)
+    {
+        binaryWriter.appendMessage(message, batch);
+    }
+    else
+    {
+        LogUtil::appendLogLine(message, batch, timestampFormatter);
+    }
+}
 
+void FileLogger::vlog(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> t,
+    const char *message,
+    va_list args)
+{
+    if (binaryFormat)
+    {
+        string payload;
+        if (BinaryLogFormat::encodeMessage(message, args, payload))
+        {
+            logQueue->addLog(unique_ptr<LogMessage>(new LogMessage(level, tag, t, std::move(payload), true)));
+            return;
+        }
+    }
+    Logger::vlog(level, tag, t, message, args);
+}
+
+void FileLogger::run()
+{
+    vector<unique_ptr<LogMessage>> suppressionReports;
     while (!needsShutdown)
     {
-        unique_ptr<LogMessage> message = logQueue->getNextLog();
+        // Block until at least one message is available or periodic work is due, then take everything else that is
+        // already queued so that a burst of messages costs a single write. The batch lock keeps flush() from writing
+        // newer messages ahead of a batch that is still being written.
+        lock_guard<mutex> batchGuard(batchLock);
+        unique_ptr<LogMessage> message = logQueue->getNextLog(nextWakeup());
+        batchBuffer.clear();
+        unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, false);
+        if (nullptr != dropReport)
+        {
+            appendMessage(*dropReport, batchBuffer);
+        }
+        takeSuppressionReports(suppressionReports, false);
+        for (auto &report : suppressionReports)
+        {
+            appendMessage(*report, batchBuffer);
+        }
+        suppressionReports.clear();
+        while (nullptr != message)
+        {
+            appendMessage(*message, batchBuffer);
+            if (batchBuffer.size() >= MAX_BATCH_BYTES || !logQueue->hasNextLog())
+            {
+                break;
+            }
+            message = logQueue->getNextLog();
+        }
 
-        if (nullptr != message)
+        if (!batchBuffer.empty() && writeBatch(batchBuffer))
         {
-            writeLogMessage(std::move(message));
+            bytesSinceSync += batchBuffer.size();
+            fileSize += batchBuffer.size();
         }
-        this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_WAIT_TIME_MILLISECONDS));
+        syncIfNeeded();
+        rotateIfNeeded();
     }
 }
 
+uint64_t FileLogger::getDroppedCount() const
+{
+    return logQueue->getDroppedCount();
+}
+
+uint64_t FileLogger::getDroppedCount(LogLevel level) const
+{
+    return logQueue->getDroppedCount(level);
+}
+
 void FileLogger::queueLog(
     LogLevel level,
     const char *tag,
@@ -133,6 +323,7 @@ void FileLogger::stop()
 {
     needsShutdown = true;
     logQueue->shutdown();
+    rotator.stop();
 
     unique_lock<mutex> runLock(isRunningLock);
     isRunning = false;
@@ -157,6 +348,7 @@ void FileLogger::shutdown()
 
     // If we've gotten here, we must be shutting down so we should dump the remaining messages and exit
     flush();
+    rotator.stop();
 
     unique_lock<mutex> runLock(isRunningLock);
     isRunning = false;
@@ -171,12 +363,43 @@ void FileLogger::flush()
     }
     runLock.unlock();
 
+    lock_guard<mutex> batchGuard(batchLock);
+    string buffer;
     while (logQueue->hasNextLog())
     {
         unique_ptr<LogMessage> message = logQueue->getNextLog();
         if (nullptr != message)
         {
-            writeLogMessage(std::move(message));
+            appendMessage(*message, buffer);
         }
+        if (buffer.size() >= MAX_BATCH_BYTES)
+        {
+            if (writeBatch(buffer))
+            {
+                fileSize += buffer.size();
+            }
+            buffer.clear();
+        }
+    }
+
+    unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, true);
+    if (nullptr != dropReport)
+    {
+        appendMessage(*dropReport, buffer);
+    }
+    vector<unique_ptr<LogMessage>> suppressionReports;
+    takeSuppressionReports(suppressionReports, true);
+    for (auto &report : suppressionReports)
+    {
+        appendMessage(*report, buffer);
+    }
+
+    if (!buffer.empty() && writeBatch(buffer))
+    {
+        fileSize += buffer.size();
     }
-}
\ No newline at end of file
+    if (flushIntervalMs > 0 || flushThresholdBytes > 0)
+    {
+        fsync(outputFd);
+    }
+}
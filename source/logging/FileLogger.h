@@ -4,13 +4,16 @@
 #ifndef DEVICE_CLIENT_FILELOGGER_H
 #define DEVICE_CLIENT_FILELOGGER_H
 
-#include <fstream>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <stdio.h>
 
+#include "BinaryLogFormat.h"
 #include "LogLevel.h"
 #include "LogQueue.h"
+#include "LogRotator.h"
 #include "Logger.h"
 
 namespace Aws
@@ -33,10 +36,9 @@ namespace Aws
                     std::string logFile = DEFAULT_LOG_FILE;
 
                     /**
-                     * \brief The default value in milliseconds for which Device client will wait after getting a
-                     * log message from logQueue
+                     * \brief The maximum number of bytes of formatted log output gathered into a single write
                      */
-                    static constexpr int DEFAULT_WAIT_TIME_MILLISECONDS = 1;
+                    static constexpr size_t MAX_BATCH_BYTES = 64 * 1024;
 
                     /**
                      * \brief Flag used to notify underlying threads that they should discontinue any processing
@@ -52,17 +54,118 @@ namespace Aws
                     std::unique_ptr<LogQueue> logQueue = std::unique_ptr<LogQueue>(new LogQueue);
 
                     /**
-                     * \brief an std::ofstream representing an underlying file that is used to write log output to disk
+                     * \brief File descriptor of the underlying file that is used to write log output to disk
                      */
-                    std::unique_ptr<std::ofstream> outputStream;
+                    int outputFd = -1;
 
                     /**
-                     * \brief Write the log message to the log file
+                     * \brief Held while a batch of log messages is taken from the LogQueue and written out
+                     */
+                    std::mutex batchLock;
+                    /**
+                     * \brief Buffer reused by the logger thread to format each batch of log messages
+                     */
+                    std::string batchBuffer;
+                    /**
+                     * \brief Formats the timestamps of log lines, only used while holding batchLock
+                     */
+                    LogUtil::TimestampFormatter timestampFormatter;
+
+                    /**
+                     * \brief Interval in milliseconds after which written log output is synced to disk, 0 to disable
+                     */
+                    int flushIntervalMs = 0;
+
+                    /**
+                     * \brief Number of written bytes after which log output is synced to disk, 0 to disable
+                     */
+                    size_t flushThresholdBytes = 0;
+
+                    /**
+                     * \brief Whether log messages are written in the binary log format rather than as text
                      *
-                     * This method will write the log message to the file specified for logging
-                     * @param message the message to log
+                     * Read by every thread that logs, since formatting is skipped on the calling thread in binary mode.
                      */
-                    void writeLogMessage(std::unique_ptr<LogMessage> message) const;
+                    std::atomic<bool> binaryFormat{false};
+
+                    /**
+                     * \brief Serializes log messages when writing in the binary log format
+                     */
+                    BinaryLogFormat::Writer binaryWriter;
+
+                    /**
+                     * \brief Number of bytes written by the logger thread since the log file was last synced
+                     */
+                    size_t bytesSinceSync = 0;
+
+                    /**
+                     * \brief The time at which the logger thread last synced the log file
+                     */
+                    std::chrono::steady_clock::time_point lastSync;
+
+                    /**
+                     * \brief Size in bytes of the log file, kept up to date by the logger thread
+                     */
+                    std::size_t fileSize = 0;
+
+                    /**
+                     * \brief The time at which the log file was opened
+                     */
+                    std::chrono::steady_clock::time_point fileOpenedAt;
+
+                    /**
+                     * \brief Decides when the log file is rotated and maintains the rotated log files
+                     */
+                    LogRotator rotator;
+
+                    /**
+                     * \brief Open the log file for appending and make sure it has the expected permissions
+                     *
+                     * @return the file descriptor of the log file, or -1 if it could not be opened
+                     */
+                    int openLogFile() const;
+
+                    /**
+                     * \brief Reset the state kept about the log file after it has been opened, and start a new session
+                     * when writing in the binary log format. Must be called while holding batchLock.
+                     */
+                    void beginLogFile();
+
+                    /**
+                     * \brief Rotate the log file if it has reached the configured size or age
+                     *
+                     * The log file is renamed and a new one is opened in its place, which is all the logger thread
+                     * does. Compressing and pruning rotated log files is left to the LogRotator background thread.
+                     * Must be called while holding batchLock.
+                     */
+                    void rotateIfNeeded();
+
+                    /**
+                     * \brief Write a batch of formatted log output to the log file with a single write
+                     *
+                     * @param batch the formatted log lines to write
+                     * @return true if the batch was written, false otherwise
+                     */
+                    bool writeBatch(const std::string &batch) const;
+
+                    /**
+                     * \brief Sync the log file to disk if either the flush interval or the flush threshold is reached
+                     */
+                    void syncIfNeeded();
+
+                    /**
+                     * \brief Time the logger thread may wait for a message before the log file must be synced or
+                     * reports checked
+                     */
+                    std::chrono::milliseconds nextWakeup() const;
+
+                    /**
+                     * \brief Append a log message to a batch in either the text or the binary log format
+                     *
+                     * @param message the message to append
+                     * @param batch the batch to append the message to
+                     */
+                    void appendMessage(LogMessage &message, std::string &batch);
 
                     /**
                      * \brief Creates the directories required as part of the full path to the desired log file
@@ -75,10 +178,10 @@ namespace Aws
                     /**
                      * \brief Begins processing of log messages in the LogQueue
                      *
-                     * This method will begin processing of log messages in the LogQueue. The thread will process until
-                     * all of the messages are removed from the queue, and then will wait until new messages arrive in
-                     * the queue. This method will check to make sure the shutdown() method has not been called before
-                     * processing any additional messages in the queue.
+                     * This method will begin processing of log messages in the LogQueue. Every message available in
+                     * the queue is formatted into a single batch that is written to the log file at once, and then the
+                     * thread will wait until new messages arrive in the queue. This method will check to make sure the
+                     * shutdown() method has not been called before processing any additional messages in the queue.
                      */
                     void run();
 
@@ -89,6 +192,17 @@ namespace Aws
                         const std::string &message) override;
 
                   public:
+                    /**
+                     * \brief Queues the log message with its formatting deferred to the logger thread or to the binary
+                     * log decoder when the binary log format is enabled, otherwise formats it on the calling thread
+                     */
+                    virtual void vlog(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> t,
+                        const char *message,
+                        va_list args) override;
+
                     /**
                      * \brief The full path to the default log file for the Device Client
                      *
@@ -98,6 +212,8 @@ namespace Aws
                     static constexpr char DEFAULT_LOG_FILE[] =
                         "/var/log/aws-iot-device-client/aws-iot-device-client.log";
 
+                    ~FileLogger() override;
+
                     virtual bool start(const PlainConfig &config) override;
 
                     virtual void stop() override;
@@ -109,6 +225,10 @@ namespace Aws
                     virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
 
                     virtual void flush() override;
+
+                    virtual std::uint64_t getDroppedCount() const override;
+
+                    virtual std::uint64_t getDroppedCount(LogLevel level) const override;
                 };
             } // namespace Logging
         } // namespace DeviceClient
@@ -9,6 +9,8 @@
 #include <chrono>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <utility>
 
 namespace Aws
 {
@@ -39,9 +41,13 @@ namespace Aws
                      */
                     std::chrono::time_point<std::chrono::system_clock> time;
                     /**
-                     * \brief The message to be logged
+                     * \brief The message to be logged, or its encoded format string and arguments if deferred
                      */
                     std::string message;
+                    /**
+                     * \brief Whether formatting of the message has been deferred, see BinaryLogFormat::encodeMessage
+                     */
+                    bool deferred = false;
 
                   public:
                     LogMessage(
@@ -52,6 +58,20 @@ namespace Aws
                         : level(level), tag(tag), time(time), message(message)
                     {
                     }
+                    /**
+                     * \brief Creates a message whose formatting is deferred until it is written out
+                     *
+                     * @param payload the format string and arguments encoded by BinaryLogFormat::encodeMessage
+                     */
+                    LogMessage(
+                        LogLevel level,
+                        const std::string &tag,
+                        std::chrono::time_point<std::chrono::system_clock> time,
+                        std::string &&payload,
+                        bool deferred)
+                        : level(level), tag(tag), time(time), message(std::move(payload)), deferred(deferred)
+                    {
+                    }
                     ~LogMessage() = default;
 
                     /**
@@ -63,7 +83,7 @@ namespace Aws
                      * \brief Returns the message tag
                      * @return the message tag
                      */
-                    std::string getTag() const { return tag; }
+                    const std::string &getTag() const { return tag; }
                     /**
                      * \brief Returns the time that the message was generated
                      * @return the time that the message was generated
@@ -71,9 +91,14 @@ namespace Aws
                     std::chrono::time_point<std::chrono::system_clock> getTime() const { return time; }
                     /**
                      * \brief Returns the log message
-                     * @return the log message
+                     * @return the log message, or the encoded format string and arguments if formatting is deferred
                      */
                     std::string &getMessage() { return message; }
+                    /**
+                     * \brief Returns whether formatting of the message has been deferred
+                     * @return true if getMessage() returns an encoded payload rather than text
+                     */
+                    bool isDeferred() const { return deferred; }
                 };
             } // namespace Logging
         } // namespace DeviceClient
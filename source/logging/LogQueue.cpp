@@ -2,60 +2,273 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "LogQueue.h"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <thread>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 
+constexpr size_t LogQueue::CACHE_LINE_SIZE;
 constexpr int LogQueue::EMPTY_WAIT_TIME_MILLISECONDS;
+constexpr size_t LogQueue::DEFAULT_CAPACITY;
+
+namespace
+{
+    size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+} // namespace
+
+LogQueue::LogQueue(size_t capacity, OverflowPolicy overflowPolicy)
+    : mask(roundUpToPowerOfTwo(capacity) - 1), slots(new Slot[roundUpToPowerOfTwo(capacity)]),
+      overflowPolicy(overflowPolicy)
+{
+    for (size_t i = 0; i <= mask; i++)
+    {
+        slots[i].sequence.store(i, memory_order_relaxed);
+    }
+    for (auto &dropped : droppedByLevel)
+    {
+        dropped.store(0, memory_order_relaxed);
+    }
+}
+
+LogQueue::~LogQueue()
+{
+    LogMessage *log = nullptr;
+    while (tryDequeue(log))
+    {
+        delete log;
+    }
+}
+
+bool LogQueue::tryEnqueue(LogMessage *log)
+{
+    size_t pos = enqueuePos.load(memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[pos & mask];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            // The slot is free, try to claim it before another producer does.
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+            {
+                slot.message = log;
+                // Sequentially consistent so that it is ordered before the check of waitingConsumers in addLog().
+                slot.sequence.store(pos + 1, memory_order_seq_cst);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The slot still holds a message from the previous lap, the queue is full.
+            return false;
+        }
+        else
+        {
+            // Another producer claimed this position first.
+            pos = enqueuePos.load(memory_order_relaxed);
+        }
+    }
+}
+
+bool LogQueue::tryDequeue(LogMessage *&log)
+{
+    size_t pos = dequeuePos.load(memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[pos & mask];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            // The slot holds a published message. Consumers compete here when shutdown() flushes the queue from
+            // another thread while the logger thread is still running.
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+            {
+                log = slot.message;
+                slot.message = nullptr;
+                // Hand the slot back to producers for the next lap around the ring.
+                slot.sequence.store(pos + mask + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Nothing has been published at this position yet, the queue is empty.
+            return false;
+        }
+        else
+        {
+            pos = dequeuePos.load(memory_order_relaxed);
+        }
+    }
+}
+
+bool LogQueue::hasPublishedLog() const
+{
+    size_t pos = dequeuePos.load(memory_order_relaxed);
+    return slots[pos & mask].sequence.load(memory_order_seq_cst) == pos + 1;
+}
+
+size_t LogQueue::approximateSize() const
+{
+    // Load the consumer position first, the producer position can only have moved further ahead since
+    size_t dequeued = dequeuePos.load(memory_order_relaxed);
+    size_t enqueued = enqueuePos.load(memory_order_relaxed);
+    return enqueued - dequeued;
+}
+
+void LogQueue::drop(LogMessage *log)
+{
+    if (nullptr == log)
+    {
+        // An empty message carries nothing worth reporting
+        return;
+    }
+    size_t level = static_cast<size_t>(log->getLevel());
+    if (level < sizeof(droppedByLevel) / sizeof(droppedByLevel[0]))
+    {
+        droppedByLevel[level].fetch_add(1, memory_order_relaxed);
+    }
+    unreportedDrops.fetch_add(1, memory_order_relaxed);
+    delete log;
+}
 
 void LogQueue::addLog(unique_ptr<LogMessage> log)
 {
-    unique_lock<mutex> addLock(queueLock);
-    logQueue.push_back(std::move(log));
-    addLock.unlock();
-    newLogNotifier.notify_one();
+    LogMessage *message = log.release();
+    if (overflowPolicy == OverflowPolicy::DROP_BELOW_LEVEL && nullptr != message &&
+        message->getLevel() > LogLevel::WARN && approximateSize() >= capacity() - capacity() / 4)
+    {
+        // Keep the last quarter of the queue for WARN and ERROR messages
+        drop(message);
+        return;
+    }
+
+    // Other producers may refill the slot freed by evicting the oldest message, so only try a few times.
+    constexpr int MAX_EVICTIONS = 4;
+    int evictions = 0;
+    while (!tryEnqueue(message))
+    {
+        LogMessage *oldest = nullptr;
+        if (overflowPolicy != OverflowPolicy::DROP_OLDEST || evictions++ == MAX_EVICTIONS)
+        {
+            drop(message);
+            return;
+        }
+        if (tryDequeue(oldest))
+        {
+            drop(oldest);
+        }
+    }
+
+    // Either the consumer sees the new message before going to sleep, or we see that it is waiting and wake it up.
+    if (waitingConsumers.load() > 0)
+    {
+        lock_guard<mutex> notifyLock(waitLock);
+        newLogNotifier.notify_all();
+    }
 }
 
 bool LogQueue::hasNextLog()
 {
-    unique_lock<mutex> readLock(queueLock);
-    return !logQueue.empty();
+    return interruptPending || hasPublishedLog();
 }
 
 std::unique_ptr<LogMessage> LogQueue::getNextLog()
 {
-    unique_lock<mutex> readLock(queueLock);
+    return waitForNextLog(nullptr);
+}
 
-    while (logQueue.empty() && !isShutdown)
-    {
-        newLogNotifier.wait_for(readLock, chrono::milliseconds(EMPTY_WAIT_TIME_MILLISECONDS));
-    }
+std::unique_ptr<LogMessage> LogQueue::getNextLog(chrono::milliseconds timeout)
+{
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + timeout;
+    return waitForNextLog(&deadline);
+}
 
-    if (logQueue.empty())
+std::unique_ptr<LogMessage> LogQueue::waitForNextLog(const chrono::steady_clock::time_point *deadline)
+{
+    LogMessage *message = nullptr;
+    for (;;)
     {
-        return nullptr;
+        if (interruptPending.exchange(false))
+        {
+            return nullptr;
+        }
+
+        if (tryDequeue(message))
+        {
+            return unique_ptr<LogMessage>(message);
+        }
+
+        if (isShutdown)
+        {
+            return nullptr;
+        }
+
+        chrono::milliseconds wait(EMPTY_WAIT_TIME_MILLISECONDS);
+        if (deadline != nullptr)
+        {
+            auto remaining = chrono::duration_cast<chrono::milliseconds>(*deadline - chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+            {
+                return nullptr;
+            }
+            wait = min(wait, remaining);
+        }
+
+        unique_lock<mutex> readLock(waitLock);
+        waitingConsumers.fetch_add(1);
+        if (!hasPublishedLog() && !isShutdown && !interruptPending)
+        {
+            newLogNotifier.wait_for(readLock, wait);
+        }
+        waitingConsumers.fetch_sub(1);
     }
-    else
+}
+
+uint64_t LogQueue::getDroppedCount() const
+{
+    uint64_t total = 0;
+    for (const auto &dropped : droppedByLevel)
     {
-        unique_ptr<LogMessage> message = std::move(logQueue.front());
-        logQueue.pop_front();
-        return message;
+        total += dropped.load(memory_order_relaxed);
     }
+    return total;
+}
+
+uint64_t LogQueue::getDroppedCount(LogLevel level) const
+{
+    size_t index = static_cast<size_t>(level);
+    return index < sizeof(droppedByLevel) / sizeof(droppedByLevel[0])
+               ? droppedByLevel[index].load(memory_order_relaxed)
+               : 0;
+}
+
+uint64_t LogQueue::takeUnreportedDropCount()
+{
+    return unreportedDrops.exchange(0, memory_order_relaxed);
 }
 
 void LogQueue::shutdown()
 {
-    // Grab the lock in case there's active logging while we attempt to shutdown
-    unique_lock<mutex> shutdownLock(queueLock);
-    // We need to prepend the queue with a null message so that any waiting threads are interrupted and do not process
-    // any of the log messages.
-    logQueue.push_front(nullptr);
+    // Interrupt the next read so that any waiting threads do not process any of the log messages.
+    interruptPending = true;
 
     isShutdown = true;
 
     // Force getNextEvent() to stop blocking regardless of whether there's actually a new event
     // so that we can safely shutdown
-    newLogNotifier.notify_one();
+    lock_guard<mutex> shutdownLock(waitLock);
+    newLogNotifier.notify_all();
 }
@@ -6,8 +6,11 @@
 
 #include "LogMessage.h"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 
 namespace Aws
@@ -21,37 +24,184 @@ namespace Aws
                 /**
                  * \brief A thread-safe queue used by our Logger implementations to queue incoming messages
                  * from multiple threads and process them in order
+                 *
+                 * The queue is a bounded ring buffer of preallocated slots. Each slot carries a sequence number that
+                 * tells producers and consumers whether the slot is free or holds a published message, so that
+                 * neither side needs to take a lock to add or remove a message. The consumer only falls back to a
+                 * condition variable when the queue is empty, and producers only touch the mutex when they know a
+                 * consumer is sleeping.
+                 *
+                 * Producers never block. When the queue is full, messages are dropped according to the overflow
+                 * policy and counted so that the logger can report them.
                  */
                 class LogQueue
                 {
+                  public:
+                    /**
+                     * \brief What to drop when a message is added to a full queue
+                     */
+                    enum class OverflowPolicy
+                    {
+                        /** Drop the message being added **/
+                        DROP_NEWEST,
+                        /** Drop the oldest message in the queue to make room for the message being added **/
+                        DROP_OLDEST,
+                        /**
+                         * Drop INFO and DEBUG messages once the queue is three quarters full, keeping the rest of
+                         * the queue for WARN and ERROR messages, which are only dropped when the queue is full
+                         **/
+                        DROP_BELOW_LEVEL
+                    };
+
                   private:
                     /**
-                     * \brief Whether the LogQueue has been shutdown or not.
+                     * \brief Size in bytes used to keep the producer and consumer positions on separate cache lines
                      */
-                    std::atomic<bool> isShutdown{false};
+                    static constexpr std::size_t CACHE_LINE_SIZE = 64;
                     /**
                      * \brief The default value in milliseconds for which Device client will wait after blocking when
                      * the queue is empty.
                      */
                     static constexpr int EMPTY_WAIT_TIME_MILLISECONDS = 200;
+
+                    /**
+                     * \brief A single preallocated entry of the ring buffer
+                     */
+                    struct Slot
+                    {
+                        /**
+                         * \brief Equal to the enqueue position when the slot is free and to the enqueue position + 1
+                         * once a message has been published into it
+                         */
+                        std::atomic<std::size_t> sequence{0};
+                        /**
+                         * \brief The message owned by the slot while it is published
+                         */
+                        LogMessage *message{nullptr};
+                    };
+
+                    /**
+                     * \brief Index mask applied to the positions, the capacity is always a power of two
+                     */
+                    const std::size_t mask;
+                    /**
+                     * \brief The preallocated slots of the ring buffer
+                     */
+                    std::unique_ptr<Slot[]> slots;
+
+                    char padding0[CACHE_LINE_SIZE];
+                    /**
+                     * \brief Next position to be claimed by a producer
+                     */
+                    std::atomic<std::size_t> enqueuePos{0};
+                    char padding1[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+                    /**
+                     * \brief Next position to be claimed by a consumer
+                     */
+                    std::atomic<std::size_t> dequeuePos{0};
+                    char padding2[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+
+                    /**
+                     * \brief Whether the LogQueue has been shutdown or not.
+                     */
+                    std::atomic<bool> isShutdown{false};
                     /**
-                     * \brief a Mutex used to control multi-threaded access to the LogQueue
+                     * \brief Set by shutdown() so that the next call to getNextLog() returns immediately without a
+                     * message, interrupting the consumer before it processes anything else
                      */
-                    std::mutex queueLock;
+                    std::atomic<bool> interruptPending{false};
+                    /**
+                     * \brief Number of consumers currently blocked waiting for a new message
+                     */
+                    std::atomic<int> waitingConsumers{0};
+                    /**
+                     * \brief a Mutex used together with newLogNotifier to put an idle consumer to sleep
+                     */
+                    std::mutex waitLock;
                     /**
                      * \brief Used to wake up waiting threads when new data arrives, or when
                      * the LogQueue has shut down
                      */
                     std::condition_variable newLogNotifier;
+
                     /**
-                     * \brief Responsible for queuing the LogMessages upon arrival for processing
+                     * \brief The overflow policy applied when the queue is full
                      */
-                    std::deque<std::unique_ptr<LogMessage>> logQueue;
+                    const OverflowPolicy overflowPolicy;
+                    /**
+                     * \brief Number of messages dropped since the queue was created, by log level
+                     */
+                    std::atomic<std::uint64_t> droppedByLevel[(int)LogLevel::DEBUG + 1];
+                    /**
+                     * \brief Number of messages dropped since the last call to takeUnreportedDropCount()
+                     */
+                    std::atomic<std::uint64_t> unreportedDrops{0};
+
+                    /**
+                     * \brief Attempt to publish a message into the next free slot
+                     *
+                     * @param log the message to publish, ownership is only taken on success
+                     * @return true if the message was published, false if the queue is full
+                     */
+                    bool tryEnqueue(LogMessage *log);
+
+                    /**
+                     * \brief Attempt to take the oldest published message
+                     *
+                     * @param log set to the message on success
+                     * @return true if a message was taken, false if the queue is empty
+                     */
+                    bool tryDequeue(LogMessage *&log);
+
+                    /**
+                     * \brief Determine whether the slot at the head of the queue holds a published message
+                     */
+                    bool hasPublishedLog() const;
+
+                    /**
+                     * \brief Wait for the next log message, until deadline when one is given
+                     */
+                    std::unique_ptr<LogMessage> waitForNextLog(const std::chrono::steady_clock::time_point *deadline);
+
+                    /**
+                     * \brief Returns the number of messages currently in the queue, which may be slightly off while
+                     * other threads add or remove messages
+                     */
+                    std::size_t approximateSize() const;
+
+                    /**
+                     * \brief Delete a message that could not be queued and count it as dropped
+                     */
+                    void drop(LogMessage *log);
 
                   public:
+                    /**
+                     * \brief The default number of slots in the LogQueue
+                     */
+                    static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+                    /**
+                     * \brief Creates a LogQueue
+                     *
+                     * @param capacity the number of preallocated slots, rounded up to the next power of two
+                     * @param overflowPolicy what to drop when a message is added to a full queue
+                     */
+                    explicit LogQueue(
+                        std::size_t capacity = DEFAULT_CAPACITY,
+                        OverflowPolicy overflowPolicy = OverflowPolicy::DROP_NEWEST);
+
+                    ~LogQueue();
+
+                    // Non-copyable.
+                    LogQueue(const LogQueue &) = delete;
+                    LogQueue &operator=(const LogQueue &) = delete;
+
                     /**
                      * \brief Adds a single log to the LogQueue.
                      *
+                     * Producers never take a lock to add a message and never wait for the consumer. If the queue is
+                     * full, a message is dropped according to the overflow policy instead.
+                     *
                      * @param log the log to add to the LogQueue
                      */
                     void addLog(std::unique_ptr<LogMessage> log);
@@ -62,6 +212,16 @@ namespace Aws
                      */
                     std::unique_ptr<LogMessage> getNextLog();
 
+                    /**
+                     * \brief Gets the next log message, waiting no longer than timeout for one to arrive.
+                     *
+                     * Lets a consumer do periodic work, such as syncing its output, while no message is logged.
+                     *
+                     * @param timeout the longest time to wait for a message
+                     * @return the next log message in the LogQueue, or nullptr when none arrived in time
+                     */
+                    std::unique_ptr<LogMessage> getNextLog(std::chrono::milliseconds timeout);
+
                     /**
                      * \brief Determine whether the LogQueue has a message available
                      *
@@ -69,6 +229,32 @@ namespace Aws
                      */
                     bool hasNextLog();
 
+                    /**
+                     * \brief Returns the number of slots in the LogQueue
+                     */
+                    std::size_t capacity() const { return mask + 1; }
+
+                    /**
+                     * \brief Returns the overflow policy of the LogQueue
+                     */
+                    OverflowPolicy getOverflowPolicy() const { return overflowPolicy; }
+
+                    /**
+                     * \brief Returns the number of messages dropped since the LogQueue was created
+                     */
+                    std::uint64_t getDroppedCount() const;
+
+                    /**
+                     * \brief Returns the number of messages of a given level dropped since the LogQueue was created
+                     */
+                    std::uint64_t getDroppedCount(LogLevel level) const;
+
+                    /**
+                     * \brief Returns the number of messages dropped since the last call and resets it, so that the
+                     * logger can report every dropped message exactly once
+                     */
+                    std::uint64_t takeUnreportedDropCount();
+
                     /**
                      * \brief Force all consumers to stop waiting so that they can flush the queue
                      * and end any waiting behavior that might prevent the thread from shutting down.
@@ -0,0 +1,179 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LogRateLimiter.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace std::chrono;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+constexpr char LogRateLimiter::OVERFLOW_TAG[];
+constexpr size_t LogRateLimiter::SHARD_COUNT;
+constexpr size_t LogRateLimiter::MAX_TAGS_PER_SHARD;
+constexpr int LogRateLimiter::MIN_WINDOW_MS;
+
+namespace
+{
+    /**
+     * \brief 64-bit FNV-1a hash of a null terminated string
+     */
+    uint64_t hashTag(const char *tag)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char *c = tag; *c != '\0'; c++)
+        {
+            hash ^= static_cast<unsigned char>(*c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+} // namespace
+
+void LogRateLimiter::configure(int ratePerSecond, int burst)
+{
+    enabled = false;
+    tokensPerSecond = static_cast<double>(max(ratePerSecond, 0));
+    burstSize = static_cast<double>(max(burst, 1));
+    for (auto &shard : shards)
+    {
+        lock_guard<mutex> shardGuard(shard.lock);
+        shard.buckets.clear();
+        shard.overflow = Bucket();
+        shard.overflow.tag = OVERFLOW_TAG;
+        shard.overflow.tokens = burstSize;
+    }
+    suppressedCount = 0;
+    enabled = ratePerSecond > 0;
+}
+
+void LogRateLimiter::refill(Bucket &bucket, steady_clock::time_point now) const
+{
+    if (bucket.lastRefill == steady_clock::time_point())
+    {
+        bucket.lastRefill = now;
+        return;
+    }
+    if (now <= bucket.lastRefill)
+    {
+        return;
+    }
+    double elapsedSeconds = duration_cast<duration<double>>(now - bucket.lastRefill).count();
+    bucket.tokens = min(bucket.tokens + elapsedSeconds * tokensPerSecond, burstSize.load());
+    bucket.lastRefill = now;
+}
+
+void LogRateLimiter::closeWindow(Bucket &bucket, steady_clock::time_point now, Suppression &closed)
+{
+    closed.tag = bucket.tag;
+    closed.level = bucket.suppressedLevel;
+    closed.count = bucket.suppressed;
+    closed.duration = duration_cast<milliseconds>(now - bucket.suppressedSince);
+    bucket.suppressed = 0;
+}
+
+bool LogRateLimiter::isWindowClosed(const Bucket &bucket, steady_clock::time_point now)
+{
+    return bucket.tokens >= 1 && now - bucket.suppressedSince >= milliseconds(MIN_WINDOW_MS);
+}
+
+LogRateLimiter::Bucket &LogRateLimiter::findBucket(
+    Shard &shard,
+    uint64_t hash,
+    const char *tag,
+    steady_clock::time_point now)
+{
+    auto found = shard.buckets.find(hash);
+    if (found != shard.buckets.end())
+    {
+        // Tags whose hashes collide share a bucket, which only makes the limit stricter for both
+        return found->second;
+    }
+
+    if (shard.buckets.size() >= MAX_TAGS_PER_SHARD)
+    {
+        // Forget the tags that have gone quiet, a tag with a full bucket behaves exactly like a new one
+        for (auto bucket = shard.buckets.begin(); bucket != shard.buckets.end();)
+        {
+            refill(bucket->second, now);
+            if (bucket->second.suppressed == 0 && bucket->second.tokens >= burstSize)
+            {
+                bucket = shard.buckets.erase(bucket);
+            }
+            else
+            {
+                bucket++;
+            }
+        }
+        if (shard.buckets.size() >= MAX_TAGS_PER_SHARD)
+        {
+            return shard.overflow;
+        }
+    }
+
+    Bucket &bucket = shard.buckets[hash];
+    bucket.tag = tag;
+    bucket.tokens = burstSize;
+    bucket.lastRefill = now;
+    return bucket;
+}
+
+bool LogRateLimiter::tryAcquire(const char *tag, LogLevel level, steady_clock::time_point now, Suppression &closed)
+{
+    closed.count = 0;
+    uint64_t hash = hashTag(tag);
+    Shard &shard = shards[hash % SHARD_COUNT];
+
+    lock_guard<mutex> shardGuard(shard.lock);
+    Bucket &bucket = findBucket(shard, hash, tag, now);
+    refill(bucket, now);
+    if (bucket.tokens >= 1)
+    {
+        if (bucket.suppressed > 0 && isWindowClosed(bucket, now))
+        {
+            closeWindow(bucket, now, closed);
+        }
+        bucket.tokens -= 1;
+        return true;
+    }
+
+    if (bucket.suppressed == 0)
+    {
+        bucket.suppressedSince = now;
+        bucket.suppressedLevel = level;
+    }
+    else if (level < bucket.suppressedLevel)
+    {
+        // Lower levels are more severe
+        bucket.suppressedLevel = level;
+    }
+    bucket.suppressed++;
+    suppressedCount.fetch_add(1, memory_order_relaxed);
+    return false;
+}
+
+void LogRateLimiter::collectSuppressions(steady_clock::time_point now, bool all, vector<Suppression> &suppressions)
+{
+    for (auto &shard : shards)
+    {
+        lock_guard<mutex> shardGuard(shard.lock);
+        auto collect = [this, now, all, &suppressions](Bucket &bucket) {
+            if (bucket.suppressed == 0)
+            {
+                return;
+            }
+            refill(bucket, now);
+            if (all || isWindowClosed(bucket, now))
+            {
+                suppressions.emplace_back();
+                closeWindow(bucket, now, suppressions.back());
+            }
+        };
+        for (auto &bucket : shard.buckets)
+        {
+            collect(bucket.second);
+        }
+        collect(shard.overflow);
+    }
+}
@@ -0,0 +1,189 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_LOGRATELIMITER_H
+#define DEVICE_CLIENT_LOGRATELIMITER_H
+
+#include "LogLevel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Limits the rate at which each log tag can log, using one token bucket per tag
+                 *
+                 * Each tag may log a burst of messages in a row, after which it is limited to a steady rate. The
+                 * messages beyond the limit are suppressed before they are formatted, and counted. Once the bucket
+                 * of a tag has refilled, the suppression window of that tag closes and the number of suppressed
+                 * messages is handed back to the logger so that it can print a summary.
+                 *
+                 * The buckets are spread over a fixed number of independently locked shards so that threads logging
+                 * under different tags rarely contend. The number of tracked tags is bounded: once a shard is full,
+                 * the tags that are not tracked share a single bucket.
+                 */
+                class LogRateLimiter
+                {
+                  public:
+                    /**
+                     * \brief The messages of a tag suppressed during a window that has closed
+                     */
+                    struct Suppression
+                    {
+                        std::string tag;
+                        /** The most severe level among the suppressed messages **/
+                        LogLevel level{LogLevel::DEBUG};
+                        std::uint64_t count{0};
+                        /** Time between the first suppressed message and the end of the window **/
+                        std::chrono::milliseconds duration{0};
+                    };
+
+                    /**
+                     * \brief Tag reported for the messages of the tags that did not fit in their shard
+                     */
+                    static constexpr char OVERFLOW_TAG[] = "(untracked tags)";
+
+                    LogRateLimiter() = default;
+
+                    // Non-copyable.
+                    LogRateLimiter(const LogRateLimiter &) = delete;
+                    LogRateLimiter &operator=(const LogRateLimiter &) = delete;
+
+                    /**
+                     * \brief Sets the rate and burst of every bucket, forgetting the state of all tags
+                     *
+                     * @param ratePerSecond the number of messages per second a tag may log past its burst, 0 disables
+                     * the rate limiting
+                     * @param burst the number of messages a tag may log in a row
+                     */
+                    void configure(int ratePerSecond, int burst);
+
+                    /**
+                     * \brief Whether messages are rate limited at all
+                     */
+                    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+                    /**
+                     * \brief Takes a token from the bucket of a tag
+                     *
+                     * @param tag the tag of the message
+                     * @param level the level of the message
+                     * @param now the current time
+                     * @param closed set to the suppressed messages of the tag if this message closes a suppression
+                     * window, its count is left at 0 otherwise
+                     * @return true if the message may be logged, false if it is suppressed
+                     */
+                    bool tryAcquire(
+                        const char *tag,
+                        LogLevel level,
+                        std::chrono::steady_clock::time_point now,
+                        Suppression &closed);
+
+                    /**
+                     * \brief Collects the suppression windows that have closed without the tag logging again
+                     *
+                     * @param now the current time
+                     * @param all collect the suppressed messages of every tag, even if its window is still open
+                     * @param suppressions the collected windows are appended to this vector
+                     */
+                    void collectSuppressions(
+                        std::chrono::steady_clock::time_point now,
+                        bool all,
+                        std::vector<Suppression> &suppressions);
+
+                    /**
+                     * \brief Returns the number of messages suppressed since the limiter was configured
+                     */
+                    std::uint64_t getSuppressedCount() const
+                    {
+                        return suppressedCount.load(std::memory_order_relaxed);
+                    }
+
+                  private:
+                    static constexpr std::size_t SHARD_COUNT = 16;
+                    /**
+                     * \brief Maximum number of tags tracked by a single shard, not counting the overflow bucket
+                     */
+                    static constexpr std::size_t MAX_TAGS_PER_SHARD = 64;
+                    /**
+                     * \brief Minimum duration of a suppression window, so that a tag logging at its limit produces at
+                     * most one summary per window rather than one per message
+                     */
+                    static constexpr int MIN_WINDOW_MS = 1000;
+
+                    struct Bucket
+                    {
+                        std::string tag;
+                        double tokens{0};
+                        std::chrono::steady_clock::time_point lastRefill;
+                        std::uint64_t suppressed{0};
+                        std::chrono::steady_clock::time_point suppressedSince;
+                        LogLevel suppressedLevel{LogLevel::DEBUG};
+                    };
+
+                    struct Shard
+                    {
+                        std::mutex lock;
+                        /**
+                         * \brief Buckets keyed by the hash of their tag, so that looking a tag up does not allocate
+                         */
+                        std::unordered_map<std::uint64_t, Bucket> buckets;
+                        /**
+                         * \brief Shared by the tags that arrive once the shard already tracks MAX_TAGS_PER_SHARD tags
+                         */
+                        Bucket overflow;
+                    };
+
+                    std::atomic<bool> enabled{false};
+                    std::atomic<double> tokensPerSecond{0};
+                    std::atomic<double> burstSize{1};
+                    std::atomic<std::uint64_t> suppressedCount{0};
+                    Shard shards[SHARD_COUNT];
+
+                    /**
+                     * \brief Adds the tokens earned since the last refill, up to the burst size
+                     */
+                    void refill(Bucket &bucket, std::chrono::steady_clock::time_point now) const;
+
+                    /**
+                     * \brief Moves the suppressed messages of a bucket into a Suppression and resets them
+                     */
+                    static void closeWindow(
+                        Bucket &bucket,
+                        std::chrono::steady_clock::time_point now,
+                        Suppression &closed);
+
+                    /**
+                     * \brief Whether a bucket holding suppressed messages may report them, which is once it has
+                     * refilled enough for a message and its window has lasted at least MIN_WINDOW_MS
+                     */
+                    static bool isWindowClosed(const Bucket &bucket, std::chrono::steady_clock::time_point now);
+
+                    /**
+                     * \brief Returns the bucket of a tag, creating it if the shard still has room
+                     */
+                    Bucket &findBucket(
+                        Shard &shard,
+                        std::uint64_t hash,
+                        const char *tag,
+                        std::chrono::steady_clock::time_point now);
+                };
+            } // namespace Logging
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_LOGRATELIMITER_H
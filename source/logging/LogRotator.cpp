@@ -0,0 +1,356 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LogRotator.h"
+#include "../util/FileUtils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#if defined(__linux__)
+#    include <sys/syscall.h>
+#endif
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+constexpr char LogRotator::COMPRESSED_EXTENSION[];
+
+namespace
+{
+    constexpr char TAG[] = "LogRotator.cpp";
+    constexpr char TEMPORARY_EXTENSION[] = ".tmp";
+    /**
+     * \brief Length of the rotation time in a rotated file name, "20111008T070709178Z"
+     */
+    constexpr size_t ROTATION_TIME_LENGTH = 19;
+    constexpr size_t COMPRESSION_BUFFER_SIZE = 64 * 1024;
+
+    bool endsWith(const string &value, const string &suffix)
+    {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    bool pathExists(const string &path)
+    {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0;
+    }
+
+    /**
+     * \brief Determine whether the part of a file name following the log file name and a dot identifies a rotated
+     * generation, that is a rotation time optionally followed by "-<counter>"
+     */
+    bool isGenerationSuffix(const string &suffix)
+    {
+        if (suffix.size() < ROTATION_TIME_LENGTH)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < ROTATION_TIME_LENGTH; i++)
+        {
+            bool expectDigit = i != 8 && i != ROTATION_TIME_LENGTH - 1;
+            char expected = i == 8 ? 'T' : 'Z';
+            if (expectDigit ? !isdigit(static_cast<unsigned char>(suffix[i])) : suffix[i] != expected)
+            {
+                return false;
+            }
+        }
+        if (suffix.size() == ROTATION_TIME_LENGTH)
+        {
+            return true;
+        }
+        if (suffix[ROTATION_TIME_LENGTH] != '-' || suffix.size() == ROTATION_TIME_LENGTH + 1)
+        {
+            return false;
+        }
+        return all_of(suffix.begin() + ROTATION_TIME_LENGTH + 1, suffix.end(), [](char c) {
+            return isdigit(static_cast<unsigned char>(c)) != 0;
+        });
+    }
+
+    /**
+     * \brief Orders generation suffixes from the oldest to the newest rotation
+     */
+    bool isOlderGeneration(const string &lhs, const string &rhs)
+    {
+        int timeOrder = lhs.compare(0, ROTATION_TIME_LENGTH, rhs, 0, ROTATION_TIME_LENGTH);
+        if (timeOrder != 0)
+        {
+            return timeOrder < 0;
+        }
+        // Rotations within the same millisecond are told apart by their counter, the first one has none
+        auto counter = [](const string &suffix) {
+            return suffix.size() > ROTATION_TIME_LENGTH ? stoul(suffix.substr(ROTATION_TIME_LENGTH + 1)) : 0;
+        };
+        return counter(lhs) < counter(rhs);
+    }
+
+    void lowerThreadPriority()
+    {
+#if defined(__linux__)
+        // On Linux the nice value of a thread can be changed on its own, without affecting the logger thread
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19) != 0)
+        {
+            cout << TAG << ": Failed to lower the priority of the log rotation thread, errno: " << errno << endl;
+        }
+#endif
+    }
+} // namespace
+
+LogRotator::~LogRotator()
+{
+    stop();
+}
+
+void LogRotator::start(const string &logFile, const PlainConfig::LogConfig &config)
+{
+    stop();
+
+    this->logFile = logFile;
+    maxSizeBytes = static_cast<size_t>(max(config.rotationMaxSizeBytes, 0));
+    maxAgeSeconds = max(config.rotationMaxAgeSeconds, 0);
+    generations = static_cast<size_t>(max(config.rotationGenerations, 1));
+    compress = config.rotationCompress;
+
+    if (isEnabled())
+    {
+        stopRequested = false;
+        workPending = true;
+        worker = thread(&LogRotator::run, this);
+    }
+}
+
+void LogRotator::stop()
+{
+    if (!worker.joinable())
+    {
+        return;
+    }
+
+    {
+        lock_guard<mutex> workGuard(workLock);
+        stopRequested = true;
+    }
+    workNotifier.notify_all();
+    worker.join();
+}
+
+bool LogRotator::shouldRotate(size_t fileSize, chrono::steady_clock::time_point openedAt) const
+{
+    if (maxSizeBytes > 0 && fileSize >= maxSizeBytes)
+    {
+        return true;
+    }
+    return maxAgeSeconds > 0 && chrono::steady_clock::now() - openedAt >= chrono::seconds(maxAgeSeconds);
+}
+
+string LogRotator::nextRotatedFile(chrono::system_clock::time_point now) const
+{
+    auto totalMs = chrono::duration_cast<chrono::milliseconds>(now.time_since_epoch()).count();
+    time_t timer = static_cast<time_t>(totalMs / 1000);
+    struct tm bt;
+    gmtime_r(&timer, &bt);
+
+    char rotationTime[ROTATION_TIME_LENGTH + 1];
+    size_t length = strftime(rotationTime, sizeof(rotationTime), "%Y%m%dT%H%M%S", &bt);
+    snprintf(rotationTime + length, sizeof(rotationTime) - length, "%03dZ", static_cast<int>(totalMs % 1000));
+
+    string base = logFile + "." + rotationTime;
+    string candidate = base;
+    for (int counter = 1; pathExists(candidate) || pathExists(candidate + COMPRESSED_EXTENSION); counter++)
+    {
+        candidate = base + "-" + to_string(counter);
+    }
+    return candidate;
+}
+
+void LogRotator::notifyRotated()
+{
+    {
+        lock_guard<mutex> workGuard(workLock);
+        workPending = true;
+    }
+    workNotifier.notify_all();
+}
+
+vector<string> LogRotator::listRotatedFiles(const string &logFile)
+{
+    string directory = FileUtils::ExtractParentDirectory(logFile);
+    string prefix = logFile.substr(logFile.rfind('/') == string::npos ? 0 : logFile.rfind('/') + 1) + ".";
+
+    vector<pair<string, string>> rotated;
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+    {
+        return {};
+    }
+    for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+        string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        string suffix = name.substr(prefix.size());
+        if (endsWith(suffix, COMPRESSED_EXTENSION))
+        {
+            suffix.resize(suffix.size() - strlen(COMPRESSED_EXTENSION));
+        }
+        if (isGenerationSuffix(suffix))
+        {
+            rotated.emplace_back(suffix, directory + name);
+        }
+    }
+    closedir(dir);
+
+    sort(rotated.begin(), rotated.end(), [](const pair<string, string> &lhs, const pair<string, string> &rhs) {
+        return isOlderGeneration(rhs.first, lhs.first);
+    });
+    vector<string> paths;
+    for (const auto &generation : rotated)
+    {
+        paths.push_back(generation.second);
+    }
+    return paths;
+}
+
+void LogRotator::run()
+{
+    lowerThreadPriority();
+
+    unique_lock<mutex> workGuard(workLock);
+    while (!stopRequested)
+    {
+        if (workPending)
+        {
+            workPending = false;
+            workGuard.unlock();
+            maintain();
+            workGuard.lock();
+            continue;
+        }
+        workNotifier.wait(workGuard, [this]() { return stopRequested || workPending; });
+    }
+}
+
+void LogRotator::maintain()
+{
+    // Clean up after a Device Client that stopped while compressing. A temporary file is an incomplete compression
+    // that has to start over, while a compressed file next to its original only missed the removal of the original.
+    for (const auto &path : listRotatedFiles(logFile))
+    {
+        if (endsWith(path, COMPRESSED_EXTENSION))
+        {
+            continue;
+        }
+        string temporary = path + COMPRESSED_EXTENSION + TEMPORARY_EXTENSION;
+        if (pathExists(temporary))
+        {
+            unlink(temporary.c_str());
+        }
+        if (pathExists(path + COMPRESSED_EXTENSION))
+        {
+            unlink(path.c_str());
+        }
+    }
+
+    vector<string> rotated = listRotatedFiles(logFile);
+    // Only the generations that are kept are worth compressing
+    for (size_t i = 0; i < rotated.size(); i++)
+    {
+        if (stopRequested)
+        {
+            return;
+        }
+        if (i >= generations)
+        {
+            if (unlink(rotated[i].c_str()) != 0 && errno != ENOENT)
+            {
+                cout << TAG << ": Failed to remove rotated log file " << rotated[i] << ", errno: " << errno << endl;
+            }
+        }
+        else if (compress && !endsWith(rotated[i], COMPRESSED_EXTENSION))
+        {
+            compressFile(rotated[i]);
+        }
+    }
+}
+
+bool LogRotator::compressFile(const string &path)
+{
+    string compressed = path + COMPRESSED_EXTENSION;
+    string temporary = compressed + TEMPORARY_EXTENSION;
+
+    int input = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (input < 0)
+    {
+        cout << TAG << ": Failed to open rotated log file " << path << " for compression, errno: " << errno << endl;
+        return false;
+    }
+    int output = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    gzFile gz = output < 0 ? nullptr : gzdopen(output, "wb");
+    if (gz == nullptr)
+    {
+        cout << TAG << ": Failed to create " << temporary << ", errno: " << errno << endl;
+        if (output >= 0)
+        {
+            close(output);
+        }
+        close(input);
+        return false;
+    }
+
+    vector<char> buffer(COMPRESSION_BUFFER_SIZE);
+    bool completed = true;
+    for (;;)
+    {
+        if (stopRequested)
+        {
+            completed = false;
+            break;
+        }
+        ssize_t bytesRead = read(input, buffer.data(), buffer.size());
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead <= 0)
+        {
+            completed = bytesRead == 0;
+            break;
+        }
+        if (gzwrite(gz, buffer.data(), static_cast<unsigned>(bytesRead)) != bytesRead)
+        {
+            completed = false;
+            break;
+        }
+    }
+    close(input);
+    // gzclose() also closes the output file descriptor
+    completed = gzclose(gz) == Z_OK && completed;
+
+    if (!completed || rename(temporary.c_str(), compressed.c_str()) != 0)
+    {
+        if (!stopRequested)
+        {
+            cout << TAG << ": Failed to compress rotated log file " << path << endl;
+        }
+        unlink(temporary.c_str());
+        return false;
+    }
+    unlink(path.c_str());
+    return true;
+}
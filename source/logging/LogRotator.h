@@ -0,0 +1,142 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_LOGROTATOR_H
+#define DEVICE_CLIENT_LOGROTATOR_H
+
+#include "../config/Config.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Decides when the FileLogger rotates its log file and maintains the rotated log files
+                 *
+                 * A rotated log file is named after the log file and the UTC time of the rotation, for example
+                 * "aws-iot-device-client.log.20111008T070709178Z", with a ".gz" extension once it has been
+                 * compressed. The FileLogger renames the log file itself so that rotation only costs a rename and
+                 * an open on the logger thread. Compressing rotated files and removing the generations beyond the
+                 * configured count happens on a background thread running at the lowest scheduling priority.
+                 */
+                class LogRotator
+                {
+                  public:
+                    /**
+                     * \brief Extension added to a rotated log file once it has been compressed
+                     */
+                    static constexpr char COMPRESSED_EXTENSION[] = ".gz";
+
+                    LogRotator() = default;
+                    ~LogRotator();
+
+                    // Non-copyable.
+                    LogRotator(const LogRotator &) = delete;
+                    LogRotator &operator=(const LogRotator &) = delete;
+
+                    /**
+                     * \brief Applies the rotation settings for a log file and starts the background thread if
+                     * rotation is enabled
+                     *
+                     * The background thread immediately compresses and prunes rotated log files left behind by a
+                     * previous run.
+                     *
+                     * @param logFile the full path to the log file
+                     * @param config the log configuration holding the rotation settings
+                     */
+                    void start(const std::string &logFile, const PlainConfig::LogConfig &config);
+
+                    /**
+                     * \brief Stops the background thread, abandoning a compression that is in progress
+                     */
+                    void stop();
+
+                    /**
+                     * \brief Whether rotation by size or by age is enabled
+                     */
+                    bool isEnabled() const { return maxSizeBytes > 0 || maxAgeSeconds > 0; }
+
+                    /**
+                     * \brief Determine whether the log file should be rotated
+                     *
+                     * @param fileSize the current size in bytes of the log file
+                     * @param openedAt the time at which the log file was opened
+                     * @return true if either the size or the age limit has been reached
+                     */
+                    bool shouldRotate(std::size_t fileSize, std::chrono::steady_clock::time_point openedAt) const;
+
+                    /**
+                     * \brief Returns the path the log file should be renamed to when it is rotated now
+                     *
+                     * @param now the current time
+                     * @return a path that is not used by any other generation of the log file
+                     */
+                    std::string nextRotatedFile(std::chrono::system_clock::time_point now) const;
+
+                    /**
+                     * \brief Wakes the background thread up to compress and prune the rotated log files
+                     */
+                    void notifyRotated();
+
+                    /**
+                     * \brief Lists the rotated generations of a log file, newest first
+                     *
+                     * @param logFile the full path to the log file
+                     * @return the full paths of the rotated log files, compressed or not
+                     */
+                    static std::vector<std::string> listRotatedFiles(const std::string &logFile);
+
+                  private:
+                    std::string logFile;
+                    std::size_t maxSizeBytes = 0;
+                    int maxAgeSeconds = 0;
+                    std::size_t generations = 0;
+                    bool compress = false;
+
+                    std::thread worker;
+                    std::mutex workLock;
+                    std::condition_variable workNotifier;
+                    bool workPending = false;
+                    std::atomic<bool> stopRequested{false};
+
+                    /**
+                     * \brief Body of the background thread
+                     */
+                    void run();
+
+                    /**
+                     * \brief Compresses the rotated log files that are not compressed yet and removes the oldest
+                     * generations beyond the configured count
+                     */
+                    void maintain();
+
+                    /**
+                     * \brief Compresses a rotated log file into a gzip file and removes the original
+                     *
+                     * The compressed file is written under a temporary name and renamed once complete, so that a
+                     * partially compressed file is never mistaken for a generation.
+                     *
+                     * @param path the rotated log file
+                     * @return true if the file was compressed, false otherwise
+                     */
+                    bool compressFile(const std::string &path);
+                };
+            } // namespace Logging
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_LOGROTATOR_H
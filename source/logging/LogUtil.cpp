@@ -0,0 +1,122 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Logger.h"
+#include "BinaryLogFormat.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace Aws::Iot::DeviceClient;
+using namespace std;
+using namespace std::chrono;
+
+constexpr char TIMESTAMP_FORMAT[] =
+    "%Y-%m-%dT%H:%M:%S."; // ISO 8601 "2011-10-08T07:07:09.178Z", ms will be calculated last
+
+void LogUtil::generateTimestamp(
+    std::chrono::time_point<std::chrono::system_clock> t,
+    size_t bufferSize,
+    char *timeBuffer)
+{
+    auto ms = duration_cast<milliseconds>(t.time_since_epoch()) % 1000;
+    auto timer = system_clock::to_time_t(t);
+    struct tm buf;
+    std::tm bt = *gmtime_r(&timer, &buf);
+
+    std::ostringstream time_stream;
+    time_stream << std::put_time(&bt, TIMESTAMP_FORMAT);
+    time_stream << std::setfill('0') << std::setw(3) << ms.count();
+    time_stream << "Z";
+
+    const string timestamp = time_stream.str();
+    timestamp.copy(timeBuffer, bufferSize);
+    timeBuffer[bufferSize - 1] = '\0';
+}
+
+constexpr size_t LogUtil::TimestampFormatter::BUFFER_SIZE;
+
+size_t LogUtil::TimestampFormatter::format(std::chrono::time_point<std::chrono::system_clock> t, char *timeBuffer)
+{
+    long long totalMs = duration_cast<milliseconds>(t.time_since_epoch()).count();
+    long long second = totalMs / 1000;
+    long long ms = totalMs % 1000;
+    if (ms < 0)
+    {
+        // Round towards the past for times before the epoch so that the milliseconds stay positive
+        ms += 1000;
+        second--;
+    }
+
+    if (cachedPrefixLength == 0 || second != cachedSecond)
+    {
+        auto timer = static_cast<time_t>(second);
+        struct tm bt;
+        if (gmtime_r(&timer, &bt) == nullptr)
+        {
+            timeBuffer[0] = '\0';
+            return 0;
+        }
+        // Leave room for the milliseconds, the "Z" and the null terminator
+        cachedPrefixLength = strftime(cachedPrefix, BUFFER_SIZE - 5, TIMESTAMP_FORMAT, &bt);
+        cachedSecond = second;
+    }
+
+    memcpy(timeBuffer, cachedPrefix, cachedPrefixLength);
+    char *millis = timeBuffer + cachedPrefixLength;
+    millis[0] = static_cast<char>('0' + ms / 100);
+    millis[1] = static_cast<char>('0' + ms / 10 % 10);
+    millis[2] = static_cast<char>('0' + ms % 10);
+    millis[3] = 'Z';
+    millis[4] = '\0';
+    return cachedPrefixLength + 4;
+}
+
+void LogUtil::appendLogLine(
+    Logging::LogMessage &message,
+    std::string &buffer,
+    TimestampFormatter &timestampFormatter)
+{
+    char time_buffer[TimestampFormatter::BUFFER_SIZE];
+    size_t timeLength = timestampFormatter.format(message.getTime(), time_buffer);
+
+    buffer.append(time_buffer, timeLength);
+    buffer.push_back(' ');
+    buffer.append(Logging::LogLevelMarshaller::ToString(message.getLevel()));
+    buffer.append(" {");
+    buffer.append(message.getTag());
+    buffer.append("}: ");
+    if (!message.isDeferred())
+    {
+        buffer.append(message.getMessage());
+    }
+    else if (!Logging::BinaryLogFormat::formatMessage(message.getMessage(), buffer))
+    {
+        buffer.append("<malformed deferred log message>");
+    }
+    buffer.push_back('\n');
+}
+
+bool LogUtil::writeFully(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -2,34 +2,107 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Logger.h"
+#include <algorithm>
 #include <chrono>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace Aws::Iot::DeviceClient;
 using namespace std;
 using namespace std::chrono;
 
-constexpr char TIMESTAMP_FORMAT[] =
-    "%Y-%m-%dT%H:%M:%S."; // ISO 8601 "2011-10-08T07:07:09.178Z", ms will be calculated last
+constexpr int Logging::Logger::DROP_REPORT_INTERVAL_MS;
 
-void LogUtil::generateTimestamp(
-    std::chrono::time_point<std::chrono::system_clock> t,
-    size_t bufferSize,
-    char *timeBuffer)
+void Logging::Logger::configureQueue(std::unique_ptr<LogQueue> &queue, const PlainConfig::LogConfig &config)
 {
-    auto ms = duration_cast<milliseconds>(t.time_since_epoch()) % 1000;
-    auto timer = system_clock::to_time_t(t);
-    struct tm buf;
-    std::tm bt = *gmtime_r(&timer, &buf);
-
-    std::ostringstream time_stream;
-    time_stream << std::put_time(&bt, TIMESTAMP_FORMAT);
-    time_stream << std::setfill('0') << std::setw(3) << ms.count();
-    time_stream << "Z";
-
-    const string timestamp = time_stream.str();
-    timestamp.copy(timeBuffer, bufferSize);
-    timeBuffer[bufferSize - 1] = '\0';
+    LogQueue::OverflowPolicy overflowPolicy = LogQueue::OverflowPolicy::DROP_NEWEST;
+    if (config.queueOverflowPolicy == PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_OLDEST)
+    {
+        overflowPolicy = LogQueue::OverflowPolicy::DROP_OLDEST;
+    }
+    else if (config.queueOverflowPolicy == PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_BELOW_LEVEL)
+    {
+        overflowPolicy = LogQueue::OverflowPolicy::DROP_BELOW_LEVEL;
+    }
+
+    unique_ptr<LogQueue> configured(new LogQueue(static_cast<size_t>(max(config.queueCapacity, 1)), overflowPolicy));
+    // The queue may have been shut down by the logger it was taken from, but its messages can still be read
+    while (queue->hasNextLog())
+    {
+        unique_ptr<LogMessage> message = queue->getNextLog();
+        if (nullptr != message)
+        {
+            configured->addLog(std::move(message));
+        }
+    }
+    queue = std::move(configured);
+}
+
+unique_ptr<Logging::LogMessage> Logging::Logger::takeDropReport(LogQueue &queue, bool force)
+{
+    auto now = steady_clock::now();
+    if (!force && now - lastDropReport < milliseconds(DROP_REPORT_INTERVAL_MS))
+    {
+        return nullptr;
+    }
+
+    uint64_t dropped = queue.takeUnreportedDropCount();
+    if (dropped == 0)
+    {
+        return nullptr;
+    }
+    lastDropReport = now;
+    return unique_ptr<LogMessage>(new LogMessage(
+        LogLevel::WARN,
+        LOGGER_TAG,
+        system_clock::now(),
+        Util::FormatMessage(
+            "%llu log messages were dropped because the log queue was full",
+            static_cast<unsigned long long>(dropped))));
+}
+
+constexpr int Logging::Logger::SUPPRESSION_REPORT_INTERVAL_MS;
+
+string Logging::Logger::describeSuppression(const LogRateLimiter::Suppression &suppression)
+{
+    return Util::FormatMessage(
+        "%llu log messages were suppressed by the log rate limit over the last %lld ms",
+        static_cast<unsigned long long>(suppression.count),
+        static_cast<long long>(suppression.duration.count()));
+}
+
+bool Logging::Logger::admitRateLimited(LogLevel level, const char *tag, time_point<system_clock> t)
+{
+    LogRateLimiter::Suppression closed;
+    if (!rateLimiter.tryAcquire(tag, level, steady_clock::now(), closed))
+    {
+        return false;
+    }
+    if (closed.count > 0)
+    {
+        queueLog(closed.level, tag, t, describeSuppression(closed));
+    }
+    return true;
+}
+
+void Logging::Logger::takeSuppressionReports(vector<unique_ptr<LogMessage>> &reports, bool force)
+{
+    if (!rateLimiter.isEnabled())
+    {
+        return;
+    }
+    auto now = steady_clock::now();
+    if (!force && now - lastSuppressionReport < milliseconds(SUPPRESSION_REPORT_INTERVAL_MS))
+    {
+        return;
+    }
+    lastSuppressionReport = now;
+
+    vector<LogRateLimiter::Suppression> suppressions;
+    rateLimiter.collectSuppressions(now, force, suppressions);
+    for (const auto &suppression : suppressions)
+    {
+        reports.push_back(unique_ptr<LogMessage>(
+            new LogMessage(suppression.level, suppression.tag, system_clock::now(), describeSuppression(suppression))));
+    }
 }
@@ -7,12 +7,16 @@
 #include "../config/Config.h"
 #include "../util/StringUtils.h"
 #include "LogLevel.h"
+#include "LogMessage.h"
 #include "LogQueue.h"
+#include "LogRateLimiter.h"
 #include <chrono>
 #include <cstdarg>
+#include <cstdint>
 #include <ctime>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace Aws
 {
@@ -23,7 +27,8 @@ namespace Aws
             namespace LogUtil
             {
                 /**
-                 * Generates a timestamp to be applied to a log entry
+                 * Generates a timestamp to be applied to a log entry. The loggers use TimestampFormatter instead,
+                 * which produces the same output without allocating.
                  * @param t the current time
                  * @param timeBuffer a buffer to store the timestamp in
                  */
@@ -31,6 +36,60 @@ namespace Aws
                     std::chrono::time_point<std::chrono::system_clock> t,
                     size_t bufferSize,
                     char *timeBuffer);
+
+                /**
+                 * \brief Generates the same timestamps as generateTimestamp() without allocating, by caching the
+                 * formatted date and time of the last second seen and only writing the milliseconds of each log line
+                 *
+                 * The formatter keeps state between calls and is not thread-safe. Each logger owns its own instance.
+                 */
+                class TimestampFormatter
+                {
+                  public:
+                    /**
+                     * \brief Size of a buffer large enough to hold any timestamp, including the null terminator
+                     */
+                    static constexpr size_t BUFFER_SIZE = 32;
+
+                    /**
+                     * Writes the ISO 8601 timestamp of a log entry, e.g. "2011-10-08T07:07:09.178Z"
+                     * @param t the time of the log entry
+                     * @param timeBuffer a buffer of at least BUFFER_SIZE bytes, the timestamp is null terminated
+                     * @return the length of the timestamp
+                     */
+                    size_t format(std::chrono::time_point<std::chrono::system_clock> t, char *timeBuffer);
+
+                  private:
+                    /**
+                     * \brief Seconds since the epoch of the cached prefix
+                     */
+                    long long cachedSecond = 0;
+                    /**
+                     * \brief The formatted date and time of cachedSecond up to the milliseconds, "2011-10-08T07:07:09."
+                     */
+                    char cachedPrefix[BUFFER_SIZE] = {0};
+                    size_t cachedPrefixLength = 0;
+                };
+
+                /**
+                 * Formats a log message as a single line of log output and appends it to a buffer
+                 * @param message the message to format
+                 * @param buffer the buffer to append the formatted line to
+                 * @param timestampFormatter the formatter used for the timestamp of the line
+                 */
+                void appendLogLine(
+                    Logging::LogMessage &message,
+                    std::string &buffer,
+                    TimestampFormatter &timestampFormatter);
+
+                /**
+                 * Writes the entire buffer to a file descriptor, retrying on partial writes and interrupts
+                 * @param fd the file descriptor to write to
+                 * @param data the data to write
+                 * @param length the number of bytes to write
+                 * @return true if all of the bytes were written, false otherwise
+                 */
+                bool writeFully(int fd, const char *data, size_t length);
             } // namespace LogUtil
 
             namespace Logging
@@ -80,6 +139,97 @@ namespace Aws
                      */
                     void setLogLevel(int level) { logLevel = level; }
 
+                    /**
+                     * \brief Minimum time between two reports of the log messages dropped by the LogQueue
+                     */
+                    static constexpr int DROP_REPORT_INTERVAL_MS = 5000;
+
+                    /**
+                     * \brief The time of the last report of dropped log messages, only used by the logger thread
+                     * while it holds its batch lock
+                     */
+                    std::chrono::steady_clock::time_point lastDropReport;
+
+                    /**
+                     * \brief Replaces a LogQueue with one of the configured capacity and overflow policy, carrying over
+                     * the messages already queued
+                     *
+                     * Meant to be called from start(), before the logger thread starts reading from the queue.
+                     *
+                     * @param queue the LogQueue to replace
+                     * @param config the log configuration holding the queue settings
+                     */
+                    static void configureQueue(std::unique_ptr<LogQueue> &queue, const PlainConfig::LogConfig &config);
+
+                    /**
+                     * \brief Creates a warning reporting how many log messages the LogQueue dropped since the previous
+                     * report
+                     *
+                     * @param queue the LogQueue of the logger
+                     * @param force report even if the previous report was less than DROP_REPORT_INTERVAL_MS ago
+                     * @return the warning, or nullptr if there is nothing to report yet
+                     */
+                    std::unique_ptr<LogMessage> takeDropReport(LogQueue &queue, bool force);
+
+                    /**
+                     * \brief Limits the rate at which each tag can log, configured from start()
+                     */
+                    LogRateLimiter rateLimiter;
+
+                    /**
+                     * \brief Minimum time between two checks for the suppression windows of the rate limiter that
+                     * closed while their tag stayed quiet
+                     */
+                    static constexpr int SUPPRESSION_REPORT_INTERVAL_MS = 1000;
+
+                    /**
+                     * \brief The time of the last check for closed suppression windows, only used by the logger
+                     * thread while it holds its batch lock
+                     */
+                    std::chrono::steady_clock::time_point lastSuppressionReport;
+
+                    /**
+                     * \brief Creates a summary for each tag that had messages suppressed by the rate limiter and
+                     * stopped logging before it could report them itself
+                     *
+                     * @param reports the summaries are appended to this vector
+                     * @param force report every tag with suppressed messages, even if its suppression window is still
+                     * open, and regardless of the time of the previous check
+                     */
+                    void takeSuppressionReports(std::vector<std::unique_ptr<LogMessage>> &reports, bool force);
+
+                    /**
+                     * \brief Determine whether a message that passed the log level check should be logged or is
+                     * suppressed by the rate limit of its tag
+                     *
+                     * Warnings and errors are never rate limited, so that a flood of less severe messages under the
+                     * same tag cannot hide them.
+                     *
+                     * @param level the log level
+                     * @param tag the tag of the message
+                     * @param t the time of the message
+                     * @return true if the message should be formatted and queued
+                     */
+                    bool admit(LogLevel level, const char *tag, std::chrono::time_point<std::chrono::system_clock> t)
+                    {
+                        return !rateLimiter.isEnabled() || level <= LogLevel::WARN || admitRateLimited(level, tag, t);
+                    }
+
+                  private:
+                    /**
+                     * \brief Takes a token from the rate limiter, and queues the summary of the suppressed messages of
+                     * the tag if this message closes its suppression window
+                     */
+                    bool admitRateLimited(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> t);
+
+                    /**
+                     * \brief Formats the summary of the messages of a tag suppressed by the rate limiter
+                     */
+                    static std::string describeSuppression(const LogRateLimiter::Suppression &suppression);
+
                   public:
                     // Logger inherited by FileLogger. Make destructor virtual to avoid memory leak.
                     virtual ~Logger() = default;
@@ -124,7 +274,7 @@ namespace Aws
                     {
                         va_list args;
                         va_start(args, message);
-                        if (logLevel >= (int)LogLevel::ERROR)
+                        if (logLevel >= (int)LogLevel::ERROR && admit(LogLevel::ERROR, tag, t))
                         {
                             vlog(LogLevel::ERROR, tag, t, message, args);
                         }
@@ -151,7 +301,7 @@ namespace Aws
                     {
                         va_list args;
                         va_start(args, message);
-                        if (logLevel >= (int)LogLevel::WARN)
+                        if (logLevel >= (int)LogLevel::WARN && admit(LogLevel::WARN, tag, t))
                         {
                             vlog(LogLevel::WARN, tag, t, message, args);
                         }
@@ -178,7 +328,7 @@ namespace Aws
                     {
                         va_list args;
                         va_start(args, message);
-                        if (logLevel >= (int)LogLevel::INFO)
+                        if (logLevel >= (int)LogLevel::INFO && admit(LogLevel::INFO, tag, t))
                         {
                             vlog(LogLevel::INFO, tag, t, message, args);
                         }
@@ -205,7 +355,7 @@ namespace Aws
                     {
                         va_list args;
                         va_start(args, message);
-                        if (logLevel >= (int)LogLevel::DEBUG)
+                        if (logLevel >= (int)LogLevel::DEBUG && admit(LogLevel::DEBUG, tag, t))
                         {
                             vlog(LogLevel::DEBUG, tag, t, message, args);
                         }
@@ -253,6 +403,16 @@ namespace Aws
                      * that this is called from
                      */
                     virtual void flush() = 0;
+
+                    /**
+                     * \brief Returns the number of log messages dropped because the LogQueue was full
+                     */
+                    virtual std::uint64_t getDroppedCount() const = 0;
+
+                    /**
+                     * \brief Returns the number of log messages of a given level dropped because the LogQueue was full
+                     */
+                    virtual std::uint64_t getDroppedCount(LogLevel level) const = 0;
                 };
             } // namespace Logging
         } // namespace DeviceClient
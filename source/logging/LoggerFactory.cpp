@@ -8,6 +8,7 @@ using namespace Aws::Iot::DeviceClient;
 using namespace Aws::Iot::DeviceClient::Logging;
 
 shared_ptr<Logger> LoggerFactory::logger = std::make_shared<StdOutLogger>();
+atomic<int> LoggerFactory::logLevel{(int)LogLevel::DEBUG};
 
 shared_ptr<Logger> LoggerFactory::getLoggerInstance()
 {
@@ -33,5 +34,16 @@ bool LoggerFactory::reconfigure(const PlainConfig &config)
         logger.reset(new StdOutLogger);
         logger->setLogQueue(std::move(logQueue));
     }
+    else if (
+        (config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_JOURNALD ||
+         config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_SYSLOG) &&
+        dynamic_cast<SystemLogger *>(logger.get()) == nullptr)
+    {
+        logger->stop();
+        unique_ptr<LogQueue> logQueue = logger->takeLogQueue();
+        logger.reset(new SystemLogger);
+        logger->setLogQueue(std::move(logQueue));
+    }
+    logLevel.store(config.logConfig.deviceClientlogLevel, memory_order_relaxed);
     return logger->start(config);
-}
\ No newline at end of file
+}
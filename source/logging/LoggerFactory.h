@@ -4,6 +4,28 @@
 #ifndef DEVICE_CLIENT_LOGGERFACTORY_H
 #define DEVICE_CLIENT_LOGGERFACTORY_H
 
+/**
+ * \brief The lowest log level that is compiled into the Device Client (0 = ERROR, 1 = WARN, 2 = INFO, 3 = DEBUG)
+ *
+ * Set through the LOG_MIN_LEVEL CMake option. Log statements below this level are removed at compile time, regardless
+ * of the log level configured at runtime.
+ */
+#ifndef DC_LOG_MIN_LEVEL
+#    define DC_LOG_MIN_LEVEL 3
+#endif
+
+/**
+ * \brief Determine whether a log statement at the given level would be processed
+ *
+ * The check happens before any of the log statement's arguments are evaluated, so a disabled log statement costs a
+ * single relaxed atomic load, or nothing at all if the level is compiled out.
+ *
+ * @param level one of ERROR, WARN, INFO or DEBUG
+ */
+#define DC_LOG_ENABLED(level)                                                                                          \
+    ((int)Aws::Iot::DeviceClient::Logging::LogLevel::level <= DC_LOG_MIN_LEVEL &&                                     \
+     LoggerFactory::isLogLevelEnabled(Aws::Iot::DeviceClient::Logging::LogLevel::level))
+
 /**
  * \brief Log INFO message
  *
@@ -11,7 +33,13 @@
  * @param message the information message to be logged (The message string must be NULL terminated)
  */
 #define LOG_INFO(tag, message)                                                                                         \
-    LoggerFactory::getLoggerInstance().get()->info(tag, std::chrono::system_clock::now(), message)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(INFO))                                                                                      \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->info(tag, std::chrono::system_clock::now(), message);            \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log DEBUG message
  *
@@ -19,7 +47,13 @@
  * @param message the debug message to be logged (The message string must be NULL terminated)
  */
 #define LOG_DEBUG(tag, message)                                                                                        \
-    LoggerFactory::getLoggerInstance().get()->debug(tag, std::chrono::system_clock::now(), message)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(DEBUG))                                                                                     \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->debug(tag, std::chrono::system_clock::now(), message);           \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log WARN message
  *
@@ -27,7 +61,13 @@
  * @param message the warning message to be logged (The message string must be NULL terminated)
  */
 #define LOG_WARN(tag, message)                                                                                         \
-    LoggerFactory::getLoggerInstance().get()->warn(tag, std::chrono::system_clock::now(), message)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(WARN))                                                                                      \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->warn(tag, std::chrono::system_clock::now(), message);            \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log ERROR message
  *
@@ -35,7 +75,13 @@
  * @param message the error message to be logged (The message string must be NULL terminated)
  */
 #define LOG_ERROR(tag, message)                                                                                        \
-    LoggerFactory::getLoggerInstance().get()->error(tag, std::chrono::system_clock::now(), message)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(ERROR))                                                                                     \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->error(tag, std::chrono::system_clock::now(), message);           \
+        }                                                                                                              \
+    } while (0)
 
 /**
  * \brief Log INFO message
@@ -45,7 +91,14 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_INFO(tag, message, ...)                                                                                   \
-    LoggerFactory::getLoggerInstance().get()->info(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(INFO))                                                                                      \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->info(                                                            \
+                tag, std::chrono::system_clock::now(), message, __VA_ARGS__);                                          \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log DEBUG message
  *
@@ -54,7 +107,14 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_DEBUG(tag, message, ...)                                                                                  \
-    LoggerFactory::getLoggerInstance().get()->debug(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(DEBUG))                                                                                     \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->debug(                                                           \
+                tag, std::chrono::system_clock::now(), message, __VA_ARGS__);                                          \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log WARN message
  *
@@ -63,7 +123,14 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_WARN(tag, message, ...)                                                                                   \
-    LoggerFactory::getLoggerInstance().get()->warn(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(WARN))                                                                                      \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->warn(                                                            \
+                tag, std::chrono::system_clock::now(), message, __VA_ARGS__);                                          \
+        }                                                                                                              \
+    } while (0)
 /**
  * \brief Log ERROR message
  *
@@ -72,12 +139,21 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_ERROR(tag, message, ...)                                                                                  \
-    LoggerFactory::getLoggerInstance().get()->error(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (DC_LOG_ENABLED(ERROR))                                                                                     \
+        {                                                                                                              \
+            LoggerFactory::getLoggerInstance().get()->error(                                                           \
+                tag, std::chrono::system_clock::now(), message, __VA_ARGS__);                                          \
+        }                                                                                                              \
+    } while (0)
 
 #include "../config/Config.h"
 #include "FileLogger.h"
 #include "Logger.h"
 #include "StdOutLogger.h"
+#include "SystemLogger.h"
+#include <atomic>
 #include <chrono>
 #include <memory>
 
@@ -104,8 +180,23 @@ namespace Aws
                      * \brief The logger implementation
                      */
                     static std::shared_ptr<Logger> logger;
+                    /**
+                     * \brief Mirror of the active logger's runtime log level, read by the logging macros
+                     */
+                    static std::atomic<int> logLevel;
 
                   public:
+                    /**
+                     * \brief Determine whether messages at the given level are processed by the active logger
+                     *
+                     * @param level the level of the message
+                     * @return true if the message would be logged, false otherwise
+                     */
+                    static bool isLogLevelEnabled(LogLevel level)
+                    {
+                        return (int)level <= logLevel.load(std::memory_order_relaxed);
+                    }
+
                     /**
                      * \brief Returns the active logger instance
                      *
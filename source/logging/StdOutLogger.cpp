@@ -4,42 +4,66 @@
 #include "StdOutLogger.h"
 
 #include <iostream>
-#include <sstream>
 #include <thread>
-
-constexpr int TIMESTAMP_BUFFER_SIZE = 25;
+#include <unistd.h>
+#include <vector>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 
-constexpr int StdOutLogger::DEFAULT_WAIT_TIME_MILLISECONDS;
+constexpr size_t StdOutLogger::MAX_BATCH_BYTES;
 
-void StdOutLogger::writeLogMessage(unique_ptr<LogMessage> message) const
+void StdOutLogger::writeBatch(const string &batch) const
 {
-    char time_buffer[TIMESTAMP_BUFFER_SIZE];
-    LogUtil::generateTimestamp(message->getTime(), TIMESTAMP_BUFFER_SIZE, time_buffer);
-
-    cout << time_buffer << " " << LogLevelMarshaller::ToString(message->getLevel()) << " {" << message->getTag()
-         << "}: " << message->getMessage() << endl;
+    // Anything already buffered by std::cout must reach the terminal before the batch to keep the output ordered.
+    cout.flush();
+    LogUtil::writeFully(STDOUT_FILENO, batch.data(), batch.size());
 }
 
 void StdOutLogger::run()
 {
+    vector<unique_ptr<LogMessage>> suppressionReports;
     while (!needsShutdown)
     {
+        // Block until at least one message is available, then take everything else that is already queued so that
+        // a burst of messages costs a single write. The batch lock keeps flush() from writing newer messages ahead
+        // of a batch that is still being written.
+        lock_guard<mutex> batchGuard(batchLock);
         unique_ptr<LogMessage> message = logQueue->getNextLog();
+        batchBuffer.clear();
+        unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, false);
+        if (nullptr != dropReport)
+        {
+            LogUtil::appendLogLine(*dropReport, batchBuffer, timestampFormatter);
+        }
+        takeSuppressionReports(suppressionReports, false);
+        for (auto &report : suppressionReports)
+        {
+            LogUtil::appendLogLine(*report, batchBuffer, timestampFormatter);
+        }
+        suppressionReports.clear();
+        while (nullptr != message)
+        {
+            LogUtil::appendLogLine(*message, batchBuffer, timestampFormatter);
+            if (batchBuffer.size() >= MAX_BATCH_BYTES || !logQueue->hasNextLog())
+            {
+                break;
+            }
+            message = logQueue->getNextLog();
+        }
 
-        if (nullptr != message)
+        if (!batchBuffer.empty())
         {
-            writeLogMessage(std::move(message));
+            writeBatch(batchBuffer);
         }
-        this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_WAIT_TIME_MILLISECONDS));
     }
 }
 
 bool StdOutLogger::start(const PlainConfig &config)
 {
     setLogLevel(config.logConfig.deviceClientlogLevel);
+    configureQueue(logQueue, config.logConfig);
+    rateLimiter.configure(config.logConfig.rateLimitPerSecond, config.logConfig.rateLimitBurst);
 
     thread log_thread(&StdOutLogger::run, this);
     log_thread.detach();
@@ -76,14 +100,48 @@ void StdOutLogger::shutdown()
 
 void StdOutLogger::flush()
 {
+    lock_guard<mutex> batchGuard(batchLock);
+    string buffer;
     while (logQueue->hasNextLog())
     {
         unique_ptr<LogMessage> message = logQueue->getNextLog();
         if (nullptr != message)
         {
-            writeLogMessage(std::move(message));
+            LogUtil::appendLogLine(*message, buffer, timestampFormatter);
+        }
+        if (buffer.size() >= MAX_BATCH_BYTES)
+        {
+            writeBatch(buffer);
+            buffer.clear();
         }
     }
+
+    unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, true);
+    if (nullptr != dropReport)
+    {
+        LogUtil::appendLogLine(*dropReport, buffer, timestampFormatter);
+    }
+    vector<unique_ptr<LogMessage>> suppressionReports;
+    takeSuppressionReports(suppressionReports, true);
+    for (auto &report : suppressionReports)
+    {
+        LogUtil::appendLogLine(*report, buffer, timestampFormatter);
+    }
+
+    if (!buffer.empty())
+    {
+        writeBatch(buffer);
+    }
+}
+
+uint64_t StdOutLogger::getDroppedCount() const
+{
+    return logQueue->getDroppedCount();
+}
+
+uint64_t StdOutLogger::getDroppedCount(LogLevel level) const
+{
+    return logQueue->getDroppedCount(level);
 }
 
 void StdOutLogger::queueLog(
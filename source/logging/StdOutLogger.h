@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <mutex>
+#include <string>
 
 namespace Aws
 {
@@ -30,10 +31,9 @@ namespace Aws
                      */
                     bool needsShutdown = false;
                     /**
-                     * \brief The default value in milliseconds for which Device client will wait after getting a
-                     * log message from logQueue
+                     * \brief The maximum number of bytes of formatted log output gathered into a single write
                      */
-                    static constexpr int DEFAULT_WAIT_TIME_MILLISECONDS = 1;
+                    static constexpr size_t MAX_BATCH_BYTES = 64 * 1024;
                     /**
                      * \brief a LogQueue instance used to queue incoming log messages for processing
                      */
@@ -41,19 +41,30 @@ namespace Aws
                     /**
                      * \brief Begins processing of log messages in the LogQueue
                      *
-                     * This method will begin processing of log messages in the LogQueue. The thread will process until
-                     * all of the messages are removed from the queue, and then will wait until new messages arrive in
-                     * the queue. This method will check to make sure the shutdown() method has not been called before
-                     * processing any additional messages in the queue.
+                     * This method will begin processing of log messages in the LogQueue. Every message available in
+                     * the queue is formatted into a single batch that is written to standard output at once, and then
+                     * the thread will wait until new messages arrive in the queue. This method will check to make sure
+                     * the shutdown() method has not been called before processing any additional messages in the queue.
                      */
                     void run();
                     /**
-                     * \brief Write the log message to standard output
+                     * \brief Held while a batch of log messages is taken from the LogQueue and written out
+                     */
+                    std::mutex batchLock;
+                    /**
+                     * \brief Buffer reused by the logger thread to format each batch of log messages
+                     */
+                    std::string batchBuffer;
+                    /**
+                     * \brief Formats the timestamps of log lines, only used while holding batchLock
+                     */
+                    LogUtil::TimestampFormatter timestampFormatter;
+                    /**
+                     * \brief Write a batch of formatted log output to standard output with a single write
                      *
-                     * This method will write the log message to the file specified for logging
-                     * @param message the message to log
+                     * @param batch the formatted log lines to write
                      */
-                    void writeLogMessage(std::unique_ptr<LogMessage> message) const;
+                    void writeBatch(const std::string &batch) const;
 
                   protected:
                     virtual void queueLog(
@@ -74,6 +85,10 @@ namespace Aws
                     virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
 
                     virtual void flush() override;
+
+                    virtual std::uint64_t getDroppedCount() const override;
+
+                    virtual std::uint64_t getDroppedCount(LogLevel level) const override;
                 };
             } // namespace Logging
         } // namespace DeviceClient
@@ -0,0 +1,388 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SystemLogger.h"
+#include "BinaryLogFormat.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+constexpr char SystemLogger::DEFAULT_JOURNALD_SOCKET[];
+constexpr char SystemLogger::DEFAULT_SYSLOG_SOCKET[];
+constexpr char SystemLogger::IDENTIFIER[];
+constexpr size_t SystemLogger::MAX_BATCH_MESSAGES;
+constexpr size_t SystemLogger::MAX_MESSAGE_BYTES;
+constexpr size_t SystemLogger::MAX_SYSLOG_MSGID_LENGTH;
+constexpr int SystemLogger::SYSLOG_FACILITY;
+
+SystemLogger::~SystemLogger()
+{
+    if (socketFd >= 0)
+    {
+        close(socketFd);
+    }
+}
+
+int SystemLogger::toSyslogSeverity(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::ERROR:
+            return 3;
+        case LogLevel::WARN:
+            return 4;
+        case LogLevel::INFO:
+            return 6;
+        default:
+            return 7;
+    }
+}
+
+void SystemLogger::appendJournalField(string &record, const char *name, const char *value, size_t length)
+{
+    record.append(name);
+    if (memchr(value, '\n', length) == nullptr)
+    {
+        record.push_back('=');
+        record.append(value, length);
+    }
+    else
+    {
+        // A value spanning several lines is written as its little endian 64-bit length followed by the raw bytes
+        record.push_back('\n');
+        uint64_t size = length;
+        for (int i = 0; i < 8; i++)
+        {
+            record.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+        }
+        record.append(value, length);
+    }
+    record.push_back('\n');
+}
+
+bool SystemLogger::connectSocket()
+{
+    if (socketFd >= 0)
+    {
+        close(socketFd);
+        socketFd = -1;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        cout << LOGGER_TAG << FormatMessage(": Log socket path %s is too long", socketPath.c_str()) << endl;
+        return false;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to create a log socket, errno: %d", errno) << endl;
+        return false;
+    }
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        cout << LOGGER_TAG
+             << FormatMessage(": Failed to connect to log socket %s, errno: %d", socketPath.c_str(), errno) << endl;
+        close(fd);
+        return false;
+    }
+    socketFd = fd;
+    return true;
+}
+
+void SystemLogger::appendMessageText(LogMessage &message, string &record)
+{
+    const string *text = &message.getMessage();
+    if (message.isDeferred())
+    {
+        // Messages queued by a FileLogger in the binary log format are formatted here
+        scratch.clear();
+        if (!BinaryLogFormat::formatMessage(message.getMessage(), scratch))
+        {
+            scratch = "<malformed deferred log message>";
+        }
+        text = &scratch;
+    }
+    record.append(*text, 0, min(text->size(), MAX_MESSAGE_BYTES));
+}
+
+void SystemLogger::appendRecord(LogMessage &message)
+{
+    if (recordCount == MAX_BATCH_MESSAGES)
+    {
+        sendBatch();
+    }
+    if (records.size() <= recordCount)
+    {
+        records.emplace_back();
+    }
+    string &record = records[recordCount++];
+    record.clear();
+
+    char timestamp[LogUtil::TimestampFormatter::BUFFER_SIZE];
+    size_t timestampLength = timestampFormatter.format(message.getTime(), timestamp);
+    int severity = toSyslogSeverity(message.getLevel());
+
+    if (protocol == Protocol::JOURNALD)
+    {
+        string priority = to_string(severity);
+        string facility = to_string(SYSLOG_FACILITY);
+        appendJournalField(record, "PRIORITY", priority.c_str(), priority.size());
+        appendJournalField(record, "SYSLOG_FACILITY", facility.c_str(), facility.size());
+        appendJournalField(record, "SYSLOG_IDENTIFIER", IDENTIFIER, strlen(IDENTIFIER));
+        appendJournalField(record, "SYSLOG_PID", processId.c_str(), processId.size());
+        appendJournalField(record, "DEVICE_CLIENT_TAG", message.getTag().c_str(), message.getTag().size());
+        appendJournalField(record, "DEVICE_CLIENT_TIMESTAMP", timestamp, timestampLength);
+        messageText.clear();
+        appendMessageText(message, messageText);
+        appendJournalField(record, "MESSAGE", messageText.c_str(), messageText.size());
+        return;
+    }
+
+    // RFC 5424: <PRI>VERSION TIMESTAMP HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA MSG
+    record.push_back('<');
+    record.append(to_string(SYSLOG_FACILITY * 8 + severity));
+    record.append(">1 ");
+    record.append(timestamp, timestampLength);
+    record.push_back(' ');
+    record.append(hostName.empty() ? "-" : hostName);
+    record.push_back(' ');
+    record.append(IDENTIFIER);
+    record.push_back(' ');
+    record.append(processId);
+    record.push_back(' ');
+    // MSGID only allows printable US-ASCII characters without spaces
+    size_t msgIdLength = min(message.getTag().size(), MAX_SYSLOG_MSGID_LENGTH);
+    for (size_t i = 0; i < msgIdLength; i++)
+    {
+        char c = message.getTag()[i];
+        record.push_back(c > ' ' && c < 127 ? c : '_');
+    }
+    if (msgIdLength == 0)
+    {
+        record.push_back('-');
+    }
+    record.append(" - ");
+    appendMessageText(message, record);
+}
+
+int SystemLogger::sendRecords(size_t first)
+{
+    size_t count = recordCount - first;
+#if defined(__linux__)
+    struct iovec vectors[MAX_BATCH_MESSAGES];
+    struct mmsghdr headers[MAX_BATCH_MESSAGES];
+    memset(headers, 0, sizeof(headers));
+    for (size_t i = 0; i < count; i++)
+    {
+        vectors[i].iov_base = const_cast<char *>(records[first + i].data());
+        vectors[i].iov_len = records[first + i].size();
+        headers[i].msg_hdr.msg_iov = &vectors[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    return sendmmsg(socketFd, headers, static_cast<unsigned int>(count), MSG_NOSIGNAL);
+#else
+    (void)count;
+    const string &record = records[first];
+    return send(socketFd, record.data(), record.size(), 0) < 0 ? -1 : 1;
+#endif
+}
+
+void SystemLogger::sendBatch()
+{
+    size_t sent = 0;
+    bool reconnected = false;
+    while (sent < recordCount)
+    {
+        int result = socketFd < 0 ? -1 : sendRecords(sent);
+        if (result > 0)
+        {
+            sent += static_cast<size_t>(result);
+            continue;
+        }
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result < 0 && errno == EMSGSIZE)
+        {
+            cout << LOGGER_TAG << ": Dropped a log message too large for the log socket" << endl;
+            sent++;
+            continue;
+        }
+        // The system log may have been restarted, which invalidates the connection
+        if (!reconnected && connectSocket())
+        {
+            reconnected = true;
+            continue;
+        }
+        cout << LOGGER_TAG
+             << FormatMessage(
+                    ": Failed to send %zu log messages to %s, errno: %d", recordCount - sent, socketPath.c_str(), errno)
+             << endl;
+        break;
+    }
+    recordCount = 0;
+}
+
+void SystemLogger::run()
+{
+    vector<unique_ptr<LogMessage>> suppressionReports;
+    while (!needsShutdown)
+    {
+        // Block until at least one message is available, then take everything else that is already queued so that
+        // a burst of messages costs a single system call. The batch lock keeps flush() from sending newer messages
+        // ahead of a batch that is still being sent.
+        lock_guard<mutex> batchGuard(batchLock);
+        unique_ptr<LogMessage> message = logQueue->getNextLog();
+        unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, false);
+        if (nullptr != dropReport)
+        {
+            appendRecord(*dropReport);
+        }
+        takeSuppressionReports(suppressionReports, false);
+        for (auto &report : suppressionReports)
+        {
+            appendRecord(*report);
+        }
+        suppressionReports.clear();
+        while (nullptr != message)
+        {
+            appendRecord(*message);
+            if (recordCount >= MAX_BATCH_MESSAGES || !logQueue->hasNextLog())
+            {
+                break;
+            }
+            message = logQueue->getNextLog();
+        }
+
+        if (recordCount > 0)
+        {
+            sendBatch();
+        }
+    }
+}
+
+bool SystemLogger::start(const PlainConfig &config)
+{
+    setLogLevel(config.logConfig.deviceClientlogLevel);
+    protocol = config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_SYSLOG ? Protocol::SYSLOG
+                                                                                                : Protocol::JOURNALD;
+    socketPath = config.logConfig.deviceClientLogSocket;
+    if (socketPath.empty())
+    {
+        socketPath = protocol == Protocol::SYSLOG ? DEFAULT_SYSLOG_SOCKET : DEFAULT_JOURNALD_SOCKET;
+    }
+
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) == 0)
+    {
+        hostName = host;
+    }
+    processId = to_string(getpid());
+
+    if (!connectSocket())
+    {
+        return false;
+    }
+    configureQueue(logQueue, config.logConfig);
+    rateLimiter.configure(config.logConfig.rateLimitPerSecond, config.logConfig.rateLimitBurst);
+
+    thread log_thread(&SystemLogger::run, this);
+    log_thread.detach();
+
+    return true;
+}
+
+void SystemLogger::stop()
+{
+    needsShutdown = true;
+    logQueue->shutdown();
+}
+
+unique_ptr<LogQueue> SystemLogger::takeLogQueue()
+{
+    unique_ptr<LogQueue> tmp = std::move(logQueue);
+    logQueue = unique_ptr<LogQueue>(new LogQueue);
+    return tmp;
+}
+
+void SystemLogger::setLogQueue(std::unique_ptr<LogQueue> incomingQueue)
+{
+    this->logQueue = std::move(incomingQueue);
+}
+
+void SystemLogger::shutdown()
+{
+    needsShutdown = true;
+    logQueue->shutdown();
+
+    // If we've gotten here, we must be shutting down so we should dump the remaining messages and exit
+    flush();
+}
+
+void SystemLogger::flush()
+{
+    lock_guard<mutex> batchGuard(batchLock);
+    while (logQueue->hasNextLog())
+    {
+        unique_ptr<LogMessage> message = logQueue->getNextLog();
+        if (nullptr != message)
+        {
+            appendRecord(*message);
+        }
+    }
+
+    unique_ptr<LogMessage> dropReport = takeDropReport(*logQueue, true);
+    if (nullptr != dropReport)
+    {
+        appendRecord(*dropReport);
+    }
+    vector<unique_ptr<LogMessage>> suppressionReports;
+    takeSuppressionReports(suppressionReports, true);
+    for (auto &report : suppressionReports)
+    {
+        appendRecord(*report);
+    }
+
+    if (recordCount > 0)
+    {
+        sendBatch();
+    }
+}
+
+uint64_t SystemLogger::getDroppedCount() const
+{
+    return logQueue->getDroppedCount();
+}
+
+uint64_t SystemLogger::getDroppedCount(LogLevel level) const
+{
+    return logQueue->getDroppedCount(level);
+}
+
+void SystemLogger::queueLog(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> t,
+    const std::string &message)
+{
+    logQueue.get()->addLog(unique_ptr<LogMessage>(new LogMessage(level, tag, t, message)));
+}
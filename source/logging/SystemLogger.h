@@ -0,0 +1,218 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SYSTEMLOGGER_H
+#define DEVICE_CLIENT_SYSTEMLOGGER_H
+
+#include "LogLevel.h"
+#include "LogQueue.h"
+#include "Logger.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Logging implementation that sends each log message as a structured record to the system
+                 * log over a Unix datagram socket
+                 *
+                 * Two protocols are supported. The journald native protocol sends the message, the priority and the
+                 * tag of a log message as separate journal fields, so that `journalctl -p` and field matches work
+                 * without parsing the message. The syslog protocol sends RFC 5424 messages, with the log level as the
+                 * severity and the tag as the MSGID. Every message available in the queue is sent in a single system
+                 * call where the platform supports it.
+                 */
+                class SystemLogger final : public Logger
+                {
+                  public:
+                    /**
+                     * \brief The socket the journald protocol is sent to unless another one is configured
+                     */
+                    static constexpr char DEFAULT_JOURNALD_SOCKET[] = "/run/systemd/journal/socket";
+                    /**
+                     * \brief The socket the syslog protocol is sent to unless another one is configured
+                     */
+                    static constexpr char DEFAULT_SYSLOG_SOCKET[] = "/dev/log";
+                    /**
+                     * \brief Identifier of the Device Client in the system log
+                     */
+                    static constexpr char IDENTIFIER[] = "aws-iot-device-client";
+
+                    enum class Protocol
+                    {
+                        JOURNALD,
+                        SYSLOG
+                    };
+
+                  private:
+                    /**
+                     * \brief Flag used to notify underlying threads that they should discontinue any processing
+                     * so that the application can safely shutdown
+                     */
+                    bool needsShutdown = false;
+                    /**
+                     * \brief The maximum number of log messages sent with a single system call
+                     */
+                    static constexpr size_t MAX_BATCH_MESSAGES = 64;
+                    /**
+                     * \brief Messages longer than this are truncated so that each record fits in a datagram
+                     */
+                    static constexpr size_t MAX_MESSAGE_BYTES = 32 * 1024;
+                    /**
+                     * \brief RFC 5424 limits the MSGID field, which holds the tag, to 32 characters
+                     */
+                    static constexpr size_t MAX_SYSLOG_MSGID_LENGTH = 32;
+                    /**
+                     * \brief Syslog facility of the records, LOG_DAEMON
+                     */
+                    static constexpr int SYSLOG_FACILITY = 3;
+
+                    /**
+                     * \brief a LogQueue instance used to queue incoming log messages for processing
+                     */
+                    std::unique_ptr<LogQueue> logQueue = std::unique_ptr<LogQueue>(new LogQueue);
+                    /**
+                     * \brief Held while a batch of log messages is taken from the LogQueue and sent
+                     */
+                    std::mutex batchLock;
+                    /**
+                     * \brief The encoded records of the current batch, reused across batches, only used while holding
+                     * batchLock
+                     */
+                    std::vector<std::string> records;
+                    /**
+                     * \brief Number of records of the current batch
+                     */
+                    size_t recordCount = 0;
+                    /**
+                     * \brief Scratch buffer used to format deferred messages
+                     */
+                    std::string scratch;
+                    /**
+                     * \brief Scratch buffer holding the text of a message before it is encoded as a journal field
+                     */
+                    std::string messageText;
+                    /**
+                     * \brief Formats the timestamps of the records, only used while holding batchLock
+                     */
+                    LogUtil::TimestampFormatter timestampFormatter;
+
+                    Protocol protocol = Protocol::JOURNALD;
+                    std::string socketPath;
+                    int socketFd = -1;
+                    /**
+                     * \brief The host name and process id written into every syslog record
+                     */
+                    std::string hostName;
+                    std::string processId;
+
+                    /**
+                     * \brief Begins processing of log messages in the LogQueue
+                     *
+                     * Every message available in the queue, up to MAX_BATCH_MESSAGES, is encoded into a record and
+                     * the records are sent together. This method will check to make sure the shutdown() method has
+                     * not been called before processing any additional messages in the queue.
+                     */
+                    void run();
+
+                    /**
+                     * \brief Creates the socket and connects it to the configured path
+                     *
+                     * @return true if the socket is connected
+                     */
+                    bool connectSocket();
+
+                    /**
+                     * \brief Encodes a log message into the next record of the batch, in the configured protocol
+                     */
+                    void appendRecord(LogMessage &message);
+
+                    /**
+                     * \brief Sends the records of the current batch and empties it
+                     *
+                     * If the system log is restarted, the socket is connected again once before the batch is given up.
+                     */
+                    void sendBatch();
+
+                    /**
+                     * \brief Sends the records of the current batch, from the given index on, with a single system
+                     * call where sendmmsg(2) is available and one record at a time otherwise
+                     *
+                     * @param first the index of the first record to send
+                     * @return the number of records sent, or -1 on error
+                     */
+                    int sendRecords(size_t first);
+
+                    /**
+                     * \brief Appends the text of a message, formatting it first if it was deferred, and truncating it
+                     * to MAX_MESSAGE_BYTES
+                     */
+                    void appendMessageText(LogMessage &message, std::string &record);
+
+                  protected:
+                    virtual void queueLog(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> t,
+                        const std::string &message) override;
+
+                  public:
+                    SystemLogger() = default;
+                    ~SystemLogger();
+
+                    // Non-copyable.
+                    SystemLogger(const SystemLogger &) = delete;
+                    SystemLogger &operator=(const SystemLogger &) = delete;
+
+                    /**
+                     * \brief Returns the syslog severity of a log level, which journald calls the priority
+                     */
+                    static int toSyslogSeverity(LogLevel level);
+
+                    /**
+                     * \brief Appends a field in the journald native protocol, using the binary form of the field
+                     * when its value contains a newline
+                     *
+                     * @param record the record to append the field to
+                     * @param name the field name, made of uppercase letters, digits and underscores
+                     * @param value the field value
+                     * @param length the length of the value
+                     */
+                    static void appendJournalField(
+                        std::string &record,
+                        const char *name,
+                        const char *value,
+                        size_t length);
+
+                    virtual bool start(const PlainConfig &config) override;
+
+                    virtual void stop() override;
+
+                    virtual void shutdown() override;
+
+                    virtual std::unique_ptr<LogQueue> takeLogQueue() override;
+
+                    virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
+
+                    virtual void flush() override;
+
+                    virtual std::uint64_t getDroppedCount() const override;
+
+                    virtual std::uint64_t getDroppedCount(LogLevel level) const override;
+                };
+            } // namespace Logging
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SYSTEMLOGGER_H
@@ -0,0 +1,70 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../BinaryLogFormat.h"
+#include "../Logger.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+/**
+ * \brief Decodes a log file written by the Device Client in the binary log format back to the text log format
+ *
+ * Usage: dc-logdecode <binary-log-file> [output-file]
+ *
+ * The decoded log is written to stdout unless an output file is given.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        cerr << "Usage: " << argv[0] << " <binary-log-file> [output-file]" << endl;
+        return 1;
+    }
+
+    ifstream input(argv[1], ios::in | ios::binary);
+    if (!input.is_open())
+    {
+        cerr << "Failed to open " << argv[1] << " for reading" << endl;
+        return 1;
+    }
+
+    ofstream outputFile;
+    if (argc == 3)
+    {
+        outputFile.open(argv[2], ios::out | ios::trunc);
+        if (!outputFile.is_open())
+        {
+            cerr << "Failed to open " << argv[2] << " for writing" << endl;
+            return 1;
+        }
+    }
+    ostream &output = argc == 3 ? outputFile : cout;
+
+    BinaryLogFormat::Reader reader(input);
+    LogUtil::TimestampFormatter timestampFormatter;
+    string line;
+    for (unique_ptr<LogMessage> message = reader.next(); message != nullptr; message = reader.next())
+    {
+        line.clear();
+        LogUtil::appendLogLine(*message, line, timestampFormatter);
+        output << line;
+    }
+    output.flush();
+
+    if (!reader.getError().empty())
+    {
+        cerr << "Failed to decode " << argv[1] << ": " << reader.getError() << endl;
+        return 1;
+    }
+    if (!output)
+    {
+        cerr << "Failed to write the decoded log" << endl;
+        return 1;
+    }
+    return 0;
+}
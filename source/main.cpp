@@ -178,6 +178,32 @@ void deviceClientAbort(const string &reason, int exitCode)
     exit(exitCode);
 }
 
+/**
+ * \brief Reads the configuration again and applies the sensor publish settings, leaving the MQTT connection and the
+ * other features running
+ *
+ * @param cliArgs the command line arguments the device client was started with
+ */
+void reloadSensorPublish(const CliArgs &cliArgs)
+{
+#if !defined(EXCLUDE_SENSOR_PUBLISH) && !defined(DISABLE_MQTT)
+    shared_ptr<Feature> sensorPublish = features->get(SensorPublishFeature::NAME);
+    if (!sensorPublish)
+    {
+        LOG_INFO(TAG, "Sensor Publish is disabled, the device client must be restarted to enable it");
+        return;
+    }
+
+    Config reloaded;
+    if (!reloaded.init(cliArgs))
+    {
+        LOG_ERROR(TAG, "Unable to reload configuration, sensor publish settings are unchanged");
+        return;
+    }
+    static_pointer_cast<SensorPublishFeature>(sensorPublish)->reconfigure(reloaded.config);
+#endif
+}
+
 void attemptConnection()
 {
     try
@@ -639,6 +665,7 @@ int main(int argc, char *argv[])
                 break;
             case SIGHUP:
                 resourceManager->dumpMemTrace();
+                reloadSensorPublish(cliArgs);
                 break;
             default:
                 break;
@@ -1,4 +1,4 @@
-// Serve lines from a file over a Unix Domain Socket.
+// Serve lines from a file over a Unix Domain Socket, or over a shared memory ring passed to the client through it.
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -18,6 +18,8 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include "../../../sensor-publish/SensorShmRing.h"
+
 // Wrapper for system call errors.
 class syscall_error : public std::runtime_error
 {
@@ -91,6 +93,32 @@ std::vector<std::string> read(const std::string &filename, const std::string &de
     return lines;
 }
 
+// closed_by_peer checks without blocking whether the client closed the connection.
+bool closed_by_peer(int clientfd)
+{
+    char byte;
+    ssize_t count = recv(clientfd, &byte, sizeof(byte), MSG_DONTWAIT | MSG_PEEK);
+    return count == 0 || (count == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+// write_ring appends one line to the ring, waiting while it is full. Returns false once the client closed.
+bool write_ring(struct dc_shm_ring *ring, int clientfd, const std::string &line)
+{
+    while (dc_shm_ring_write(ring, line.data(), line.size()) == -1)
+    {
+        if (errno != EAGAIN)
+        {
+            throw syscall_error("Error writing shared memory ring", errno);
+        }
+        if (closed_by_peer(clientfd))
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     std::string filename = getenv("FILENAME", _s("/src/.marcoaz/sample-sensor-data.txt"));
@@ -99,6 +127,8 @@ int main(int argc, char *argv[])
     unsigned int delay_ms = getenv("DELAY_MS", 1000U);
     bool repeat_file = getenv("REPEAT_FILE", true);
     bool check_peercred = getenv("CHECK_PEERCRED", true);
+    bool shm = getenv("TRANSPORT", _s("unix-stream")) == "shm";
+    uint64_t shm_capacity = getenv("SHM_CAPACITY", static_cast<uint64_t>(1U << 20));
 
     // Ignore SIGPIPE and handle errors when remote closes on write.
     signal(SIGPIPE, SIG_IGN);
@@ -180,6 +210,23 @@ int main(int argc, char *argv[])
             }
         }
 
+        // Pass a new ring to each client, a previous client may still have the last one mapped.
+        struct dc_shm_ring ring;
+        if (shm)
+        {
+            if (dc_shm_ring_create(&ring, "sensor-publish-example-server", shm_capacity) == -1)
+            {
+                throw syscall_error("Error creating shared memory ring", errno);
+            }
+            if (dc_shm_ring_send(&ring, clientfd) == -1)
+            {
+                std::cerr << "client connection closed before the shared memory ring was passed\n";
+                dc_shm_ring_destroy(&ring);
+                close(clientfd);
+                continue;
+            }
+        }
+
         bool closed = false;
 
         // Write file until client closes connection.
@@ -188,7 +235,12 @@ int main(int argc, char *argv[])
             for (const auto &line : lines)
             {
                 // Send one line to the client.
-                std::string::size_type nbytes = 0;
+                if (shm && !write_ring(&ring, clientfd, line))
+                {
+                    closed = true;
+                    break;
+                }
+                std::string::size_type nbytes = shm ? line.size() : 0;
                 while (nbytes != line.size())
                 {
                     ssize_t count = write(clientfd, &line[nbytes], line.size() - nbytes);
@@ -230,6 +282,10 @@ int main(int argc, char *argv[])
         }
 
         // Close server connection with client.
+        if (shm)
+        {
+            dc_shm_ring_destroy(&ring);
+        }
         close(clientfd);
     }
 
@@ -0,0 +1,362 @@
+// Serve generated messages to sensor publish over one or more Unix Domain Sockets, at a paced rate.
+//
+// Each message starts with the time it was generated, in nanoseconds of the steady clock, followed by a space, filler
+// characters and the delimiter. The time lets a reader measure the latency of each message.
+#ifndef SENSOR_PUBLISH_LOAD_GENERATOR_H
+#define SENSOR_PUBLISH_LOAD_GENERATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace load_generator
+{
+    // Wrapper for system call errors.
+    class syscall_error : public std::runtime_error
+    {
+      public:
+        syscall_error(const std::string &msg, int errnum) : std::runtime_error(msg), errno_(errnum)
+        {
+            std::ostringstream oss;
+            oss << msg << ": " << std::strerror(errno_) << " (" << errno_ << ")";
+            what_ = oss.str();
+        }
+
+        virtual const char *what() const noexcept { return what_.c_str(); }
+
+        std::string what_;
+        int errno_;
+    };
+
+    // Longest time a thread blocks before checking whether the generator stopped.
+    constexpr int POLL_TIMEOUT_MS = 100;
+
+    // How the size of each message is drawn, the size includes the delimiter.
+    enum class size_dist
+    {
+        fixed,    // Every message is size bytes.
+        uniform,  // Uniform between size_min and size_max.
+        normal    // Normal around size with size_stddev, clamped between size_min and size_max.
+    };
+
+    struct options
+    {
+        std::string path{"/tmp/sensors/load-generator"};
+        unsigned int sockets{1};
+        double rate{1000};  // Messages per second on each socket, 0 to write as fast as the reader keeps up.
+        size_dist dist{size_dist::fixed};
+        std::size_t size{128};
+        std::size_t size_min{32};
+        std::size_t size_max{1024};
+        double size_stddev{32};
+        std::string delim{"\n"};
+        std::size_t burst{64};  // Most messages generated for one write.
+    };
+
+    // Counters of one socket, updated by its thread.
+    struct counters
+    {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> connections{0};
+        std::atomic<uint64_t> cpu_nanos{0};  // CPU time of the thread serving the socket.
+    };
+
+    // parse_size_dist converts the name of a size distribution, throwing for an unknown name.
+    inline size_dist parse_size_dist(const std::string &name)
+    {
+        if (name == "fixed")
+        {
+            return size_dist::fixed;
+        }
+        if (name == "uniform")
+        {
+            return size_dist::uniform;
+        }
+        if (name == "normal")
+        {
+            return size_dist::normal;
+        }
+        throw std::runtime_error("Unknown size distribution: " + name);
+    }
+
+    // socket_path returns the path of a socket, suffixed with its index when there are several.
+    inline std::string socket_path(const std::string &path, unsigned int index, unsigned int sockets)
+    {
+        return sockets > 1 ? path + "-" + std::to_string(index) : path;
+    }
+
+    // now_nanos returns the steady clock time embedded in messages.
+    inline uint64_t now_nanos()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    // thread_cpu_nanos returns the CPU time of the calling thread.
+    inline uint64_t thread_cpu_nanos()
+    {
+        struct timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == -1)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    // parse_timestamp reads the generation time at the start of a message, returns false when there is none.
+    inline bool parse_timestamp(const char *begin, const char *end, uint64_t &nanos)
+    {
+        nanos = 0;
+        const char *p = begin;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            nanos = nanos * 10 + static_cast<uint64_t>(*p - '0');
+            ++p;
+        }
+        return p != begin && p < end && *p == ' ';
+    }
+
+    // generator listens on each socket from its own thread, and streams messages to the client connected to it
+    // until the client closes or stop is called. One client is served at a time on each socket.
+    class generator
+    {
+      public:
+        explicit generator(const options &opts) : opts_(opts)
+        {
+            if (opts_.sockets == 0 || opts_.burst == 0 || opts_.delim.empty() || opts_.rate < 0)
+            {
+                throw std::runtime_error("Invalid load generator options");
+            }
+            for (unsigned int i = 0; i < opts_.sockets; ++i)
+            {
+                counters_.emplace_back(new counters());
+            }
+        }
+
+        ~generator() { stop(); }
+
+        generator(const generator &) = delete;
+        generator &operator=(const generator &) = delete;
+
+        // start binds every socket before returning, so that a client may connect at once.
+        void start()
+        {
+            running_ = true;
+            for (unsigned int i = 0; i < opts_.sockets; ++i)
+            {
+                int listenfd = listen_on(socket_path(opts_.path, i, opts_.sockets));
+                threads_.emplace_back([this, i, listenfd]() { serve(i, listenfd); });
+            }
+        }
+
+        // stop closes every socket, and waits for their threads to exit.
+        void stop()
+        {
+            running_ = false;
+            for (auto &thread : threads_)
+            {
+                thread.join();
+            }
+            threads_.clear();
+        }
+
+        const options &get_options() const { return opts_; }
+
+        const counters &get_counters(unsigned int index) const { return *counters_[index]; }
+
+      private:
+        using clock = std::chrono::steady_clock;
+
+        options opts_;
+        std::vector<std::unique_ptr<counters>> counters_;
+        std::vector<std::thread> threads_;
+        std::atomic<bool> running_{false};
+
+        // listen_on creates a socket bound to path, replacing any file at path.
+        static int listen_on(const std::string &path)
+        {
+            struct sockaddr_un addr;
+            if (path.size() > sizeof(addr.sun_path) - 1)
+            {
+                throw std::runtime_error("Socket path too long");
+            }
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            unlink(path.c_str());
+
+            int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd == -1)
+            {
+                throw syscall_error("Error creating socket", errno);
+            }
+            if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1 ||
+                listen(fd, SOMAXCONN) == -1)
+            {
+                int errnum = errno;
+                close(fd);
+                throw syscall_error("Error listening on socket " + path, errnum);
+            }
+            return fd;
+        }
+
+        // wait_for waits up to POLL_TIMEOUT_MS for fd to be ready, returns false once stopped.
+        bool wait_for(int fd, short events) const
+        {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = events;
+            pfd.revents = 0;
+            poll(&pfd, 1, POLL_TIMEOUT_MS);
+            return running_;
+        }
+
+        // write_all writes the whole buffer, returns false once the client closed or the generator stopped.
+        bool write_all(int clientfd, const std::string &buf) const
+        {
+            std::size_t nbytes = 0;
+            while (nbytes != buf.size())
+            {
+                ssize_t count = send(clientfd, &buf[nbytes], buf.size() - nbytes, MSG_NOSIGNAL);
+                if (count == -1)
+                {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        if (!wait_for(clientfd, POLLOUT))
+                        {
+                            return false;
+                        }
+                    }
+                    else if (errno != EINTR)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                nbytes += static_cast<std::size_t>(count);
+            }
+            return true;
+        }
+
+        // append_message appends one message of the given size, never shorter than its timestamp and delimiter.
+        void append_message(std::string &buf, std::size_t size, uint64_t nanos) const
+        {
+            std::size_t start = buf.size();
+            buf.append(std::to_string(nanos));
+            buf.push_back(' ');
+            std::size_t used = buf.size() - start + opts_.delim.size();
+            if (size > used)
+            {
+                buf.append(size - used, 'x');
+            }
+            buf.append(opts_.delim);
+        }
+
+        // due returns the number of messages to write now, at most opts_.burst, sleeping when none is due yet.
+        std::size_t due(clock::time_point start, uint64_t sent) const
+        {
+            if (opts_.rate == 0)
+            {
+                return opts_.burst;
+            }
+            auto now = clock::now();
+            auto messages = static_cast<uint64_t>(std::chrono::duration<double>(now - start).count() * opts_.rate);
+            if (messages > sent)
+            {
+                return static_cast<std::size_t>(std::min<uint64_t>(messages - sent, opts_.burst));
+            }
+            std::chrono::duration<double> next(static_cast<double>(sent + 1) / opts_.rate);
+            std::this_thread::sleep_until(std::min(
+                start + std::chrono::duration_cast<clock::duration>(next),
+                now + std::chrono::milliseconds(POLL_TIMEOUT_MS)));
+            return 0;
+        }
+
+        void serve(unsigned int index, int listenfd)
+        {
+            counters &stats = *counters_[index];
+            std::mt19937 rng(index);
+            std::uniform_int_distribution<std::size_t> uniform(
+                opts_.size_min, std::max(opts_.size_min, opts_.size_max));
+            std::normal_distribution<double> normal(static_cast<double>(opts_.size), opts_.size_stddev);
+            auto next_size = [&]() -> std::size_t {
+                switch (opts_.dist)
+                {
+                    case size_dist::uniform:
+                        return uniform(rng);
+                    case size_dist::normal:
+                    {
+                        double size = std::max(0.0, normal(rng));
+                        return std::min(opts_.size_max, std::max(opts_.size_min, static_cast<std::size_t>(size)));
+                    }
+                    default:
+                        return opts_.size;
+                }
+            };
+
+            std::string buf;
+            while (wait_for(listenfd, POLLIN))
+            {
+                int clientfd = accept4(listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (clientfd == -1)
+                {
+                    continue;
+                }
+                ++stats.connections;
+
+                // Messages are due at a steady pace from the time the client connected, a write which falls behind
+                // catches up with bursts of up to opts_.burst messages.
+                auto start = clock::now();
+                uint64_t sent = 0;
+                while (running_)
+                {
+                    std::size_t count = due(start, sent);
+                    if (count == 0)
+                    {
+                        continue;
+                    }
+
+                    buf.clear();
+                    uint64_t nanos = now_nanos();
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        append_message(buf, next_size(), nanos);
+                    }
+                    if (!write_all(clientfd, buf))
+                    {
+                        break;
+                    }
+                    sent += count;
+                    stats.messages += count;
+                    stats.bytes += buf.size();
+                    stats.cpu_nanos = thread_cpu_nanos();
+                }
+                close(clientfd);
+            }
+            close(listenfd);
+            stats.cpu_nanos = thread_cpu_nanos();
+        }
+    };
+} // namespace load_generator
+
+#endif // SENSOR_PUBLISH_LOAD_GENERATOR_H
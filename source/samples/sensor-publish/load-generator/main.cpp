@@ -0,0 +1,133 @@
+// Generate sensor messages at a configured rate and size distribution over one or more Unix Domain Sockets, and
+// report the achieved rate.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+
+#include "LoadGenerator.h"
+
+// getenv reads value from environment and converts to any type.
+template <typename T> T getenv(const std::string &name, const T &default_value)
+{
+    auto psv = std::getenv(name.c_str());
+    if (psv)
+    {
+        T val;
+        std::istringstream iss;
+        iss.str(psv);
+        iss >> val;
+        return val;
+    }
+    return default_value;
+}
+
+// _s converts the null terminated string to std::string.
+std::string _s(const char *ps)
+{
+    return std::string(ps);
+}
+
+// Set by SIGINT and SIGTERM to print the totals before exiting.
+volatile sig_atomic_t stopped = 0;
+
+void on_signal(int)
+{
+    stopped = 1;
+}
+
+// Totals of all sockets.
+struct totals
+{
+    uint64_t messages{0};
+    uint64_t bytes{0};
+    uint64_t connections{0};
+};
+
+totals sum(const load_generator::generator &gen)
+{
+    totals t;
+    for (unsigned int i = 0; i < gen.get_options().sockets; ++i)
+    {
+        const load_generator::counters &c = gen.get_counters(i);
+        t.messages += c.messages;
+        t.bytes += c.bytes;
+        t.connections += c.connections;
+    }
+    return t;
+}
+
+int main()
+{
+    load_generator::options opts;
+    opts.path = getenv("SUN_PATH", _s("/tmp/sensors/load-generator"));
+    opts.sockets = getenv("SOCKETS", 1U);
+    opts.rate = getenv("RATE", 1000.0);
+    opts.dist = load_generator::parse_size_dist(getenv("SIZE_DIST", _s("fixed")));
+    opts.size = getenv("MSG_SIZE", static_cast<std::size_t>(128));
+    opts.size_min = getenv("SIZE_MIN", static_cast<std::size_t>(32));
+    opts.size_max = getenv("SIZE_MAX", static_cast<std::size_t>(1024));
+    opts.size_stddev = getenv("SIZE_STDDEV", 32.0);
+    opts.delim = getenv("DELIM", _s("\n"));
+    opts.burst = getenv("BURST", static_cast<std::size_t>(64));
+    unsigned int duration_sec = getenv("DURATION_SEC", 0U);
+    unsigned int report_sec = getenv("REPORT_SEC", 1U);
+
+    // The delimiter of an environment variable cannot hold a new line, so accept it escaped.
+    if (opts.delim == "\\n")
+    {
+        opts.delim = "\n";
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    load_generator::generator gen(opts);
+    gen.start();
+    for (unsigned int i = 0; i < opts.sockets; ++i)
+    {
+        std::cout << "listening: " << load_generator::socket_path(opts.path, i, opts.sockets) << "\n";
+    }
+
+    // Report the rate achieved over each interval, across all sockets.
+    auto start = std::chrono::steady_clock::now();
+    auto last_time = start;
+    totals last;
+    auto end = start + std::chrono::seconds(duration_sec);
+    while (!stopped && (duration_sec == 0 || std::chrono::steady_clock::now() < end))
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(report_sec > 0 ? report_sec : 1));
+        auto now = std::chrono::steady_clock::now();
+        totals t = sum(gen);
+        double seconds = std::chrono::duration<double>(now - last_time).count();
+        std::printf(
+            "connections: %llu rate: %.0f msg/s %.0f B/s target: %.0f msg/s\n",
+            static_cast<unsigned long long>(t.connections),
+            static_cast<double>(t.messages - last.messages) / seconds,
+            static_cast<double>(t.bytes - last.bytes) / seconds,
+            opts.rate * opts.sockets);
+        std::fflush(stdout);
+        last = t;
+        last_time = now;
+    }
+
+    gen.stop();
+    totals t = sum(gen);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf(
+        "total: %llu messages %llu bytes in %.1f s, %.0f msg/s %.0f B/s\n",
+        static_cast<unsigned long long>(t.messages),
+        static_cast<unsigned long long>(t.bytes),
+        seconds,
+        static_cast<double>(t.messages) / seconds,
+        static_cast<double>(t.bytes) / seconds);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,90 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BatchController.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr chrono::milliseconds BatchController::UPDATE_INTERVAL;
+constexpr double BatchController::SMOOTHING;
+
+namespace
+{
+    double smooth(double average, double sample, bool &initialized)
+    {
+        if (!initialized)
+        {
+            initialized = true;
+            return sample;
+        }
+        return average + BatchController::SMOOTHING * (sample - average);
+    }
+} // namespace
+
+BatchController::BatchController(chrono::milliseconds targetLatency, size_t maxPayloadBytes, TimePointT start)
+    : mTargetLatency(targetLatency), mMaxPayloadBytes(max<size_t>(1, maxPayloadBytes)), mIntervalStart(start),
+      mBatchTime(targetLatency)
+{
+}
+
+void BatchController::onMessages(size_t count, size_t bytes)
+{
+    mIntervalMessages += count;
+    mIntervalBytes += bytes;
+}
+
+void BatchController::onPuback(chrono::microseconds latency)
+{
+    mIntervalPubackMicros += static_cast<uint64_t>(max<int64_t>(0, latency.count()));
+    ++mIntervalPubacks;
+}
+
+bool BatchController::update(TimePointT now)
+{
+    auto elapsed = now - mIntervalStart;
+    if (elapsed < UPDATE_INTERVAL)
+    {
+        return false;
+    }
+
+    double seconds = chrono::duration<double>(elapsed).count();
+    mArrivalRate = smooth(mArrivalRate, static_cast<double>(mIntervalMessages) / seconds, mHaveRate);
+    if (mIntervalMessages > 0)
+    {
+        mMessageBytes = smooth(
+            mMessageBytes,
+            static_cast<double>(mIntervalBytes) / static_cast<double>(mIntervalMessages),
+            mHaveMessageBytes);
+    }
+    if (mIntervalPubacks > 0)
+    {
+        mPubackLatencyMs = smooth(
+            mPubackLatencyMs,
+            static_cast<double>(mIntervalPubackMicros) / static_cast<double>(mIntervalPubacks) / 1000.0,
+            mHavePuback);
+    }
+    mIntervalStart = now;
+    mIntervalMessages = 0;
+    mIntervalBytes = 0;
+    mIntervalPubackMicros = 0;
+    mIntervalPubacks = 0;
+
+    // Leave the time a PUBACK takes out of the target latency, publishing at once when there is none left.
+    double batchMs = max(0.0, static_cast<double>(mTargetLatency.count()) - mPubackLatencyMs);
+    double batchSize = floor(mArrivalRate * batchMs / 1000.0);
+    if (mMessageBytes > 0)
+    {
+        batchSize = min(batchSize, floor(static_cast<double>(mMaxPayloadBytes) / mMessageBytes));
+    }
+    size_t size = batchSize < 1 ? 1 : static_cast<size_t>(batchSize);
+    chrono::milliseconds time(static_cast<int64_t>(batchMs));
+
+    bool changed = size != mBatchSize || time != mBatchTime;
+    mBatchSize = size;
+    mBatchTime = time;
+    return changed;
+}
@@ -0,0 +1,142 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BATCHCONTROLLER_H
+#define DEVICE_CLIENT_BATCHCONTROLLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief BatchController adapts the batch size and batch time of a sensor to its traffic.
+                 *
+                 * A message waits in the read buffer for up to the batch time and then for its PUBACK, so the batch
+                 * time is what remains of the target latency once the observed PUBACK latency is taken off. The batch
+                 * size is the number of messages expected to arrive during the batch time at the observed arrival
+                 * rate, so that a batch usually fills just as its time runs out, and it is capped so that a batch of
+                 * the observed average message size fits in the maximum payload. Until the arrival rate is known,
+                 * every message is published on its own.
+                 *
+                 * Observations are accumulated over an update interval and smoothed with an exponentially weighted
+                 * moving average. Time is passed in by the caller, so that the controller can be driven by a trace.
+                 *
+                 * Not thread safe, a controller is only used from the event loop of its sensor.
+                 */
+                class BatchController
+                {
+                  public:
+                    using TimePointT = std::chrono::high_resolution_clock::time_point;
+
+                    /**
+                     * \brief Interval over which arrivals are counted before the batch settings are updated
+                     */
+                    static constexpr std::chrono::milliseconds UPDATE_INTERVAL{250};
+
+                    /**
+                     * \brief Weight of the latest interval in the moving averages
+                     */
+                    static constexpr double SMOOTHING = 0.25;
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param targetLatency the latency targeted from reading a message to its PUBACK
+                     * @param maxPayloadBytes the largest batch to publish, in bytes
+                     * @param start the time from which arrivals are counted
+                     */
+                    BatchController(
+                        std::chrono::milliseconds targetLatency,
+                        std::size_t maxPayloadBytes,
+                        TimePointT start);
+
+                    /**
+                     * \brief Record messages read from the sensor
+                     */
+                    void onMessages(std::size_t count, std::size_t bytes);
+
+                    /**
+                     * \brief Record the latency of a PUBACK
+                     */
+                    void onPuback(std::chrono::microseconds latency);
+
+                    /**
+                     * \brief Update the batch settings once the update interval elapsed
+                     *
+                     * @return true when the batch size or the batch time changed
+                     */
+                    bool update(TimePointT now);
+
+                    /**
+                     * @return the number of messages in a batch, at least 1
+                     */
+                    std::size_t getBatchSize() const { return mBatchSize; }
+
+                    /**
+                     * @return the longest time a message waits to be published, 0 to publish as messages are read
+                     */
+                    std::chrono::milliseconds getBatchTime() const { return mBatchTime; }
+
+                    /**
+                     * @return the smoothed arrival rate in messages per second
+                     */
+                    double getArrivalRate() const { return mArrivalRate; }
+
+                    /**
+                     * @return the smoothed size of a message in bytes
+                     */
+                    double getMessageBytes() const { return mMessageBytes; }
+
+                    /**
+                     * @return the smoothed PUBACK latency in milliseconds
+                     */
+                    double getPubackLatencyMs() const { return mPubackLatencyMs; }
+
+                  private:
+                    std::chrono::milliseconds mTargetLatency;
+
+                    std::size_t mMaxPayloadBytes;
+
+                    /**
+                     * \brief Start of the current update interval
+                     */
+                    TimePointT mIntervalStart;
+
+                    std::size_t mIntervalMessages{0};
+
+                    std::size_t mIntervalBytes{0};
+
+                    std::uint64_t mIntervalPubackMicros{0};
+
+                    std::size_t mIntervalPubacks{0};
+
+                    double mArrivalRate{0};
+
+                    double mMessageBytes{0};
+
+                    double mPubackLatencyMs{0};
+
+                    bool mHaveRate{false};
+
+                    bool mHaveMessageBytes{false};
+
+                    bool mHavePuback{false};
+
+                    std::size_t mBatchSize{1};
+
+                    std::chrono::milliseconds mBatchTime;
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BATCHCONTROLLER_H
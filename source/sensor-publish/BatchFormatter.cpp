@@ -0,0 +1,151 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BatchFormatter.h"
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr uint8_t CBOR_BYTE_STRING = 2;
+    constexpr uint8_t CBOR_ARRAY = 4;
+} // namespace
+
+void BatchFormatter::begin(size_t count)
+{
+    mOutput.clear();
+    mCount = 0;
+    switch (mFormat)
+    {
+        case Format::Json:
+            mOutput.push_back('[');
+            break;
+        case Format::LengthPrefixed:
+            break;
+        case Format::Cbor:
+            appendCborHead(CBOR_ARRAY, count);
+            break;
+    }
+}
+
+void BatchFormatter::add(const uint8_t *data, size_t len)
+{
+    switch (mFormat)
+    {
+        case Format::Json:
+            if (mCount > 0)
+            {
+                mOutput.push_back(',');
+            }
+            appendJsonString(data, len);
+            break;
+        case Format::LengthPrefixed:
+        {
+            uint32_t length = static_cast<uint32_t>(len);
+            char prefix[4] = {static_cast<char>(length >> 24),
+                              static_cast<char>(length >> 16),
+                              static_cast<char>(length >> 8),
+                              static_cast<char>(length)};
+            mOutput.append(prefix, sizeof(prefix));
+            mOutput.append(reinterpret_cast<const char *>(data), len);
+            break;
+        }
+        case Format::Cbor:
+            appendCborHead(CBOR_BYTE_STRING, len);
+            mOutput.append(reinterpret_cast<const char *>(data), len);
+            break;
+    }
+    ++mCount;
+}
+
+aws_byte_cursor BatchFormatter::finish()
+{
+    if (mFormat == Format::Json)
+    {
+        mOutput.push_back(']');
+    }
+    return aws_byte_cursor_from_array(mOutput.data(), mOutput.size());
+}
+
+void BatchFormatter::appendCborHead(uint8_t majorType, uint64_t value)
+{
+    // The shortest encoding of the argument is used, as required for deterministic CBOR.
+    uint8_t type = static_cast<uint8_t>(majorType << 5);
+    if (value < 24)
+    {
+        mOutput.push_back(static_cast<char>(type | value));
+        return;
+    }
+    int bytes;
+    if (value <= 0xFF)
+    {
+        mOutput.push_back(static_cast<char>(type | 24));
+        bytes = 1;
+    }
+    else if (value <= 0xFFFF)
+    {
+        mOutput.push_back(static_cast<char>(type | 25));
+        bytes = 2;
+    }
+    else if (value <= 0xFFFFFFFF)
+    {
+        mOutput.push_back(static_cast<char>(type | 26));
+        bytes = 4;
+    }
+    else
+    {
+        mOutput.push_back(static_cast<char>(type | 27));
+        bytes = 8;
+    }
+    for (int i = bytes - 1; i >= 0; --i)
+    {
+        mOutput.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void BatchFormatter::appendJsonString(const uint8_t *data, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    mOutput.push_back('"');
+    const uint8_t *end = data + len;
+    while (data < end)
+    {
+        // Copy runs of characters which need no escaping at once.
+        const uint8_t *run = data;
+        while (data < end && *data >= 0x20 && *data != '"' && *data != '\\')
+        {
+            ++data;
+        }
+        mOutput.append(reinterpret_cast<const char *>(run), static_cast<size_t>(data - run));
+        if (data == end)
+        {
+            break;
+        }
+
+        uint8_t c = *data++;
+        mOutput.push_back('\\');
+        switch (c)
+        {
+            case '"':
+            case '\\':
+                mOutput.push_back(static_cast<char>(c));
+                break;
+            case '\n':
+                mOutput.push_back('n');
+                break;
+            case '\r':
+                mOutput.push_back('r');
+                break;
+            case '\t':
+                mOutput.push_back('t');
+                break;
+            default:
+                mOutput.append("u00");
+                mOutput.push_back(hex[c >> 4]);
+                mOutput.push_back(hex[c & 0xF]);
+                break;
+        }
+    }
+    mOutput.push_back('"');
+}
@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BATCH_FORMATTER_H
+#define DEVICE_CLIENT_BATCH_FORMATTER_H
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief BatchFormatter frames the messages of a batch, so that subscribers do not need to split
+                 * batches on the end of message delimiter.
+                 *
+                 * Messages are added without their delimiter and copied once into an output buffer, which is reused
+                 * for every batch and only grows to the size of the largest formatted batch.
+                 *
+                 * Not thread safe, a formatter is only used from the event loop of its sensor.
+                 */
+                class BatchFormatter
+                {
+                  public:
+                    enum class Format
+                    {
+                        /** A JSON array holding each message as a string, such as ["msg1","msg2"] **/
+                        Json,
+                        /** Each message preceded by its length as a 4 byte big endian integer **/
+                        LengthPrefixed,
+                        /** A CBOR (RFC 8949) array holding each message as a byte string **/
+                        Cbor
+                    };
+
+                    explicit BatchFormatter(Format format) : mFormat(format) {}
+
+                    Format getFormat() const { return mFormat; }
+
+                    /**
+                     * \brief Start a batch, discarding the previous one
+                     *
+                     * @param count the number of messages in the batch
+                     */
+                    void begin(std::size_t count);
+
+                    /**
+                     * \brief Append a message to the batch
+                     */
+                    void add(const std::uint8_t *data, std::size_t len);
+
+                    /**
+                     * \brief Complete the batch
+                     *
+                     * @return the formatted batch, valid until the next call to begin()
+                     */
+                    aws_byte_cursor finish();
+
+                  private:
+                    Format mFormat;
+
+                    std::string mOutput;
+
+                    /**
+                     * \brief Number of messages added since begin()
+                     */
+                    std::size_t mCount{0};
+
+                    /**
+                     * \brief Append the head of a CBOR data item, its major type and its length or count
+                     */
+                    void appendCborHead(std::uint8_t majorType, std::uint64_t value);
+
+                    void appendJsonString(const std::uint8_t *data, std::size_t len);
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BATCH_FORMATTER_H
@@ -0,0 +1,71 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Compressor.h"
+
+#include "../logging/LoggerFactory.h"
+
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char Compressor::TAG[];
+
+Compressor::Compressor(int level, size_t maxInputBytes) : mLevel(level), mMaxInputBytes(maxInputBytes)
+{
+    memset(&mStream, 0, sizeof(mStream));
+}
+
+Compressor::~Compressor()
+{
+    if (mInitialized)
+    {
+        deflateEnd(&mStream);
+    }
+}
+
+bool Compressor::init()
+{
+    int rc = deflateInit(&mStream, mLevel);
+    if (rc != Z_OK)
+    {
+        LOGM_ERROR(TAG, "Failed to initialize deflate level %d: %s", mLevel, zError(rc));
+        return false;
+    }
+    mInitialized = true;
+    mOutput.resize(deflateBound(&mStream, static_cast<uLong>(mMaxInputBytes)));
+    return true;
+}
+
+bool Compressor::compress(const aws_byte_cursor &input, aws_byte_cursor &output)
+{
+    if (!mInitialized)
+    {
+        return false;
+    }
+
+    size_t bound = deflateBound(&mStream, static_cast<uLong>(input.len));
+    if (bound > mOutput.size())
+    {
+        mOutput.resize(bound);
+    }
+
+    // Reset keeps the allocated state, so that the stream is reused without allocating for every batch.
+    deflateReset(&mStream);
+    mStream.next_in = input.ptr;
+    mStream.avail_in = static_cast<uInt>(input.len);
+    mStream.next_out = mOutput.data();
+    mStream.avail_out = static_cast<uInt>(mOutput.size());
+
+    int rc = deflate(&mStream, Z_FINISH);
+    if (rc != Z_STREAM_END)
+    {
+        LOGM_ERROR(TAG, "Failed to deflate %zu bytes: %s", input.len, zError(rc));
+        return false;
+    }
+
+    output = aws_byte_cursor_from_array(mOutput.data(), static_cast<size_t>(mStream.total_out));
+    return true;
+}
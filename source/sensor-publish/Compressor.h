@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_COMPRESSOR_H
+#define DEVICE_CLIENT_COMPRESSOR_H
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <zlib.h>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Compressor deflates sensor batches before they are published.
+                 *
+                 * Each batch is compressed on its own into a complete zlib stream (RFC 1950), so that a subscriber
+                 * decompresses every message independently, for example with zlib.decompress() in Python. The deflate
+                 * state and the output buffer are allocated once by init() and reused for every batch.
+                 *
+                 * Not thread safe, a compressor is only used from the event loop of its sensor.
+                 */
+                class Compressor
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param level the deflate compression level, from 1 (fastest) to 9 (smallest)
+                     * @param maxInputBytes the size of the largest batch, used to size the output buffer
+                     */
+                    Compressor(int level, std::size_t maxInputBytes);
+
+                    ~Compressor();
+
+                    // Non-copyable.
+                    Compressor(const Compressor &) = delete;
+                    Compressor &operator=(const Compressor &) = delete;
+
+                    /**
+                     * \brief Allocate the deflate state and the output buffer
+                     *
+                     * @return true on success
+                     */
+                    bool init();
+
+                    /**
+                     * \brief Compress a batch
+                     *
+                     * The output buffer only grows for batches larger than maxInputBytes, which are found in a spool
+                     * written with a larger buffer capacity.
+                     *
+                     * @param input the batch to compress
+                     * @param output set to the compressed batch on return, valid until the next call to compress()
+                     * @return true on success
+                     */
+                    bool compress(const aws_byte_cursor &input, aws_byte_cursor &output);
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "Compressor.cpp";
+
+                    int mLevel;
+
+                    std::size_t mMaxInputBytes;
+
+                    z_stream mStream;
+
+                    bool mInitialized{false};
+
+                    std::vector<std::uint8_t> mOutput;
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_COMPRESSOR_H
@@ -0,0 +1,297 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "DeadLetterTask.h"
+
+#include "../Feature.h"
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/error.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/zero.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+#include <aws/mqtt/client.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char DeadLetterTask::TAG[];
+constexpr char DeadLetterTask::REASON_PUBLISH_FAILED[];
+constexpr char DeadLetterTask::REASON_BUFFER_FULL[];
+constexpr int64_t DeadLetterTask::PUBLISH_INTERVAL_MS;
+constexpr size_t DeadLetterTask::MAX_MESSAGE_BYTES;
+constexpr size_t DeadLetterTask::MAX_RECORD_PAYLOAD_BYTES;
+
+namespace
+{
+    /**
+     * \brief Space reserved in every message for the fields outside of the records
+     */
+    constexpr size_t MESSAGE_OVERHEAD_BYTES = 128;
+
+    void appendBase64(string &out, const uint8_t *data, size_t len)
+    {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        size_t i = 0;
+        for (; i + 2 < len; i += 3)
+        {
+            uint32_t triple = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+            out.push_back(alphabet[(triple >> 18) & 0x3F]);
+            out.push_back(alphabet[(triple >> 12) & 0x3F]);
+            out.push_back(alphabet[(triple >> 6) & 0x3F]);
+            out.push_back(alphabet[triple & 0x3F]);
+        }
+        if (i < len)
+        {
+            uint32_t triple = uint32_t(data[i]) << 16;
+            if (i + 1 < len)
+            {
+                triple |= uint32_t(data[i + 1]) << 8;
+            }
+            out.push_back(alphabet[(triple >> 18) & 0x3F]);
+            out.push_back(alphabet[(triple >> 12) & 0x3F]);
+            out.push_back(i + 1 < len ? alphabet[(triple >> 6) & 0x3F] : '=');
+            out.push_back('=');
+        }
+    }
+
+    void appendJsonString(string &out, const string &value)
+    {
+        out.push_back('"');
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out.push_back('\\');
+                out.push_back(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                out.append(escaped);
+            }
+            else
+            {
+                out.push_back(c);
+            }
+        }
+        out.push_back('"');
+    }
+} // namespace
+
+DeadLetterTask::DeadLetterTask(
+    const PlainConfig::SensorPublish::SensorSettings &settings,
+    PendingPublishes &pending,
+    shared_ptr<Crt::Mqtt::MqttConnection> connection,
+    aws_event_loop *eventLoop)
+    : mSettings(settings), mPending(pending), mConnection(connection), mEventLoop(eventLoop)
+{
+    // Initialize a task to publish dead letter messages to MQTT from the event loop.
+    // Only needs to be done once.
+    AWS_ZERO_STRUCT(mTask);
+    aws_task_init(
+        &mTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status)
+        {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<DeadLetterTask *>(arg);
+            self->publishDeadLetters();
+        },
+        this,
+        __func__);
+
+    // Since dead letter topic never changes, initialize a cursor with statically allocated memory.
+    if (enabled())
+    {
+        mTopic = aws_byte_cursor_from_c_str(mSettings.mqttDeadLetterTopic->c_str());
+    }
+    else
+    {
+        // Dead letter topic is not enabled, zero struct to prevent accidental use.
+        AWS_ZERO_STRUCT(mTopic);
+    }
+}
+
+bool DeadLetterTask::enabled() const
+{
+    return mSettings.mqttDeadLetterTopic.has_value() && !mSettings.mqttDeadLetterTopic.value().empty();
+}
+
+int DeadLetterTask::start()
+{
+    lock_guard<mutex> lock(mLock);
+    mStarted = enabled();
+    return Feature::SUCCESS;
+}
+
+int DeadLetterTask::stop()
+{
+    {
+        lock_guard<mutex> lock(mLock);
+        if (!mStarted)
+        {
+            return Feature::SUCCESS;
+        }
+
+        // Cancel the current task.
+        if (mScheduled && aws_event_loop_thread_is_callers_thread(mEventLoop))
+        {
+            aws_event_loop_cancel_task(mEventLoop, &mTask);
+            mScheduled = false;
+        }
+        mStarted = false;
+
+        // Publish the pending records now rather than lose them, the sensor may be replaced on reconfiguration.
+        if (!takeMessage())
+        {
+            return Feature::SUCCESS;
+        }
+    }
+
+    aws_byte_cursor payload = aws_byte_cursor_from_array(mMessage.data(), mMessage.size());
+    publish(&payload);
+    return Feature::SUCCESS;
+}
+
+void DeadLetterTask::add(const char *reason, const aws_byte_cursor &payload, size_t bytes)
+{
+    lock_guard<mutex> lock(mLock);
+    if (!mStarted)
+    {
+        return;
+    }
+
+    // Drop the record when it does not fit in the current message, the next message reports the count.
+    size_t keptBytes = min(payload.len, MAX_RECORD_PAYLOAD_BYTES);
+    size_t recordBytes = 64 + strlen(reason) + (keptBytes + 2) / 3 * 4;
+    size_t messageBytes = MESSAGE_OVERHEAD_BYTES + 2 * mSettings.name->size() + mRecords.size();
+    if (messageBytes + recordBytes > MAX_MESSAGE_BYTES)
+    {
+        ++mDropped;
+        return;
+    }
+
+    if (!mRecords.empty())
+    {
+        mRecords.push_back(',');
+    }
+    mRecords.append("{\"reason\":\"");
+    mRecords.append(reason);
+    mRecords.append("\",\"bytes\":");
+    mRecords.append(to_string(bytes));
+    mRecords.append(",\"payload\":\"");
+    appendBase64(mRecords, payload.ptr, keptBytes);
+    mRecords.append("\"}");
+
+    // Schedule the next message, which collects every record added until then.
+    if (!mScheduled)
+    {
+        uint64_t runAtNanos;
+        aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+        chrono::milliseconds delayMs(PUBLISH_INTERVAL_MS);
+        runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+        aws_event_loop_schedule_task_future(mEventLoop, &mTask, runAtNanos);
+        mScheduled = true;
+    }
+}
+
+void DeadLetterTask::publishDeadLetters()
+{
+    {
+        lock_guard<mutex> lock(mLock);
+        mScheduled = false;
+        if (!mStarted || !takeMessage())
+        {
+            return;
+        }
+    }
+
+    // Only the event loop of the sensor builds and publishes messages, so mMessage needs no lock here.
+    aws_byte_cursor payload = aws_byte_cursor_from_array(mMessage.data(), mMessage.size());
+    publish(&payload);
+}
+
+bool DeadLetterTask::takeMessage()
+{
+    if (mRecords.empty())
+    {
+        return false;
+    }
+
+    if (mDropped > 0)
+    {
+        LOGM_WARN(
+            TAG,
+            "Dropped %llu dead letter records sensor name: %s",
+            static_cast<unsigned long long>(mDropped),
+            mSettings.name->c_str());
+    }
+
+    mMessage.clear();
+    mMessage.append("{\"sensor\":");
+    appendJsonString(mMessage, mSettings.name.value());
+    mMessage.append(",\"dropped\":");
+    mMessage.append(to_string(mDropped));
+    mMessage.append(",\"records\":[");
+    mMessage.append(mRecords);
+    mMessage.append("]}");
+    mRecords.clear();
+    mDropped = 0;
+    return true;
+}
+
+void DeadLetterTask::publish(const aws_byte_cursor *payload)
+{
+    mPending.add();
+    uint16_t packetId = aws_mqtt_client_connection_publish(
+        mConnection->GetUnderlyingConnection(),
+        &mTopic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        false,
+        payload,
+        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata)
+        {
+            auto *self = static_cast<DeadLetterTask *>(userdata);
+            if (error_code)
+            {
+                // Log an error, failed dead letter messages are not retried.
+                LOGM_ERROR(
+                    TAG,
+                    "Error dead letter sensor name: %s func: %s msg: %s",
+                    self->mSettings.name->c_str(),
+                    __func__,
+                    aws_error_str(error_code));
+            }
+            else
+            {
+                LOGM_DEBUG(
+                    TAG, "Publish dead letter sensor name: %s packetId: %d", self->mSettings.name->c_str(), packet_id);
+            }
+            self->mPending.complete(); // Last access, the sensor may be destroyed once nothing is pending.
+        },
+        this);
+    if (packetId == 0)
+    {
+        // The completion callback is never invoked when the publish is not queued.
+        LOGM_ERROR(
+            TAG,
+            "Error dead letter sensor name: %s func: aws_mqtt_client_connection_publish msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        mPending.complete();
+    }
+}
@@ -0,0 +1,208 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_DEAD_LETTER_TASK_H
+#define DEVICE_CLIENT_DEAD_LETTER_TASK_H
+
+#include "../config/Config.h"
+#include "PendingPublishes.h"
+
+#include <aws/crt/Types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief DeadLetterTask publishes sensor data which could not be delivered to the dead letter topic.
+                 *
+                 * Records are batched into a single JSON message per interval, so that a failing sensor publishes
+                 * at most MAX_MESSAGE_BYTES per PUBLISH_INTERVAL_MS to the dead letter topic. Records which do not fit
+                 * in the current message are dropped and counted in the next message.
+                 */
+                class DeadLetterTask
+                {
+                  public:
+                    /**
+                     * \brief Reason recorded when the PUBACK of a sensor batch reports an error
+                     */
+                    static constexpr char REASON_PUBLISH_FAILED[] = "publish-failed";
+
+                    /**
+                     * \brief Reason recorded when the read buffer is full and holds no end of message delimiter
+                     */
+                    static constexpr char REASON_BUFFER_FULL[] = "buffer-full";
+
+                    /**
+                     * \brief Interval between dead letter messages
+                     */
+                    static constexpr int64_t PUBLISH_INTERVAL_MS = 1000;
+
+                    /**
+                     * \brief Maximum size of a dead letter message
+                     */
+                    static constexpr std::size_t MAX_MESSAGE_BYTES = 64 * 1024;
+
+                    /**
+                     * \brief Payloads longer than this are truncated in their record, the record still holds the
+                     * original size
+                     */
+                    static constexpr std::size_t MAX_RECORD_PAYLOAD_BYTES = 4 * 1024;
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "DeadLetterTask.cpp";
+
+                    /**
+                     * \brief Task for publishing dead letter message to MQTT
+                     */
+                    aws_task mTask;
+
+                    /**
+                     * \brief Settings associated with the sensor
+                     */
+                    const PlainConfig::SensorPublish::SensorSettings &mSettings;
+
+                    /**
+                     * \brief Publishes of the sensor waiting for their completion callback
+                     */
+                    PendingPublishes &mPending;
+
+                    /**
+                     * \brief MQTT client connection
+                     */
+                    std::shared_ptr<Crt::Mqtt::MqttConnection> mConnection;
+
+                    /**
+                     * \brief Event loop used to schedule task.
+                     */
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    /**
+                     * \brief Dead letter topic
+                     */
+                    aws_byte_cursor mTopic;
+
+                    /**
+                     * \brief Records may be added from the event loop of the MQTT connection, which can differ
+                     * from the event loop of the sensor
+                     */
+                    std::mutex mLock;
+
+                    /**
+                     * \brief Records waiting to be published, separated by commas
+                     */
+                    std::string mRecords;
+
+                    /**
+                     * \brief Number of records dropped since the last dead letter message
+                     */
+                    uint64_t mDropped{0};
+
+                    /**
+                     * \brief Message being published, reused across messages
+                     */
+                    std::string mMessage;
+
+                    /**
+                     * \brief Flag to indicate the task is scheduled
+                     */
+                    bool mScheduled{false};
+
+                    /**
+                     * \brief Flag to indicate task has previously been started, written with mLock held and read
+                     * without it from the event loop of the sensor
+                     */
+                    std::atomic<bool> mStarted{false};
+
+                    /**
+                     * \brief Build the dead letter message from the pending records and publish it
+                     */
+                    void publishDeadLetters();
+
+                    /**
+                     * \brief Build the dead letter message from the pending records into mMessage, must be called
+                     * with mLock held
+                     *
+                     * @return true when there were pending records
+                     */
+                    bool takeMessage();
+
+                    /**
+                     * \brief Publish payload to topic
+                     */
+                    virtual void publish(const aws_byte_cursor *payload);
+
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param settings the settings for this sensor
+                     * @param pending the publishes of the sensor waiting for their completion callback
+                     * @param connection mqtt connection used to publish dead letter messages
+                     * @param eventLoop the event loop of the sensor
+                     */
+                    DeadLetterTask(
+                        const PlainConfig::SensorPublish::SensorSettings &settings,
+                        PendingPublishes &pending,
+                        std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
+                        aws_event_loop *eventLoop);
+
+                    virtual ~DeadLetterTask() = default;
+
+                    // Non-copyable.
+                    DeadLetterTask(const DeadLetterTask &) = delete;
+                    DeadLetterTask &operator=(const DeadLetterTask &) = delete;
+
+                    /**
+                     * \brief Returns true when a dead letter topic is configured
+                     */
+                    bool enabled() const;
+
+                    /**
+                     * \brief Start accepting records
+                     *
+                     * @return an integer representing the SUCCESS or FAILURE of the start() operation
+                     */
+                    int start();
+
+                    /**
+                     * \brief Stop accepting records, pending records are published
+                     *
+                     * @return an integer representing the SUCCESS or FAILURE of the stop() operation
+                     */
+                    int stop();
+
+                    /**
+                     * \brief Queue sensor data for the next dead letter message
+                     *
+                     * @param reason why the data could not be delivered
+                     * @param payload the data, truncated to MAX_RECORD_PAYLOAD_BYTES
+                     * @param bytes the size of the data before any truncation by the caller
+                     */
+                    void add(const char *reason, const aws_byte_cursor &payload, std::size_t bytes);
+
+                    /**
+                     * @return true when the task is started
+                     */
+                    bool started() const { return mStarted; }
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_DEAD_LETTER_TASK_H
@@ -0,0 +1,340 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "EomMatcher.h"
+
+#include <bitset>
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    /**
+     * \brief Decodes the escape sequence starting with the backslash at pos, if it stands for a single character
+     *
+     * Character class escapes such as \d or \s, assertions such as \b, and back references are rejected.
+     */
+    bool decodeEscape(const string &pattern, size_t &pos, char &out)
+    {
+        if (pos + 1 >= pattern.size())
+        {
+            return false;
+        }
+        char c = pattern[pos + 1];
+        switch (c)
+        {
+            case 'n':
+                out = '\n';
+                break;
+            case 'r':
+                out = '\r';
+                break;
+            case 't':
+                out = '\t';
+                break;
+            case 'f':
+                out = '\f';
+                break;
+            case 'v':
+                out = '\v';
+                break;
+            case '0':
+                if (pos + 2 < pattern.size() && isdigit(static_cast<unsigned char>(pattern[pos + 2])))
+                {
+                    return false;
+                }
+                out = '\0';
+                break;
+            case 'x':
+            {
+                if (pos + 3 >= pattern.size())
+                {
+                    return false;
+                }
+                int high = hexValue(pattern[pos + 2]);
+                int low = hexValue(pattern[pos + 3]);
+                if (high < 0 || low < 0)
+                {
+                    return false;
+                }
+                out = static_cast<char>(high * 16 + low);
+                pos += 4;
+                return true;
+            }
+            default:
+                // ECMAScript only allows identity escapes of characters that are not word characters
+                if (isalnum(static_cast<unsigned char>(c)) || c == '_')
+                {
+                    return false;
+                }
+                out = c;
+                break;
+        }
+        pos += 2;
+        return true;
+    }
+} // namespace
+
+EomMatcher::EomMatcher(const string &pattern)
+{
+    if (!compileLiteral(pattern))
+    {
+        mKind = Kind::Regex;
+        mRepeated = false;
+        mLiteral.clear();
+        mByteSet.reset();
+        mPattern = regex(pattern);
+    }
+}
+
+bool EomMatcher::compileLiteral(const string &pattern)
+{
+    size_t atoms = 0;
+    bool hasByteSet = false;
+    size_t pos = 0;
+    while (pos < pattern.size())
+    {
+        char c = pattern[pos];
+        if (mRepeated || (hasByteSet && c != '+'))
+        {
+            return false; // Only a "+" may follow a character class, and nothing may follow the "+".
+        }
+
+        char decoded;
+        if (c == '\\')
+        {
+            if (!decodeEscape(pattern, pos, decoded))
+            {
+                return false;
+            }
+            mLiteral.push_back(decoded);
+            ++atoms;
+        }
+        else if (c == '[')
+        {
+            // A character class listing single characters, such as "[,]" or "[\r\n]"
+            bitset<256> members;
+            ++pos;
+            if (pos < pattern.size() && pattern[pos] == '^')
+            {
+                return false;
+            }
+            while (pos < pattern.size() && pattern[pos] != ']')
+            {
+                c = pattern[pos];
+                if (c == '\\')
+                {
+                    if (!decodeEscape(pattern, pos, decoded))
+                    {
+                        return false;
+                    }
+                }
+                else if (c == '[' || c == '-')
+                {
+                    return false;
+                }
+                else
+                {
+                    decoded = c;
+                    ++pos;
+                }
+                members.set(static_cast<unsigned char>(decoded));
+            }
+            if (pos >= pattern.size() || members.none())
+            {
+                return false;
+            }
+            ++pos;
+
+            if (members.count() == 1)
+            {
+                mLiteral.push_back(decoded);
+            }
+            else
+            {
+                if (atoms > 0)
+                {
+                    return false;
+                }
+                mByteSet = members;
+                hasByteSet = true;
+            }
+            ++atoms;
+        }
+        else if (c == '+')
+        {
+            if (atoms != 1)
+            {
+                return false;
+            }
+            mRepeated = true;
+            ++pos;
+        }
+        else if (c != '\0' && strchr("^$.*?()]{}|", c) != nullptr)
+        {
+            return false;
+        }
+        else
+        {
+            mLiteral.push_back(c);
+            ++pos;
+            ++atoms;
+        }
+    }
+
+    if (atoms == 0)
+    {
+        return false;
+    }
+    if (!mByteSet.none())
+    {
+        mKind = Kind::ByteSet;
+    }
+    else if (mLiteral.size() == 1)
+    {
+        mKind = Kind::Byte;
+        mByteSet.set(static_cast<unsigned char>(mLiteral[0]));
+    }
+    else
+    {
+        mKind = Kind::Literal;
+    }
+    return true;
+}
+
+size_t EomMatcher::findAll(const char *begin, const char *end, size_t offset, queue<size_t> &bounds) const
+{
+    size_t count = 0;
+    const char *pos = begin;
+    switch (mKind)
+    {
+        case Kind::Byte:
+        case Kind::ByteSet:
+        {
+            char delimiter = mLiteral.empty() ? '\0' : mLiteral[0];
+            while (pos < end)
+            {
+                if (mKind == Kind::Byte)
+                {
+                    pos = static_cast<const char *>(memchr(pos, delimiter, static_cast<size_t>(end - pos)));
+                }
+                else
+                {
+                    while (pos < end && !inByteSet(pos))
+                    {
+                        ++pos;
+                    }
+                    pos = pos < end ? pos : nullptr;
+                }
+                if (pos == nullptr)
+                {
+                    break;
+                }
+                ++pos;
+                if (mRepeated)
+                {
+                    // The greedy "+" consumes the whole run of delimiters.
+                    while (pos < end && inByteSet(pos))
+                    {
+                        ++pos;
+                    }
+                }
+                bounds.emplace(offset + static_cast<size_t>(pos - begin));
+                ++count;
+            }
+            break;
+        }
+        case Kind::Literal:
+        {
+            // Sensor messages are short, so finding the first byte with memchr and comparing the rest beats
+            // memmem, which pays for its setup on every message.
+            size_t length = mLiteral.size();
+            while (static_cast<size_t>(end - pos) >= length)
+            {
+                pos = static_cast<const char *>(memchr(pos, mLiteral[0], static_cast<size_t>(end - pos) - length + 1));
+                if (pos == nullptr)
+                {
+                    break;
+                }
+                if (memcmp(pos + 1, mLiteral.data() + 1, length - 1) != 0)
+                {
+                    ++pos;
+                    continue;
+                }
+                pos += length;
+                bounds.emplace(offset + static_cast<size_t>(pos - begin));
+                ++count;
+            }
+            break;
+        }
+        case Kind::Regex:
+        {
+            for (auto m = cregex_iterator(begin, end, mPattern), mend = cregex_iterator(); m != mend; ++m)
+            {
+                // Store the position of one-past the end of the match.
+                bounds.emplace(offset + static_cast<size_t>((*m).position() + (*m).length()));
+                ++count;
+            }
+            break;
+        }
+    }
+    return count;
+}
+
+size_t EomMatcher::messageLength(const char *begin, const char *end) const
+{
+    const char *pos = end;
+    switch (mKind)
+    {
+        case Kind::Byte:
+        case Kind::ByteSet:
+        {
+            // A delimiter byte inside the message would have ended it, so every trailing delimiter byte is part of
+            // the match.
+            while (pos > begin && inByteSet(pos - 1))
+            {
+                --pos;
+            }
+            break;
+        }
+        case Kind::Literal:
+        {
+            if (static_cast<size_t>(end - begin) >= mLiteral.size())
+            {
+                pos = end - mLiteral.size();
+            }
+            break;
+        }
+        case Kind::Regex:
+        {
+            // The leftmost match in the message is the one which ends it.
+            cmatch m;
+            if (regex_search(begin, end, m, mPattern))
+            {
+                pos = begin + m.position(0);
+            }
+            break;
+        }
+    }
+    return static_cast<size_t>(pos - begin);
+}
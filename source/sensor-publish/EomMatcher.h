@@ -0,0 +1,125 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_EOM_MATCHER_H
+#define DEVICE_CLIENT_EOM_MATCHER_H
+
+#include <bitset>
+#include <cstddef>
+#include <queue>
+#include <regex>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Finds end of message boundaries in sensor data
+                 *
+                 * The eomDelimiter setting is a regular expression, but almost every configuration uses a literal
+                 * such as "\n" or "\r\n". The pattern is compiled once into the cheapest matcher that gives the same
+                 * matches as std::regex: memchr(3) for a single byte, a byte table for a character class such as
+                 * "[\r\n]", memchr(3) and memcmp(3) for a literal string, and std::regex for anything else. A trailing
+                 * "+" is supported on a single byte or character class.
+                 */
+                class EomMatcher
+                {
+                  public:
+                    enum class Kind
+                    {
+                        /** A single byte, such as "\n" or "[,]+" **/
+                        Byte,
+                        /** A character class of several bytes, such as "[\r\n]+" **/
+                        ByteSet,
+                        /** A literal string of several bytes, such as "\r\n" **/
+                        Literal,
+                        /** Any other regular expression **/
+                        Regex
+                    };
+
+                    /**
+                     * \brief Compiles the pattern into a matcher
+                     *
+                     * @param pattern an ECMAScript regular expression
+                     * @throws std::regex_error when the pattern is not a valid regular expression
+                     */
+                    explicit EomMatcher(const std::string &pattern);
+
+                    /**
+                     * \brief Finds every non-overlapping match in the range, leftmost first, like
+                     * std::cregex_iterator
+                     *
+                     * @param begin the start of the range to scan
+                     * @param end one past the end of the range to scan
+                     * @param offset the index of begin in the read buffer
+                     * @param bounds receives the read buffer index of one past the end of each match
+                     * @return the number of matches found
+                     */
+                    std::size_t findAll(
+                        const char *begin,
+                        const char *end,
+                        std::size_t offset,
+                        std::queue<std::size_t> &bounds) const;
+
+                    /**
+                     * \brief Returns the length of a message without the end of message delimiter it ends with
+                     *
+                     * @param begin the start of the message
+                     * @param end one past the end of the match which ends the message, as found by findAll()
+                     * @return the number of bytes before the delimiter
+                     */
+                    std::size_t messageLength(const char *begin, const char *end) const;
+
+                    Kind getKind() const { return mKind; }
+
+                    /**
+                     * \brief Whether a match extends over every adjacent delimiter, as with "[\r\n]+"
+                     */
+                    bool isRepeated() const { return mRepeated; }
+
+                  private:
+                    Kind mKind{Kind::Regex};
+
+                    bool mRepeated{false};
+
+                    /**
+                     * \brief The bytes to match, for Kind::Byte and Kind::Literal
+                     */
+                    std::string mLiteral;
+
+                    /**
+                     * \brief The bytes of the character class, for Kind::Byte and Kind::ByteSet
+                     */
+                    std::bitset<256> mByteSet;
+
+                    /**
+                     * \brief The compiled pattern, only used for Kind::Regex
+                     */
+                    std::regex mPattern;
+
+                    /**
+                     * \brief Decodes a pattern made only of literal characters, escaped characters and character
+                     * classes listing single characters, with an optional trailing "+"
+                     *
+                     * @param pattern the regular expression
+                     * @return true when the pattern can be matched without a regular expression engine
+                     */
+                    bool compileLiteral(const std::string &pattern);
+
+                    /**
+                     * \brief Returns whether the byte at pos is part of the character class, for Kind::Byte and
+                     * Kind::ByteSet
+                     */
+                    bool inByteSet(const char *pos) const { return mByteSet[static_cast<unsigned char>(*pos)]; }
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_EOM_MATCHER_H
@@ -0,0 +1,54 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "EventLoopCall.h"
+
+#include <aws/common/task_scheduler.h>
+#include <aws/io/event_loop.h>
+
+#include <future>
+#include <utility>
+
+using namespace std;
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                void runOnEventLoop(aws_event_loop *eventLoop, const function<void()> &callback)
+                {
+                    if (aws_event_loop_thread_is_callers_thread(eventLoop))
+                    {
+                        callback();
+                        return;
+                    }
+
+                    // The task runs even when it is canceled by the event loop shutting down, then nothing runs on
+                    // the loop anymore.
+                    promise<void> done;
+                    pair<const function<void()> *, promise<void> *> context(&callback, &done);
+                    aws_task task;
+                    aws_task_init(
+                        &task,
+                        [](struct aws_task *, void *arg, enum aws_task_status status)
+                        {
+                            auto *context = static_cast<pair<const function<void()> *, promise<void> *> *>(arg);
+                            if (status != AWS_TASK_STATUS_CANCELED)
+                            {
+                                (*context->first)();
+                            }
+                            context->second->set_value();
+                        },
+                        &context,
+                        __func__);
+                    aws_event_loop_schedule_task_now(eventLoop, &task);
+                    done.get_future().wait();
+                }
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
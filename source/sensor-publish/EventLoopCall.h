@@ -0,0 +1,31 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_EVENT_LOOP_CALL_H
+#define DEVICE_CLIENT_EVENT_LOOP_CALL_H
+
+#include <functional>
+
+struct aws_event_loop;
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Run the callback on the event loop and wait for it to complete
+                 *
+                 * The callback runs directly when called from the event loop. It does not run when the event loop
+                 * is shutting down, the event loop then cancels every task itself.
+                 */
+                void runOnEventLoop(aws_event_loop *eventLoop, const std::function<void()> &callback);
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_EVENT_LOOP_CALL_H
@@ -5,17 +5,21 @@
 
 #include "../Feature.h"
 #include "../logging/LoggerFactory.h"
+#include "EventLoopCall.h"
 
 #include <aws/common/byte_buf.h>
 #include <aws/common/error.h>
 #include <aws/common/task_scheduler.h>
 #include <aws/common/zero.h>
+#include <aws/crt/JsonObject.h>
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 #include <aws/mqtt/client.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <initializer_list>
 
 using namespace std;
 using namespace Aws::Iot;
@@ -24,13 +28,18 @@ using namespace Aws::Iot::DeviceClient::Logging;
 using namespace Aws::Iot::DeviceClient::SensorPublish;
 
 constexpr char HeartbeatTask::TAG[];
+constexpr uint8_t HeartbeatTask::BINARY_VERSION;
+constexpr size_t HeartbeatTask::BINARY_SIZE;
 
 HeartbeatTask::HeartbeatTask(
     const SensorState &state,
     const PlainConfig::SensorPublish::SensorSettings &settings,
+    SensorCounters &counters,
+    PendingPublishes &pending,
     shared_ptr<Crt::Mqtt::MqttConnection> connection,
     aws_event_loop *eventLoop)
-    : mState(state), mSettings(settings), mConnection(connection), mEventLoop(eventLoop)
+    : mState(state), mSettings(settings), mCounters(counters), mPending(pending), mConnection(connection),
+      mEventLoop(eventLoop)
 {
     // Initialize a task to publish heartbeat to MQTT from the event loop.
     // Only needs to be done once.
@@ -60,6 +69,18 @@ HeartbeatTask::HeartbeatTask(
         AWS_ZERO_STRUCT(mTopic);
     }
     mPayload = aws_byte_cursor_from_c_str(mSettings.name->c_str());
+
+    if (mSettings.heartbeatFormat.has_value())
+    {
+        if (mSettings.heartbeatFormat.value() == PlainConfig::SensorPublish::HEARTBEAT_FORMAT_JSON)
+        {
+            mFormat = Format::Json;
+        }
+        else if (mSettings.heartbeatFormat.value() == PlainConfig::SensorPublish::HEARTBEAT_FORMAT_BINARY)
+        {
+            mFormat = Format::Binary;
+        }
+    }
 }
 
 bool HeartbeatTask::enabled() const
@@ -78,8 +99,9 @@ int HeartbeatTask::start()
     // Unspecified topic means heartbeat is not enabled.
     if (enabled())
     {
-        scheduleHeartbeat();
+        mLastHeartbeat = chrono::steady_clock::now();
         mStarted = true;
+        scheduleHeartbeat();
     }
 
     return Feature::SUCCESS;
@@ -87,15 +109,10 @@ int HeartbeatTask::start()
 
 int HeartbeatTask::stop()
 {
-    if (mStarted)
-    {
-        // Cancel the current task.
-        if (aws_event_loop_thread_is_callers_thread(mEventLoop))
-        {
-            aws_event_loop_cancel_task(mEventLoop, &mTask);
-        }
-        mStarted = false;
-    }
+    // Cancel the current task, which only the event loop may do. The task re-arms itself, so it is canceled even when
+    // not started.
+    mStarted = false;
+    runOnEventLoop(mEventLoop, [this]() { aws_event_loop_cancel_task(mEventLoop, &mTask); });
 
     return Feature::SUCCESS;
 }
@@ -108,21 +125,81 @@ void HeartbeatTask::publishHeartbeat()
         return;
     }
 
+    // Schedule the next heartbeat check from the event loop, so that stop cancels it.
+    scheduleHeartbeat();
+
     // No heartbeat published when sensor is not connected.
     if (mState < SensorState::Connected)
     {
-        // Schedule the next heartbeat check.
-        scheduleHeartbeat();
         return;
     }
 
     // Publish the heartbeat message.
+    if (mFormat != Format::Name)
+    {
+        updatePayload();
+    }
     publish();
 }
 
+void HeartbeatTask::updatePayload()
+{
+    auto now = chrono::steady_clock::now();
+    auto interval = chrono::duration_cast<chrono::milliseconds>(now - mLastHeartbeat);
+    mLastHeartbeat = now;
+
+    mPayloadData = formatCounters(mFormat, mSettings.name.value(), mCounters.take(), interval);
+    mPayload = aws_byte_cursor_from_array(mPayloadData.data(), mPayloadData.size());
+}
+
+string HeartbeatTask::formatCounters(
+    Format format,
+    const string &name,
+    const SensorCounters::Snapshot &counters,
+    chrono::milliseconds interval)
+{
+    uint64_t intervalMs = static_cast<uint64_t>(max<int64_t>(0, interval.count()));
+    if (format == Format::Binary)
+    {
+        // The version, followed by every field in network byte order, in the order of the Json format.
+        string payload;
+        payload.reserve(BINARY_SIZE);
+        payload.push_back(static_cast<char>(BINARY_VERSION));
+        for (uint64_t value :
+             {intervalMs,
+              counters.bytesRead,
+              counters.messages,
+              counters.batches,
+              counters.publishErrors,
+              counters.discardedBytes,
+              counters.reconnects,
+              counters.maxBufferFill})
+        {
+            for (int shift = 56; shift >= 0; shift -= 8)
+            {
+                payload.push_back(static_cast<char>((value >> shift) & 0xff));
+            }
+        }
+        return payload;
+    }
+
+    Crt::JsonObject object;
+    object.WithString("name", name.c_str());
+    object.WithInt64("interval_ms", static_cast<int64_t>(intervalMs));
+    object.WithInt64("bytes_read", static_cast<int64_t>(counters.bytesRead));
+    object.WithInt64("messages", static_cast<int64_t>(counters.messages));
+    object.WithInt64("batches", static_cast<int64_t>(counters.batches));
+    object.WithInt64("publish_errors", static_cast<int64_t>(counters.publishErrors));
+    object.WithInt64("discarded_bytes", static_cast<int64_t>(counters.discardedBytes));
+    object.WithInt64("reconnects", static_cast<int64_t>(counters.reconnects));
+    object.WithInt64("max_buffer_fill", static_cast<int64_t>(counters.maxBufferFill));
+    return object.View().WriteCompact().c_str();
+}
+
 void HeartbeatTask::publish()
 {
-    aws_mqtt_client_connection_publish(
+    mPending.add();
+    uint16_t packetId = aws_mqtt_client_connection_publish(
         mConnection->GetUnderlyingConnection(),
         &mTopic,
         AWS_MQTT_QOS_AT_LEAST_ONCE,
@@ -145,13 +222,19 @@ void HeartbeatTask::publish()
                 LOGM_DEBUG(
                     TAG, "Publish heartbeat sensor name: %s packetId: %d", self->mSettings.name->c_str(), packet_id);
             }
-            // Schedule the next heartbeat check.
-            if (self->mStarted)
-            {
-                self->scheduleHeartbeat();
-            }
+            self->mPending.complete(); // Last access, the sensor may be destroyed once nothing is pending.
         },
         this);
+    if (packetId == 0)
+    {
+        // The completion callback is never invoked when the publish is not queued.
+        LOGM_ERROR(
+            TAG,
+            "Error heartbeat sensor name: %s func: aws_mqtt_client_connection_publish msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        mPending.complete();
+    }
 }
 
 void HeartbeatTask::scheduleHeartbeat()
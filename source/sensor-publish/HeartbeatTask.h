@@ -5,11 +5,18 @@
 #define DEVICE_CLIENT_HEARTBEAT_TASK_H
 
 #include "../config/Config.h"
+#include "PendingPublishes.h"
+#include "SensorCounters.h"
 #include "SensorState.h"
 
 #include <aws/crt/Types.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 
 namespace Aws
 {
@@ -21,9 +28,33 @@ namespace Aws
             {
                 /**
                  * \brief HeartbeatTask publishes a heartbeat message while sensor is connected.
+                 *
+                 * The heartbeat holds the sensor name, or the counters of the sensor since the last heartbeat as
+                 * compact JSON or binary, depending on heartbeatFormat.
                  */
                 class HeartbeatTask
                 {
+                  public:
+                    /**
+                     * \brief Payload of the heartbeat message
+                     */
+                    enum class Format
+                    {
+                        Name,
+                        Json,
+                        Binary
+                    };
+
+                    /**
+                     * \brief Version in the first byte of a binary heartbeat
+                     */
+                    static constexpr std::uint8_t BINARY_VERSION = 1;
+
+                    /**
+                     * \brief Size of a binary heartbeat, the version followed by 8 big-endian 64-bit fields
+                     */
+                    static constexpr std::size_t BINARY_SIZE = 1 + 8 * sizeof(std::uint64_t);
+
                   private:
                     /**
                      * \brief Used by the logger to specify source of log messages.
@@ -45,6 +76,16 @@ namespace Aws
                      */
                     const PlainConfig::SensorPublish::SensorSettings &mSettings;
 
+                    /**
+                     * \brief Counters of the sensor, taken by every heartbeat
+                     */
+                    SensorCounters &mCounters;
+
+                    /**
+                     * \brief Publishes of the sensor waiting for their completion callback
+                     */
+                    PendingPublishes &mPending;
+
                     /**
                      * \brief MQTT client connection
                      */
@@ -66,9 +107,27 @@ namespace Aws
                     aws_byte_cursor mPayload;
 
                     /**
-                     * \brief Flag to indicate task has previously been started
+                     * \brief Format of the heartbeat message payload
+                     */
+                    Format mFormat{Format::Name};
+
+                    /**
+                     * \brief Storage of the payload when it holds the counters
+                     *
+                     * The MQTT client copies the payload when the publish is queued, so the next heartbeat may be
+                     * formatted before the previous publish completed.
+                     */
+                    std::string mPayloadData;
+
+                    /**
+                     * \brief Time the counters were last taken
                      */
-                    bool mStarted{false};
+                    std::chrono::steady_clock::time_point mLastHeartbeat;
+
+                    /**
+                     * \brief Flag to indicate task has previously been started, read by the completion callbacks
+                     */
+                    std::atomic<bool> mStarted{false};
 
                     /**
                      * \brief Returns true when heartbeat enabled
@@ -80,6 +139,11 @@ namespace Aws
                      */
                     void publishHeartbeat();
 
+                    /**
+                     * \brief Take the counters and format them into the payload
+                     */
+                    void updatePayload();
+
                     /**
                      * \brief Publish payload to topic
                      */
@@ -96,12 +160,16 @@ namespace Aws
                      *
                      * @param state machine of the sensor associated with the heartbeat
                      * @param settings the settings for this sensor
+                     * @param counters the counters of the sensor reported by the heartbeat
+                     * @param pending the publishes of the sensor waiting for their completion callback
                      * @param connection mqtt connection used to publish heartbeat
                      * @param eventLoop the event loop for the heartbeat
                      */
                     HeartbeatTask(
                         const SensorState &state,
                         const PlainConfig::SensorPublish::SensorSettings &settings,
+                        SensorCounters &counters,
+                        PendingPublishes &pending,
                         std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
                         aws_event_loop *eventLoop);
 
@@ -121,6 +189,8 @@ namespace Aws
                     /**
                      * \brief Stop publishing heartbeat message
                      *
+                     * Blocks until the heartbeat task is canceled on the event loop, when called from another thread.
+                     *
                      * @return an integer representing the SUCCESS or FAILURE of the start() operation
                      */
                     int stop();
@@ -129,6 +199,26 @@ namespace Aws
                      * @return true when heartbeat is started
                      */
                     bool started() const { return mStarted; }
+
+                    /**
+                     * @return the payload of the heartbeat being published
+                     */
+                    const aws_byte_cursor &getPayload() const { return mPayload; }
+
+                    /**
+                     * \brief Format counters taken over an interval as a heartbeat payload
+                     *
+                     * @param format Json or Binary
+                     * @param name the name of the sensor, only part of the Json format
+                     * @param counters the counters taken
+                     * @param interval the time over which the counters were accumulated
+                     * @return the payload
+                     */
+                    static std::string formatCounters(
+                        Format format,
+                        const std::string &name,
+                        const SensorCounters::Snapshot &counters,
+                        std::chrono::milliseconds interval);
                 };
             } // namespace SensorPublish
         } // namespace DeviceClient
@@ -0,0 +1,209 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "MessageFilter.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * \brief FNV-1a hash of a message
+     */
+    uint64_t hashMessage(const uint8_t *data, size_t len)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < len; ++i)
+        {
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    const char *skipSpace(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * \brief Parse a number at the start of a field, which is not null terminated
+     */
+    bool parseNumber(const char *p, const char *end, double &value)
+    {
+        p = skipSpace(p, end);
+        if (p < end && *p == '"')
+        {
+            ++p;
+        }
+
+        // Copy the characters of the number, so that strtod stops at the end of the field.
+        char number[64];
+        size_t len = 0;
+        while (p < end && len < sizeof(number) - 1 && (isdigit(static_cast<unsigned char>(*p)) || *p == '-' ||
+                                                       *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+        {
+            number[len++] = *p++;
+        }
+        number[len] = '\0';
+
+        char *parsed;
+        value = strtod(number, &parsed);
+        return parsed != number && isfinite(value);
+    }
+} // namespace
+
+MessageFilter::MessageFilter(const PlainConfig::SensorPublish::SensorSettings &settings)
+{
+    mDedup = settings.filterDedup.has_value() && settings.filterDedup.value();
+    if (settings.filterDeadband.has_value())
+    {
+        mDeadband = true;
+        mDeadbandWidth = settings.filterDeadband.value();
+        if (settings.filterJsonKey.has_value())
+        {
+            mJsonKey = settings.filterJsonKey.value();
+        }
+        else
+        {
+            mCsvColumn = static_cast<size_t>(settings.filterCsvColumn.value());
+        }
+    }
+    if (settings.filterKeepEvery.has_value())
+    {
+        mKeepEvery = static_cast<uint64_t>(settings.filterKeepEvery.value());
+    }
+    if (settings.filterMinIntervalMs.has_value())
+    {
+        mMinInterval = chrono::milliseconds(settings.filterMinIntervalMs.value());
+    }
+}
+
+bool MessageFilter::configured(const PlainConfig::SensorPublish::SensorSettings &settings)
+{
+    return (settings.filterDedup.has_value() && settings.filterDedup.value()) ||
+           settings.filterDeadband.has_value() ||
+           (settings.filterKeepEvery.has_value() && settings.filterKeepEvery.value() > 1) ||
+           (settings.filterMinIntervalMs.has_value() && settings.filterMinIntervalMs.value() > 0);
+}
+
+bool MessageFilter::accept(const uint8_t *data, size_t len, chrono::high_resolution_clock::time_point now)
+{
+    uint64_t hash = 0;
+    if (mDedup)
+    {
+        hash = hashMessage(data, len);
+        if (mHaveKept && hash == mLastHash && len == mLastLength)
+        {
+            ++mCounters.duplicate;
+            return false;
+        }
+    }
+
+    double value = 0;
+    bool haveValue = mDeadband && extractValue(data, len, value);
+    if (haveValue && mHaveLastValue && fabs(value - mLastValue) <= mDeadbandWidth)
+    {
+        ++mCounters.deadband;
+        return false;
+    }
+
+    if (mHaveKept && (mSkipped + 1 < mKeepEvery || now - mLastKept < mMinInterval))
+    {
+        ++mSkipped;
+        ++mCounters.sampled;
+        return false;
+    }
+
+    // Each stage compares the next message with this one.
+    mLastHash = hash;
+    mLastLength = len;
+    if (haveValue)
+    {
+        mLastValue = value;
+        mHaveLastValue = true;
+    }
+    mSkipped = 0;
+    mLastKept = now;
+    mHaveKept = true;
+    ++mCounters.kept;
+    return true;
+}
+
+bool MessageFilter::extractValue(const uint8_t *data, size_t len, double &value) const
+{
+    const char *begin = reinterpret_cast<const char *>(data);
+    if (!mJsonKey.empty())
+    {
+        return jsonValue(begin, begin + len, mJsonKey, value);
+    }
+    return csvValue(begin, begin + len, mCsvColumn, value);
+}
+
+bool MessageFilter::jsonValue(const char *begin, const char *end, const string &key, double &value)
+{
+    int depth = 0;
+    const char *p = begin;
+    while (p < end)
+    {
+        char c = *p++;
+        if (c == '"')
+        {
+            const char *stringStart = p;
+            while (p < end && *p != '"')
+            {
+                p += (*p == '\\') ? 2 : 1;
+            }
+            if (p >= end)
+            {
+                return false;
+            }
+            const char *stringEnd = p++;
+
+            // A string followed by a colon in the outermost object is a key.
+            if (depth == 1 && static_cast<size_t>(stringEnd - stringStart) == key.size() &&
+                memcmp(stringStart, key.data(), key.size()) == 0)
+            {
+                p = skipSpace(p, end);
+                if (p < end && *p == ':')
+                {
+                    return parseNumber(p + 1, end, value);
+                }
+            }
+        }
+        else if (c == '{' || c == '[')
+        {
+            ++depth;
+        }
+        else if (c == '}' || c == ']')
+        {
+            --depth;
+        }
+    }
+    return false;
+}
+
+bool MessageFilter::csvValue(const char *begin, const char *end, size_t column, double &value)
+{
+    const char *p = begin;
+    for (size_t i = 0; i < column; ++i)
+    {
+        p = static_cast<const char *>(memchr(p, ',', static_cast<size_t>(end - p)));
+        if (p == nullptr)
+        {
+            return false;
+        }
+        ++p;
+    }
+    return parseNumber(p, end, value);
+}
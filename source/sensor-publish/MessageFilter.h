@@ -0,0 +1,149 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_MESSAGEFILTER_H
+#define DEVICE_CLIENT_MESSAGEFILTER_H
+
+#include "../config/Config.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief MessageFilter drops sensor messages before they are batched.
+                 *
+                 * A message goes through each configured stage in turn, and is dropped by the first one that rejects
+                 * it:
+                 * - duplicate: the message is identical to the last message kept, compared by length and hash.
+                 * - deadband: the numeric value of a field, taken from a top-level JSON key or a CSV column, changed
+                 *   by no more than the deadband since the last message kept. Messages without the field are kept.
+                 * - sampling: only one in every filter_keep_every messages is kept, and at most one message per
+                 *   filter_min_interval_ms.
+                 *
+                 * Messages are read in place and never copied.
+                 *
+                 * Not thread safe, a filter is only used from the event loop of its sensor.
+                 */
+                class MessageFilter
+                {
+                  public:
+                    /**
+                     * \brief Number of messages kept, and dropped by each stage
+                     */
+                    struct Counters
+                    {
+                        std::uint64_t kept{0};
+                        std::uint64_t duplicate{0};
+                        std::uint64_t deadband{0};
+                        std::uint64_t sampled{0};
+
+                        std::uint64_t dropped() const { return duplicate + deadband + sampled; }
+                    };
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param settings the settings of the sensor, which have been validated
+                     */
+                    explicit MessageFilter(const PlainConfig::SensorPublish::SensorSettings &settings);
+
+                    /**
+                     * \brief Returns true when the settings of a sensor enable any filter stage
+                     */
+                    static bool configured(const PlainConfig::SensorPublish::SensorSettings &settings);
+
+                    /**
+                     * \brief Decide whether to keep a message
+                     *
+                     * @param data the start of the message
+                     * @param len the length of the message without its end of message delimiter
+                     * @param now the time the message was read
+                     * @return true when the message is kept
+                     */
+                    bool accept(
+                        const std::uint8_t *data,
+                        std::size_t len,
+                        std::chrono::high_resolution_clock::time_point now);
+
+                    const Counters &getCounters() const { return mCounters; }
+
+                    /**
+                     * \brief Find the numeric value of a top-level key in a JSON object
+                     *
+                     * A value given as a string, such as "21.5", is also parsed.
+                     *
+                     * @return true when the key is found and its value is a number
+                     */
+                    static bool jsonValue(const char *begin, const char *end, const std::string &key, double &value);
+
+                    /**
+                     * \brief Find the numeric value of a zero-based column of a comma separated line
+                     *
+                     * @return true when the column is found and its value is a number
+                     */
+                    static bool csvValue(const char *begin, const char *end, std::size_t column, double &value);
+
+                  private:
+                    bool mDedup{false};
+
+                    bool mDeadband{false};
+
+                    double mDeadbandWidth{0};
+
+                    /**
+                     * \brief Key of the deadband field, when it is read from JSON messages
+                     */
+                    std::string mJsonKey;
+
+                    /**
+                     * \brief Column of the deadband field, when it is read from CSV messages
+                     */
+                    std::size_t mCsvColumn{0};
+
+                    std::uint64_t mKeepEvery{1};
+
+                    std::chrono::milliseconds mMinInterval{0};
+
+                    /**
+                     * \brief Hash and length of the last message kept, for duplicate suppression
+                     */
+                    std::uint64_t mLastHash{0};
+
+                    std::size_t mLastLength{0};
+
+                    /**
+                     * \brief Field value of the last message kept, for the deadband
+                     */
+                    double mLastValue{0};
+
+                    bool mHaveLastValue{false};
+
+                    /**
+                     * \brief Number of messages which reached the sampling stage since the last one kept
+                     */
+                    std::uint64_t mSkipped{0};
+
+                    std::chrono::high_resolution_clock::time_point mLastKept;
+
+                    bool mHaveKept{false};
+
+                    Counters mCounters;
+
+                    bool extractValue(const std::uint8_t *data, std::size_t len, double &value) const;
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_MESSAGEFILTER_H
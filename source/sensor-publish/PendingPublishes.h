@@ -0,0 +1,88 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_PENDING_PUBLISHES_H
+#define DEVICE_CLIENT_PENDING_PUBLISHES_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief PendingPublishes counts the MQTT publishes of a sensor whose completion callback has not
+                 * returned yet.
+                 *
+                 * The completion callbacks of the sensor data, heartbeat and dead letter publishes access the sensor,
+                 * so a sensor may only be destroyed once none is pending. Each callback calls complete() as its last
+                 * access to the sensor, which then invokes the idle callback without accessing the sensor again. The
+                 * argument of the idle callback is shared, so that it outlives the owner of the sensor as long as a
+                 * callback is invoking it.
+                 */
+                class PendingPublishes
+                {
+                  public:
+                    /**
+                     * \brief Invoked once no publish is pending, from the thread completing the last one
+                     */
+                    using IdleCallback = void (*)(void *arg);
+
+                    /**
+                     * \brief Set the idle callback, before the first publish
+                     */
+                    void setIdleCallback(IdleCallback callback, std::shared_ptr<void> arg)
+                    {
+                        mIdleCallback = callback;
+                        mIdleArg = std::move(arg);
+                    }
+
+                    /**
+                     * \brief Count a publish, before it is queued
+                     */
+                    void add() { ++mCount; }
+
+                    /**
+                     * \brief Count a publish as complete, from any thread
+                     *
+                     * The sensor may be destroyed as soon as the count drops, so the idle callback is copied first.
+                     */
+                    void complete()
+                    {
+                        IdleCallback callback = mIdleCallback;
+                        if (callback == nullptr)
+                        {
+                            --mCount;
+                            return;
+                        }
+                        std::shared_ptr<void> arg = mIdleArg;
+                        if (--mCount == 0)
+                        {
+                            callback(arg.get());
+                        }
+                    }
+
+                    /**
+                     * \brief Number of pending publishes
+                     */
+                    std::size_t get() const { return mCount; }
+
+                  private:
+                    std::atomic<std::size_t> mCount{0};
+
+                    IdleCallback mIdleCallback{nullptr};
+
+                    std::shared_ptr<void> mIdleArg;
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_PENDING_PUBLISHES_H
@@ -5,6 +5,7 @@
 
 #include "../Feature.h"
 #include "../logging/LoggerFactory.h"
+#include "EventLoopCall.h"
 
 #include <aws/common/allocator.h>
 #include <aws/common/byte_buf.h>
@@ -17,11 +18,17 @@
 #include <aws/mqtt/client.h>
 
 #include <algorithm>
+#include <arpa/inet.h>
 #include <chrono>
+#include <cinttypes>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <functional>
+#include <limits>
 #include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace Aws::Iot;
@@ -31,6 +38,26 @@ using namespace Aws::Iot::DeviceClient::SensorPublish;
 using namespace Aws::Crt::Mqtt;
 
 constexpr char Sensor::TAG[];
+constexpr uint32_t Sensor::CONNECT_TIMEOUT_MS;
+constexpr size_t Sensor::SPOOL_IN_FLIGHT_LIMIT;
+constexpr size_t Sensor::SPOOL_SEGMENT_BYTES;
+constexpr int64_t Sensor::SPOOL_DRAIN_INTERVAL_MS;
+constexpr size_t Sensor::PUBACK_SAMPLE_SLOTS;
+constexpr int Sensor::PUBACK_ID_SHIFT;
+constexpr uint64_t Sensor::PUBACK_TIME_MASK;
+
+namespace
+{
+    /**
+     * \brief Userdata of a publish, holds a copy of the payload for the dead letter topic
+     */
+    struct PublishContext
+    {
+        Sensor *sensor;
+        aws_byte_buf payload;
+        size_t bytes;
+    };
+} // namespace
 
 Sensor::Sensor(
     const PlainConfig::SensorPublish::SensorSettings &settings,
@@ -39,14 +66,37 @@ Sensor::Sensor(
     aws_event_loop *eventLoop,
     shared_ptr<Socket> socket)
     : mSettings(settings), mAllocator(allocator), mConnection(connection), mEventLoop(eventLoop), mSocket(socket),
-      mEomPattern(settings.eomDelimiter.value()), mHeartbeatTask(mState, mSettings, mConnection, mEventLoop)
+      mEomMatcher(settings.eomDelimiter.has_value() ? settings.eomDelimiter.value() : string("\n")),
+      mHeartbeatTask(mState, mSettings, mCounters, mPending, mConnection, mEventLoop),
+      mDeadLetterTask(mSettings, mPending, mConnection, mEventLoop)
 {
+    // Round the allocation up to a power of two, so that positions keep mapping to the same index after they wrap.
+    mReadCapacity = static_cast<size_t>(mSettings.bufferCapacity.value());
+    size_t allocation = 1;
+    while (allocation < mReadCapacity)
+    {
+        allocation <<= 1;
+    }
+    mReadMask = allocation - 1;
+
     // Handle out of memory when allocating read buffer.
     AWS_ZERO_STRUCT(mReadBuf);
-    if (aws_byte_buf_init(&mReadBuf, mAllocator, mSettings.bufferCapacity.value()) != AWS_OP_SUCCESS)
+    AWS_ZERO_STRUCT(mWrapBuf);
+    if (aws_byte_buf_init(&mReadBuf, mAllocator, allocation) != AWS_OP_SUCCESS ||
+        aws_byte_buf_init(&mWrapBuf, mAllocator, mReadCapacity) != AWS_OP_SUCCESS)
     {
+        aws_byte_buf_clean_up(&mReadBuf);
         throw std::runtime_error{"Unable to allocate memory for read buffer"};
     }
+    mOwnedReadBuf = mReadBuf;
+
+    mDatagram = mSettings.transport.has_value() &&
+                mSettings.transport.value() == PlainConfig::SensorPublish::TRANSPORT_UNIX_DATAGRAM;
+    if (mSettings.transport.has_value() && mSettings.transport.value() == PlainConfig::SensorPublish::TRANSPORT_SHM)
+    {
+        mRing.reset(new ShmRing());
+        AWS_ZERO_STRUCT(mRingHandle);
+    }
 
     // Since topic never changes, initialize a cursor with statically allocated memory.
     mTopic = aws_byte_cursor_from_c_str(mSettings.mqttTopic->c_str());
@@ -67,42 +117,236 @@ Sensor::Sensor(
         },
         this,
         __func__);
+
+    // Initialize a task to publish buffered messages from the event loop when the publish timeout expires.
+    AWS_ZERO_STRUCT(mFlushTask);
+    aws_task_init(
+        &mFlushTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status)
+        {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->onFlushTaskCallback();
+        },
+        this,
+        __func__);
+
+    // Initialize a task to resume reading from the event loop once the in-flight window has room.
+    AWS_ZERO_STRUCT(mResumeTask);
+    aws_task_init(
+        &mResumeTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status)
+        {
+            auto *self = static_cast<Sensor *>(arg);
+            self->mResumeScheduled = false;
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            self->onResumeTaskCallback();
+        },
+        this,
+        __func__);
+
+    if (mSettings.batchFormat.has_value())
+    {
+        const string &format = mSettings.batchFormat.value();
+        if (format == PlainConfig::SensorPublish::BATCH_FORMAT_JSON)
+        {
+            mFormatter.reset(new BatchFormatter(BatchFormatter::Format::Json));
+        }
+        else if (format == PlainConfig::SensorPublish::BATCH_FORMAT_LENGTH_PREFIXED)
+        {
+            mFormatter.reset(new BatchFormatter(BatchFormatter::Format::LengthPrefixed));
+        }
+        else if (format == PlainConfig::SensorPublish::BATCH_FORMAT_CBOR)
+        {
+            mFormatter.reset(new BatchFormatter(BatchFormatter::Format::Cbor));
+        }
+    }
+
+    if (MessageFilter::configured(mSettings))
+    {
+        mFilter.reset(new MessageFilter(mSettings));
+    }
+
+    if (mSettings.adaptiveLatencyMs.has_value())
+    {
+        size_t maxPayloadBytes = mSettings.adaptiveMaxPayloadBytes.has_value()
+                                     ? static_cast<size_t>(mSettings.adaptiveMaxPayloadBytes.value())
+                                     : mReadCapacity;
+        mPublishEpoch = chrono::high_resolution_clock::now();
+        mBatchController.reset(new BatchController(
+            chrono::milliseconds(mSettings.adaptiveLatencyMs.value()), maxPayloadBytes, mPublishEpoch));
+    }
+    for (auto &slot : mPublishTimes)
+    {
+        slot = 0;
+    }
+
+    if (mSettings.compression.has_value() &&
+        mSettings.compression.value() == PlainConfig::SensorPublish::COMPRESSION_DEFLATE)
+    {
+        mCompressor.reset(new Compressor(static_cast<int>(mSettings.compressionLevel.value()), mReadCapacity));
+        if (!mCompressor->init())
+        {
+            aws_byte_buf_clean_up(&mReadBuf);
+            aws_byte_buf_clean_up(&mWrapBuf);
+            throw std::runtime_error{"Unable to initialize compression"};
+        }
+    }
+
+    // Recover batches spooled before a restart, they are published once the sensor is started.
+    if (mSettings.spoolDir.has_value() && !mSettings.spoolDir->empty())
+    {
+        mSpool.reset(new Spool(
+            mSettings.spoolDir.value(), static_cast<size_t>(mSettings.spoolMaxBytes.value()), SPOOL_SEGMENT_BYTES));
+        if (!mSpool->open())
+        {
+            aws_byte_buf_clean_up(&mReadBuf);
+            aws_byte_buf_clean_up(&mWrapBuf);
+            throw std::runtime_error{"Unable to open spool directory"};
+        }
+
+        // Initialize a task to publish spooled batches from the event loop.
+        AWS_ZERO_STRUCT(mDrainTask);
+        aws_task_init(
+            &mDrainTask,
+            [](struct aws_task *, void *arg, enum aws_task_status status)
+            {
+                if (status == AWS_TASK_STATUS_CANCELED)
+                {
+                    return; // Ignore canceled tasks.
+                }
+                auto *self = static_cast<Sensor *>(arg);
+                self->onDrainTaskCallback();
+            },
+            this,
+            __func__);
+        mLastDrain = chrono::high_resolution_clock::now();
+    }
 }
 
 Sensor::~Sensor()
 {
-    if (mSocket->is_open())
-    {
-        mState = SensorState::NotConnected;
-        mSocket->close();
-    }
+    // Tasks are canceled from the event loop, so that none of them runs once the sensor is destroyed.
+    runOnEventLoop(
+        [this]()
+        {
+            detachRing();
+            if (mSocket->is_open())
+            {
+                mState = SensorState::NotConnected;
+                mSocket->close();
+            }
+            cancelTasks();
+            mHeartbeatTask.stop();
+            mDeadLetterTask.stop();
+        });
     mSocket->clean_up();
-    mHeartbeatTask.stop();
     aws_byte_buf_clean_up_secure(&mReadBuf);
+    aws_byte_buf_clean_up_secure(&mWrapBuf);
 }
 
 int Sensor::start()
 {
     LOGM_DEBUG(TAG, "Starting sensor name: %s", mSettings.name->c_str());
+    mStarted = true;
     connect();
     mHeartbeatTask.start();
+    mDeadLetterTask.start();
+    scheduleDrain();
     return Feature::SUCCESS;
 }
 
 int Sensor::stop()
 {
     LOGM_DEBUG(TAG, "Stopping sensor name: %s", mSettings.name->c_str());
-    close();
-    reset();
-    mHeartbeatTask.stop();
+    runOnEventLoop(
+        [this]()
+        {
+            mStarted = false;
+            close();
+            reset();
+            cancelTasks();
+            mHeartbeatTask.stop();
+            mDeadLetterTask.stop();
+        });
+    if (mFilter)
+    {
+        const MessageFilter::Counters &counters = mFilter->getCounters();
+        LOGM_INFO(
+            TAG,
+            "Filtered sensor name: %s kept: %" PRIu64 " duplicate: %" PRIu64 " deadband: %" PRIu64 " sampled: %" PRIu64,
+            mSettings.name->c_str(),
+            counters.kept,
+            counters.duplicate,
+            counters.deadband,
+            counters.sampled);
+    }
     return Feature::SUCCESS;
 }
 
+void Sensor::runOnEventLoop(const function<void()> &callback)
+{
+    SensorPublish::runOnEventLoop(mEventLoop, callback);
+}
+
+void Sensor::cancelTasks()
+{
+    if (mState == SensorState::Connecting)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mConnectTask);
+        mState = SensorState::NotConnected;
+    }
+    if (mFlushScheduled)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mFlushTask);
+        mFlushScheduled = false;
+    }
+    if (mDrainScheduled)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mDrainTask);
+        mDrainScheduled = false;
+    }
+    if (mResumeScheduled)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mResumeTask);
+        mResumeScheduled = false;
+    }
+}
+
 string Sensor::getName() const
 {
     return mSettings.name.value();
 }
 
+MessageFilter::Counters Sensor::getFilterCounters() const
+{
+    return mFilter ? mFilter->getCounters() : MessageFilter::Counters();
+}
+
+void Sensor::drain()
+{
+    LOGM_DEBUG(TAG, "Drain sensor name: %s messages: %zu", mSettings.name->c_str(), mEomBounds.size());
+    mDraining = true;
+    while (!mEomBounds.empty())
+    {
+        // Every publish moves the timeout forward, so expire it again for the batch left below the batch size.
+        size_t buffered = mEomBounds.size();
+        mNextPublishTimeout = chrono::high_resolution_clock::now() - chrono::milliseconds(1);
+        publish();
+        if (mEomBounds.size() == buffered)
+        {
+            break;
+        }
+    }
+    mDraining = false;
+}
+
 void Sensor::connect(bool delay)
 {
     if (mState != SensorState::NotConnected)
@@ -120,6 +364,10 @@ void Sensor::connect(bool delay)
     }
 
     mState = SensorState::Connecting;
+    if (delay)
+    {
+        SensorCounters::add(mCounters.reconnects, 1);
+    }
 
     // Schedule task to cnnect to sensor socket.
     if (delay && mSettings.addrPollSec.value() > 0)
@@ -141,14 +389,55 @@ void Sensor::connect(bool delay)
 void Sensor::onConnectTaskCallback()
 {
     aws_socket_options socket_options;
-    socket_options.type = AWS_SOCKET_STREAM;
+    AWS_ZERO_STRUCT(socket_options);
+    socket_options.type = mDatagram ? AWS_SOCKET_DGRAM : AWS_SOCKET_STREAM;
     socket_options.domain = AWS_SOCKET_LOCAL;
-    mSocket->init(mAllocator, &socket_options);
+    socket_options.connect_timeout_ms = CONNECT_TIMEOUT_MS;
 
     aws_socket_endpoint endpoint{};
     AWS_ZERO_STRUCT(endpoint);
     snprintf(endpoint.address, AWS_ADDRESS_MAX_LEN, "%s", mSettings.addr->c_str());
 
+    if (mSettings.transport.has_value() && mSettings.transport.value() == PlainConfig::SensorPublish::TRANSPORT_TCP)
+    {
+        // The address is a numeric loopback address, checked when the config is validated.
+        in6_addr ipv6;
+        bool isIpv6 = inet_pton(AF_INET6, mSettings.addr->c_str(), &ipv6) == 1;
+        socket_options.domain = isIpv6 ? AWS_SOCKET_IPV6 : AWS_SOCKET_IPV4;
+        endpoint.port = static_cast<uint32_t>(mSettings.tcpPort.value());
+    }
+    mSocket->init(mAllocator, &socket_options);
+
+    if (mDatagram)
+    {
+        // The sensor sends datagrams to the address, so bind it rather than connect to it.
+        struct stat info;
+        if (lstat(mSettings.addr->c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        {
+            unlink(mSettings.addr->c_str()); // Remove the socket left by a previous run.
+        }
+
+        if (mSocket->bind(&endpoint) != AWS_OP_SUCCESS || mSocket->assign_to_event_loop(mEventLoop) != AWS_OP_SUCCESS)
+        {
+            // Log an error, clean up socket, and bind again later.
+            LOGM_ERROR(
+                TAG,
+                "Error sensor name: %s func: aws_socket_bind msg: %s",
+                mSettings.name->c_str(),
+                aws_error_str(aws_last_error()));
+            mSocket->clean_up();
+            mState = SensorState::NotConnected;
+            connect(true);
+            return;
+        }
+
+        // Only the owner and group of the device client may send to the sensor socket.
+        chmod(mSettings.addr->c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+        LOGM_DEBUG(TAG, "Success sensor name: %s func: aws_socket_bind", mSettings.name->c_str());
+        onConnectionResultCallback(AWS_OP_SUCCESS);
+        return;
+    }
+
     int rc = mSocket->connect(
         &endpoint,
         mEventLoop,
@@ -199,20 +488,36 @@ void Sensor::onConnectionResultCallback(int error_code)
         publish();
 
         // Update the publish timeout.
-        if (mSettings.bufferTimeMs.value() > 0)
+        if (getBufferTimeMs() > 0)
         {
-            chrono::milliseconds delayMs(mSettings.bufferTimeMs.value());
+            chrono::milliseconds delayMs(getBufferTimeMs());
             mNextPublishTimeout = chrono::high_resolution_clock::now() + delayMs;
         }
 
+        // Publish previously buffered data once the timeout expires.
+        scheduleFlush();
+
         // Register callback that will be invoked when the socket is readable.
         mSocket->subscribe_to_readable_events(
             [](struct aws_socket *, int error_code, void *user_data)
             {
                 auto *self = static_cast<Sensor *>(user_data);
-                self->onReadableCallback(error_code);
+                if (self->mRing)
+                {
+                    self->onShmSocketReadableCallback(error_code);
+                }
+                else
+                {
+                    self->onReadableCallback(error_code);
+                }
             },
             this);
+
+        // The producer may have passed the ring before the callback was registered.
+        if (mRing)
+        {
+            onShmSocketReadableCallback(AWS_OP_SUCCESS);
+        }
     }
 }
 
@@ -243,28 +548,87 @@ void Sensor::onReadableCallback(int error_code)
         bool readWouldBlock = false;
         while (!readWouldBlock)
         {
-            size_t numRead = 0, startPos = mReadBuf.len;
-            int rc = mSocket->read(&mReadBuf, &numRead);
+            // Without a spool, leave the data in the socket while the in-flight window is full, so that
+            // backpressure reaches the sensor rather than growing the memory queued for publish.
+            if (!mSpool && inFlightWindowFull())
+            {
+                // Set the flag before checking again, so that a publish acknowledged meanwhile resumes reads.
+                mReadPaused = true;
+                if (inFlightWindowFull())
+                {
+                    LOGM_DEBUG(
+                        TAG,
+                        "Pause reading sensor name: %s in-flight: %zu",
+                        mSettings.name->c_str(),
+                        mInFlight.load());
+                    return;
+                }
+                mReadPaused = false;
+            }
+
+            size_t numRead = 0;
+            int rc;
+            if (mRing)
+            {
+                rc = readRing(numRead);
+            }
+            else if (mDatagram)
+            {
+                rc = readDatagram(numRead);
+            }
+            else
+            {
+                // Read into the free space that follows the buffered data, up to the end of the buffer.
+                size_t writeIndex = (mReadStart + mReadBuf.len) & mReadMask;
+                aws_byte_buf readBuf = aws_byte_buf_from_empty_array(
+                    mReadBuf.buffer + writeIndex, min(mReadCapacity - mReadBuf.len, mReadBuf.capacity - writeIndex));
+                rc = mSocket->read(&readBuf, &numRead);
+            }
             if (rc == AWS_OP_SUCCESS)
             {
+                size_t startPos = mReadStart + mReadBuf.len;
+                size_t boundsBefore = mEomBounds.size();
+                size_t foundBefore = (mFilter ? mFoundBounds : mEomBounds).size();
+                mReadBuf.len += numRead;
                 LOGM_DEBUG(TAG, "Read sensor name: %s bytes: %zu", mSettings.name->c_str(), numRead);
+                SensorCounters::add(mCounters.bytesRead, numRead);
+                mCounters.recordBufferFill(mReadBuf.len);
 
-                // Scan the buffer for end of message boundaries.
-                // If the buffer is empty, then start scan from start of read.
-                // If the buffer is not empty, then start from one past end of last message.
-                const char *pbuf = reinterpret_cast<char *>(mReadBuf.buffer);
-                auto beginPos = mEomBounds.empty() ? startPos : mEomBounds.back();
-                for (auto m = cregex_iterator(pbuf + beginPos, pbuf + startPos + numRead, mEomPattern),
-                          mend = cregex_iterator();
-                     m != mend;
-                     ++m)
+                if (mDatagram)
                 {
-                    // Store the position of one-past the end of the match.
-                    mEomBounds.emplace(beginPos + (*m).position() + (*m).length());
+                    // Every datagram is one message, there is no delimiter to scan for.
+                    if (numRead > 0)
+                    {
+                        (mFilter ? mFoundBounds : mEomBounds).push(startPos + numRead);
+                    }
+                }
+                else
+                {
+                    // Scan the buffer for end of message boundaries.
+                    // If the buffer is empty, then start scan from start of read.
+                    // If the buffer is not empty, then start from one past end of last message.
+                    size_t beginPos = mEomBounds.empty() && mFilteredRanges.empty() ? startPos : lastMessageEnd();
+                    aws_byte_cursor scanBuf = readBufCursor(beginPos, startPos + numRead - beginPos);
+                    const char *pbuf = reinterpret_cast<const char *>(scanBuf.ptr);
+                    mEomMatcher.findAll(pbuf, pbuf + scanBuf.len, beginPos, mFilter ? mFoundBounds : mEomBounds);
+                }
+                SensorCounters::add(mCounters.messages, (mFilter ? mFoundBounds : mEomBounds).size() - foundBefore);
+
+                if (mFilter)
+                {
+                    filterMessages();
+                }
+
+                if (mBatchController)
+                {
+                    updateBatchController(mEomBounds.size() - boundsBefore, numRead);
                 }
 
                 // Invoke publish to check whether batch limits are breached.
                 publish();
+
+                // Publish the remaining messages once the timeout expires, even if no more data arrives.
+                scheduleFlush();
             }
             else
             {
@@ -298,6 +662,231 @@ void Sensor::onReadableCallback(int error_code)
     }
 }
 
+int Sensor::readDatagram(size_t &numRead)
+{
+    numRead = 0;
+    size_t datagramBytes;
+    if (mSocket->peek_datagram_size(&datagramBytes) != AWS_OP_SUCCESS)
+    {
+        return AWS_OP_ERR;
+    }
+
+    if (datagramBytes > mReadCapacity)
+    {
+        // Read what fits to report it, the rest of the datagram is discarded by the socket.
+        aws_byte_buf_reset(&mWrapBuf, false);
+        aws_byte_buf empty = aws_byte_buf_from_empty_array(mWrapBuf.buffer, 0);
+        size_t truncatedBytes = 0;
+        if (mSocket->read_datagram(&mWrapBuf, &empty, &truncatedBytes) != AWS_OP_SUCCESS)
+        {
+            return AWS_OP_ERR;
+        }
+        LOGM_ERROR(
+            TAG,
+            "Datagram is larger than the buffer, discarding %zu bytes sensor name: %s",
+            datagramBytes,
+            mSettings.name->c_str());
+        mDeadLetterTask.add(DeadLetterTask::REASON_BUFFER_FULL, aws_byte_cursor_from_buf(&mWrapBuf), datagramBytes);
+        SensorCounters::add(mCounters.discardedBytes, datagramBytes);
+        return AWS_OP_SUCCESS;
+    }
+
+    // Make room by publishing buffered messages, which stops early only when the in-flight window is full.
+    mNextReadBytes = datagramBytes;
+    while (mReadCapacity - mReadBuf.len < datagramBytes && !mEomBounds.empty())
+    {
+        size_t bufferedBytes = mReadBuf.len;
+        publish();
+        if (mReadBuf.len == bufferedBytes)
+        {
+            return AWS_OP_SUCCESS; // Read again once the in-flight window has room.
+        }
+    }
+    mNextReadBytes = 1;
+
+    // Read into the free space that follows the buffered data, which may wrap around the end of the buffer.
+    size_t writeIndex = (mReadStart + mReadBuf.len) & mReadMask;
+    size_t freeBytes = mReadCapacity - mReadBuf.len;
+    size_t firstBytes = min(freeBytes, mReadBuf.capacity - writeIndex);
+    aws_byte_buf first = aws_byte_buf_from_empty_array(mReadBuf.buffer + writeIndex, firstBytes);
+    aws_byte_buf second = aws_byte_buf_from_empty_array(mReadBuf.buffer, freeBytes - firstBytes);
+    return mSocket->read_datagram(&first, &second, &numRead);
+}
+
+void Sensor::onShmSocketReadableCallback(int error_code)
+{
+    if (error_code)
+    {
+        // Log an error, close socket, and reconnect to sensor.
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: %s msg: %s",
+            mSettings.name->c_str(),
+            __func__,
+            aws_error_str(error_code));
+        close();
+        connect(true);
+        return;
+    }
+
+    // The producer passes the ring once after accepting the connection, any other data is ignored. The socket stays
+    // open so that each side notices when the other one goes away.
+    bool attachedNow = false;
+    bool readWouldBlock = false;
+    while (!readWouldBlock)
+    {
+        uint8_t data[16];
+        aws_byte_buf readBuf = aws_byte_buf_from_empty_array(data, sizeof(data));
+        int fds[2];
+        size_t numFds = 2;
+        size_t numRead = 0;
+        if (mSocket->read_with_fds(&readBuf, &numRead, fds, &numFds) == AWS_OP_SUCCESS)
+        {
+            if (numFds == 2 && !mRing->attached())
+            {
+                if (!attachRing(fds[0], fds[1]))
+                {
+                    close();
+                    connect(true);
+                    return;
+                }
+                attachedNow = true;
+            }
+            else
+            {
+                for (size_t i = 0; i < numFds; ++i)
+                {
+                    ::close(fds[i]);
+                }
+            }
+            continue;
+        }
+
+        int lastError = aws_last_error();
+        if (lastError == AWS_IO_READ_WOULD_BLOCK)
+        {
+            readWouldBlock = true;
+        }
+        else if (lastError == AWS_IO_SOCKET_NOT_CONNECTED || lastError == AWS_IO_SOCKET_CLOSED)
+        {
+            // Close socket, and reconnect to sensor.
+            close();
+            connect(true);
+            return;
+        }
+        else
+        {
+            // Log an error and wait for socket to become readable before trying to read.
+            LOGM_ERROR(
+                TAG,
+                "Error sensor name: %s func: aws_socket_read msg: %s",
+                mSettings.name->c_str(),
+                aws_error_str(lastError));
+            readWouldBlock = true;
+        }
+    }
+
+    if (attachedNow)
+    {
+        LOGM_INFO(
+            TAG,
+            "Reading from shared memory ring sensor name: %s bytes: %zu",
+            mSettings.name->c_str(),
+            mRing->capacity());
+        // Read the data written before the ring was attached, later data is signaled through the eventfd.
+        onReadableCallback(AWS_OP_SUCCESS);
+    }
+}
+
+bool Sensor::attachRing(int memFd, int eventFd)
+{
+    if (!mRing->attach(memFd, eventFd))
+    {
+        return false;
+    }
+
+    AWS_ZERO_STRUCT(mRingHandle);
+    mRingHandle.data.fd = mRing->eventFd();
+    int rc = aws_event_loop_subscribe_to_io_events(
+        mEventLoop,
+        &mRingHandle,
+        AWS_IO_EVENT_TYPE_READABLE,
+        [](struct aws_event_loop *, struct aws_io_handle *, int, void *user_data)
+        {
+            auto *self = static_cast<Sensor *>(user_data);
+            self->mRing->clearWakeup();
+            self->onReadableCallback(AWS_OP_SUCCESS);
+        },
+        this);
+    if (rc != AWS_OP_SUCCESS)
+    {
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: aws_event_loop_subscribe_to_io_events msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        mRing->detach();
+        return false;
+    }
+
+    // Batch in place from the ring, starting from the first byte the previous connection did not release.
+    reset();
+    mReadBuf = aws_byte_buf_from_empty_array(mRing->data(), mRing->capacity());
+    mReadMask = mRing->capacity() - 1;
+    mReadCapacity = min(mReadCapacity, mRing->capacity());
+    mReadStart = static_cast<size_t>(mRing->tail());
+    return true;
+}
+
+void Sensor::detachRing()
+{
+    if (!mRing || !mRing->attached())
+    {
+        return;
+    }
+
+    // Unlike closing the eventfd, which the producer keeps open, unsubscribing stops its events. epoll_ctl is thread
+    // safe and the event loop frees the handle data itself, so this is safe from any thread.
+    aws_event_loop_unsubscribe_from_io_events(mEventLoop, &mRingHandle);
+    mRing->detach();
+
+    mReadBuf = mOwnedReadBuf;
+    mReadMask = mOwnedReadBuf.capacity - 1;
+    mReadCapacity = static_cast<size_t>(mSettings.bufferCapacity.value());
+    reset();
+}
+
+int Sensor::readRing(size_t &numRead)
+{
+    numRead = 0;
+    if (!mRing->attached())
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK); // Read once the producer passed the ring.
+    }
+
+    size_t readable = 0;
+    bool valid = mRing->readable(readable);
+    if (valid && readable == mReadBuf.len)
+    {
+        // Ask for a wakeup before waiting, then check again for data written meanwhile.
+        mRing->requestWakeup();
+        valid = mRing->readable(readable);
+    }
+    if (!valid)
+    {
+        LOGM_ERROR(TAG, "Shared memory ring position is not valid sensor name: %s", mSettings.name->c_str());
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+    if (readable == mReadBuf.len)
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    // The data is already in place, so reading only extends the buffered data up to the capacity.
+    numRead = min(readable - mReadBuf.len, mReadCapacity - mReadBuf.len);
+    return AWS_OP_SUCCESS;
+}
+
 void Sensor::publish()
 {
     // Check whether limits are breached and, if so, compute bufferSize and numBatches.
@@ -308,50 +897,303 @@ void Sensor::publish()
         return;
     }
 
-    size_t startPos = 0, lastEom = 0;
+    size_t lastEom = mReadStart;
+    bool published = false;
     while (numBatches > 0)
     {
+        // Keep the remaining messages buffered until a publish is acknowledged, unless they can be spooled. The
+        // resume task publishes them then, so set the flag before checking again as when reads are paused.
+        if (!mSpool && !mDraining && inFlightWindowFull())
+        {
+            mReadPaused = true;
+            if (inFlightWindowFull())
+            {
+                break;
+            }
+        }
+
         // Publish complete messages in bufferSize increments.
         size_t numToPub = min(mEomBounds.size(), bufferSize);
-        for (size_t i = 0; i < numToPub; ++i)
+        aws_byte_cursor pubBuf;
+        if (mFormatter)
         {
-            lastEom = mEomBounds.front();
-            mEomBounds.pop();
+            // Frame each message without its delimiter, in the same pass over the boundaries.
+            mFormatter->begin(numToPub);
+            for (size_t i = 0; i < numToPub; ++i)
+            {
+                size_t messageStart = lastEom;
+                if (!mFilteredRanges.empty() && mFilteredRanges.front().first == messageStart)
+                {
+                    // Skip the dropped messages before this one, they are released with the batch.
+                    messageStart = mFilteredRanges.front().second;
+                    mFilteredRanges.pop();
+                }
+                lastEom = mEomBounds.front();
+                mEomBounds.pop();
+                aws_byte_cursor message = readBufCursor(messageStart, lastEom - messageStart);
+                const char *begin = reinterpret_cast<const char *>(message.ptr);
+                mFormatter->add(
+                    message.ptr, mDatagram ? message.len : mEomMatcher.messageLength(begin, begin + message.len));
+            }
+            pubBuf = mFormatter->finish();
         }
+        else
+        {
+            for (size_t i = 0; i < numToPub; ++i)
+            {
+                lastEom = mEomBounds.front();
+                mEomBounds.pop();
+            }
 
-        // Create a shallow copy of a buffer up to the lastEom.
-        aws_byte_cursor pubBuf = aws_byte_cursor_from_array(mReadBuf.buffer + startPos, lastEom);
+            // Create a shallow copy of the buffer up to the lastEom, unless the batch wraps around the end of the
+            // buffer or holds dropped messages.
+            if (mFilteredRanges.empty() || mFilteredRanges.front().first >= lastEom)
+            {
+                pubBuf = readBufCursor(mReadStart, lastEom - mReadStart);
+            }
+            else
+            {
+                pubBuf = gatherKeptMessages(lastEom);
+            }
+        }
         LOGM_DEBUG(TAG, "Publish sensor name: %s bytes: %zu", mSettings.name->c_str(), pubBuf.len);
 
         // Publish buffer.
-        publishOneMessage(&pubBuf);
+        publishOrSpool(&pubBuf);
+        SensorCounters::add(mCounters.batches, 1);
+        published = true;
 
-        // Update start of next message to 1-past end of current message.
-        startPos = lastEom;
+        // Release the published messages, the start of next message is 1-past end of current message.
+        consumeReadBuf(lastEom - mReadStart);
+        releaseFiltered();
 
         --numBatches;
     }
 
-    if (mEomBounds.empty())
+    // Update the publish timeout, unless the in-flight window held back every batch. The held back batches are then
+    // published as soon as the window has room, rather than another bufferTimeMs later.
+    if (published && getBufferTimeMs() > 0)
+    {
+        chrono::milliseconds delayMs(getBufferTimeMs());
+        mNextPublishTimeout = chrono::high_resolution_clock::now() + delayMs;
+    }
+}
+
+void Sensor::onFlushTaskCallback()
+{
+    mFlushScheduled = false;
+    if (mState != SensorState::Connected)
     {
-        // Advance the lastEom to the start of the buffer.
-        size_t count = mReadBuf.len - lastEom;
-        std::memcpy(mReadBuf.buffer, mReadBuf.buffer + lastEom, count);
-        mReadBuf.len = count;
+        return; // Buffered messages are published after reconnecting.
     }
 
-    // Update the publish timeout.
-    if (mSettings.bufferTimeMs.value() > 0)
+    if (chrono::high_resolution_clock::now() > mNextPublishTimeout)
     {
-        chrono::milliseconds delayMs(mSettings.bufferTimeMs.value());
-        mNextPublishTimeout = chrono::high_resolution_clock::now() + delayMs;
+        publish();
+    }
+
+    // Schedule the task again, either for messages left in the buffer or because a publish moved the timeout.
+    scheduleFlush();
+}
+
+void Sensor::scheduleFlush()
+{
+    // While the in-flight window is full, the resume task publishes the buffered messages instead.
+    if (mFlushScheduled || getBufferTimeMs() <= 0 || mEomBounds.empty() || mReadPaused ||
+        mState != SensorState::Connected)
+    {
+        return;
+    }
+
+    // The publish timeout is measured with the standard library clock, so schedule the task after the time remaining.
+    auto delay = mNextPublishTimeout - chrono::high_resolution_clock::now();
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    if (delay.count() > 0)
+    {
+        runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delay).count();
+    }
+    // Run just past the timeout, since publish() requires the timeout to be exceeded.
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::milliseconds(1)).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mFlushTask, runAtNanos);
+    mFlushScheduled = true;
+}
+
+void Sensor::publishOrSpool(const aws_byte_cursor *payload)
+{
+    if (mSpool && (!mSpool->empty() || inFlightWindowFull()))
+    {
+        if (mSpool->append(*payload))
+        {
+            LOGM_DEBUG(TAG, "Spool sensor name: %s bytes: %zu", mSettings.name->c_str(), payload->len);
+            scheduleDrain();
+            return;
+        }
+        // Fall back to the in-memory queue of the MQTT connection rather than lose the batch.
+    }
+    publishOneMessage(payload);
+}
+
+void Sensor::onDrainTaskCallback()
+{
+    mDrainScheduled = false;
+    if (!mStarted)
+    {
+        return; // Spooled batches are published once the sensor is started again.
+    }
+
+    // Replenish the budget for the time elapsed, allowing at most one second of burst.
+    auto now = chrono::high_resolution_clock::now();
+    double rate = static_cast<double>(mSettings.spoolDrainBytesPerSec.value());
+    mDrainBudget = min(rate, mDrainBudget + rate * chrono::duration<double>(now - mLastDrain).count());
+    mLastDrain = now;
+
+    // A batch larger than one second of budget is published once the budget is full, and paid for afterwards.
+    aws_byte_cursor payload;
+    while (!inFlightWindowFull() && mSpool->front(payload) &&
+           (static_cast<double>(payload.len) <= mDrainBudget || mDrainBudget >= rate))
+    {
+        LOGM_DEBUG(TAG, "Drain spool sensor name: %s bytes: %zu", mSettings.name->c_str(), payload.len);
+        mDrainBudget -= static_cast<double>(payload.len);
+        publishOneMessage(&payload);
+        mSpool->pop();
+    }
+
+    scheduleDrain();
+}
+
+void Sensor::scheduleDrain()
+{
+    if (mDrainScheduled || !mSpool || mSpool->empty())
+    {
+        return;
+    }
+
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    chrono::milliseconds delayMs(SPOOL_DRAIN_INTERVAL_MS);
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mDrainTask, runAtNanos);
+    mDrainScheduled = true;
+}
+
+size_t Sensor::getInFlightWindow() const
+{
+    if (mSettings.maxInFlight.value() > 0)
+    {
+        return static_cast<size_t>(mSettings.maxInFlight.value());
+    }
+    return mSpool ? SPOOL_IN_FLIGHT_LIMIT : numeric_limits<size_t>::max();
+}
+
+void Sensor::onPublishComplete()
+{
+    --mInFlight;
+    if (mReadPaused && !inFlightWindowFull() && !mResumeScheduled.exchange(true))
+    {
+        aws_event_loop_schedule_task_now(mEventLoop, &mResumeTask);
+    }
+}
+
+void Sensor::recordPublishTime(uint16_t packetId)
+{
+    if (!mBatchController)
+    {
+        return;
+    }
+    auto sent = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - mPublishEpoch);
+    uint64_t micros = static_cast<uint64_t>(max<int64_t>(0, sent.count())) & PUBACK_TIME_MASK;
+    mPublishTimes[packetId % PUBACK_SAMPLE_SLOTS] = (static_cast<uint64_t>(packetId) << PUBACK_ID_SHIFT) | micros;
+}
+
+void Sensor::onPuback(uint16_t packetId)
+{
+    if (!mBatchController)
+    {
+        return;
+    }
+
+    // The PUBACK may arrive before its send time is recorded, or after the slot is reused, then it is not measured.
+    uint64_t slot = mPublishTimes[packetId % PUBACK_SAMPLE_SLOTS].exchange(0);
+    if (slot == 0 || (slot >> PUBACK_ID_SHIFT) != packetId)
+    {
+        return;
+    }
+    auto now = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - mPublishEpoch);
+    int64_t latency = now.count() - static_cast<int64_t>(slot & PUBACK_TIME_MASK);
+    if (latency >= 0)
+    {
+        mPubackMicros += static_cast<uint64_t>(latency);
+        ++mPubacks;
+    }
+}
+
+void Sensor::updateBatchController(size_t messages, size_t bytes)
+{
+    mBatchController->onMessages(messages, bytes);
+    uint64_t pubacks = mPubacks.exchange(0);
+    uint64_t pubackMicros = mPubackMicros.exchange(0);
+    if (pubacks > 0)
+    {
+        mBatchController->onPuback(chrono::microseconds(static_cast<int64_t>(pubackMicros / pubacks)));
+    }
+
+    if (mBatchController->update(chrono::high_resolution_clock::now()))
+    {
+        LOGM_DEBUG(
+            TAG,
+            "Adapt batching sensor name: %s rate: %.1f msg/s message: %.0f bytes puback: %.1f ms batch size: %zu "
+            "batch time: %lld ms",
+            mSettings.name->c_str(),
+            mBatchController->getArrivalRate(),
+            mBatchController->getMessageBytes(),
+            mBatchController->getPubackLatencyMs(),
+            mBatchController->getBatchSize(),
+            static_cast<long long>(mBatchController->getBatchTime().count()));
+        if (mBatchController->getBatchTime().count() == 0)
+        {
+            // Publish the buffered messages now rather than when the previous batch time runs out.
+            mNextPublishTimeout = TimePointT();
+        }
+    }
+}
+
+size_t Sensor::getBufferSize() const
+{
+    if (mBatchController)
+    {
+        return mBatchController->getBatchSize();
+    }
+    return static_cast<size_t>(mSettings.bufferSize.value());
+}
+
+int64_t Sensor::getBufferTimeMs() const
+{
+    if (mBatchController)
+    {
+        return mBatchController->getBatchTime().count();
     }
+    return mSettings.bufferTimeMs.value();
+}
+
+void Sensor::onResumeTaskCallback()
+{
+    if (!mReadPaused.exchange(false) || mState != SensorState::Connected)
+    {
+        return; // Reads are resumed by the readable event after reconnecting.
+    }
+    LOGM_DEBUG(TAG, "Resume reading sensor name: %s in-flight: %zu", mSettings.name->c_str(), mInFlight.load());
+
+    // Publish the messages held back while the window was full, then read the data left in the socket.
+    publish();
+    scheduleFlush();
+    onReadableCallback(AWS_OP_SUCCESS);
 }
 
 bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
 {
     // Buffer size is the number of messages published in a single batch.
-    bufferSize = size_t(mSettings.bufferSize.value());
+    bufferSize = getBufferSize();
     if (bufferSize == 0)
     {
         // Publish all buffered messages as a single batch.
@@ -370,7 +1212,7 @@ bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
             {
                 numBatches = 1; // Publish timeout.
             }
-            else if (mReadBuf.len == mReadBuf.capacity)
+            else if (mReadCapacity - mReadBuf.len < mNextReadBytes)
             {
                 numBatches = 1; // Buffer full.
             }
@@ -379,7 +1221,7 @@ bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
         {
             // Discard unpublished data when buffer is full and we haven't
             // found any end of message delimeters in the buffer.
-            if (mReadBuf.len == mReadBuf.capacity)
+            if (mReadBuf.len == mReadCapacity)
             {
                 LOGM_ERROR(
                     TAG,
@@ -387,7 +1229,10 @@ bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
                     "messages sensor name: %s",
                     mReadBuf.len,
                     mSettings.name->c_str());
-                aws_byte_buf_reset(&mReadBuf, false);
+                aws_byte_cursor discarded = readBufCursor(mReadStart, mReadBuf.len);
+                mDeadLetterTask.add(DeadLetterTask::REASON_BUFFER_FULL, discarded, discarded.len);
+                SensorCounters::add(mCounters.discardedBytes, mReadBuf.len);
+                consumeReadBuf(mReadBuf.len);
             }
         }
     }
@@ -397,36 +1242,151 @@ bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
 
 void Sensor::publishOneMessage(const aws_byte_cursor *payload)
 {
-    aws_mqtt_client_connection_publish(
+    // Compress into the buffer of the compressor, which the MQTT client copies before the next batch is compressed.
+    aws_byte_cursor compressed;
+    const aws_byte_cursor *published = payload;
+    if (mCompressor)
+    {
+        if (!mCompressor->compress(*payload, compressed))
+        {
+            LOGM_ERROR(TAG, "Error sensor name: %s func: compress", mSettings.name->c_str());
+            mCounters.addPublishError();
+            mDeadLetterTask.add(DeadLetterTask::REASON_PUBLISH_FAILED, *payload, payload->len);
+            return;
+        }
+        LOGM_DEBUG(
+            TAG,
+            "Compressed sensor name: %s bytes: %zu compressed: %zu",
+            mSettings.name->c_str(),
+            payload->len,
+            compressed.len);
+        published = &compressed;
+    }
+
+    ++mInFlight;
+    mPending.add();
+    if (!mDeadLetterTask.started())
+    {
+        uint16_t packetId = aws_mqtt_client_connection_publish(
+            mConnection->GetUnderlyingConnection(),
+            &mTopic,
+            AWS_MQTT_QOS_AT_LEAST_ONCE,
+            false,
+            published,
+            [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata)
+            {
+                auto *self = static_cast<Sensor *>(userdata);
+                if (error_code)
+                {
+                    // Log an error, but otherwise discard the message data.
+                    self->mCounters.addPublishError();
+                    LOGM_ERROR(
+                        TAG,
+                        "Error sensor name: %s func: %s msg: %s",
+                        self->mSettings.name->c_str(),
+                        __func__,
+                        aws_error_str(error_code));
+                }
+                else
+                {
+                    LOGM_DEBUG(
+                        TAG, "Publish complete sensor name: %s packetId: %d", self->mSettings.name->c_str(), packet_id);
+                    self->onPuback(packet_id);
+                }
+                self->onPublishComplete();
+                self->mPending.complete(); // Last access, the sensor may be destroyed once nothing is pending.
+            },
+            this);
+        if (packetId == 0)
+        {
+            // The completion callback is never invoked when the publish is not queued.
+            mCounters.addPublishError();
+            LOGM_ERROR(
+                TAG,
+                "Error sensor name: %s func: aws_mqtt_client_connection_publish msg: %s",
+                mSettings.name->c_str(),
+                aws_error_str(aws_last_error()));
+            onPublishComplete();
+            mPending.complete();
+        }
+        else
+        {
+            recordPublishTime(packetId);
+        }
+        return;
+    }
+
+    // Keep a copy of the part of the payload recorded by the dead letter task, until the publish completes.
+    aws_byte_cursor kept = *payload;
+    kept.len = min(kept.len, DeadLetterTask::MAX_RECORD_PAYLOAD_BYTES);
+    auto *context = new PublishContext{this, {}, payload->len};
+    if (aws_byte_buf_init_copy_from_cursor(&context->payload, mAllocator, kept) != AWS_OP_SUCCESS)
+    {
+        AWS_ZERO_STRUCT(context->payload);
+    }
+
+    uint16_t packetId = aws_mqtt_client_connection_publish(
         mConnection->GetUnderlyingConnection(),
         &mTopic,
         AWS_MQTT_QOS_AT_LEAST_ONCE,
         false,
-        payload,
+        published,
         [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata)
         {
-            auto *self = static_cast<Sensor *>(userdata);
+            auto *context = static_cast<PublishContext *>(userdata);
+            auto *self = context->sensor;
             if (error_code)
             {
-                // Log an error, but otherwise discard the message data.
+                // Log an error and send the message data to the dead letter topic.
+                self->mCounters.addPublishError();
                 LOGM_ERROR(
                     TAG,
                     "Error sensor name: %s func: %s msg: %s",
                     self->mSettings.name->c_str(),
                     __func__,
                     aws_error_str(error_code));
+                self->mDeadLetterTask.add(
+                    DeadLetterTask::REASON_PUBLISH_FAILED,
+                    aws_byte_cursor_from_buf(&context->payload),
+                    context->bytes);
             }
             else
             {
                 LOGM_DEBUG(
                     TAG, "Publish complete sensor name: %s packetId: %d", self->mSettings.name->c_str(), packet_id);
+                self->onPuback(packet_id);
             }
+            aws_byte_buf_clean_up(&context->payload);
+            delete context;
+            self->onPublishComplete();
+            self->mPending.complete(); // Last access, the sensor may be destroyed once nothing is pending.
         },
-        this);
+        context);
+    if (packetId == 0)
+    {
+        // The completion callback is never invoked when the publish is not queued.
+        mCounters.addPublishError();
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: aws_mqtt_client_connection_publish msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        mDeadLetterTask.add(
+            DeadLetterTask::REASON_PUBLISH_FAILED, aws_byte_cursor_from_buf(&context->payload), context->bytes);
+        aws_byte_buf_clean_up(&context->payload);
+        delete context;
+        onPublishComplete();
+        mPending.complete();
+    }
+    else
+    {
+        recordPublishTime(packetId);
+    }
 }
 
 void Sensor::close()
 {
+    detachRing();
     if (mSocket->is_open())
     {
         mState = SensorState::NotConnected;
@@ -446,11 +1406,137 @@ void Sensor::close()
     }
 }
 
-void Sensor::reset()
+aws_byte_cursor Sensor::readBufCursor(size_t position, size_t count)
+{
+    size_t index = position & mReadMask;
+    if (index + count <= mReadBuf.capacity)
+    {
+        return aws_byte_cursor_from_array(mReadBuf.buffer + index, count);
+    }
+
+    // Copy both parts of the data into a contiguous buffer.
+    size_t firstPart = mReadBuf.capacity - index;
+    std::memcpy(mWrapBuf.buffer, mReadBuf.buffer + index, firstPart);
+    std::memcpy(mWrapBuf.buffer + firstPart, mReadBuf.buffer, count - firstPart);
+    mWrapBuf.len = count;
+    return aws_byte_cursor_from_buf(&mWrapBuf);
+}
+
+size_t Sensor::lastMessageEnd() const
+{
+    size_t end = mEomBounds.empty() ? mReadStart : mEomBounds.back();
+    if (!mFilteredRanges.empty())
+    {
+        end = max(end, mFilteredRanges.back().second);
+    }
+    return end;
+}
+
+void Sensor::filterMessages()
+{
+    auto now = chrono::high_resolution_clock::now();
+    size_t messageStart = lastMessageEnd();
+    while (!mFoundBounds.empty())
+    {
+        size_t messageEnd = mFoundBounds.front();
+        mFoundBounds.pop();
+
+        aws_byte_cursor message = readBufCursor(messageStart, messageEnd - messageStart);
+        const char *begin = reinterpret_cast<const char *>(message.ptr);
+        size_t length = mDatagram ? message.len : mEomMatcher.messageLength(begin, begin + message.len);
+        if (mFilter->accept(message.ptr, length, now))
+        {
+            mEomBounds.push(messageEnd);
+        }
+        else if (!mFilteredRanges.empty() && mFilteredRanges.back().second == messageStart)
+        {
+            mFilteredRanges.back().second = messageEnd;
+        }
+        else
+        {
+            mFilteredRanges.push(make_pair(messageStart, messageEnd));
+        }
+        messageStart = messageEnd;
+    }
+    releaseFiltered();
+}
+
+void Sensor::releaseFiltered()
+{
+    while (!mFilteredRanges.empty() && mFilteredRanges.front().first == mReadStart)
+    {
+        size_t count = mFilteredRanges.front().second - mFilteredRanges.front().first;
+        mFilteredRanges.pop();
+        consumeReadBuf(count);
+    }
+}
+
+aws_byte_cursor Sensor::gatherKeptMessages(size_t end)
+{
+    aws_byte_buf_reset(&mWrapBuf, false);
+    size_t position = mReadStart;
+    while (position < end)
+    {
+        size_t runEnd = end;
+        if (!mFilteredRanges.empty() && mFilteredRanges.front().first < end)
+        {
+            runEnd = mFilteredRanges.front().first;
+        }
+
+        // Copy the run in up to two parts, when it wraps around the end of the read buffer.
+        while (position < runEnd)
+        {
+            size_t index = position & mReadMask;
+            size_t count = min(runEnd - position, mReadBuf.capacity - index);
+            aws_byte_buf_write(&mWrapBuf, mReadBuf.buffer + index, count);
+            position += count;
+        }
+
+        if (runEnd < end)
+        {
+            position = mFilteredRanges.front().second;
+            mFilteredRanges.pop();
+        }
+    }
+    return aws_byte_cursor_from_buf(&mWrapBuf);
+}
+
+void Sensor::clearReadBuf()
 {
     aws_byte_buf_reset(&mReadBuf, false);
+    mReadStart = 0;
+}
+
+void Sensor::consumeReadBuf(size_t count)
+{
+    mReadBuf.len -= count;
+    mReadStart += count;
+    if (mRing && mRing->attached())
+    {
+        mRing->release(count);
+    }
+    else if (mReadBuf.len == 0)
+    {
+        // Start over from the beginning of the buffer, so that the next read is not split at its end.
+        mReadStart = 0;
+    }
+}
+
+void Sensor::reset()
+{
+    clearReadBuf();
+    mNextReadBytes = 1;
+    mReadPaused = false;
     while (!mEomBounds.empty())
     {
         mEomBounds.pop();
     }
+    while (!mFoundBounds.empty())
+    {
+        mFoundBounds.pop();
+    }
+    while (!mFilteredRanges.empty())
+    {
+        mFilteredRanges.pop();
+    }
 }
@@ -5,19 +5,33 @@
 #define DEVICE_CLIENT_SENSOR_H
 
 #include "../config/Config.h"
+#include "BatchController.h"
+#include "BatchFormatter.h"
+#include "Compressor.h"
+#include "DeadLetterTask.h"
+#include "EomMatcher.h"
 #include "HeartbeatTask.h"
+#include "MessageFilter.h"
+#include "PendingPublishes.h"
+#include "SensorCounters.h"
 #include "SensorState.h"
+#include "ShmRing.h"
 #include "Socket.h"
+#include "Spool.h"
 
 #include <aws/crt/Types.h>
+#include <aws/io/io.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <queue>
-#include <regex>
 #include <string>
+#include <utility>
 
 namespace Aws
 {
@@ -38,6 +52,46 @@ namespace Aws
                      */
                     static constexpr char TAG[] = "Sensor.cpp";
 
+                    /**
+                     * \brief Number of unacknowledged publishes above which batches are written to the spool, when
+                     * maxInFlight is not configured
+                     *
+                     * Publishes are not acknowledged while the MQTT connection is down, so this also bounds the
+                     * data queued in memory by the CRT during an outage.
+                     */
+                    static constexpr std::size_t SPOOL_IN_FLIGHT_LIMIT = 8;
+
+                    /**
+                     * \brief Size of a spool segment file
+                     */
+                    static constexpr std::size_t SPOOL_SEGMENT_BYTES = 1024 * 1024;
+
+                    /**
+                     * \brief Interval between runs of the drain task while the spool holds records
+                     */
+                    static constexpr int64_t SPOOL_DRAIN_INTERVAL_MS = 100;
+
+                    /**
+                     * \brief Timeout of a connection to the sensor
+                     */
+                    static constexpr std::uint32_t CONNECT_TIMEOUT_MS = 3000;
+
+                    /**
+                     * \brief Number of publishes whose send time is kept to measure the PUBACK latency, when adaptive
+                     * batching is configured
+                     *
+                     * Publishes are sampled by packet id, a publish whose slot is reused before its PUBACK arrives is
+                     * not measured.
+                     */
+                    static constexpr std::size_t PUBACK_SAMPLE_SLOTS = 64;
+
+                    /**
+                     * \brief Layout of a sampled publish, the packet id above the send time in microseconds
+                     */
+                    static constexpr int PUBACK_ID_SHIFT = 48;
+
+                    static constexpr std::uint64_t PUBACK_TIME_MASK = (std::uint64_t(1) << PUBACK_ID_SHIFT) - 1;
+
                     /**
                      * \brief Settings associated with the sensor
                      */
@@ -66,23 +120,89 @@ namespace Aws
                     std::shared_ptr<Socket> mSocket;
 
                     /**
-                     * \brief Buffer for reading sensor data
+                     * \brief Circular buffer for reading sensor data
                      *
-                     * Buffer is allocated once and never larger than AWS IoT maximum message size.
+                     * Buffer is allocated once and never holds more than bufferCapacity bytes, which is never larger
+                     * than AWS IoT maximum message size. The len field is the number of buffered bytes, starting at
+                     * mReadStart. The allocation is rounded up to a power of two so that positions map to an index
+                     * in the buffer with mReadMask, even after they wrap around.
                      */
                     aws_byte_buf mReadBuf;
 
+                    /**
+                     * \brief Read buffer allocated by the sensor
+                     *
+                     * mReadBuf is the same buffer, except while a shared memory ring is attached, when it points to the
+                     * data of the ring instead.
+                     */
+                    aws_byte_buf mOwnedReadBuf;
+
+                    /**
+                     * \brief Maximum number of bytes buffered in mReadBuf
+                     */
+                    size_t mReadCapacity{0};
+
+                    /**
+                     * \brief Maps a position to its index in mReadBuf
+                     */
+                    size_t mReadMask{0};
+
+                    /**
+                     * \brief Free space the next read needs in mReadBuf, buffered messages are published until it fits
+                     *
+                     * A stream read takes whatever fits, so this is 1 unless a datagram is waiting to be read.
+                     */
+                    size_t mNextReadBytes{1};
+
+                    /**
+                     * \brief Flag to indicate the sensor is read from a Unix datagram socket, one message per datagram
+                     */
+                    bool mDatagram{false};
+
+                    /**
+                     * \brief Position of the first buffered byte
+                     *
+                     * Positions only ever increase as data is read and published, so that end of message boundaries
+                     * stay valid while the data before them is consumed.
+                     */
+                    size_t mReadStart{0};
+
+                    /**
+                     * \brief Contiguous copy of buffered data which wraps around the end of mReadBuf
+                     *
+                     * Only used to scan or publish the few reads and batches that straddle the end of the buffer.
+                     */
+                    aws_byte_buf mWrapBuf;
+
                     /**
                      * \brief End of message boundaries in read buffer
                      *
-                     * Stores index in buffer of one-past the end of the boundary.
+                     * Stores the position of one-past the end of the boundary.
                      */
                     std::queue<size_t> mEomBounds;
 
                     /**
-                     * \brief Pattern used to identify end of message boundary
+                     * \brief Filter deciding which messages are batched, only set when a filter is configured
+                     */
+                    std::unique_ptr<MessageFilter> mFilter;
+
+                    /**
+                     * \brief End of message boundaries found by the last scan, before they are filtered
                      */
-                    std::regex mEomPattern;
+                    std::queue<size_t> mFoundBounds;
+
+                    /**
+                     * \brief Start and end position of the runs of dropped messages in read buffer
+                     *
+                     * Adjacent dropped messages are merged into one run, and a run at the start of the buffered data
+                     * is released at once. The other runs are left out of the batch they fall into.
+                     */
+                    std::queue<std::pair<size_t, size_t>> mFilteredRanges;
+
+                    /**
+                     * \brief Matcher compiled from the end of message delimiter
+                     */
+                    EomMatcher mEomMatcher;
 
                     using TimePointT = std::chrono::high_resolution_clock::time_point;
 
@@ -101,16 +221,165 @@ namespace Aws
                      */
                     SensorState mState{SensorState::NotConnected};
 
+                    /**
+                     * \brief Activity of the sensor since the last heartbeat
+                     */
+                    SensorCounters mCounters;
+
+                    /**
+                     * \brief Publishes of sensor data, heartbeats and dead letters waiting for their completion
+                     * callback
+                     */
+                    PendingPublishes mPending;
+
                     /**
                      * \brief Task for publishing heartbeat to MQTT
                      */
                     HeartbeatTask mHeartbeatTask;
 
+                    /**
+                     * \brief Task for publishing undelivered sensor data to the dead letter topic
+                     */
+                    DeadLetterTask mDeadLetterTask;
+
                     /**
                      * \brief Task for connecting to sensor
                      */
                     aws_task mConnectTask;
 
+                    /**
+                     * \brief Task for publishing buffered messages once the publish timeout expires
+                     *
+                     * Without it, buffered messages would only be published when more data arrives.
+                     */
+                    aws_task mFlushTask;
+
+                    /**
+                     * \brief Flag to indicate the flush task is scheduled
+                     */
+                    bool mFlushScheduled{false};
+
+                    /**
+                     * \brief Number of publishes waiting for a PUBACK
+                     *
+                     * Decremented from the event loop of the MQTT connection.
+                     */
+                    std::atomic<std::size_t> mInFlight{0};
+
+                    /**
+                     * \brief Flag to indicate the buffered messages are published regardless of the in-flight window,
+                     * before the sensor is replaced
+                     */
+                    bool mDraining{false};
+
+                    /**
+                     * \brief Flag to indicate reading from the sensor or publishing buffered messages stopped because
+                     * the in-flight window is full
+                     *
+                     * Unread data stays in the socket, so that the sensor blocks once the socket buffer is full.
+                     */
+                    std::atomic<bool> mReadPaused{false};
+
+                    /**
+                     * \brief Task for resuming reads once a publish in the in-flight window is acknowledged
+                     */
+                    aws_task mResumeTask;
+
+                    /**
+                     * \brief Flag to indicate the resume task is scheduled, it is scheduled from the event loop of
+                     * the MQTT connection
+                     */
+                    std::atomic<bool> mResumeScheduled{false};
+
+                    /**
+                     * \brief Shared memory ring the sensor data is read from, only set when transport is shm
+                     *
+                     * The producer passes the ring over the socket once connected. While it is attached, sensor data
+                     * is batched in place from the ring and the space is released to the producer once published.
+                     */
+                    std::unique_ptr<ShmRing> mRing;
+
+                    /**
+                     * \brief Event loop handle of the eventfd signaled by the producer of the ring
+                     */
+                    aws_io_handle mRingHandle;
+
+                    /**
+                     * \brief Formatter framing the messages of every batch, only set when batchFormat is configured
+                     * and is not raw
+                     */
+                    std::unique_ptr<BatchFormatter> mFormatter;
+
+                    /**
+                     * \brief Compressor applied to every batch when it is published, only set when compression is
+                     * configured
+                     *
+                     * Batches are stored uncompressed in the read buffer and the spool, and sent uncompressed to the
+                     * dead letter topic.
+                     */
+                    std::unique_ptr<Compressor> mCompressor;
+
+                    /**
+                     * \brief Controller adapting the batch size and batch time, only set when adaptiveLatencyMs is
+                     * configured
+                     *
+                     * bufferSize and bufferTimeMs are not used while it is set.
+                     */
+                    std::unique_ptr<BatchController> mBatchController;
+
+                    /**
+                     * \brief Origin of the send times of publishes
+                     */
+                    TimePointT mPublishEpoch;
+
+                    /**
+                     * \brief Packet id and send time in microseconds since mPublishEpoch of sampled publishes, indexed
+                     * by packet id
+                     *
+                     * Written from the event loop of the sensor and taken from the event loop of the MQTT connection.
+                     */
+                    std::array<std::atomic<std::uint64_t>, PUBACK_SAMPLE_SLOTS> mPublishTimes;
+
+                    /**
+                     * \brief Total and number of PUBACK latencies measured since the controller was last updated
+                     *
+                     * Added to from the event loop of the MQTT connection, so a latency may be counted in the next
+                     * update.
+                     */
+                    std::atomic<std::uint64_t> mPubackMicros{0};
+
+                    std::atomic<std::uint64_t> mPubacks{0};
+
+                    /**
+                     * \brief Store for batches which cannot be published, only set when spoolDir is configured
+                     */
+                    std::unique_ptr<Spool> mSpool;
+
+                    /**
+                     * \brief Task for publishing spooled batches at the drain rate
+                     */
+                    aws_task mDrainTask;
+
+                    /**
+                     * \brief Flag to indicate the drain task is scheduled
+                     */
+                    bool mDrainScheduled{false};
+
+                    /**
+                     * \brief Flag to indicate the sensor is started, spooled batches are only published while it is
+                     */
+                    std::atomic<bool> mStarted{false};
+
+                    /**
+                     * \brief Number of bytes the drain task may publish, replenished at spoolDrainBytesPerSec
+                     */
+                    double mDrainBudget{0};
+
+                    /**
+                     * \brief Time at which the drain budget was last replenished
+                     */
+                    TimePointT mLastDrain;
+
                     /**
                      * \brief Connect to the sensor
                      */
@@ -131,6 +400,132 @@ namespace Aws
                      */
                     void onReadableCallback(int error_code);
 
+                    /**
+                     * \brief Read the next datagram into the free space of the read buffer
+                     *
+                     * Buffered messages are published first when the datagram does not fit. A datagram larger than
+                     * the buffer capacity is sent to the dead letter topic and discarded.
+                     *
+                     * @param numRead set to the number of bytes read, 0 when the datagram does not fit yet
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with the error raised as for aws_socket_read
+                     */
+                    int readDatagram(size_t &numRead);
+
+                    /**
+                     * \brief Callback function when the socket of a shared memory ring sensor is readable
+                     *
+                     * Attaches the ring passed by the producer, and reconnects when the producer closes the socket.
+                     */
+                    void onShmSocketReadableCallback(int error_code);
+
+                    /**
+                     * \brief Map the ring passed by the producer and read from it instead of the socket
+                     *
+                     * Data left in the ring by a previous connection is read again.
+                     *
+                     * @return true on success, the file descriptors are closed on failure
+                     */
+                    bool attachRing(int memFd, int eventFd);
+
+                    /**
+                     * \brief Stop reading from the ring and discard the data read from it but not released
+                     */
+                    void detachRing();
+
+                    /**
+                     * \brief Extend the buffered data with the data written to the ring since the last read
+                     *
+                     * @param numRead set to the number of bytes read
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with the error raised as for aws_socket_read
+                     */
+                    int readRing(size_t &numRead);
+
+                    /**
+                     * \brief Callback function for flush task
+                     */
+                    void onFlushTaskCallback();
+
+                    /**
+                     * \brief Schedule the flush task at the publish timeout, if messages are buffered
+                     *
+                     * A publish moves the timeout without rescheduling the task. The task schedules itself again when
+                     * it runs before the timeout, so it runs at most once per bufferTimeMs.
+                     */
+                    void scheduleFlush();
+
+                    /**
+                     * \brief Callback function for drain task
+                     */
+                    void onDrainTaskCallback();
+
+                    /**
+                     * \brief Schedule the drain task, if the spool holds records
+                     */
+                    void scheduleDrain();
+
+                    /**
+                     * \brief Maximum number of publishes waiting for a PUBACK
+                     *
+                     * Either maxInFlight, SPOOL_IN_FLIGHT_LIMIT when only the spool is configured, or no limit.
+                     */
+                    std::size_t getInFlightWindow() const;
+
+                    /**
+                     * \brief Returns true when no more publishes may be sent until one is acknowledged
+                     */
+                    bool inFlightWindowFull() const { return mInFlight >= getInFlightWindow(); }
+
+                    /**
+                     * \brief Release a slot of the in-flight window, resuming reads if they were paused
+                     *
+                     * Called from the event loop of the MQTT connection.
+                     */
+                    void onPublishComplete();
+
+                    /**
+                     * \brief Record the send time of a publish, to measure its PUBACK latency
+                     */
+                    void recordPublishTime(uint16_t packetId);
+
+                    /**
+                     * \brief Measure the PUBACK latency of a publish whose send time was recorded
+                     *
+                     * Called from the event loop of the MQTT connection.
+                     */
+                    void onPuback(uint16_t packetId);
+
+                    /**
+                     * \brief Pass the messages read and the PUBACK latencies measured to the batch controller, and
+                     * update the batch settings
+                     *
+                     * @param messages the number of messages read
+                     * @param bytes the number of bytes read
+                     */
+                    void updateBatchController(size_t messages, size_t bytes);
+
+                    /**
+                     * \brief Number of messages in a batch, 0 to publish all buffered messages as one batch
+                     */
+                    size_t getBufferSize() const;
+
+                    /**
+                     * \brief Longest time a message is buffered, 0 or less to publish messages as they are read
+                     */
+                    int64_t getBufferTimeMs() const;
+
+                    /**
+                     * \brief Callback function for resume task
+                     */
+                    void onResumeTaskCallback();
+
+                    /**
+                     * \brief Publish one batch, or append it to the spool when it cannot be published now
+                     *
+                     * Once a batch is spooled, later batches are spooled too until the spool is drained, so that
+                     * batches are published in order.
+                     */
+                    void publishOrSpool(const aws_byte_cursor *payload);
+
                     /**
                      * \brief Publish buffered messages
                      */
@@ -149,7 +544,53 @@ namespace Aws
                     /**
                      * \brief Publish one message
                      */
-                    void publishOneMessage(const aws_byte_cursor *payload);
+                    virtual void publishOneMessage(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Returns a cursor over buffered data, copying it to mWrapBuf when it wraps around the end
+                     * of the read buffer
+                     *
+                     * @param position the position of the first byte
+                     * @param count the number of bytes
+                     * @return the cursor
+                     */
+                    aws_byte_cursor readBufCursor(size_t position, size_t count);
+
+                    /**
+                     * \brief Returns the position one past the end of the last message found, or the position of the
+                     * first buffered byte
+                     */
+                    size_t lastMessageEnd() const;
+
+                    /**
+                     * \brief Move the boundaries of the messages kept by the filter from mFoundBounds to mEomBounds,
+                     * recording the dropped messages in mFilteredRanges
+                     */
+                    void filterMessages();
+
+                    /**
+                     * \brief Release the dropped messages at the start of the buffered data
+                     */
+                    void releaseFiltered();
+
+                    /**
+                     * \brief Copy the kept messages from the first buffered byte up to a position to mWrapBuf,
+                     * leaving out the runs of dropped messages between them
+                     *
+                     * @param end the position one past the end of the last message
+                     * @return a cursor over mWrapBuf
+                     */
+                    aws_byte_cursor gatherKeptMessages(size_t end);
+
+                    /**
+                     * \brief Discard all buffered data
+                     */
+                    void clearReadBuf();
+
+                    /**
+                     * \brief Release the first count buffered bytes once they are published or discarded
+                     */
+                    void consumeReadBuf(size_t count);
 
                     /**
                      * \brief Close connection to server
@@ -161,6 +602,19 @@ namespace Aws
                      */
                     void reset();
 
+                    /**
+                     * \brief Run the callback on the event loop of the sensor and wait for it to complete
+                     *
+                     * The callback runs directly when called from the event loop. It does not run when the event loop
+                     * is shutting down, the event loop then cancels every task itself.
+                     */
+                    void runOnEventLoop(const std::function<void()> &callback);
+
+                    /**
+                     * \brief Cancel the tasks scheduled by the sensor, must be called from the event loop
+                     */
+                    void cancelTasks();
+
                   public:
                     /**
                      * \brief Constructor
@@ -200,6 +654,49 @@ namespace Aws
                      * @return a string value representing the sensor name
                      */
                     std::string getName() const;
+
+                    /**
+                     * \brief Number of messages kept and dropped by the filter, all zero when no filter is configured
+                     */
+                    MessageFilter::Counters getFilterCounters() const;
+
+                    /**
+                     * \brief Activity of the sensor since the last heartbeat
+                     */
+                    SensorCounters &getCounters() { return mCounters; }
+
+                    /**
+                     * \brief Publish every complete message in the read buffer, regardless of the batch size, the
+                     * batch time and the in-flight window
+                     *
+                     * Called from the event loop of the sensor before it is stopped to apply new settings. A partial
+                     * message at the end of the buffer is not published.
+                     */
+                    void drain();
+
+                    /**
+                     * \brief Number of publishes of sensor data waiting for a PUBACK
+                     */
+                    std::size_t getInFlight() const { return mInFlight; }
+
+                    /**
+                     * \brief Number of publishes of the sensor whose completion callback has not returned yet
+                     *
+                     * The completion callback of a publish refers to the sensor, so a sensor is not destroyed while
+                     * this is above zero.
+                     */
+                    std::size_t getPendingPublishes() const { return mPending.get(); }
+
+                    /**
+                     * \brief Set the callback invoked once no publish of the sensor is pending, before it is started
+                     *
+                     * The callback is invoked from the thread completing the last publish, once the sensor is no
+                     * longer accessed, so it may schedule the sensor to be destroyed.
+                     */
+                    void setIdleCallback(PendingPublishes::IdleCallback callback, std::shared_ptr<void> arg)
+                    {
+                        mPending.setIdleCallback(callback, std::move(arg));
+                    }
                 };
             } // namespace SensorPublish
         } // namespace DeviceClient
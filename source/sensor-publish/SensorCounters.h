@@ -0,0 +1,122 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SENSOR_COUNTERS_H
+#define DEVICE_CLIENT_SENSOR_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief SensorCounters accumulates the activity of a sensor since the last heartbeat.
+                 *
+                 * Every counter except publishErrors is only written from the event loop of the sensor, which is also
+                 * where the heartbeat takes them, so they are updated with a relaxed load and store rather than a
+                 * locked read-modify-write. publishErrors is also counted from the event loop of the MQTT connection
+                 * and uses an atomic add. Other threads may read the counters, but only as an estimate.
+                 */
+                struct SensorCounters
+                {
+                    /**
+                     * \brief Values of the counters at the time they are taken
+                     */
+                    struct Snapshot
+                    {
+                        std::uint64_t bytesRead{0};
+                        std::uint64_t messages{0};
+                        std::uint64_t batches{0};
+                        std::uint64_t publishErrors{0};
+                        std::uint64_t discardedBytes{0};
+                        std::uint64_t reconnects{0};
+                        std::uint64_t maxBufferFill{0};
+                    };
+
+                    /**
+                     * \brief Bytes read from the sensor
+                     */
+                    std::atomic<std::uint64_t> bytesRead{0};
+
+                    /**
+                     * \brief Complete messages read from the sensor, before they are filtered
+                     */
+                    std::atomic<std::uint64_t> messages{0};
+
+                    /**
+                     * \brief Batches published or spooled
+                     */
+                    std::atomic<std::uint64_t> batches{0};
+
+                    /**
+                     * \brief Batches which could not be compressed, queued or acknowledged
+                     */
+                    std::atomic<std::uint64_t> publishErrors{0};
+
+                    /**
+                     * \brief Bytes discarded without being published because they did not fit in the buffer
+                     */
+                    std::atomic<std::uint64_t> discardedBytes{0};
+
+                    /**
+                     * \brief Connections to the sensor attempted again after an error or a disconnect
+                     */
+                    std::atomic<std::uint64_t> reconnects{0};
+
+                    /**
+                     * \brief Largest number of bytes buffered at once
+                     */
+                    std::atomic<std::uint64_t> maxBufferFill{0};
+
+                    /**
+                     * \brief Add to a counter only written from the event loop of the sensor
+                     */
+                    static void add(std::atomic<std::uint64_t> &counter, std::uint64_t count)
+                    {
+                        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+                    }
+
+                    /**
+                     * \brief Record the number of bytes buffered, from the event loop of the sensor
+                     */
+                    void recordBufferFill(std::uint64_t bytes)
+                    {
+                        if (bytes > maxBufferFill.load(std::memory_order_relaxed))
+                        {
+                            maxBufferFill.store(bytes, std::memory_order_relaxed);
+                        }
+                    }
+
+                    /**
+                     * \brief Count a failed publish, from any thread
+                     */
+                    void addPublishError() { publishErrors.fetch_add(1, std::memory_order_relaxed); }
+
+                    /**
+                     * \brief Return the counters and reset them, from the event loop of the sensor
+                     */
+                    Snapshot take()
+                    {
+                        Snapshot snapshot;
+                        snapshot.bytesRead = bytesRead.exchange(0, std::memory_order_relaxed);
+                        snapshot.messages = messages.exchange(0, std::memory_order_relaxed);
+                        snapshot.batches = batches.exchange(0, std::memory_order_relaxed);
+                        snapshot.publishErrors = publishErrors.exchange(0, std::memory_order_relaxed);
+                        snapshot.discardedBytes = discardedBytes.exchange(0, std::memory_order_relaxed);
+                        snapshot.reconnects = reconnects.exchange(0, std::memory_order_relaxed);
+                        snapshot.maxBufferFill = maxBufferFill.exchange(0, std::memory_order_relaxed);
+                        return snapshot;
+                    }
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SENSOR_COUNTERS_H
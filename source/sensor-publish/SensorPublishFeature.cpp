@@ -4,10 +4,19 @@
 #include "SensorPublishFeature.h"
 
 #include "../logging/LoggerFactory.h"
+#include "EventLoopCall.h"
 
 #include <aws/common/error.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/zero.h>
+#include <aws/crt/JsonObject.h>
+#include <aws/io/event_loop.h>
 
+#include <algorithm>
+#include <chrono>
+#include <numeric>
 #include <stdexcept>
+#include <utility>
 
 using namespace std;
 using namespace Aws::Iot;
@@ -19,6 +28,87 @@ const int Feature::SUCCESS; // Retain reference from header-only source to avoid
 
 constexpr char SensorPublishFeature::TAG[];
 constexpr char SensorPublishFeature::NAME[];
+constexpr int64_t SensorPublishFeature::RELEASE_RETRY_MS;
+constexpr int64_t SensorPublishFeature::PENDING_PUBLISHES_TIMEOUT_MS;
+
+namespace
+{
+    int64_t weight(const PlainConfig::SensorPublish::SensorSettings &settings)
+    {
+        return settings.eventLoopWeight.has_value() ? settings.eventLoopWeight.value() : 1;
+    }
+
+    std::string sensorName(const PlainConfig::SensorPublish::SensorSettings &settings)
+    {
+        return settings.name.has_value() ? settings.name.value() : std::string();
+    }
+
+    /**
+     * \brief Serialize the settings of one sensor, so that every setting of the configuration file is compared
+     */
+    std::string serializeSettings(const PlainConfig::SensorPublish::SensorSettings &settings)
+    {
+        PlainConfig::SensorPublish sensorPublish;
+        sensorPublish.settings.push_back(settings);
+        Crt::JsonObject object;
+        sensorPublish.SerializeToObject(object);
+        return object.View().WriteCompact().c_str();
+    }
+} // namespace
+
+SensorPublishFeature::SensorPublishFeature() : mReleaseState(std::make_shared<ReleaseState>())
+{
+    mReleaseState->feature = this;
+
+    // Initialize a task to destroy the retired sensors from an event loop.
+    AWS_ZERO_STRUCT(mReleaseTask);
+    aws_task_init(
+        &mReleaseTask,
+        [](struct aws_task *task, void *arg, enum aws_task_status status)
+        {
+            auto *self = static_cast<SensorPublishFeature *>(arg);
+            bool released = status == AWS_TASK_STATUS_CANCELED || self->onReleaseTaskCallback();
+
+            ReleaseState &state = *self->mReleaseState;
+            std::lock_guard<std::mutex> lock(state.lock);
+            if (!released && state.feature != nullptr)
+            {
+                uint64_t runAtNanos;
+                aws_event_loop_current_clock_time(self->mReleaseLoop, &runAtNanos);
+                chrono::milliseconds delayMs(RELEASE_RETRY_MS);
+                runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+                aws_event_loop_schedule_task_future(self->mReleaseLoop, task, runAtNanos);
+                return;
+            }
+            state.releaseScheduled = false;
+            state.changed.notify_all();
+        },
+        this,
+        __func__);
+}
+
+SensorPublishFeature::~SensorPublishFeature()
+{
+    std::unique_lock<std::mutex> lock(mReleaseState->lock);
+    mReleaseState->feature = nullptr;
+    mReleaseState->changed.wait(lock, [this]() { return !mReleaseState->releaseScheduled; });
+
+    // The completion callbacks access their sensor until it is idle. They only return once the MQTT connection
+    // completes or fails their publish, so rather than block the shutdown, give up after a while.
+    mReleaseState->watching = true;
+    auto idle = [](const SensorEntry &entry) { return entry.sensor->getPendingPublishes() == 0; };
+    if (!mReleaseState->changed.wait_for(
+            lock,
+            chrono::milliseconds(PENDING_PUBLISHES_TIMEOUT_MS),
+            [this, &idle]()
+            {
+                return std::all_of(mSensors.begin(), mSensors.end(), idle) &&
+                       std::all_of(mRetiredSensors.begin(), mRetiredSensors.end(), idle);
+            }))
+    {
+        LOGM_WARN(TAG, "Timed out waiting for the pending publishes of %s", getName().c_str());
+    }
+}
 
 int SensorPublishFeature::init(
     shared_ptr<SharedCrtResourceManager> manager,
@@ -27,34 +117,250 @@ int SensorPublishFeature::init(
 {
     mResourceManager = manager;
     mBaseNotifier = notifier;
+    mReleaseLoop = mResourceManager->getNextEventLoop();
 
+    std::vector<const PlainConfig::SensorPublish::SensorSettings *> enabledSettings;
+    std::vector<int64_t> weights;
     for (auto &setting : config.sensorPublish.settings)
     {
         if (setting.enabled)
         {
-            try
-            {
-                auto *eventLoop = mResourceManager->getNextEventLoop();
-                if (eventLoop)
-                {
-                    mSensors.emplace_back(createSensor(
-                        setting, mResourceManager->getAllocator(), mResourceManager->getConnection(), eventLoop));
-                }
-                else
-                {
-                    throw std::runtime_error{"event loop returned by crt is null"};
-                }
-            }
-            catch (const std::exception &e)
-            {
-                LOGM_ERROR(TAG, "Error initializing sensor: %s message: %s", setting.name->c_str(), e.what());
-            }
+            enabledSettings.push_back(&setting);
+            weights.push_back(weight(setting));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mSensorsLock);
+    std::vector<std::size_t> placement = placeSensors(weights, mResourceManager->getEventLoopCount());
+    for (std::size_t i = 0; i < enabledSettings.size(); ++i)
+    {
+        addSensor(*enabledSettings[i], placement[i], mSensors);
+    }
+
+    return Feature::SUCCESS;
+}
+
+bool SensorPublishFeature::addSensor(
+    const PlainConfig::SensorPublish::SensorSettings &settings,
+    std::size_t loopIndex,
+    std::vector<SensorEntry> &sensors)
+{
+    try
+    {
+        SensorEntry entry;
+        entry.settings.reset(new PlainConfig::SensorPublish::SensorSettings(settings));
+        entry.loopIndex = loopIndex;
+        entry.eventLoop = mResourceManager->getEventLoopCount() > 0 ? mResourceManager->getEventLoop(loopIndex)
+                                                                     : mResourceManager->getNextEventLoop();
+        if (!entry.eventLoop)
+        {
+            throw std::runtime_error{"event loop returned by crt is null"};
+        }
+        LOGM_INFO(TAG, "Placing sensor: %s on event loop: %zu", settings.name->c_str(), loopIndex);
+        entry.sensor = createSensor(
+            *entry.settings, mResourceManager->getAllocator(), mResourceManager->getConnection(), entry.eventLoop);
+        entry.sensor->setIdleCallback(onSensorIdle, mReleaseState);
+        sensors.push_back(std::move(entry));
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        LOGM_ERROR(TAG, "Error initializing sensor: %s message: %s", settings.name->c_str(), e.what());
+        return false;
+    }
+}
+
+int SensorPublishFeature::reconfigure(const PlainConfig &config)
+{
+    LOGM_INFO(TAG, "Reconfiguring %s", getName().c_str());
+
+    std::lock_guard<std::mutex> lock(mSensorsLock);
+    releaseRetiredSensors();
+
+    // Match each configured sensor with the first running sensor of the same name.
+    std::vector<bool> matched(mSensors.size(), false);
+    std::vector<const PlainConfig::SensorPublish::SensorSettings *> changed(mSensors.size(), nullptr);
+    std::vector<const PlainConfig::SensorPublish::SensorSettings *> added;
+    for (auto &setting : config.sensorPublish.settings)
+    {
+        if (!config.sensorPublish.enabled || !setting.enabled)
+        {
+            continue;
+        }
+        std::size_t i = 0;
+        while (i < mSensors.size() && (matched[i] || sensorName(*mSensors[i].settings) != sensorName(setting)))
+        {
+            ++i;
+        }
+        if (i == mSensors.size())
+        {
+            added.push_back(&setting);
+            continue;
+        }
+        matched[i] = true;
+        if (serializeSettings(*mSensors[i].settings) != serializeSettings(setting))
+        {
+            changed[i] = &setting;
         }
     }
 
+    // Stop the removed and changed sensors, and create the changed ones again on the event loop they ran on.
+    std::size_t removedCount = 0;
+    std::vector<SensorEntry> sensors;
+    for (std::size_t i = 0; i < mSensors.size(); ++i)
+    {
+        SensorEntry &entry = mSensors[i];
+        if (matched[i] && changed[i] == nullptr)
+        {
+            sensors.push_back(std::move(entry));
+            continue;
+        }
+
+        LOGM_INFO(TAG, "%s sensor: %s", matched[i] ? "Replacing" : "Removing", entry.settings->name->c_str());
+        if (mStarted)
+        {
+            drainAndStop(entry);
+        }
+        std::size_t loopIndex = entry.loopIndex;
+        mRetiredSensors.push_back(std::move(entry));
+        mReleaseState->watching = true;
+        if (!matched[i])
+        {
+            ++removedCount;
+        }
+        else if (addSensor(*changed[i], loopIndex, sensors) && mStarted)
+        {
+            sensors.back().sensor->start();
+        }
+    }
+    mSensors = std::move(sensors);
+
+    // Place the new sensors on top of the load of the running ones.
+    std::vector<int64_t> loads(mResourceManager->getEventLoopCount(), 0);
+    for (const auto &entry : mSensors)
+    {
+        if (entry.loopIndex < loads.size())
+        {
+            loads[entry.loopIndex] += weight(*entry.settings);
+        }
+    }
+    std::vector<int64_t> weights;
+    for (const auto *setting : added)
+    {
+        weights.push_back(weight(*setting));
+    }
+    std::vector<std::size_t> placement = placeSensors(weights, loads);
+    for (std::size_t i = 0; i < added.size(); ++i)
+    {
+        if (addSensor(*added[i], placement[i], mSensors) && mStarted)
+        {
+            mSensors.back().sensor->start();
+        }
+    }
+    releaseRetiredSensors();
+
+    LOGM_INFO(
+        TAG,
+        "Reconfigured %s sensors: %zu added: %zu removed: %zu replaced: %zu",
+        getName().c_str(),
+        mSensors.size(),
+        added.size(),
+        removedCount,
+        static_cast<std::size_t>(std::count_if(
+            changed.begin(),
+            changed.end(),
+            [](const PlainConfig::SensorPublish::SensorSettings *setting) { return setting != nullptr; })));
+
     return Feature::SUCCESS;
 }
 
+void SensorPublishFeature::drainAndStop(SensorEntry &entry)
+{
+    runOnEventLoop(
+        entry.eventLoop,
+        [&entry]()
+        {
+            entry.sensor->drain();
+            entry.sensor->stop();
+        });
+}
+
+void SensorPublishFeature::releaseRetiredSensors()
+{
+    // The flag is set before the pending publishes are counted, and a completion callback counts its publish before
+    // reading the flag, so either a sensor is released here or its last callback schedules the release task.
+    mRetiredSensors.erase(
+        std::remove_if(
+            mRetiredSensors.begin(),
+            mRetiredSensors.end(),
+            [](const SensorEntry &entry) { return entry.sensor->getPendingPublishes() == 0; }),
+        mRetiredSensors.end());
+    mReleaseState->watching = !mRetiredSensors.empty();
+}
+
+void SensorPublishFeature::onSensorIdle(void *arg)
+{
+    auto *state = static_cast<ReleaseState *>(arg);
+    if (!state->watching)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state->lock);
+    state->changed.notify_all();
+    SensorPublishFeature *self = state->feature;
+    if (self == nullptr || state->releaseScheduled || self->mReleaseLoop == nullptr)
+    {
+        return;
+    }
+    aws_event_loop_schedule_task_now(self->mReleaseLoop, &self->mReleaseTask);
+    state->releaseScheduled = true;
+}
+
+bool SensorPublishFeature::onReleaseTaskCallback()
+{
+    // Reconfigure, start and stop hold the lock while they wait for the event loops of the sensors, so rather than
+    // block this event loop, try again later.
+    std::unique_lock<std::mutex> lock(mSensorsLock, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return false;
+    }
+    releaseRetiredSensors();
+    return true;
+}
+
+std::vector<std::size_t> SensorPublishFeature::placeSensors(const std::vector<int64_t> &weights, std::size_t loopCount)
+{
+    return placeSensors(weights, std::vector<int64_t>(loopCount, 0));
+}
+
+std::vector<std::size_t> SensorPublishFeature::placeSensors(
+    const std::vector<int64_t> &weights,
+    std::vector<int64_t> loads)
+{
+    std::vector<std::size_t> placement(weights.size(), 0);
+    if (loads.empty())
+    {
+        return placement;
+    }
+
+    // Placing the heaviest sensors first, each on the least loaded loop, keeps the loads of the loops within the
+    // largest weight of each other.
+    std::vector<std::size_t> order(weights.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+        order.begin(), order.end(), [&weights](std::size_t a, std::size_t b) { return weights[a] > weights[b]; });
+
+    for (std::size_t sensor : order)
+    {
+        auto loop = static_cast<std::size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        placement[sensor] = loop;
+        loads[loop] += weights[sensor];
+    }
+    return placement;
+}
+
 std::unique_ptr<Sensor> SensorPublishFeature::createSensor(
     const PlainConfig::SensorPublish::SensorSettings &settings,
     aws_allocator *allocator,
@@ -73,6 +379,7 @@ std::string SensorPublishFeature::getName()
 // cppcheck-suppress unusedFunction
 std::size_t SensorPublishFeature::getSensorsSize() const
 {
+    std::lock_guard<std::mutex> lock(mSensorsLock);
     return mSensors.size();
 }
 
@@ -80,13 +387,15 @@ int SensorPublishFeature::start()
 {
     LOGM_INFO(TAG, "Starting %s", getName().c_str());
 
-    for (auto &sensor : mSensors)
+    std::lock_guard<std::mutex> lock(mSensorsLock);
+    for (auto &entry : mSensors)
     {
-        if (sensor->start() != SharedCrtResourceManager::SUCCESS)
+        if (entry.sensor->start() != SharedCrtResourceManager::SUCCESS)
         {
-            LOGM_INFO(TAG, "Failed to start sensor: %s", sensor->getName().c_str());
+            LOGM_INFO(TAG, "Failed to start sensor: %s", entry.sensor->getName().c_str());
         }
     }
+    mStarted = true;
 
     mBaseNotifier->onEvent(static_cast<Feature *>(this), ClientBaseEventNotification::FEATURE_STARTED);
 
@@ -97,13 +406,15 @@ int SensorPublishFeature::stop()
 {
     LOGM_INFO(TAG, "Stopping %s", getName().c_str());
 
-    for (auto &sensor : mSensors)
+    std::lock_guard<std::mutex> lock(mSensorsLock);
+    for (auto &entry : mSensors)
     {
-        if (sensor->stop() != SharedCrtResourceManager::SUCCESS)
+        if (entry.sensor->stop() != SharedCrtResourceManager::SUCCESS)
         {
-            LOGM_INFO(TAG, "Failed to stop sensor: %s", sensor->getName().c_str());
+            LOGM_INFO(TAG, "Failed to stop sensor: %s", entry.sensor->getName().c_str());
         }
     }
+    mStarted = false;
 
     mBaseNotifier->onEvent(static_cast<Feature *>(this), ClientBaseEventNotification::FEATURE_STOPPED);
 
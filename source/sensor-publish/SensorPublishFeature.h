@@ -10,8 +10,12 @@
 #include "../config/Config.h"
 #include "Sensor.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,6 +34,9 @@ namespace Aws
                  * Each Sensor reads and publishes independently of other sensors.
                  *
                  * SensorPublish notifies all Sensor instances in the list to stop and start.
+                 *
+                 * The list can be changed while the feature runs with reconfigure, which only replaces the sensors
+                 * whose settings changed, so that the MQTT connection and the other sensors are left running.
                  */
                 class SensorPublishFeature : public Feature
                 {
@@ -39,6 +46,16 @@ namespace Aws
                      */
                     static constexpr char TAG[] = "SensorPublishFeature.cpp";
 
+                    /**
+                     * \brief Delay before the release task runs again, when the sensors are locked by another thread
+                     */
+                    static constexpr int64_t RELEASE_RETRY_MS = 100;
+
+                    /**
+                     * \brief Time the destructor waits for the completion callbacks of the sensors
+                     */
+                    static constexpr int64_t PENDING_PUBLISHES_TIMEOUT_MS = 5000;
+
                     /**
                      * \brief The resource manager used to manage CRT resources
                      */
@@ -50,10 +67,89 @@ namespace Aws
                      */
                     std::shared_ptr<ClientBaseNotifier> mBaseNotifier;
 
+                    /**
+                     * \brief A sensor, the copy of the settings it was created from and the event loop it runs on
+                     *
+                     * The sensor keeps a reference to its settings, so they are owned here rather than by the
+                     * configuration, which a reload replaces.
+                     */
+                    struct SensorEntry
+                    {
+                        std::unique_ptr<PlainConfig::SensorPublish::SensorSettings> settings;
+                        std::unique_ptr<Sensor> sensor;
+                        aws_event_loop *eventLoop{nullptr};
+                        std::size_t loopIndex{0};
+                    };
+
                     /**
                      * \brief List of sensors
                      */
-                    std::vector<std::unique_ptr<Sensor>> mSensors;
+                    std::vector<SensorEntry> mSensors;
+
+                    /**
+                     * \brief Sensors removed or replaced by reconfigure, kept until their publishes are acknowledged
+                     */
+                    std::vector<SensorEntry> mRetiredSensors;
+
+                    /**
+                     * \brief Protects mSensors and mRetiredSensors
+                     */
+                    mutable std::mutex mSensorsLock;
+
+                    /**
+                     * \brief State shared with the idle callbacks of the sensors
+                     *
+                     * A completion callback may still invoke the idle callback after its sensor became idle, so the
+                     * state outlives the feature until every such callback returned.
+                     */
+                    struct ReleaseState
+                    {
+                        /**
+                         * \brief Protects feature and releaseScheduled
+                         */
+                        std::mutex lock;
+
+                        /**
+                         * \brief Signaled when a sensor becomes idle or the release task is no longer scheduled
+                         */
+                        std::condition_variable changed;
+
+                        /**
+                         * \brief Feature the release task is scheduled for, null once it is being destroyed
+                         */
+                        SensorPublishFeature *feature{nullptr};
+
+                        /**
+                         * \brief Flag to indicate the release task is scheduled
+                         */
+                        bool releaseScheduled{false};
+
+                        /**
+                         * \brief Flag to indicate sensors becoming idle are waited for, read without the lock when a
+                         * sensor has no publish pending anymore
+                         */
+                        std::atomic<bool> watching{false};
+                    };
+
+                    /**
+                     * \brief State shared with the idle callbacks of the sensors
+                     */
+                    std::shared_ptr<ReleaseState> mReleaseState;
+
+                    /**
+                     * \brief Task for destroying the retired sensors once their last publish completes
+                     */
+                    aws_task mReleaseTask;
+
+                    /**
+                     * \brief Event loop the release task runs on
+                     */
+                    aws_event_loop *mReleaseLoop{nullptr};
+
+                    /**
+                     * \brief Flag to indicate the feature is started, so that sensors added by reconfigure are started
+                     */
+                    bool mStarted{false};
 
                     /**
                      * \brief createSensor is a factory function for sensors
@@ -64,13 +160,56 @@ namespace Aws
                         std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
                         aws_event_loop *eventLoop) const;
 
+                    /**
+                     * \brief Create a sensor from a copy of its settings, on the event loop at loopIndex
+                     *
+                     * @return false when the sensor could not be created, the error is logged
+                     */
+                    bool addSensor(
+                        const PlainConfig::SensorPublish::SensorSettings &settings,
+                        std::size_t loopIndex,
+                        std::vector<SensorEntry> &sensors);
+
+                    /**
+                     * \brief Publish the buffered messages of a sensor and stop it, from its event loop
+                     *
+                     * Blocks until the sensor is stopped, so that none of its tasks runs after it is destroyed.
+                     */
+                    static void drainAndStop(SensorEntry &entry);
+
+                    /**
+                     * \brief Destroy the retired sensors without publishes waiting for their completion callback, must
+                     * be called with mSensorsLock held
+                     */
+                    void releaseRetiredSensors();
+
+                    /**
+                     * \brief Idle callback of every sensor, called with the release state
+                     *
+                     * Schedules the release task while sensors are retired, and wakes the destructor.
+                     */
+                    static void onSensorIdle(void *arg);
+
+                    /**
+                     * \brief Callback function for release task
+                     *
+                     * @return false when the release must be attempted again later
+                     */
+                    bool onReleaseTaskCallback();
+
                   public:
                     static constexpr char NAME[] = "Sensor Publish";
 
                     /**
                      * \brief Constructor
                      */
-                    SensorPublishFeature() = default;
+                    SensorPublishFeature();
+
+                    /**
+                     * \brief Waits for the release task, which refers to the feature, and for the completion
+                     * callbacks of the sensors, which refer to the sensors
+                     */
+                    ~SensorPublishFeature() override;
 
                     // Non-copyable.
                     SensorPublishFeature(const SensorPublishFeature &) = delete;
@@ -111,10 +250,46 @@ namespace Aws
                      */
                     std::string getName() override;
 
+                    /**
+                     * \brief Apply new sensor publish settings while the feature runs
+                     *
+                     * Sensors are matched by name. A sensor whose settings are unchanged keeps running. A sensor
+                     * that is no longer configured, or whose settings changed, publishes its buffered messages and
+                     * stops. A changed sensor is then created again with its new settings on the same event loop, and
+                     * a new sensor is placed on the least loaded event loop.
+                     *
+                     * @param config the configuration to apply, the settings are copied
+                     * @return an integer representing the SUCCESS or FAILURE of the reconfigure() operation
+                     */
+                    int reconfigure(const PlainConfig &config);
+
                     /**
                      * \brief Returns the number of initialized sensors
                      */
                     std::size_t getSensorsSize() const;
+
+                    /**
+                     * \brief Place sensors on event loops, so that the total weight of the sensors on each loop is
+                     * balanced
+                     *
+                     * @param weights the configured weight of each sensor
+                     * @param loopCount the number of event loops
+                     * @return the index of the event loop of each sensor
+                     */
+                    static std::vector<std::size_t> placeSensors(
+                        const std::vector<int64_t> &weights,
+                        std::size_t loopCount);
+
+                    /**
+                     * \brief Place sensors on event loops which already carry a load
+                     *
+                     * @param weights the configured weight of each sensor
+                     * @param loads the total weight of the sensors already on each event loop
+                     * @return the index of the event loop of each sensor
+                     */
+                    static std::vector<std::size_t> placeSensors(
+                        const std::vector<int64_t> &weights,
+                        std::vector<int64_t> loads);
                 };
             } // namespace SensorPublish
         } // namespace DeviceClient
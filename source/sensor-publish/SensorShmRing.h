@@ -0,0 +1,237 @@
+/* Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/*
+ * Producer side of the shared memory ring read by the device client when a sensor's transport is "shm".
+ *
+ * This header is plain C99 and has no dependency on the device client, so that a sensor process can copy it. The
+ * producer creates the ring, listens on the Unix domain socket configured as the sensor's addr, and passes the ring
+ * to the device client with dc_shm_ring_send() when it connects. The device client then reads sensor data from the
+ * ring in place, without a copy through the kernel, and the socket is only used to detect that either side went away.
+ *
+ * The ring is a single producer, single consumer byte stream: messages are written back to back, each terminated by
+ * the sensor's eom_delimiter, as they would be written to a stream socket. Its memory is a sealed memfd which cannot
+ * be truncated, so that the device client never faults on the mapping. The producer writes head and the consumer
+ * writes tail; both are positions in the stream that only increase and are reduced modulo capacity to index the data.
+ * When the consumer runs out of data, it sets consumer_waiting, and the next write signals the eventfd.
+ *
+ * Linux only. Define _GNU_SOURCE before including any system header when compiling as C.
+ */
+
+#ifndef DEVICE_CLIENT_SENSOR_SHM_RING_H
+#define DEVICE_CLIENT_SENSOR_SHM_RING_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define DC_SHM_RING_MAGIC 0x52534344u /* "DCSR" */
+#define DC_SHM_RING_VERSION 1u
+#define DC_SHM_RING_HEADER_BYTES 256u
+#define DC_SHM_RING_MAX_CAPACITY (1u << 30)
+
+/* Layout of the start of the shared memory, the data follows it. Fields written by each side are kept on separate
+ * cache lines. */
+struct dc_shm_ring_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity; /* Size of the data, a power of two. */
+    uint8_t reserved0[48];
+    uint64_t head; /* Position one past the last byte written, only written by the producer. */
+    uint8_t reserved1[56];
+    uint64_t tail; /* Position of the first byte not consumed yet, only written by the consumer. */
+    uint32_t consumer_waiting; /* Set by the consumer before waiting on the eventfd, cleared by the producer. */
+    uint8_t reserved2[116];
+};
+
+typedef char dc_shm_ring_header_size_check[sizeof(struct dc_shm_ring_header) == DC_SHM_RING_HEADER_BYTES ? 1 : -1];
+
+/* Producer handle of a ring. */
+struct dc_shm_ring
+{
+    struct dc_shm_ring_header *header;
+    uint8_t *data;
+    int mem_fd;
+    int event_fd;
+};
+
+/*
+ * Create a ring holding up to capacity bytes, a power of two from 4096 to DC_SHM_RING_MAX_CAPACITY.
+ * The name only identifies the memory in /proc for debugging. Returns 0, or -1 with errno set.
+ */
+static inline int dc_shm_ring_create(struct dc_shm_ring *ring, const char *name, uint64_t capacity)
+{
+    size_t size = DC_SHM_RING_HEADER_BYTES + (size_t)capacity;
+    void *map;
+
+    ring->header = NULL;
+    ring->data = NULL;
+    ring->mem_fd = -1;
+    ring->event_fd = -1;
+    if (capacity < 4096 || capacity > DC_SHM_RING_MAX_CAPACITY || (capacity & (capacity - 1)) != 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ring->mem_fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (ring->mem_fd < 0 || ftruncate(ring->mem_fd, (off_t)size) != 0 ||
+        fcntl(ring->mem_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+    {
+        goto error;
+    }
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->mem_fd, 0);
+    if (map == MAP_FAILED)
+    {
+        goto error;
+    }
+    ring->header = (struct dc_shm_ring_header *)map;
+    ring->data = (uint8_t *)map + DC_SHM_RING_HEADER_BYTES;
+    ring->header->magic = DC_SHM_RING_MAGIC;
+    ring->header->version = DC_SHM_RING_VERSION;
+    ring->header->capacity = capacity;
+
+    ring->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ring->event_fd < 0)
+    {
+        goto error;
+    }
+    return 0;
+
+error:
+{
+    int saved = errno;
+    if (ring->header != NULL)
+    {
+        munmap(ring->header, size);
+        ring->header = NULL;
+        ring->data = NULL;
+    }
+    if (ring->mem_fd >= 0)
+    {
+        close(ring->mem_fd);
+        ring->mem_fd = -1;
+    }
+    errno = saved;
+    return -1;
+}
+}
+
+/* Unmap the ring and close its file descriptors, a connected device client keeps its own mapping. */
+static inline void dc_shm_ring_destroy(struct dc_shm_ring *ring)
+{
+    if (ring->header != NULL)
+    {
+        munmap(ring->header, DC_SHM_RING_HEADER_BYTES + (size_t)ring->header->capacity);
+    }
+    if (ring->mem_fd >= 0)
+    {
+        close(ring->mem_fd);
+    }
+    if (ring->event_fd >= 0)
+    {
+        close(ring->event_fd);
+    }
+    ring->header = NULL;
+    ring->data = NULL;
+    ring->mem_fd = -1;
+    ring->event_fd = -1;
+}
+
+/*
+ * Pass the ring to the device client over a connected Unix domain stream socket, as one byte carrying the memory
+ * and eventfd file descriptors. Returns 0, or -1 with errno set.
+ */
+static inline int dc_shm_ring_send(const struct dc_shm_ring *ring, int sockfd)
+{
+    char byte = 'R';
+    struct iovec iov;
+    struct msghdr msg;
+    union
+    {
+        char buf[CMSG_SPACE(2 * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct cmsghdr *cmsg;
+    int fds[2];
+    ssize_t rc;
+
+    iov.iov_base = &byte;
+    iov.iov_len = 1;
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(2 * sizeof(int));
+    fds[0] = ring->mem_fd;
+    fds[1] = ring->event_fd;
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    do
+    {
+        rc = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+    } while (rc < 0 && errno == EINTR);
+    return rc == 1 ? 0 : -1;
+}
+
+/*
+ * Append len bytes to the ring, which is all or nothing. Returns 0, or -1 with errno set to EAGAIN when the ring does
+ * not have room yet, in which case the producer retries once the device client consumed data, for example after
+ * sleeping a millisecond, or to EMSGSIZE when len is larger than the ring.
+ */
+static inline int dc_shm_ring_write(struct dc_shm_ring *ring, const void *data, size_t len)
+{
+    uint64_t capacity = ring->header->capacity;
+    uint64_t head = ring->header->head;
+    uint64_t tail = __atomic_load_n(&ring->header->tail, __ATOMIC_ACQUIRE);
+    size_t index = (size_t)(head & (capacity - 1));
+    size_t first = len;
+
+    if (len > capacity)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (capacity - (head - tail) < len)
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if (first > capacity - index)
+    {
+        first = (size_t)(capacity - index);
+    }
+    memcpy(ring->data + index, data, first);
+    memcpy(ring->data, (const uint8_t *)data + first, len - first);
+    __atomic_store_n(&ring->header->head, head + len, __ATOMIC_RELEASE);
+
+    /* Order the store of head before the load of consumer_waiting, the consumer does the opposite. */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->header->consumer_waiting, __ATOMIC_RELAXED) &&
+        __atomic_exchange_n(&ring->header->consumer_waiting, 0, __ATOMIC_ACQ_REL))
+    {
+        uint64_t one = 1;
+        ssize_t rc;
+        do
+        {
+            rc = write(ring->event_fd, &one, sizeof(one));
+        } while (rc < 0 && errno == EINTR);
+    }
+    return 0;
+}
+
+#endif /* DEVICE_CLIENT_SENSOR_SHM_RING_H */
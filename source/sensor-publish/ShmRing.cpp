@@ -0,0 +1,120 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ShmRing.h"
+
+#include "../logging/LoggerFactory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char ShmRing::TAG[];
+
+bool ShmRing::attach(int memFd, int eventFd)
+{
+    detach();
+    mMemFd = memFd;
+    mEventFd = eventFd;
+
+    // The producer must not be able to shrink the memory, or reading the mapping would raise SIGBUS.
+    int seals = fcntl(memFd, F_GET_SEALS);
+    struct stat info;
+    if (seals < 0 || (seals & F_SEAL_SHRINK) == 0 || fstat(memFd, &info) != 0 ||
+        static_cast<uint64_t>(info.st_size) < DC_SHM_RING_HEADER_BYTES)
+    {
+        LOGM_ERROR(TAG, "Shared memory ring is not a memfd sealed against shrinking");
+        detach();
+        return false;
+    }
+
+    mMapBytes = static_cast<size_t>(info.st_size);
+    void *map = mmap(nullptr, mMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+    if (map == MAP_FAILED)
+    {
+        LOGM_ERROR(TAG, "Failed to map shared memory ring: %s", strerror(errno));
+        detach();
+        return false;
+    }
+    mHeader = static_cast<dc_shm_ring_header *>(map);
+
+    uint64_t capacity = mHeader->capacity;
+    if (mHeader->magic != DC_SHM_RING_MAGIC || mHeader->version != DC_SHM_RING_VERSION || capacity == 0 ||
+        capacity > DC_SHM_RING_MAX_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+        capacity > mMapBytes - DC_SHM_RING_HEADER_BYTES)
+    {
+        LOGM_ERROR(TAG, "Shared memory ring header is not valid, version: %u", mHeader->version);
+        detach();
+        return false;
+    }
+    mCapacity = static_cast<size_t>(capacity);
+    mData = static_cast<uint8_t *>(map) + DC_SHM_RING_HEADER_BYTES;
+    mTail = __atomic_load_n(&mHeader->tail, __ATOMIC_ACQUIRE);
+
+    // Edge triggered events from the event loop are followed by reads until the eventfd would block.
+    fcntl(eventFd, F_SETFL, fcntl(eventFd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void ShmRing::detach()
+{
+    if (mHeader != nullptr)
+    {
+        munmap(mHeader, mMapBytes);
+        mHeader = nullptr;
+        mData = nullptr;
+        mCapacity = 0;
+        mMapBytes = 0;
+    }
+    if (mMemFd >= 0)
+    {
+        close(mMemFd);
+        mMemFd = -1;
+    }
+    if (mEventFd >= 0)
+    {
+        close(mEventFd);
+        mEventFd = -1;
+    }
+}
+
+bool ShmRing::readable(size_t &bytes) const
+{
+    uint64_t written = __atomic_load_n(&mHeader->head, __ATOMIC_ACQUIRE) - mTail;
+    if (written > mCapacity)
+    {
+        return false;
+    }
+    bytes = static_cast<size_t>(written);
+    return true;
+}
+
+void ShmRing::release(size_t bytes)
+{
+    mTail += bytes;
+    __atomic_store_n(&mHeader->tail, mTail, __ATOMIC_RELEASE);
+}
+
+void ShmRing::requestWakeup()
+{
+    __atomic_store_n(&mHeader->consumer_waiting, 1, __ATOMIC_RELAXED);
+    // Order the store of consumer_waiting before the next load of head, the producer does the opposite.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void ShmRing::clearWakeup()
+{
+    // A read returns the count and resets it to zero, so one read is enough.
+    uint64_t count;
+    if (read(mEventFd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+    {
+        LOGM_DEBUG(TAG, "Failed to reset shared memory ring eventfd: %s", strerror(errno));
+    }
+}
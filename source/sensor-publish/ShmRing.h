@@ -0,0 +1,126 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SHMRING_H
+#define DEVICE_CLIENT_SHMRING_H
+
+#include "SensorShmRing.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief ShmRing is the consumer side of a shared memory ring written by a sensor process.
+                 *
+                 * The layout and the producer side are defined in SensorShmRing.h. Data is read in place from the
+                 * mapping, and the space is handed back to the producer with release(). Since the producer is another
+                 * process, the positions it writes are checked before they are used.
+                 *
+                 * Not thread safe, a ring is only used from the event loop of its sensor.
+                 */
+                class ShmRing
+                {
+                  public:
+                    ShmRing() = default;
+
+                    ~ShmRing() { detach(); }
+
+                    // Non-copyable.
+                    ShmRing(const ShmRing &) = delete;
+                    ShmRing &operator=(const ShmRing &) = delete;
+
+                    /**
+                     * \brief Map the ring passed by the producer, taking ownership of both file descriptors
+                     *
+                     * The descriptors are closed when the ring is rejected.
+                     *
+                     * @param memFd the sealed memfd holding the ring
+                     * @param eventFd the eventfd signaled by the producer
+                     * @return true on success
+                     */
+                    bool attach(int memFd, int eventFd);
+
+                    /**
+                     * \brief Unmap the ring and close its file descriptors
+                     */
+                    void detach();
+
+                    bool attached() const { return mHeader != nullptr; }
+
+                    std::uint8_t *data() const { return mData; }
+
+                    /**
+                     * @return the size of the data, a power of two
+                     */
+                    std::size_t capacity() const { return mCapacity; }
+
+                    /**
+                     * @return the position of the first byte not released yet
+                     */
+                    std::uint64_t tail() const { return mTail; }
+
+                    int eventFd() const { return mEventFd; }
+
+                    /**
+                     * \brief Get the number of bytes written by the producer and not released yet
+                     *
+                     * @param bytes set on return from function
+                     * @return false when the producer wrote a head outside of the ring
+                     */
+                    bool readable(std::size_t &bytes) const;
+
+                    /**
+                     * \brief Hand consumed bytes back to the producer
+                     */
+                    void release(std::size_t bytes);
+
+                    /**
+                     * \brief Ask the producer to signal the eventfd on its next write
+                     *
+                     * Data may have been written before the request was seen, so the caller checks readable() again
+                     * before waiting.
+                     */
+                    void requestWakeup();
+
+                    /**
+                     * \brief Reset the eventfd once its readable event was received
+                     */
+                    void clearWakeup();
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "ShmRing.cpp";
+
+                    dc_shm_ring_header *mHeader{nullptr};
+
+                    std::uint8_t *mData{nullptr};
+
+                    std::size_t mCapacity{0};
+
+                    std::size_t mMapBytes{0};
+
+                    /**
+                     * \brief Consumer position, the shared copy may be overwritten by the producer
+                     */
+                    std::uint64_t mTail{0};
+
+                    int mMemFd{-1};
+
+                    int mEventFd{-1};
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SHMRING_H
@@ -4,7 +4,13 @@
 #ifndef DEVICE_CLIENT_SOCKET_H
 #define DEVICE_CLIENT_SOCKET_H
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include <aws/common/zero.h>
 #include <aws/io/socket.h>
@@ -33,8 +39,17 @@ namespace Aws
                     virtual int subscribe_to_readable_events(
                         aws_socket_on_readable_fn *on_readable,
                         void *user_data) = 0;
+                    virtual int bind(const struct aws_socket_endpoint *local_endpoint) = 0;
+                    virtual int assign_to_event_loop(struct aws_event_loop *event_loop) = 0;
                     virtual bool is_open() = 0;
                     virtual int read(aws_byte_buf *buf, std::size_t *amount_read) = 0;
+                    virtual int peek_datagram_size(std::size_t *size) = 0;
+                    virtual int read_datagram(aws_byte_buf *first, aws_byte_buf *second, std::size_t *amount_read) = 0;
+                    virtual int read_with_fds(
+                        aws_byte_buf *buf,
+                        std::size_t *amount_read,
+                        int *fds,
+                        std::size_t *num_fds) = 0;
                     virtual int close() = 0;
                     virtual void clean_up() = 0;
                 };
@@ -87,6 +102,24 @@ namespace Aws
                         return aws_socket_subscribe_to_readable_events(&socket, on_readable, user_data);
                     }
 
+                    /**
+                     * \brief bind wraps aws_socket_bind, a bound datagram socket is readable
+                     */
+                    int bind(const struct aws_socket_endpoint *local_endpoint) override
+                    {
+                        aws_socket_bind_options bind_options{};
+                        bind_options.local_endpoint = local_endpoint;
+                        return aws_socket_bind(&socket, &bind_options);
+                    }
+
+                    /**
+                     * \brief assign_to_event_loop wraps aws_socket_assign_to_event_loop
+                     */
+                    int assign_to_event_loop(struct aws_event_loop *event_loop) override
+                    {
+                        return aws_socket_assign_to_event_loop(&socket, event_loop);
+                    }
+
                     /**
                      * \brief is_open wraps aws_socket_is_open
                      */
@@ -100,6 +133,126 @@ namespace Aws
                         return aws_socket_read(&socket, buf, amount_read);
                     }
 
+                    /**
+                     * \brief peek_datagram_size returns the size of the next datagram without reading it
+                     *
+                     * aws_socket has no datagram read, so the socket is read with recv(2) on its file descriptor.
+                     * MSG_TRUNC returns the full size of a datagram from a Unix datagram socket since Linux 3.4.
+                     */
+                    int peek_datagram_size(std::size_t *size) override
+                    {
+                        ssize_t rc;
+                        do
+                        {
+                            rc = recv(socket.io_handle.data.fd, nullptr, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+                        } while (rc < 0 && errno == EINTR);
+                        if (rc < 0)
+                        {
+                            return raiseReadError();
+                        }
+                        *size = static_cast<std::size_t>(rc);
+                        return AWS_OP_SUCCESS;
+                    }
+
+                    /**
+                     * \brief read_datagram reads one datagram into the free space of two buffers, first filled first
+                     */
+                    int read_datagram(aws_byte_buf *first, aws_byte_buf *second, std::size_t *amount_read) override
+                    {
+                        struct iovec iov[2];
+                        iov[0].iov_base = first->buffer + first->len;
+                        iov[0].iov_len = first->capacity - first->len;
+                        iov[1].iov_base = second->buffer + second->len;
+                        iov[1].iov_len = second->capacity - second->len;
+                        struct msghdr msg;
+                        AWS_ZERO_STRUCT(msg);
+                        msg.msg_iov = iov;
+                        msg.msg_iovlen = 2;
+
+                        ssize_t rc;
+                        do
+                        {
+                            rc = recvmsg(socket.io_handle.data.fd, &msg, MSG_DONTWAIT);
+                        } while (rc < 0 && errno == EINTR);
+                        if (rc < 0)
+                        {
+                            return raiseReadError();
+                        }
+                        std::size_t numRead = static_cast<std::size_t>(rc);
+                        std::size_t firstRead = std::min(numRead, iov[0].iov_len);
+                        first->len += firstRead;
+                        second->len += numRead - firstRead;
+                        *amount_read = numRead;
+                        return AWS_OP_SUCCESS;
+                    }
+
+                    /**
+                     * \brief read_with_fds reads like read and receives the file descriptors passed with the data
+                     *
+                     * On input num_fds is the size of fds, on return it is the number of descriptors received, which
+                     * the caller owns. Descriptors beyond the size of fds are closed by the kernel.
+                     */
+                    int read_with_fds(aws_byte_buf *buf, std::size_t *amount_read, int *fds, std::size_t *num_fds)
+                        override
+                    {
+                        struct iovec iov;
+                        iov.iov_base = buf->buffer + buf->len;
+                        iov.iov_len = buf->capacity - buf->len;
+                        union
+                        {
+                            char data[CMSG_SPACE(MAX_RECEIVED_FDS * sizeof(int))];
+                            struct cmsghdr align;
+                        } control;
+                        struct msghdr msg;
+                        AWS_ZERO_STRUCT(msg);
+                        msg.msg_iov = &iov;
+                        msg.msg_iovlen = 1;
+                        msg.msg_control = control.data;
+                        msg.msg_controllen = sizeof(control.data);
+
+                        ssize_t rc;
+                        do
+                        {
+                            rc = recvmsg(socket.io_handle.data.fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+                        } while (rc < 0 && errno == EINTR);
+                        if (rc < 0)
+                        {
+                            return raiseReadError();
+                        }
+                        if (rc == 0)
+                        {
+                            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+                        }
+
+                        std::size_t received = 0;
+                        struct cmsghdr *cmsg;
+                        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+                        {
+                            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+                            {
+                                continue;
+                            }
+                            std::size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                            for (std::size_t i = 0; i < count; ++i)
+                            {
+                                int fd;
+                                std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                                if (received < *num_fds)
+                                {
+                                    fds[received++] = fd;
+                                }
+                                else
+                                {
+                                    ::close(fd);
+                                }
+                            }
+                        }
+                        *num_fds = received;
+                        buf->len += static_cast<std::size_t>(rc);
+                        *amount_read = static_cast<std::size_t>(rc);
+                        return AWS_OP_SUCCESS;
+                    }
+
                     /**
                      * \brief close wraps aws_socket_close
                      */
@@ -115,6 +268,27 @@ namespace Aws
                      * \brief Socket for reading sensor data
                      */
                     aws_socket socket{};
+
+                    /**
+                     * \brief Maximum number of file descriptors received by read_with_fds in one message
+                     */
+                    static constexpr std::size_t MAX_RECEIVED_FDS = 4;
+
+                    /**
+                     * \brief Raise the aws error matching errno after a failed read, as aws_socket_read does
+                     */
+                    static int raiseReadError()
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        {
+                            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+                        }
+                        if (errno == ENOTCONN || errno == EBADF)
+                        {
+                            return aws_raise_error(AWS_IO_SOCKET_NOT_CONNECTED);
+                        }
+                        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+                    }
                 };
             } // namespace SensorPublish
         } // namespace DeviceClient
@@ -0,0 +1,368 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Spool.h"
+
+#include "../logging/LoggerFactory.h"
+#include "../util/FileUtils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+using namespace Aws::Iot::DeviceClient::Util;
+
+constexpr char Spool::TAG[];
+constexpr char Spool::SEGMENT_SUFFIX[];
+constexpr size_t Spool::RECORD_HEADER_BYTES;
+
+namespace
+{
+    uint32_t checksum(const uint8_t *data, size_t len)
+    {
+        return static_cast<uint32_t>(crc32(0L, data, static_cast<uInt>(len)));
+    }
+
+    /**
+     * \brief Parses the sequence number from a segment file name, such as "00000000000000000042.spool"
+     */
+    bool parseSegmentName(const string &name, uint64_t &id)
+    {
+        size_t suffixLength = strlen(Spool::SEGMENT_SUFFIX);
+        if (name.size() <= suffixLength ||
+            name.compare(name.size() - suffixLength, suffixLength, Spool::SEGMENT_SUFFIX) != 0)
+        {
+            return false;
+        }
+        string digits = name.substr(0, name.size() - suffixLength);
+        if (!all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            return false;
+        }
+        id = strtoull(digits.c_str(), nullptr, 10);
+        return true;
+    }
+} // namespace
+
+Spool::Spool(const string &dir, size_t maxBytes, size_t segmentBytes)
+    : mDir(FileUtils::ExtractExpandedPath(dir)), mMaxBytes(maxBytes),
+      mSegmentBytes(max<size_t>(1, min(segmentBytes, maxBytes / 2)))
+{
+}
+
+Spool::~Spool()
+{
+    unmapFront();
+    if (mWriteFd >= 0)
+    {
+        close(mWriteFd);
+    }
+}
+
+bool Spool::open()
+{
+    if (!FileUtils::CreateDirectoryWithPermissions(mDir.c_str(), S_IRWXU))
+    {
+        return false;
+    }
+
+    DIR *dir = opendir(mDir.c_str());
+    if (dir == nullptr)
+    {
+        LOGM_ERROR(TAG, "Failed to open spool directory %s: %s", mDir.c_str(), strerror(errno));
+        return false;
+    }
+    vector<uint64_t> ids;
+    for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+        uint64_t id;
+        if (parseSegmentName(entry->d_name, id))
+        {
+            ids.push_back(id);
+        }
+    }
+    closedir(dir);
+    sort(ids.begin(), ids.end());
+
+    for (uint64_t id : ids)
+    {
+        size_t bytes = recoverSegment(id);
+        if (bytes == 0)
+        {
+            unlink(segmentPath(id).c_str());
+            continue;
+        }
+        mSegments.push_back({id, bytes});
+        mBytes += bytes;
+    }
+    if (!mSegments.empty())
+    {
+        LOGM_INFO(TAG, "Recovered %zu bytes from spool directory %s", mBytes, mDir.c_str());
+    }
+
+    // Recovered records are never appended to, so that a torn record cannot be followed by a valid one.
+    return startSegment();
+}
+
+bool Spool::append(const aws_byte_cursor &payload)
+{
+    if (payload.len == 0)
+    {
+        return true; // An empty record would be indistinguishable from a zero filled segment on recovery.
+    }
+
+    size_t recordBytes = RECORD_HEADER_BYTES + payload.len;
+    if (recordBytes > mMaxBytes || mWriteFd < 0)
+    {
+        LOGM_ERROR(TAG, "Unable to spool %zu bytes in spool directory %s", payload.len, mDir.c_str());
+        return false;
+    }
+
+    if (mSegments.back().bytes > 0 && mSegments.back().bytes + recordBytes > mSegmentBytes)
+    {
+        if (!startSegment())
+        {
+            return false;
+        }
+    }
+
+    // Make room for the record by deleting the oldest records.
+    uint64_t evictedBytes = 0;
+    while (mBytes + recordBytes > mMaxBytes)
+    {
+        bool lastSegment = mSegments.size() == 1;
+        evictedBytes += mSegments.front().bytes - mReadOffset;
+        dropFront();
+        if (lastSegment && !startSegment())
+        {
+            return false;
+        }
+    }
+    if (evictedBytes > 0)
+    {
+        mEvictedBytes += evictedBytes;
+        LOGM_WARN(TAG, "Spool is full, deleted %" PRIu64 " bytes from spool directory %s", evictedBytes, mDir.c_str());
+    }
+
+    uint32_t header[2] = {static_cast<uint32_t>(payload.len), checksum(payload.ptr, payload.len)};
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = payload.ptr;
+    iov[1].iov_len = payload.len;
+
+    ssize_t written;
+    do
+    {
+        written = writev(mWriteFd, iov, 2);
+    } while (written < 0 && errno == EINTR);
+    if (written != static_cast<ssize_t>(recordBytes))
+    {
+        LOGM_ERROR(TAG, "Failed to write to spool directory %s: %s", mDir.c_str(), strerror(errno));
+        // Remove any partial record, so that the segment only holds complete records.
+        if (ftruncate(mWriteFd, static_cast<off_t>(mSegments.back().bytes)) != 0)
+        {
+            startSegment();
+        }
+        return false;
+    }
+
+    mSegments.back().bytes += recordBytes;
+    mBytes += recordBytes;
+    return true;
+}
+
+bool Spool::front(aws_byte_cursor &payload)
+{
+    while (!mSegments.empty())
+    {
+        const Segment &segment = mSegments.front();
+        if (mReadOffset >= segment.bytes)
+        {
+            if (mSegments.size() == 1)
+            {
+                return false; // Every record has been consumed.
+            }
+            dropFront();
+            continue;
+        }
+
+        // Records appended since the segment was mapped are beyond the end of the mapping.
+        if (mReadMap == nullptr || mReadMapBytes < segment.bytes)
+        {
+            if (!mapFront())
+            {
+                mEvictedBytes += segment.bytes - mReadOffset;
+                dropFront();
+                if (mSegments.empty())
+                {
+                    startSegment();
+                }
+                continue;
+            }
+        }
+
+        uint32_t header[2];
+        memcpy(header, mReadMap + mReadOffset, sizeof(header));
+        payload = aws_byte_cursor_from_array(mReadMap + mReadOffset + RECORD_HEADER_BYTES, header[0]);
+        return true;
+    }
+    return false;
+}
+
+void Spool::pop()
+{
+    aws_byte_cursor payload;
+    if (!front(payload))
+    {
+        return;
+    }
+    size_t recordBytes = RECORD_HEADER_BYTES + payload.len;
+    mReadOffset += recordBytes;
+    mBytes -= recordBytes;
+    if (mReadOffset >= mSegments.front().bytes && mSegments.size() > 1)
+    {
+        dropFront();
+    }
+}
+
+string Spool::segmentPath(uint64_t id) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%020" PRIu64 "%s", id, SEGMENT_SUFFIX);
+    return mDir + "/" + name;
+}
+
+size_t Spool::recoverSegment(uint64_t id) const
+{
+    string path = segmentPath(id);
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LOGM_ERROR(TAG, "Failed to open spool segment %s: %s", path.c_str(), strerror(errno));
+        return 0;
+    }
+
+    struct stat info;
+    size_t fileBytes = fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    size_t validBytes = 0;
+    if (fileBytes > 0)
+    {
+        void *map = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            const uint8_t *data = static_cast<const uint8_t *>(map);
+            while (validBytes + RECORD_HEADER_BYTES <= fileBytes)
+            {
+                uint32_t header[2];
+                memcpy(header, data + validBytes, sizeof(header));
+                size_t recordBytes = RECORD_HEADER_BYTES + header[0];
+                if (header[0] == 0 || recordBytes > fileBytes - validBytes ||
+                    checksum(data + validBytes + RECORD_HEADER_BYTES, header[0]) != header[1])
+                {
+                    break;
+                }
+                validBytes += recordBytes;
+            }
+            munmap(map, fileBytes);
+        }
+    }
+
+    if (validBytes < fileBytes)
+    {
+        LOGM_WARN(
+            TAG,
+            "Discarding %zu bytes of incomplete records from spool segment %s",
+            fileBytes - validBytes,
+            path.c_str());
+        if (ftruncate(fd, static_cast<off_t>(validBytes)) != 0)
+        {
+            validBytes = 0;
+        }
+    }
+    close(fd);
+    return validBytes;
+}
+
+bool Spool::startSegment()
+{
+    if (mWriteFd >= 0)
+    {
+        close(mWriteFd);
+        mWriteFd = -1;
+    }
+
+    uint64_t id = mSegments.empty() ? 1 : mSegments.back().id + 1;
+    string path = segmentPath(id);
+    mWriteFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (mWriteFd < 0)
+    {
+        LOGM_ERROR(TAG, "Failed to create spool segment %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    mSegments.push_back({id, 0});
+    return true;
+}
+
+bool Spool::mapFront()
+{
+    unmapFront();
+
+    const Segment &segment = mSegments.front();
+    string path = segmentPath(segment.id);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LOGM_ERROR(TAG, "Failed to open spool segment %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    void *map = mmap(nullptr, segment.bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        LOGM_ERROR(TAG, "Failed to map spool segment %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    mReadMap = static_cast<uint8_t *>(map);
+    mReadMapBytes = segment.bytes;
+    return true;
+}
+
+void Spool::unmapFront()
+{
+    if (mReadMap != nullptr)
+    {
+        munmap(mReadMap, mReadMapBytes);
+        mReadMap = nullptr;
+        mReadMapBytes = 0;
+    }
+}
+
+void Spool::dropFront()
+{
+    unmapFront();
+    if (mSegments.size() == 1 && mWriteFd >= 0)
+    {
+        close(mWriteFd);
+        mWriteFd = -1;
+    }
+    const Segment &segment = mSegments.front();
+    mBytes -= segment.bytes - mReadOffset;
+    unlink(segmentPath(segment.id).c_str());
+    mSegments.pop_front();
+    mReadOffset = 0;
+}
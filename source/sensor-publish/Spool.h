@@ -0,0 +1,191 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SPOOL_H
+#define DEVICE_CLIENT_SPOOL_H
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Spool stores sensor batches on disk while they cannot be published, oldest first.
+                 *
+                 * The spool is an append-only log split into numbered segment files in its directory. Each record
+                 * is a header holding the payload length and CRC-32 followed by the payload. Records are appended with
+                 * write(2) to the newest segment and read through a read-only mmap(2) of the oldest segment, which is
+                 * deleted once every record in it is consumed. When the spool is over its size limit, the oldest
+                 * segments are deleted. Records left in the directory are recovered on open(), and the records of a
+                 * partially consumed segment are read again, so delivery is at least once.
+                 *
+                 * Not thread safe, a spool is only used from the event loop of its sensor.
+                 */
+                class Spool
+                {
+                  public:
+                    /**
+                     * \brief File name suffix of a segment
+                     */
+                    static constexpr char SEGMENT_SUFFIX[] = ".spool";
+
+                    /**
+                     * \brief Size of the header preceding each record, the payload length and its CRC-32
+                     */
+                    static constexpr std::size_t RECORD_HEADER_BYTES = 8;
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param dir the directory holding the segment files, which is not shared with other spools
+                     * @param maxBytes the size limit of the spool, including record headers
+                     * @param segmentBytes the size at which a segment is closed and a new one is started
+                     */
+                    Spool(const std::string &dir, std::size_t maxBytes, std::size_t segmentBytes);
+
+                    ~Spool();
+
+                    // Non-copyable.
+                    Spool(const Spool &) = delete;
+                    Spool &operator=(const Spool &) = delete;
+
+                    /**
+                     * \brief Create the directory if needed and recover the records it holds
+                     *
+                     * A record which is cut short or fails its checksum ends its segment, the rest of that segment
+                     * is discarded.
+                     *
+                     * @return true on success
+                     */
+                    bool open();
+
+                    /**
+                     * \brief Append a record, deleting the oldest segments when the spool is over its size limit
+                     *
+                     * @param payload the record, empty records are ignored
+                     * @return true on success, false if the record is larger than the size limit or on I/O error
+                     */
+                    bool append(const aws_byte_cursor &payload);
+
+                    /**
+                     * \brief Get the oldest record
+                     *
+                     * The cursor points into a mapping of the segment and is valid until the next call to append()
+                     * or pop().
+                     *
+                     * @param payload set to the record on return
+                     * @return true when the spool holds a record
+                     */
+                    bool front(aws_byte_cursor &payload);
+
+                    /**
+                     * \brief Consume the oldest record
+                     */
+                    void pop();
+
+                    /**
+                     * @return true when the spool holds no record
+                     */
+                    bool empty() const { return mBytes == 0; }
+
+                    /**
+                     * @return the size of the records held by the spool, including record headers
+                     */
+                    std::size_t size() const { return mBytes; }
+
+                    /**
+                     * @return the size of the records deleted to keep the spool under its size limit
+                     */
+                    std::uint64_t getEvictedBytes() const { return mEvictedBytes; }
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "Spool.cpp";
+
+                    struct Segment
+                    {
+                        /** Sequence number of the segment, which orders segments and names their file **/
+                        std::uint64_t id;
+                        /** Size of the valid records in the segment file **/
+                        std::size_t bytes;
+                    };
+
+                    std::string mDir;
+
+                    std::size_t mMaxBytes;
+
+                    std::size_t mSegmentBytes;
+
+                    /**
+                     * \brief Segments ordered from oldest to newest, records are appended to the last one
+                     */
+                    std::deque<Segment> mSegments;
+
+                    /**
+                     * \brief File descriptor of the last segment, opened for appending
+                     */
+                    int mWriteFd{-1};
+
+                    /**
+                     * \brief Read-only mapping of the first segment
+                     */
+                    std::uint8_t *mReadMap{nullptr};
+
+                    std::size_t mReadMapBytes{0};
+
+                    /**
+                     * \brief Offset of the oldest record in the first segment
+                     */
+                    std::size_t mReadOffset{0};
+
+                    /**
+                     * \brief Size of the records not consumed yet
+                     */
+                    std::size_t mBytes{0};
+
+                    std::uint64_t mEvictedBytes{0};
+
+                    std::string segmentPath(std::uint64_t id) const;
+
+                    /**
+                     * \brief Scan a recovered segment and truncate it after its last valid record
+                     *
+                     * @return the size of the valid records
+                     */
+                    std::size_t recoverSegment(std::uint64_t id) const;
+
+                    /**
+                     * \brief Close the last segment and start a new one
+                     */
+                    bool startSegment();
+
+                    /**
+                     * \brief Map the first segment up to its current size
+                     */
+                    bool mapFront();
+
+                    void unmapFront();
+
+                    /**
+                     * \brief Delete the first segment along with its unconsumed records
+                     */
+                    void dropFront();
+                };
+            } // namespace SensorPublish
+        } // namespace DeviceClient
+    } // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SPOOL_H
@@ -907,6 +907,284 @@ TEST_F(ConfigTestFixture, SDKLoggingConfigurationJson)
     ASSERT_STREQ("device-client.log", config.logConfig.deviceClientLogFile.c_str());
 }
 
+TEST_F(ConfigTestFixture, LogFlushConfigurationJson)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "type": "FILE",
+        "file": "device-client.log",
+        "flush-interval-ms": 1000,
+        "flush-threshold-bytes": 65536
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(1000, config.logConfig.flushIntervalMs);
+    ASSERT_EQ(65536, config.logConfig.flushThresholdBytes);
+}
+
+TEST_F(ConfigTestFixture, LogFlushConfigurationCli)
+{
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_FLUSH_INTERVAL_MS] = "250";
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_FLUSH_THRESHOLD_BYTES] = "4096";
+
+    PlainConfig config;
+    config.LoadFromCliArgs(cliArgs);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(250, config.logConfig.flushIntervalMs);
+    ASSERT_EQ(4096, config.logConfig.flushThresholdBytes);
+}
+
+TEST_F(ConfigTestFixture, LogFlushConfigurationRejectsNegativeValues)
+{
+    PlainConfig config;
+    config.logConfig.flushIntervalMs = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+
+    config.logConfig.flushIntervalMs = 0;
+    config.logConfig.flushThresholdBytes = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
+TEST_F(ConfigTestFixture, EventLoopConfigurationJson)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "event-loop": {
+        "threads": 4,
+        "cpu-affinity": [2, 3]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.eventLoop.Validate());
+    ASSERT_EQ(4, config.eventLoop.threads.value());
+    ASSERT_EQ(std::vector<int>({2, 3}), config.eventLoop.cpuAffinity);
+}
+
+TEST_F(ConfigTestFixture, EventLoopConfigurationCli)
+{
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::EventLoop::CLI_EVENT_LOOP_THREADS] = "8";
+
+    PlainConfig config;
+    ASSERT_FALSE(config.eventLoop.threads.has_value()); // Defaults to the number of cores.
+    ASSERT_TRUE(config.LoadFromCliArgs(cliArgs));
+
+    ASSERT_TRUE(config.eventLoop.Validate());
+    ASSERT_EQ(8, config.eventLoop.threads.value());
+}
+
+TEST_F(ConfigTestFixture, EventLoopConfigurationRejectsInvalidValues)
+{
+    PlainConfig config;
+    config.eventLoop.threads = 0;
+    ASSERT_FALSE(config.eventLoop.Validate());
+
+    config.eventLoop.threads = PlainConfig::EventLoop::MAX_THREADS + 1;
+    ASSERT_FALSE(config.eventLoop.Validate());
+
+    config.eventLoop.threads = 2;
+    config.eventLoop.cpuAffinity = {0, -1};
+    ASSERT_FALSE(config.eventLoop.Validate());
+}
+
+TEST_F(ConfigTestFixture, LogBinaryFormatConfiguration)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "type": "FILE",
+        "file": "device-client.log",
+        "binary-format": true
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    ASSERT_FALSE(config.logConfig.binaryFormat);
+    config.LoadFromJson(jsonView);
+    ASSERT_TRUE(config.logConfig.binaryFormat);
+
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_BINARY_FORMAT] = "false";
+    config.LoadFromCliArgs(cliArgs);
+    ASSERT_FALSE(config.logConfig.binaryFormat);
+}
+
+TEST_F(ConfigTestFixture, LogRotationConfiguration)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "type": "FILE",
+        "file": "device-client.log",
+        "rotation-max-size-bytes": 1048576,
+        "rotation-max-age-seconds": 86400,
+        "rotation-generations": 3,
+        "rotation-compress": false
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(1048576, config.logConfig.rotationMaxSizeBytes);
+    ASSERT_EQ(86400, config.logConfig.rotationMaxAgeSeconds);
+    ASSERT_EQ(3, config.logConfig.rotationGenerations);
+    ASSERT_FALSE(config.logConfig.rotationCompress);
+
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_ROTATION_MAX_SIZE_BYTES] = "4096";
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_ROTATION_GENERATIONS] = "10";
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_ROTATION_COMPRESS] = "true";
+    config.LoadFromCliArgs(cliArgs);
+
+    ASSERT_EQ(4096, config.logConfig.rotationMaxSizeBytes);
+    ASSERT_EQ(10, config.logConfig.rotationGenerations);
+    ASSERT_TRUE(config.logConfig.rotationCompress);
+}
+
+TEST_F(ConfigTestFixture, LogRotationConfigurationRejectsInvalidValues)
+{
+    PlainConfig config;
+    config.logConfig.rotationMaxSizeBytes = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+
+    config.logConfig.rotationMaxSizeBytes = 0;
+    config.logConfig.rotationMaxAgeSeconds = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+
+    config.logConfig.rotationMaxAgeSeconds = 0;
+    config.logConfig.rotationGenerations = 0;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
+TEST_F(ConfigTestFixture, LogQueueConfiguration)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "queue-capacity": 1024,
+        "queue-overflow-policy": "DROP-BELOW-LEVEL"
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    ASSERT_TRUE(config.LoadFromJson(jsonView));
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(1024, config.logConfig.queueCapacity);
+    ASSERT_STREQ(
+        PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_BELOW_LEVEL, config.logConfig.queueOverflowPolicy.c_str());
+
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_QUEUE_CAPACITY] = "256";
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_QUEUE_OVERFLOW_POLICY] = "drop-oldest";
+    config.LoadFromCliArgs(cliArgs);
+
+    ASSERT_EQ(256, config.logConfig.queueCapacity);
+    ASSERT_STREQ(PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_OLDEST, config.logConfig.queueOverflowPolicy.c_str());
+
+    config.logConfig.queueCapacity = 0;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
+TEST_F(ConfigTestFixture, LogQueueConfigurationRejectsUnknownPolicy)
+{
+    constexpr char jsonString[] = R"(
+{
+    "queue-overflow-policy": "block"
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    ASSERT_FALSE(config.logConfig.LoadFromJson(jsonView));
+    ASSERT_STREQ(PlainConfig::LogConfig::QUEUE_OVERFLOW_DROP_NEWEST, config.logConfig.queueOverflowPolicy.c_str());
+}
+
+TEST_F(ConfigTestFixture, LogRateLimitConfiguration)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "rate-limit-per-second": 10,
+        "rate-limit-burst": 50
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(10, config.logConfig.rateLimitPerSecond);
+    ASSERT_EQ(50, config.logConfig.rateLimitBurst);
+
+    CliArgs cliArgs;
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_PER_SECOND] = "0";
+    cliArgs[PlainConfig::LogConfig::CLI_LOG_RATE_LIMIT_BURST] = "200";
+    config.LoadFromCliArgs(cliArgs);
+
+    ASSERT_EQ(0, config.logConfig.rateLimitPerSecond);
+    ASSERT_EQ(200, config.logConfig.rateLimitBurst);
+
+    config.logConfig.rateLimitPerSecond = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+    config.logConfig.rateLimitPerSecond = 10;
+    config.logConfig.rateLimitBurst = 0;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
 TEST_F(ConfigTestFixture, FleetProvisioningMinimumConfig)
 {
     constexpr char jsonString[] = R"(
@@ -1369,7 +1647,8 @@ TEST_F(ConfigTestFixture, SensorPublishInvalidConfigNegativeIntegers)
                 "addr_poll_sec": -1,
                 "buffer_time_ms": -1,
                 "buffer_size": -1,
-                "heartbeat_time_sec": -1
+                "heartbeat_time_sec": -1,
+                "max_in_flight": -1
             }
         ]
     }
@@ -1426,6 +1705,487 @@ TEST_F(ConfigTestFixture, SensorPublishInvalidConfigBufferCapacityTooSmall)
     ASSERT_FALSE(settings.enabled);
 }
 
+TEST_F(ConfigTestFixture, SensorPublishSpoolConfig)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/aws-iot-device-client-test-spool-config",
+                "spool_max_bytes": 1048576,
+                "spool_drain_bytes_per_sec": 4096
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.enabled);
+    ASSERT_EQ(config.sensorPublish.settings.size(), 1);
+    const auto &settings = config.sensorPublish.settings[0];
+    ASSERT_TRUE(settings.enabled);
+    ASSERT_EQ(settings.spoolDir.value(), "/tmp/aws-iot-device-client-test-spool-config");
+    ASSERT_EQ(settings.spoolMaxBytes.value(), 1048576);
+    ASSERT_EQ(settings.spoolDrainBytesPerSec.value(), 4096);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigSpool)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/aws-iot-device-client-test-spool-config",
+                "spool_max_bytes": 1024,
+                "spool_drain_bytes_per_sec": 0
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_FALSE(config.Validate()); // Spool smaller than two buffers and zero drain rate.
+    ASSERT_TRUE(config.sensorPublish.enabled);
+    ASSERT_EQ(config.sensorPublish.settings.size(), 1);
+    const auto &settings = config.sensorPublish.settings[0];
+    ASSERT_FALSE(settings.enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigCompression)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "deflate",
+                "compression_level": 6
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "lz4"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "deflate",
+                "compression_level": 10
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_TRUE(config.sensorPublish.enabled);
+    ASSERT_EQ(config.sensorPublish.settings.size(), 3);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigBatchFormat)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "batch_format": "cbor"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "batch_format": "xml"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 2);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].batchFormat.value(), "cbor");
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigHeartbeatFormat)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_heartbeat_topic": "my-sensor-heartbeat",
+                "heartbeat_format": "json"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_heartbeat_topic": "my-sensor-heartbeat",
+                "heartbeat_format": "xml"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 2);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].heartbeatFormat.value(), "json");
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigEventLoopWeight)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "event_loop_weight": 5
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "event_loop_weight": 0
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 2);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].eventLoopWeight.value(), 5);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigFilter)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_dedup": true,
+                "filter_deadband": 0.25,
+                "filter_json_key": "temperature",
+                "filter_keep_every": 10,
+                "filter_min_interval_ms": 1000
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_deadband": 0.25
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_deadband": 0.25,
+                "filter_json_key": "temperature",
+                "filter_csv_column": 1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_csv_column": 1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_deadband": -1,
+                "filter_csv_column": 1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_keep_every": 0
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "filter_min_interval_ms": -1
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 7);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].filterDeadband.value(), 0.25);
+    ASSERT_EQ(config.sensorPublish.settings[0].filterJsonKey.value(), "temperature");
+    ASSERT_EQ(config.sensorPublish.settings[0].filterKeepEvery.value(), 10);
+    for (size_t i = 1; i < config.sensorPublish.settings.size(); ++i)
+    {
+        ASSERT_FALSE(config.sensorPublish.settings[i].enabled) << "sensor " << i;
+    }
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigAdaptiveBatching)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "adaptive_latency_ms": 250,
+                "adaptive_max_payload_bytes": 32000
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "adaptive_latency_ms": 0
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "adaptive_max_payload_bytes": 32000
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "buffer_capacity": 16000,
+                "adaptive_latency_ms": 250,
+                "adaptive_max_payload_bytes": 32000
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 4);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].adaptiveLatencyMs.value(), 250);
+    ASSERT_EQ(config.sensorPublish.settings[0].adaptiveMaxPayloadBytes.value(), 32000);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigTransport)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "unix-datagram"
+            },
+            {
+                "addr": "127.0.0.1",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "tcp",
+                "tcp_port": 5000
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "udp"
+            },
+            {
+                "addr": "192.0.2.1",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "tcp",
+                "tcp_port": 5000
+            },
+            {
+                "addr": "::1",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "tcp"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "unix-stream"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "shm"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "mqtt_topic": "my-sensor-data",
+                "transport": "shm"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate()); // At least one sensor is valid.
+    ASSERT_EQ(config.sensorPublish.settings.size(), 8);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);  // A datagram socket needs no delimiter.
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);  // Loopback address.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // Unsupported transport.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Not a loopback address.
+    ASSERT_FALSE(config.sensorPublish.settings[4].enabled); // Missing tcp_port.
+    ASSERT_FALSE(config.sensorPublish.settings[5].enabled); // A stream socket needs a delimiter.
+    ASSERT_TRUE(config.sensorPublish.settings[6].enabled);  // Shared memory ring.
+    ASSERT_FALSE(config.sensorPublish.settings[7].enabled); // A shared memory ring needs a delimiter.
+}
+
 TEST_F(ConfigTestFixture, SensorPublishDisableFeature)
 {
     constexpr char jsonString[] = R"(
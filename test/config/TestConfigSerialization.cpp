@@ -33,10 +33,26 @@ TEST(SerializeConfigTestFixture, SerializeCompleteConfigTest)
         "level": "INFO",
         "type": "file",
         "file": "./aws-iot-device-client.log",
+        "socket": "",
+        "flush-interval-ms": 0,
+        "flush-threshold-bytes": 0,
+        "binary-format": false,
+        "rotation-max-size-bytes": 0,
+        "rotation-max-age-seconds": 0,
+        "rotation-generations": 5,
+        "rotation-compress": true,
+        "queue-capacity": 4096,
+        "queue-overflow-policy": "drop-newest",
+        "rate-limit-per-second": 0,
+        "rate-limit-burst": 100,
         "enable-sdk-logging": false,
         "sdk-log-level": "TRACE",
         "sdk-log-file": "/var/log/aws-iot-device-client/sdk.log"
     },
+    "event-loop": {
+        "threads": 4,
+        "cpu-affinity": [0, 1]
+    },
     "jobs": {
         "enabled": true,
         "handler-directory": "directory"
@@ -99,7 +115,19 @@ TEST(SerializeConfigTestFixture, SerializeCompleteConfigTest)
                 "mqtt_topic": "topic_1",
                 "mqtt_dead_letter_topic": "dead_letter_topic_1",
                 "mqtt_heartbeat_topic": "heart_beat_topic_1",
-                "heartbeat_time_sec": 300
+                "heartbeat_time_sec": 300,
+                "spool_dir": "spool_dir_1",
+                "spool_max_bytes": 16777216,
+                "spool_drain_bytes_per_sec": 128000,
+                "max_in_flight": 0,
+                "compression": "deflate",
+                "compression_level": 6,
+                "batch_format": "json",
+                "event_loop_weight": 1,
+                "filter_deadband": 1.5,
+                "filter_csv_column": 2,
+                "adaptive_latency_ms": 200,
+                "adaptive_max_payload_bytes": 64000
             },
             {
                 "name": "sensor_2",
@@ -113,7 +141,19 @@ TEST(SerializeConfigTestFixture, SerializeCompleteConfigTest)
                 "mqtt_topic": "topic_2",
                 "mqtt_dead_letter_topic": "dead_letter_topic_2",
                 "mqtt_heartbeat_topic": "heart_beat_topic_2",
-                "heartbeat_time_sec": 10
+                "heartbeat_time_sec": 10,
+                "spool_max_bytes": 1,
+                "spool_drain_bytes_per_sec": 1,
+                "max_in_flight": 1,
+                "compression_level": 1,
+                "transport": "tcp",
+                "tcp_port": 5000,
+                "event_loop_weight": 4,
+                "filter_dedup": true,
+                "filter_deadband": 0.5,
+                "filter_json_key": "temperature",
+                "filter_keep_every": 2,
+                "filter_min_interval_ms": 100
             }
         ]
     }
@@ -142,6 +182,18 @@ TEST(SerializeConfigTestFixture, SerializeBasicConfigTest)
         "level": "DEBUG",
         "type": "file",
         "file": "./aws-iot-device-client.log",
+        "socket": "",
+        "flush-interval-ms": 0,
+        "flush-threshold-bytes": 0,
+        "binary-format": false,
+        "rotation-max-size-bytes": 0,
+        "rotation-max-age-seconds": 0,
+        "rotation-generations": 5,
+        "rotation-compress": true,
+        "queue-capacity": 4096,
+        "queue-overflow-policy": "drop-newest",
+        "rate-limit-per-second": 0,
+        "rate-limit-burst": 100,
         "enable-sdk-logging": false,
         "sdk-log-level": "TRACE",
         "sdk-log-file": "/var/log/aws-iot-device-client/sdk.log"
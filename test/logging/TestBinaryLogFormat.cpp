@@ -0,0 +1,212 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/BinaryLogFormat.h"
+#include "../../source/logging/FileLogger.h"
+#include "gtest/gtest.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+namespace
+{
+    bool encode(string &payload, const char *format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        bool encoded = BinaryLogFormat::encodeMessage(format, args, payload);
+        va_end(args);
+        return encoded;
+    }
+
+    string formatEagerly(const char *format, ...)
+    {
+        char buffer[512];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        return buffer;
+    }
+
+    string decode(const string &payload)
+    {
+        string message;
+        EXPECT_TRUE(BinaryLogFormat::formatMessage(payload, message));
+        return message;
+    }
+} // namespace
+
+#define ASSERT_DEFERRED_MATCHES_EAGER(...)                                                                             \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        string payload;                                                                                                \
+        ASSERT_TRUE(encode(payload, __VA_ARGS__));                                                                     \
+        ASSERT_EQ(formatEagerly(__VA_ARGS__), decode(payload));                                                        \
+    } while (0)
+
+TEST(BinaryLogFormat, deferredFormattingMatchesPrintf)
+{
+    int value = 42;
+    ASSERT_DEFERRED_MATCHES_EAGER("no arguments");
+    ASSERT_DEFERRED_MATCHES_EAGER("%d %i %+05d", -7, 13, 21);
+    ASSERT_DEFERRED_MATCHES_EAGER("%ld %lld %lu %llu", -1L, -9000000000LL, 3000000000UL, 18000000000000000000ULL);
+    ASSERT_DEFERRED_MATCHES_EAGER("%zu %u %x %#X %o", sizeof(value), 4000000000U, 255U, 255U, 8U);
+    ASSERT_DEFERRED_MATCHES_EAGER("%hhu %hd", 300, 70000);
+    ASSERT_DEFERRED_MATCHES_EAGER("%c%c", 'o', 'k');
+    ASSERT_DEFERRED_MATCHES_EAGER("*** %s: %s ***", "TAG", "message with spaces");
+    ASSERT_DEFERRED_MATCHES_EAGER("%.3s|%-6s|%6s", "truncated", "left", "right");
+    ASSERT_DEFERRED_MATCHES_EAGER("%*d|%-*d|%.*f", 6, 1, 4, 2, 3, 3.14159);
+    ASSERT_DEFERRED_MATCHES_EAGER("%f %e %g %.2f", 1.5, 12345.678, 0.0001, 2.005);
+    ASSERT_DEFERRED_MATCHES_EAGER("%p", static_cast<void *>(&value));
+    ASSERT_DEFERRED_MATCHES_EAGER("100%% done");
+}
+
+TEST(BinaryLogFormat, argumentsAreCopiedIntoThePayload)
+{
+    string payload;
+    {
+        string temporary = "short-lived";
+        ASSERT_TRUE(encode(payload, "value: %s", temporary.c_str()));
+        temporary.assign(temporary.size(), 'x');
+    }
+    ASSERT_EQ("value: short-lived", decode(payload));
+}
+
+TEST(BinaryLogFormat, rejectsFormatsThatCanNotBeDeferred)
+{
+    string payload;
+    int written = 0;
+    ASSERT_FALSE(encode(payload, "%n", &written));
+    ASSERT_FALSE(encode(payload, "%Lf", 1.0L));
+    ASSERT_FALSE(encode(payload, "%ls", L"wide"));
+}
+
+TEST(BinaryLogFormat, rejectsMalformedPayload)
+{
+    string payload;
+    ASSERT_TRUE(encode(payload, "%d and %s", 1, "two"));
+
+    string message;
+    ASSERT_FALSE(BinaryLogFormat::formatMessage(payload.substr(0, payload.size() - 2), message));
+    ASSERT_FALSE(BinaryLogFormat::formatMessage(string("\x01", 1), message));
+}
+
+TEST(BinaryLogFormat, deferredMessageIsFormattedAsTextLogLine)
+{
+    string payload;
+    ASSERT_TRUE(encode(payload, "connected to %s:%d", "localhost", 8883));
+    LogMessage message(Logging::LogLevel::INFO, "TAG", std::chrono::system_clock::now(), std::move(payload), true);
+
+    LogUtil::TimestampFormatter timestampFormatter;
+    string line;
+    LogUtil::appendLogLine(message, line, timestampFormatter);
+    string suffix = "[INFO]  {TAG}: connected to localhost:8883\n";
+    ASSERT_GE(line.size(), suffix.size());
+    ASSERT_EQ(suffix, line.substr(line.size() - suffix.size()));
+}
+
+TEST(BinaryLogFormat, readerDecodesConcatenatedSessions)
+{
+    auto time = std::chrono::system_clock::now();
+    BinaryLogFormat::Writer writer;
+    string buffer;
+
+    writer.beginSession(buffer);
+    for (int i = 0; i < 3; i++)
+    {
+        string payload;
+        ASSERT_TRUE(encode(payload, "message %d of %s", i, "first"));
+        LogMessage message(Logging::LogLevel::DEBUG, "TAG", time, std::move(payload), true);
+        writer.appendMessage(message, buffer);
+    }
+    LogMessage eager(Logging::LogLevel::ERROR, "OTHER", time, "formatted eagerly");
+    writer.appendMessage(eager, buffer);
+
+    // A second session, as written when the log file is reopened, redefines its format strings and tags
+    writer.beginSession(buffer);
+    string payload;
+    ASSERT_TRUE(encode(payload, "message %d of %s", 0, "second"));
+    LogMessage second(Logging::LogLevel::WARN, "TAG", time, std::move(payload), true);
+    writer.appendMessage(second, buffer);
+
+    istringstream input(buffer);
+    BinaryLogFormat::Reader reader(input);
+    vector<string> expected = {
+        "message 0 of first", "message 1 of first", "message 2 of first", "formatted eagerly", "message 0 of second"};
+    vector<Logging::LogLevel> expectedLevels = {
+        Logging::LogLevel::DEBUG,
+        Logging::LogLevel::DEBUG,
+        Logging::LogLevel::DEBUG,
+        Logging::LogLevel::ERROR,
+        Logging::LogLevel::WARN};
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        unique_ptr<LogMessage> message = reader.next();
+        ASSERT_NE(nullptr, message);
+        ASSERT_EQ(expected[i], message->getMessage());
+        ASSERT_EQ(expectedLevels[i], message->getLevel());
+        ASSERT_EQ(i == 3 ? "OTHER" : "TAG", message->getTag());
+        ASSERT_EQ(
+            std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count(),
+            std::chrono::duration_cast<std::chrono::microseconds>(message->getTime().time_since_epoch()).count());
+    }
+    ASSERT_EQ(nullptr, reader.next());
+    ASSERT_TRUE(reader.getError().empty());
+}
+
+TEST(BinaryLogFormat, readerReportsTruncatedInput)
+{
+    BinaryLogFormat::Writer writer;
+    string buffer;
+    writer.beginSession(buffer);
+    string payload;
+    ASSERT_TRUE(encode(payload, "value %d", 1));
+    LogMessage message(Logging::LogLevel::INFO, "TAG", std::chrono::system_clock::now(), std::move(payload), true);
+    writer.appendMessage(message, buffer);
+
+    istringstream input(buffer.substr(0, buffer.size() - 3));
+    BinaryLogFormat::Reader reader(input);
+    ASSERT_EQ(nullptr, reader.next());
+    ASSERT_FALSE(reader.getError().empty());
+}
+
+TEST(BinaryLogFormat, fileLoggerWritesBinaryLog)
+{
+    constexpr char logFile[] = "/tmp/aws-iot-device-client-test-logging/binary.log";
+    remove(logFile);
+
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    config.logConfig.deviceClientLogFile = logFile;
+    config.logConfig.binaryFormat = true;
+
+    unique_ptr<Logger> fileLogger = unique_ptr<Logger>(new FileLogger);
+    ASSERT_TRUE(fileLogger->start(config));
+    constexpr int messageCount = 100;
+    for (int i = 0; i < messageCount; i++)
+    {
+        fileLogger->info("TAG", std::chrono::system_clock::now(), "message %d: %s", i, "payload");
+    }
+    fileLogger->shutdown();
+
+    ifstream input(logFile, ios::in | ios::binary);
+    BinaryLogFormat::Reader reader(input);
+    int expected = 0;
+    for (unique_ptr<LogMessage> message = reader.next(); message != nullptr; message = reader.next())
+    {
+        ASSERT_EQ("message " + to_string(expected) + ": payload", message->getMessage());
+        ASSERT_EQ("TAG", message->getTag());
+        expected++;
+    }
+    ASSERT_TRUE(reader.getError().empty()) << reader.getError();
+    ASSERT_EQ(messageCount, expected);
+    remove(logFile);
+}
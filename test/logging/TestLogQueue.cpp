@@ -4,7 +4,10 @@
 #include "../../source/logging/LogQueue.h"
 #include "gtest/gtest.h"
 
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
@@ -109,3 +112,212 @@ TEST_F(LogQueueTest, readsAllMessagesWithNullAtBeginning)
 
     ASSERT_EQ(5, counter);
 }
+
+TEST(LogQueueConcurrencyTest, capacityRoundsUpToPowerOfTwo)
+{
+    LogQueue queue(100);
+    ASSERT_EQ(128, queue.capacity());
+}
+
+TEST(LogQueueConcurrencyTest, accountsForAllMessagesFromManyProducers)
+{
+    // Use a small queue so that producers regularly find it full and have messages dropped instead of waiting.
+    constexpr int numProducers = 8;
+    constexpr int messagesPerProducer = 5000;
+    LogQueue queue(64);
+
+    vector<thread> producers;
+    for (int p = 0; p < numProducers; p++)
+    {
+        producers.emplace_back(
+            [&queue, p]()
+            {
+                for (int i = 0; i < messagesPerProducer; i++)
+                {
+                    queue.addLog(unique_ptr<LogMessage>(new LogMessage(
+                        LogLevel::DEBUG, to_string(p), std::chrono::system_clock::now(), to_string(i))));
+                }
+            });
+    }
+
+    // Messages from a single producer must come out in the order that producer added them, with gaps for the
+    // messages that were dropped.
+    vector<int> lastReceived(numProducers, -1);
+    uint64_t received = 0;
+    auto consume = [&]()
+    {
+        unique_ptr<LogMessage> message = queue.getNextLog();
+        if (nullptr == message)
+        {
+            return;
+        }
+        int producer = stoi(message->getTag());
+        int value = stoi(message->getMessage());
+        ASSERT_LT(lastReceived[producer], value);
+        lastReceived[producer] = value;
+        received++;
+    };
+    while (received + queue.getDroppedCount() < numProducers * messagesPerProducer)
+    {
+        consume();
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+
+    ASSERT_FALSE(queue.hasNextLog());
+    ASSERT_EQ(numProducers * messagesPerProducer, received + queue.getDroppedCount());
+    ASSERT_EQ(queue.getDroppedCount(), queue.getDroppedCount(LogLevel::DEBUG));
+}
+
+TEST(LogQueueConcurrencyTest, wakesWaitingConsumer)
+{
+    // A consumer blocked on an empty queue should pick up a new message well before the empty wait time expires.
+    LogQueue queue;
+    unique_ptr<LogMessage> message;
+    std::chrono::steady_clock::time_point receivedAt;
+
+    thread consumer(
+        [&queue, &message, &receivedAt]()
+        {
+            message = queue.getNextLog();
+            receivedAt = std::chrono::steady_clock::now();
+        });
+
+    this_thread::sleep_for(chrono::milliseconds(50));
+    auto sentAt = std::chrono::steady_clock::now();
+    queue.addLog(
+        unique_ptr<LogMessage>(new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), "Message")));
+    consumer.join();
+
+    ASSERT_NE(nullptr, message);
+    ASSERT_STREQ("Message", message->getMessage().c_str());
+    ASSERT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(receivedAt - sentAt).count(), 100);
+}
+
+TEST(LogQueueConcurrencyTest, timedWaitReturnsWithoutMessage)
+{
+    // A consumer waiting with a timeout gets nullptr once the timeout expires, and a message queued before then.
+    LogQueue queue;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(nullptr, queue.getNextLog(chrono::milliseconds(50)));
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_GE(waited.count(), 40);
+    ASSERT_LT(waited.count(), 200); // Shorter than the empty wait time.
+
+    queue.addLog(
+        unique_ptr<LogMessage>(new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), "Message")));
+    unique_ptr<LogMessage> message = queue.getNextLog(chrono::milliseconds(50));
+    ASSERT_NE(nullptr, message);
+    ASSERT_STREQ("Message", message->getMessage().c_str());
+}
+
+TEST(LogQueueConcurrencyTest, dropsMessagesWhenFullAfterShutdown)
+{
+    // Once shutdown, there may be no consumer left so a full queue must not block the producer.
+    LogQueue queue(2);
+    for (int i = 0; i < 2; i++)
+    {
+        queue.addLog(unique_ptr<LogMessage>(
+            new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), "Message")));
+    }
+    queue.shutdown();
+    queue.addLog(
+        unique_ptr<LogMessage>(new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), "Dropped")));
+
+    int counter = 0;
+    while (queue.hasNextLog())
+    {
+        if (nullptr != queue.getNextLog())
+        {
+            counter++;
+        }
+    }
+    ASSERT_EQ(2, counter);
+}
+
+namespace
+{
+    void addMessages(LogQueue &queue, LogLevel level, int first, int count)
+    {
+        for (int i = first; i < first + count; i++)
+        {
+            queue.addLog(
+                unique_ptr<LogMessage>(new LogMessage(level, "TAG", std::chrono::system_clock::now(), to_string(i))));
+        }
+    }
+
+    vector<string> drainMessages(LogQueue &queue)
+    {
+        vector<string> messages;
+        while (queue.hasNextLog())
+        {
+            unique_ptr<LogMessage> message = queue.getNextLog();
+            if (nullptr != message)
+            {
+                messages.push_back(message->getMessage());
+            }
+        }
+        return messages;
+    }
+} // namespace
+
+TEST(LogQueueOverflowTest, dropsNewestMessagesWhenFull)
+{
+    LogQueue queue(4, LogQueue::OverflowPolicy::DROP_NEWEST);
+    addMessages(queue, LogLevel::INFO, 0, 6);
+
+    vector<string> expected = {"0", "1", "2", "3"};
+    ASSERT_EQ(expected, drainMessages(queue));
+    ASSERT_EQ(2u, queue.getDroppedCount());
+    ASSERT_EQ(2u, queue.getDroppedCount(LogLevel::INFO));
+    ASSERT_EQ(0u, queue.getDroppedCount(LogLevel::ERROR));
+}
+
+TEST(LogQueueOverflowTest, dropsOldestMessagesWhenFull)
+{
+    LogQueue queue(4, LogQueue::OverflowPolicy::DROP_OLDEST);
+    addMessages(queue, LogLevel::DEBUG, 0, 4);
+    addMessages(queue, LogLevel::ERROR, 4, 2);
+
+    vector<string> expected = {"2", "3", "4", "5"};
+    ASSERT_EQ(expected, drainMessages(queue));
+    // The evicted messages are counted at their own level, not at the level of the message that replaced them
+    ASSERT_EQ(2u, queue.getDroppedCount(LogLevel::DEBUG));
+    ASSERT_EQ(0u, queue.getDroppedCount(LogLevel::ERROR));
+}
+
+TEST(LogQueueOverflowTest, keepsRoomForWarningsAndErrors)
+{
+    LogQueue queue(8, LogQueue::OverflowPolicy::DROP_BELOW_LEVEL);
+    // INFO and DEBUG messages are only accepted until the queue is three quarters full
+    addMessages(queue, LogLevel::DEBUG, 0, 4);
+    addMessages(queue, LogLevel::INFO, 4, 4);
+    addMessages(queue, LogLevel::WARN, 8, 1);
+    addMessages(queue, LogLevel::ERROR, 9, 2);
+    addMessages(queue, LogLevel::ERROR, 11, 1);
+
+    vector<string> expected = {"0", "1", "2", "3", "4", "5", "8", "9"};
+    ASSERT_EQ(expected, drainMessages(queue));
+    ASSERT_EQ(0u, queue.getDroppedCount(LogLevel::DEBUG));
+    ASSERT_EQ(2u, queue.getDroppedCount(LogLevel::INFO));
+    ASSERT_EQ(0u, queue.getDroppedCount(LogLevel::WARN));
+    ASSERT_EQ(2u, queue.getDroppedCount(LogLevel::ERROR));
+    ASSERT_EQ(4u, queue.getDroppedCount());
+}
+
+TEST(LogQueueOverflowTest, reportsEachDropOnce)
+{
+    LogQueue queue(2);
+    addMessages(queue, LogLevel::WARN, 0, 5);
+
+    ASSERT_EQ(3u, queue.takeUnreportedDropCount());
+    ASSERT_EQ(0u, queue.takeUnreportedDropCount());
+    drainMessages(queue);
+    addMessages(queue, LogLevel::WARN, 5, 3);
+    ASSERT_EQ(1u, queue.takeUnreportedDropCount());
+    // The totals are never reset
+    ASSERT_EQ(4u, queue.getDroppedCount());
+}
@@ -0,0 +1,226 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/FileLogger.h"
+#include "../../source/logging/LogRateLimiter.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+namespace
+{
+    int acquireMany(LogRateLimiter &limiter, const char *tag, int count, chrono::steady_clock::time_point now)
+    {
+        int acquired = 0;
+        LogRateLimiter::Suppression closed;
+        for (int i = 0; i < count; i++)
+        {
+            if (limiter.tryAcquire(tag, Logging::LogLevel::INFO, now, closed))
+            {
+                acquired++;
+            }
+        }
+        return acquired;
+    }
+} // namespace
+
+TEST(LogRateLimiter, disabledByDefault)
+{
+    LogRateLimiter limiter;
+    ASSERT_FALSE(limiter.isEnabled());
+
+    limiter.configure(0, 10);
+    ASSERT_FALSE(limiter.isEnabled());
+    limiter.configure(10, 10);
+    ASSERT_TRUE(limiter.isEnabled());
+}
+
+TEST(LogRateLimiter, allowsBurstThenSteadyRate)
+{
+    LogRateLimiter limiter;
+    limiter.configure(10, 5);
+    auto start = chrono::steady_clock::now();
+
+    ASSERT_EQ(5, acquireMany(limiter, "TAG", 100, start));
+    ASSERT_EQ(95u, limiter.getSuppressedCount());
+    // 10 messages per second earns a token every 100 ms
+    ASSERT_EQ(1, acquireMany(limiter, "TAG", 100, start + chrono::milliseconds(100)));
+    ASSERT_EQ(3, acquireMany(limiter, "TAG", 100, start + chrono::milliseconds(400)));
+    // The bucket never holds more than the burst
+    ASSERT_EQ(5, acquireMany(limiter, "TAG", 100, start + chrono::hours(1)));
+}
+
+TEST(LogRateLimiter, limitsEachTagIndependently)
+{
+    LogRateLimiter limiter;
+    limiter.configure(1, 2);
+    auto now = chrono::steady_clock::now();
+
+    ASSERT_EQ(2, acquireMany(limiter, "NOISY", 50, now));
+    ASSERT_EQ(2, acquireMany(limiter, "QUIET", 2, now));
+    ASSERT_EQ(48u, limiter.getSuppressedCount());
+}
+
+TEST(LogRateLimiter, reportsSuppressedMessagesWhenWindowCloses)
+{
+    LogRateLimiter limiter;
+    limiter.configure(1, 1);
+    auto start = chrono::steady_clock::now();
+    LogRateLimiter::Suppression closed;
+
+    ASSERT_TRUE(limiter.tryAcquire("TAG", Logging::LogLevel::DEBUG, start, closed));
+    ASSERT_FALSE(limiter.tryAcquire("TAG", Logging::LogLevel::DEBUG, start, closed));
+    ASSERT_FALSE(limiter.tryAcquire("TAG", Logging::LogLevel::WARN, start + chrono::milliseconds(500), closed));
+    ASSERT_FALSE(limiter.tryAcquire("TAG", Logging::LogLevel::INFO, start + chrono::milliseconds(600), closed));
+    ASSERT_EQ(0u, closed.count);
+
+    ASSERT_TRUE(limiter.tryAcquire("TAG", Logging::LogLevel::DEBUG, start + chrono::milliseconds(1000), closed));
+    ASSERT_EQ("TAG", closed.tag);
+    ASSERT_EQ(3u, closed.count);
+    ASSERT_EQ(Logging::LogLevel::WARN, closed.level);
+    ASSERT_EQ(1000, closed.duration.count());
+
+    // The window was reported, the next allowed message has nothing to report
+    ASSERT_TRUE(limiter.tryAcquire("TAG", Logging::LogLevel::DEBUG, start + chrono::milliseconds(2000), closed));
+    ASSERT_EQ(0u, closed.count);
+}
+
+TEST(LogRateLimiter, collectsWindowsOfTagsThatWentQuiet)
+{
+    LogRateLimiter limiter;
+    limiter.configure(1, 1);
+    auto start = chrono::steady_clock::now();
+
+    acquireMany(limiter, "FIRST", 3, start);
+    acquireMany(limiter, "SECOND", 5, start + chrono::milliseconds(500));
+
+    vector<LogRateLimiter::Suppression> suppressions;
+    limiter.collectSuppressions(start + chrono::milliseconds(1200), false, suppressions);
+    ASSERT_EQ(1u, suppressions.size());
+    ASSERT_EQ("FIRST", suppressions[0].tag);
+    ASSERT_EQ(2u, suppressions[0].count);
+
+    suppressions.clear();
+    limiter.collectSuppressions(start + chrono::milliseconds(1300), true, suppressions);
+    ASSERT_EQ(1u, suppressions.size());
+    ASSERT_EQ("SECOND", suppressions[0].tag);
+    ASSERT_EQ(4u, suppressions[0].count);
+
+    suppressions.clear();
+    limiter.collectSuppressions(start + chrono::hours(1), true, suppressions);
+    ASSERT_TRUE(suppressions.empty());
+}
+
+TEST(LogRateLimiter, boundsTheNumberOfTrackedTags)
+{
+    LogRateLimiter limiter;
+    limiter.configure(1, 1);
+    auto now = chrono::steady_clock::now();
+
+    // Every tag stays active, so once the shards are full new tags have to share the overflow buckets
+    constexpr int tagCount = 5000;
+    int acquired = 0;
+    for (int i = 0; i < tagCount; i++)
+    {
+        acquired += acquireMany(limiter, ("PID-" + to_string(i)).c_str(), 2, now);
+    }
+    ASSERT_LT(acquired, tagCount);
+    ASSERT_EQ(2u * tagCount, acquired + limiter.getSuppressedCount());
+
+    vector<LogRateLimiter::Suppression> suppressions;
+    limiter.collectSuppressions(now, true, suppressions);
+    bool reportedOverflow = false;
+    for (const auto &suppression : suppressions)
+    {
+        reportedOverflow = reportedOverflow || suppression.tag == LogRateLimiter::OVERFLOW_TAG;
+    }
+    ASSERT_TRUE(reportedOverflow);
+}
+
+TEST(LogRateLimiter, fileLoggerWritesSuppressionSummary)
+{
+    constexpr char logFile[] = "/tmp/aws-iot-device-client-test-logging/rate-limited.log";
+    remove(logFile);
+
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    config.logConfig.deviceClientLogFile = logFile;
+    config.logConfig.rateLimitPerSecond = 1;
+    config.logConfig.rateLimitBurst = 3;
+
+    unique_ptr<Logger> fileLogger = unique_ptr<Logger>(new FileLogger);
+    ASSERT_TRUE(fileLogger->start(config));
+    for (int i = 0; i < 10; i++)
+    {
+        fileLogger->info("NOISY", std::chrono::system_clock::now(), "Nothing to publish %d", i);
+    }
+    fileLogger->error("OTHER", std::chrono::system_clock::now(), "Not limited");
+    fileLogger->shutdown();
+
+    ifstream input(logFile);
+    vector<string> lines;
+    string line;
+    while (getline(input, line))
+    {
+        lines.push_back(line.substr(line.find(' ') + 1));
+    }
+    vector<string> expected = {
+        "[INFO]  {NOISY}: Nothing to publish 0",
+        "[INFO]  {NOISY}: Nothing to publish 1",
+        "[INFO]  {NOISY}: Nothing to publish 2",
+        "[ERROR] {OTHER}: Not limited"};
+    ASSERT_EQ(5u, lines.size());
+    ASSERT_EQ(expected, vector<string>(lines.begin(), lines.begin() + 4));
+    string summaryPrefix = "[INFO]  {NOISY}: 7 log messages were suppressed by the log rate limit";
+    ASSERT_EQ(summaryPrefix, lines[4].substr(0, summaryPrefix.size()));
+    remove(logFile);
+}
+
+TEST(LogRateLimiter, fileLoggerDoesNotLimitErrors)
+{
+    constexpr char logFile[] = "/tmp/aws-iot-device-client-test-logging/rate-limited-errors.log";
+    remove(logFile);
+
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    config.logConfig.deviceClientLogFile = logFile;
+    config.logConfig.rateLimitPerSecond = 1;
+    config.logConfig.rateLimitBurst = 3;
+
+    unique_ptr<Logger> fileLogger = unique_ptr<Logger>(new FileLogger);
+    ASSERT_TRUE(fileLogger->start(config));
+    for (int i = 0; i < 10; i++)
+    {
+        fileLogger->debug("NOISY", std::chrono::system_clock::now(), "Read %d bytes", i);
+    }
+    fileLogger->error("NOISY", std::chrono::system_clock::now(), "Failed to publish");
+    fileLogger->warn("NOISY", std::chrono::system_clock::now(), "Reconnecting");
+    fileLogger->shutdown();
+
+    ifstream input(logFile);
+    vector<string> lines;
+    string line;
+    while (getline(input, line))
+    {
+        lines.push_back(line.substr(line.find(' ') + 1));
+    }
+    vector<string> expected = {
+        "[DEBUG] {NOISY}: Read 0 bytes",
+        "[DEBUG] {NOISY}: Read 1 bytes",
+        "[DEBUG] {NOISY}: Read 2 bytes",
+        "[ERROR] {NOISY}: Failed to publish",
+        "[WARN]  {NOISY}: Reconnecting"};
+    ASSERT_EQ(6u, lines.size());
+    ASSERT_EQ(expected, vector<string>(lines.begin(), lines.begin() + 5));
+    string summaryPrefix = "[DEBUG] {NOISY}: 7 log messages were suppressed by the log rate limit";
+    ASSERT_EQ(summaryPrefix, lines[5].substr(0, summaryPrefix.size()));
+    remove(logFile);
+}
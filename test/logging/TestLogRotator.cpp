@@ -0,0 +1,232 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/FileLogger.h"
+#include "../../source/logging/LogRotator.h"
+#include "../../source/util/FileUtils.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+namespace
+{
+    constexpr char LOG_DIR[] = "/tmp/aws-iot-device-client-test-logging/rotation/";
+    constexpr char LOG_FILE[] = "/tmp/aws-iot-device-client-test-logging/rotation/rotated.log";
+
+    class LogRotatorFixture : public ::testing::Test
+    {
+      public:
+        void SetUp() override
+        {
+            FileUtils::Mkdirs(LOG_DIR);
+            removeLogFiles();
+        }
+
+        void TearDown() override { removeLogFiles(); }
+
+        static void removeLogFiles()
+        {
+            DIR *dir = opendir(LOG_DIR);
+            if (dir == nullptr)
+            {
+                return;
+            }
+            for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+            {
+                string name = entry->d_name;
+                if (name != "." && name != "..")
+                {
+                    remove((string(LOG_DIR) + name).c_str());
+                }
+            }
+            closedir(dir);
+        }
+
+        static void createFile(const string &path, const string &content)
+        {
+            ofstream output(path);
+            output << content;
+        }
+
+        static string readFile(const string &path)
+        {
+            string content;
+            gzFile input = gzopen(path.c_str(), "rb");
+            if (input == nullptr)
+            {
+                return content;
+            }
+            char buffer[4096];
+            int bytesRead;
+            while ((bytesRead = gzread(input, buffer, sizeof(buffer))) > 0)
+            {
+                content.append(buffer, static_cast<size_t>(bytesRead));
+            }
+            gzclose(input);
+            return content;
+        }
+
+        template <typename Condition> static bool waitFor(Condition condition)
+        {
+            for (int i = 0; i < 500 && !condition(); i++)
+            {
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            return condition();
+        }
+    };
+} // namespace
+
+TEST_F(LogRotatorFixture, ListsRotatedFilesNewestFirst)
+{
+    createFile(string(LOG_FILE), "current");
+    createFile(string(LOG_FILE) + ".20111008T070709178Z.gz", "");
+    createFile(string(LOG_FILE) + ".20111008T070709178Z-1", "");
+    createFile(string(LOG_FILE) + ".20111009T000000000Z", "");
+    createFile(string(LOG_FILE) + ".20111008T070709178Z-2.gz", "");
+    // Files that only share a prefix with the log file are not generations
+    createFile(string(LOG_FILE) + ".bak", "");
+    createFile(string(LOG_FILE) + ".20111008T070709178Z.gz.tmp", "");
+    createFile(string(LOG_DIR) + "other.log.20111008T070709178Z", "");
+
+    vector<string> expected = {
+        string(LOG_FILE) + ".20111009T000000000Z",
+        string(LOG_FILE) + ".20111008T070709178Z-2.gz",
+        string(LOG_FILE) + ".20111008T070709178Z-1",
+        string(LOG_FILE) + ".20111008T070709178Z.gz"};
+    ASSERT_EQ(expected, LogRotator::listRotatedFiles(LOG_FILE));
+}
+
+TEST_F(LogRotatorFixture, RotatesBySizeAndAge)
+{
+    PlainConfig::LogConfig config;
+    config.rotationMaxSizeBytes = 1024;
+    LogRotator rotator;
+    rotator.start(LOG_FILE, config);
+    auto now = chrono::steady_clock::now();
+    ASSERT_FALSE(rotator.shouldRotate(1023, now - chrono::hours(24)));
+    ASSERT_TRUE(rotator.shouldRotate(1024, now));
+    rotator.stop();
+
+    config.rotationMaxSizeBytes = 0;
+    config.rotationMaxAgeSeconds = 60;
+    rotator.start(LOG_FILE, config);
+    ASSERT_FALSE(rotator.shouldRotate(1024 * 1024, now));
+    ASSERT_TRUE(rotator.shouldRotate(0, now - chrono::seconds(61)));
+    rotator.stop();
+
+    config.rotationMaxAgeSeconds = 0;
+    rotator.start(LOG_FILE, config);
+    ASSERT_FALSE(rotator.isEnabled());
+}
+
+TEST_F(LogRotatorFixture, NextRotatedFileDoesNotReuseExistingGeneration)
+{
+    PlainConfig::LogConfig config;
+    config.rotationMaxSizeBytes = 1024;
+    config.rotationCompress = false;
+    LogRotator rotator;
+    rotator.start(LOG_FILE, config);
+
+    auto time = chrono::system_clock::from_time_t(1318057629) + chrono::milliseconds(178);
+    string first = rotator.nextRotatedFile(time);
+    ASSERT_EQ(string(LOG_FILE) + ".20111008T070709178Z", first);
+    createFile(first + LogRotator::COMPRESSED_EXTENSION, "");
+    ASSERT_EQ(first + "-1", rotator.nextRotatedFile(time));
+}
+
+TEST_F(LogRotatorFixture, CompressesAndPrunesLeftoverGenerations)
+{
+    createFile(string(LOG_FILE) + ".20111008T000000000Z", "oldest\n");
+    createFile(string(LOG_FILE) + ".20111009T000000000Z", "older\n");
+    createFile(string(LOG_FILE) + ".20111010T000000000Z", "newest\n");
+    // An incomplete compression from a previous run
+    createFile(string(LOG_FILE) + ".20111010T000000000Z.gz.tmp", "partial");
+
+    PlainConfig::LogConfig config;
+    config.rotationMaxSizeBytes = 1024;
+    config.rotationGenerations = 2;
+    LogRotator rotator;
+    rotator.start(LOG_FILE, config);
+
+    vector<string> expected = {
+        string(LOG_FILE) + ".20111010T000000000Z.gz", string(LOG_FILE) + ".20111009T000000000Z.gz"};
+    ASSERT_TRUE(waitFor([&expected]() { return LogRotator::listRotatedFiles(LOG_FILE) == expected; }));
+    rotator.stop();
+
+    ASSERT_EQ("newest\n", readFile(expected[0]));
+    ASSERT_EQ("older\n", readFile(expected[1]));
+    ASSERT_FALSE(FileUtils::FileExists(string(LOG_FILE) + ".20111010T000000000Z.gz.tmp"));
+}
+
+TEST_F(LogRotatorFixture, FileLoggerRotatesLogFile)
+{
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    config.logConfig.deviceClientLogFile = LOG_FILE;
+    config.logConfig.rotationMaxSizeBytes = 2048;
+    config.logConfig.rotationGenerations = 3;
+
+    unique_ptr<Logger> fileLogger = unique_ptr<Logger>(new FileLogger);
+    ASSERT_TRUE(fileLogger->start(config));
+    constexpr int messageCount = 500;
+    for (int i = 0; i < messageCount; i++)
+    {
+        fileLogger->info("TAG", std::chrono::system_clock::now(), to_string(i).c_str());
+        if (i % 50 == 0)
+        {
+            // Give the logger thread a chance to write several batches, and rotate in between
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+    }
+
+    auto allCompressed = []() {
+        vector<string> rotated = LogRotator::listRotatedFiles(LOG_FILE);
+        for (const auto &path : rotated)
+        {
+            if (path.size() < 3 || path.compare(path.size() - 3, 3, ".gz") != 0)
+            {
+                return false;
+            }
+        }
+        return rotated.size() == 3;
+    };
+    ASSERT_TRUE(waitFor(allCompressed));
+    fileLogger->shutdown();
+
+    // The kept generations and the current log file hold the most recent messages in order
+    string content;
+    vector<string> rotated = LogRotator::listRotatedFiles(LOG_FILE);
+    for (auto generation = rotated.rbegin(); generation != rotated.rend(); generation++)
+    {
+        content += readFile(*generation);
+    }
+    content += readFile(LOG_FILE);
+
+    istringstream lines(content);
+    string line;
+    int expected = -1;
+    while (getline(lines, line))
+    {
+        int value = stoi(line.substr(line.rfind(' ') + 1));
+        if (expected >= 0)
+        {
+            ASSERT_EQ(expected, value);
+        }
+        expected = value + 1;
+    }
+    ASSERT_EQ(messageCount, expected);
+}
@@ -2,10 +2,17 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "../../source/logging/FileLogger.h"
+#include "../../source/logging/LoggerFactory.h"
 #include "../../source/logging/StdOutLogger.h"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
 using namespace std;
+using namespace Aws::Iot::DeviceClient;
 using namespace Aws::Iot::DeviceClient::Logging;
 
 TEST(Logging, swapsLogQueue)
@@ -38,3 +45,95 @@ TEST(Logging, queueNotNullAfterTake)
     ASSERT_TRUE(NULL != stdOutLogger->takeLogQueue());
     ASSERT_FALSE(stdOutLogger->takeLogQueue()->hasNextLog());
 }
+
+TEST(Logging, fileLoggerWritesBatchedMessagesInOrder)
+{
+    constexpr char logFile[] = "/tmp/aws-iot-device-client-test-logging/batched.log";
+    remove(logFile);
+
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    config.logConfig.deviceClientLogFile = logFile;
+    config.logConfig.flushThresholdBytes = 1024;
+
+    unique_ptr<Logger> fileLogger = unique_ptr<Logger>(new FileLogger);
+    ASSERT_TRUE(fileLogger->start(config));
+
+    constexpr int messageCount = 1000;
+    for (int i = 0; i < messageCount; i++)
+    {
+        fileLogger->info("TAG", std::chrono::system_clock::now(), to_string(i).c_str());
+    }
+    fileLogger->shutdown();
+
+    ifstream input(logFile);
+    string line;
+    int expected = 0;
+    while (getline(input, line))
+    {
+        string suffix = "{TAG}: " + to_string(expected);
+        ASSERT_GE(line.size(), suffix.size());
+        ASSERT_EQ(suffix, line.substr(line.size() - suffix.size()));
+        expected++;
+    }
+    ASSERT_EQ(messageCount, expected);
+    remove(logFile);
+}
+
+TEST(Logging, timestampFormatterMatchesGenerateTimestamp)
+{
+    LogUtil::TimestampFormatter formatter;
+    auto start = std::chrono::system_clock::now();
+    // Cover entries within the same second as well as entries crossing seconds, minutes and days
+    for (int i = 0; i < 5000; i++)
+    {
+        auto t = start + std::chrono::milliseconds(i * 7) + std::chrono::hours(i % 3 == 0 ? i : 0);
+        char expected[LogUtil::TimestampFormatter::BUFFER_SIZE];
+        LogUtil::generateTimestamp(t, sizeof(expected), expected);
+
+        char actual[LogUtil::TimestampFormatter::BUFFER_SIZE];
+        size_t length = formatter.format(t, actual);
+        ASSERT_STREQ(expected, actual);
+        ASSERT_EQ(strlen(expected), length);
+    }
+}
+
+TEST(Logging, timestampFormatterFormatsFixedTime)
+{
+    LogUtil::TimestampFormatter formatter;
+    auto t = std::chrono::system_clock::from_time_t(1318057629) + std::chrono::milliseconds(8);
+    char actual[LogUtil::TimestampFormatter::BUFFER_SIZE];
+
+    ASSERT_EQ(24u, formatter.format(t, actual));
+    ASSERT_STREQ("2011-10-08T07:07:09.008Z", actual);
+    formatter.format(t + std::chrono::milliseconds(170), actual);
+    ASSERT_STREQ("2011-10-08T07:07:09.178Z", actual);
+    formatter.format(t + std::chrono::milliseconds(992), actual);
+    ASSERT_STREQ("2011-10-08T07:07:10.000Z", actual);
+}
+
+TEST(Logging, disabledLogStatementDoesNotEvaluateArguments)
+{
+    constexpr char TAG[] = "TestLogging.cpp";
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::INFO;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_STDOUT;
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+
+    int evaluations = 0;
+    auto argument = [&evaluations]() {
+        evaluations++;
+        return "value";
+    };
+
+    ASSERT_FALSE(LoggerFactory::isLogLevelEnabled(Logging::LogLevel::DEBUG));
+    LOGM_DEBUG(TAG, "Debug %s", argument());
+    ASSERT_EQ(0, evaluations);
+
+    ASSERT_TRUE(LoggerFactory::isLogLevelEnabled(Logging::LogLevel::INFO));
+    LOGM_INFO(TAG, "Info %s", argument());
+    ASSERT_EQ(1, evaluations);
+
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+}
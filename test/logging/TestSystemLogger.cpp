@@ -0,0 +1,193 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/SystemLogger.h"
+#include "../../source/util/FileUtils.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+namespace
+{
+    constexpr char LOG_DIR[] = "/tmp/aws-iot-device-client-test-logging/";
+    constexpr char SOCKET_PATH[] = "/tmp/aws-iot-device-client-test-logging/system-log.sock";
+
+    /**
+     * \brief Stands in for journald or syslogd by receiving the datagrams sent to a local Unix socket
+     */
+    class SystemLoggerFixture : public ::testing::Test
+    {
+      public:
+        int serverFd = -1;
+
+        void SetUp() override
+        {
+            FileUtils::Mkdirs(LOG_DIR);
+            unlink(SOCKET_PATH);
+            serverFd = socket(AF_UNIX, SOCK_DGRAM, 0);
+            ASSERT_GE(serverFd, 0);
+
+            struct sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            strncpy(address.sun_path, SOCKET_PATH, sizeof(address.sun_path) - 1);
+            ASSERT_EQ(0, ::bind(serverFd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+
+            struct timeval timeout = {2, 0};
+            setsockopt(serverFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+
+        void TearDown() override
+        {
+            close(serverFd);
+            unlink(SOCKET_PATH);
+        }
+
+        vector<string> receive(size_t count) const
+        {
+            vector<string> datagrams;
+            vector<char> buffer(64 * 1024);
+            while (datagrams.size() < count)
+            {
+                ssize_t received = recv(serverFd, buffer.data(), buffer.size(), 0);
+                if (received < 0)
+                {
+                    break;
+                }
+                datagrams.emplace_back(buffer.data(), static_cast<size_t>(received));
+            }
+            return datagrams;
+        }
+
+        static PlainConfig createConfig(const char *type)
+        {
+            PlainConfig config;
+            config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+            config.logConfig.deviceClientLogtype = type;
+            config.logConfig.deviceClientLogSocket = SOCKET_PATH;
+            return config;
+        }
+
+        /**
+         * \brief Decodes a record of the journald native protocol into its fields
+         */
+        static map<string, string> parseJournalRecord(const string &record)
+        {
+            map<string, string> fields;
+            size_t pos = 0;
+            while (pos < record.size())
+            {
+                size_t end = record.find_first_of("=\n", pos);
+                string name = record.substr(pos, end - pos);
+                if (record[end] == '=')
+                {
+                    size_t newline = record.find('\n', end);
+                    fields[name] = record.substr(end + 1, newline - end - 1);
+                    pos = newline + 1;
+                }
+                else
+                {
+                    uint64_t length = 0;
+                    for (int i = 0; i < 8; i++)
+                    {
+                        length |= static_cast<uint64_t>(static_cast<unsigned char>(record[end + 1 + i])) << (8 * i);
+                    }
+                    fields[name] = record.substr(end + 9, static_cast<size_t>(length));
+                    pos = end + 9 + static_cast<size_t>(length) + 1;
+                }
+            }
+            return fields;
+        }
+    };
+} // namespace
+
+TEST_F(SystemLoggerFixture, SendsJournalFields)
+{
+    unique_ptr<Logger> logger = unique_ptr<Logger>(new SystemLogger);
+    ASSERT_TRUE(logger->start(createConfig(PlainConfig::LogConfig::LOG_TYPE_JOURNALD)));
+    logger->info("Sensor.cpp", std::chrono::system_clock::now(), "Nothing to publish");
+    logger->error("JobEngine.cpp", std::chrono::system_clock::now(), "first line\nsecond line");
+    logger->shutdown();
+
+    vector<string> records = receive(2);
+    ASSERT_EQ(2u, records.size());
+
+    map<string, string> info = parseJournalRecord(records[0]);
+    ASSERT_EQ("6", info["PRIORITY"]);
+    ASSERT_EQ("Sensor.cpp", info["DEVICE_CLIENT_TAG"]);
+    ASSERT_EQ("Nothing to publish", info["MESSAGE"]);
+    ASSERT_EQ(SystemLogger::IDENTIFIER, info["SYSLOG_IDENTIFIER"]);
+    ASSERT_EQ(to_string(getpid()), info["SYSLOG_PID"]);
+    ASSERT_FALSE(info["DEVICE_CLIENT_TIMESTAMP"].empty());
+
+    // A message spanning several lines is sent in the binary form of the field
+    map<string, string> error = parseJournalRecord(records[1]);
+    ASSERT_EQ("3", error["PRIORITY"]);
+    ASSERT_EQ("JobEngine.cpp", error["DEVICE_CLIENT_TAG"]);
+    ASSERT_EQ("first line\nsecond line", error["MESSAGE"]);
+}
+
+TEST_F(SystemLoggerFixture, SendsSyslogMessages)
+{
+    unique_ptr<Logger> logger = unique_ptr<Logger>(new SystemLogger);
+    ASSERT_TRUE(logger->start(createConfig(PlainConfig::LogConfig::LOG_TYPE_SYSLOG)));
+    logger->warn("Sensor.cpp", std::chrono::system_clock::now(), "Read buffer full");
+    logger->debug("AWS IoT Device Client Logger", std::chrono::system_clock::now(), "Spaces in the tag");
+    logger->shutdown();
+
+    vector<string> records = receive(2);
+    ASSERT_EQ(2u, records.size());
+
+    // Facility daemon (3) and severity warning (4) give a priority of 28
+    string warnSuffix = " aws-iot-device-client " + to_string(getpid()) + " Sensor.cpp - Read buffer full";
+    ASSERT_EQ("<28>1 ", records[0].substr(0, 6));
+    ASSERT_EQ(warnSuffix, records[0].substr(records[0].size() - warnSuffix.size()));
+
+    string debugSuffix =
+        " aws-iot-device-client " + to_string(getpid()) + " AWS_IoT_Device_Client_Logger - Spaces in the tag";
+    ASSERT_EQ("<31>1 ", records[1].substr(0, 6));
+    ASSERT_EQ(debugSuffix, records[1].substr(records[1].size() - debugSuffix.size()));
+}
+
+TEST_F(SystemLoggerFixture, SendsEveryMessageInOrder)
+{
+    unique_ptr<Logger> logger = unique_ptr<Logger>(new SystemLogger);
+    ASSERT_TRUE(logger->start(createConfig(PlainConfig::LogConfig::LOG_TYPE_JOURNALD)));
+    // More messages than fit in a single batch
+    constexpr int messageCount = 200;
+    for (int i = 0; i < messageCount; i++)
+    {
+        logger->info("TAG", std::chrono::system_clock::now(), to_string(i).c_str());
+    }
+    logger->shutdown();
+
+    vector<string> records = receive(messageCount);
+    ASSERT_EQ(static_cast<size_t>(messageCount), records.size());
+    for (int i = 0; i < messageCount; i++)
+    {
+        ASSERT_EQ(to_string(i), parseJournalRecord(records[i])["MESSAGE"]);
+    }
+}
+
+TEST_F(SystemLoggerFixture, FailsToStartWithoutSocket)
+{
+    PlainConfig config = createConfig(PlainConfig::LogConfig::LOG_TYPE_JOURNALD);
+    config.logConfig.deviceClientLogSocket = string(LOG_DIR) + "missing.sock";
+
+    unique_ptr<Logger> logger = unique_ptr<Logger>(new SystemLogger);
+    ASSERT_FALSE(logger->start(config));
+}
@@ -0,0 +1,131 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/BatchController.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    using TimePoint = BatchController::TimePointT;
+
+    /**
+     * \brief Synthetic arrival trace, messages arrive in steps of the same size and each step gets PUBACKs of the
+     * same latency
+     */
+    struct Trace
+    {
+        int64_t durationMs;
+        int64_t stepMs;
+        size_t messagesPerStep;
+        size_t messageBytes;
+        int64_t pubackMs;
+    };
+
+    /**
+     * \brief Drive the controller with a trace starting at time now, updating it after every step
+     *
+     * @return the time at the end of the trace
+     */
+    TimePoint run(BatchController &controller, TimePoint now, const Trace &trace)
+    {
+        for (int64_t elapsed = 0; elapsed < trace.durationMs; elapsed += trace.stepMs)
+        {
+            now += chrono::milliseconds(trace.stepMs);
+            controller.onMessages(trace.messagesPerStep, trace.messagesPerStep * trace.messageBytes);
+            if (trace.pubackMs >= 0)
+            {
+                controller.onPuback(chrono::milliseconds(trace.pubackMs));
+            }
+            controller.update(now);
+        }
+        return now;
+    }
+} // namespace
+
+TEST(BatchController, PublishEachMessageUntilRateIsKnown)
+{
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(200), 128000, start);
+    ASSERT_EQ(controller.getBatchSize(), 1);
+    ASSERT_EQ(controller.getBatchTime(), chrono::milliseconds(200));
+
+    // Nothing changes before the end of the first update interval.
+    controller.onMessages(100, 10000);
+    ASSERT_FALSE(controller.update(start + BatchController::UPDATE_INTERVAL - chrono::milliseconds(1)));
+    ASSERT_EQ(controller.getBatchSize(), 1);
+    ASSERT_TRUE(controller.update(start + BatchController::UPDATE_INTERVAL));
+    ASSERT_EQ(controller.getBatchSize(), 80); // 400 messages per second for 200 ms.
+}
+
+TEST(BatchController, BatchFillsWithinTargetLatency)
+{
+    // 1000 messages per second, without PUBACK latency, are batched by 200 for a target latency of 200 ms.
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(200), 128000, start);
+    run(controller, start, {2000, 10, 10, 100, -1});
+
+    ASSERT_DOUBLE_EQ(controller.getArrivalRate(), 1000.0);
+    ASSERT_DOUBLE_EQ(controller.getMessageBytes(), 100.0);
+    ASSERT_EQ(controller.getBatchSize(), 200);
+    ASSERT_EQ(controller.getBatchTime(), chrono::milliseconds(200));
+}
+
+TEST(BatchController, PubackLatencyShortensBatchTime)
+{
+    // A PUBACK latency of 50 ms leaves 150 ms of the target latency to batch.
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(200), 128000, start);
+    run(controller, start, {2000, 10, 10, 100, 50});
+
+    ASSERT_DOUBLE_EQ(controller.getPubackLatencyMs(), 50.0);
+    ASSERT_EQ(controller.getBatchSize(), 150);
+    ASSERT_EQ(controller.getBatchTime(), chrono::milliseconds(150));
+}
+
+TEST(BatchController, PubackLatencyAboveTarget)
+{
+    // When PUBACKs alone take longer than the target, then messages are published as they are read.
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(200), 128000, start);
+    run(controller, start, {2000, 10, 10, 100, 300});
+
+    ASSERT_EQ(controller.getBatchSize(), 1);
+    ASSERT_EQ(controller.getBatchTime(), chrono::milliseconds(0));
+}
+
+TEST(BatchController, BatchFitsMaxPayload)
+{
+    // 200 messages of 100 bytes would not fit in 5000 bytes.
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(200), 5000, start);
+    run(controller, start, {2000, 10, 10, 100, -1});
+
+    ASSERT_EQ(controller.getBatchSize(), 50);
+}
+
+TEST(BatchController, AdaptsToBurstAndIdle)
+{
+    // A burst grows the batch, then the batch shrinks back once the sensor goes quiet.
+    TimePoint start;
+    BatchController controller(chrono::milliseconds(100), 128000, start);
+    TimePoint now = run(controller, start, {1000, 10, 1, 50, -1});
+    ASSERT_EQ(controller.getBatchSize(), 10); // 100 messages per second.
+
+    now = run(controller, now, {2000, 10, 50, 50, -1});
+    size_t burstSize = controller.getBatchSize();
+    ASSERT_GT(burstSize, 400u);
+    ASSERT_LE(burstSize, 500u); // 5000 messages per second.
+
+    now = run(controller, now, {1000, 10, 0, 50, -1});
+    ASSERT_LT(controller.getBatchSize(), burstSize);
+    run(controller, now, {10000, 10, 0, 50, -1});
+    ASSERT_EQ(controller.getBatchSize(), 1);
+    ASSERT_EQ(controller.getBatchTime(), chrono::milliseconds(100));
+}
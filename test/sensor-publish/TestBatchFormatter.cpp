@@ -0,0 +1,64 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/BatchFormatter.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    string format(BatchFormatter &formatter, const vector<string> &messages)
+    {
+        formatter.begin(messages.size());
+        for (const auto &message : messages)
+        {
+            formatter.add(reinterpret_cast<const uint8_t *>(message.data()), message.size());
+        }
+        aws_byte_cursor batch = formatter.finish();
+        return string(reinterpret_cast<const char *>(batch.ptr), batch.len);
+    }
+} // namespace
+
+TEST(BatchFormatter, JsonArrayOfStrings)
+{
+    BatchFormatter formatter(BatchFormatter::Format::Json);
+    ASSERT_EQ("[]", format(formatter, {}));
+    ASSERT_EQ("[\"msg1\",\"msg2\"]", format(formatter, {"msg1", "msg2"}));
+
+    // Messages holding JSON are escaped, so that any message gives a valid JSON string.
+    ASSERT_EQ(
+        "[\"{\\\"t\\\":21}\",\"a\\\\b\\tc\\u0001\"]", format(formatter, {"{\"t\":21}", string("a\\b\tc\x01", 6)}));
+}
+
+TEST(BatchFormatter, LengthPrefixedFrames)
+{
+    BatchFormatter formatter(BatchFormatter::Format::LengthPrefixed);
+    string batch = format(formatter, {"msg1", "", string(258, 'x')});
+    ASSERT_EQ(string("\0\0\0\x04msg1\0\0\0\0\0\0\x01\x02", 16), batch.substr(0, 16));
+    ASSERT_EQ(16 + 258, batch.size());
+}
+
+TEST(BatchFormatter, CborArrayOfByteStrings)
+{
+    BatchFormatter formatter(BatchFormatter::Format::Cbor);
+    ASSERT_EQ(string("\x82\x44msg1\x40", 7), format(formatter, {"msg1", ""}));
+
+    // Lengths from 24 are encoded in the bytes following the head.
+    string batch = format(formatter, {string(24, 'a'), string(256, 'b'), string(65536, 'c')});
+    ASSERT_EQ(string("\x83\x58\x18", 3), batch.substr(0, 3));
+    ASSERT_EQ(string("\x59\x01\x00", 3), batch.substr(3 + 24, 3));
+    ASSERT_EQ(string("\x5a\x00\x01\x00\x00", 5), batch.substr(3 + 24 + 3 + 256, 5));
+    ASSERT_EQ(3 + 24 + 3 + 256 + 5 + 65536, batch.size());
+
+    // Arrays of 24 messages or more have a longer head too.
+    vector<string> messages(30, "m");
+    ASSERT_EQ(string("\x98\x1e\x41m", 4), format(formatter, messages).substr(0, 4));
+}
@@ -0,0 +1,87 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/Compressor.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    string sensorData(size_t size)
+    {
+        string data;
+        for (int i = 0; data.size() < size; ++i)
+        {
+            data.append("{\"temperature\":" + to_string(20 + i % 7));
+            data.append(",\"humidity\":" + to_string(40 + i % 11) + "}\n");
+        }
+        data.resize(size);
+        return data;
+    }
+
+    string decompress(const aws_byte_cursor &compressed, size_t size)
+    {
+        vector<Bytef> out(size);
+        uLongf outLen = static_cast<uLongf>(out.size());
+        if (uncompress(out.data(), &outLen, compressed.ptr, static_cast<uLong>(compressed.len)) != Z_OK)
+        {
+            return string();
+        }
+        return string(reinterpret_cast<const char *>(out.data()), outLen);
+    }
+} // namespace
+
+TEST(Compressor, CompressesEachBatchIndependently)
+{
+    Compressor compressor(6, 4096);
+    ASSERT_TRUE(compressor.init());
+
+    string first = sensorData(4096);
+    string second = sensorData(1000);
+    aws_byte_cursor compressed;
+
+    ASSERT_TRUE(compressor.compress(aws_byte_cursor_from_array(first.data(), first.size()), compressed));
+    ASSERT_LT(compressed.len, first.size() / 4);
+    ASSERT_EQ(first, decompress(compressed, first.size()));
+
+    // Every batch is a complete stream, which does not depend on the batches compressed before it.
+    ASSERT_TRUE(compressor.compress(aws_byte_cursor_from_array(second.data(), second.size()), compressed));
+    ASSERT_EQ(second, decompress(compressed, second.size()));
+}
+
+TEST(Compressor, CompressesBatchLargerThanMaxInput)
+{
+    Compressor compressor(1, 128);
+    ASSERT_TRUE(compressor.init());
+
+    // Incompressible data is larger once compressed, and does not fit in the buffer sized for the max input.
+    string data;
+    uint32_t state = 1;
+    for (int i = 0; i < 1024; ++i)
+    {
+        state = state * 1103515245 + 12345;
+        data.push_back(static_cast<char>(state >> 24));
+    }
+    aws_byte_cursor compressed;
+    ASSERT_TRUE(compressor.compress(aws_byte_cursor_from_array(data.data(), data.size()), compressed));
+    ASSERT_EQ(data, decompress(compressed, data.size()));
+}
+
+TEST(Compressor, InvalidLevel)
+{
+    Compressor compressor(42, 128);
+    ASSERT_FALSE(compressor.init());
+
+    string data = sensorData(64);
+    aws_byte_cursor compressed;
+    ASSERT_FALSE(compressor.compress(aws_byte_cursor_from_array(data.data(), data.size()), compressed));
+}
@@ -0,0 +1,168 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/DeadLetterTask.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/byte_buf.h>
+#include <aws/crt/Types.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class DeadLetterTaskTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        // Configure settings used by DeadLetterTask.
+        settings.name = "my-sensor";
+        settings.mqttDeadLetterTopic = "my-sensor-dead-letter";
+
+        // Initialize event loop group and get an event loop from it.
+        aws_event_loop_group_options elg_options;
+        AWS_ZERO_STRUCT(elg_options);
+        elg_options.loop_count = 1;
+        elg_options.shutdown_options = nullptr;
+        eventLoopGroup = aws_event_loop_group_new(aws_default_allocator(), &elg_options);
+        eventLoop = aws_event_loop_group_get_next_loop(eventLoopGroup);
+    }
+
+    void TearDown() override { aws_event_loop_group_release(eventLoopGroup); }
+
+    PlainConfig::SensorPublish::SensorSettings settings;
+    PendingPublishes pending;
+    std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection;
+    aws_event_loop_group *eventLoopGroup;
+    aws_event_loop *eventLoop;
+};
+
+/**
+ * \brief DeadLetterTask which records the published messages instead of publishing to MQTT
+ */
+class CapturingDeadLetterTask : public DeadLetterTask
+{
+  public:
+    CapturingDeadLetterTask(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        PendingPublishes &pending,
+        std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
+        aws_event_loop *eventLoop)
+        : DeadLetterTask(settings, pending, connection, eventLoop)
+    {
+    }
+
+    vector<string> getMessages()
+    {
+        lock_guard<mutex> lock(mMessagesLock);
+        return mMessages;
+    }
+
+  private:
+    void publish(const aws_byte_cursor *payload) override
+    {
+        lock_guard<mutex> lock(mMessagesLock);
+        mMessages.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+    }
+
+    mutex mMessagesLock;
+    vector<string> mMessages;
+};
+
+TEST_F(DeadLetterTaskTest, TopicNotSpecified)
+{
+    // When a dead letter topic is not specified, then records are ignored.
+    settings.mqttDeadLetterTopic = std::string{};
+
+    CapturingDeadLetterTask task(settings, pending, connection, eventLoop);
+    task.start();
+    ASSERT_FALSE(task.started());
+
+    aws_byte_cursor payload = aws_byte_cursor_from_c_str("abc");
+    task.add(DeadLetterTask::REASON_BUFFER_FULL, payload, payload.len);
+
+    this_thread::sleep_for(chrono::milliseconds(DeadLetterTask::PUBLISH_INTERVAL_MS + 500));
+    ASSERT_TRUE(task.getMessages().empty());
+    task.stop();
+}
+
+TEST_F(DeadLetterTaskTest, RecordsBatchedInOneMessage)
+{
+    // Records added within the publish interval are published as a single message.
+    CapturingDeadLetterTask task(settings, pending, connection, eventLoop);
+    task.start();
+    ASSERT_TRUE(task.started());
+
+    aws_byte_cursor first = aws_byte_cursor_from_c_str("abc");
+    aws_byte_cursor second = aws_byte_cursor_from_c_str("de");
+    task.add(DeadLetterTask::REASON_BUFFER_FULL, first, first.len);
+    task.add(DeadLetterTask::REASON_PUBLISH_FAILED, second, 10);
+
+    this_thread::sleep_for(chrono::milliseconds(DeadLetterTask::PUBLISH_INTERVAL_MS + 500));
+    vector<string> messages = task.getMessages();
+    ASSERT_EQ(1, messages.size());
+    ASSERT_EQ(
+        "{\"sensor\":\"my-sensor\",\"dropped\":0,\"records\":["
+        "{\"reason\":\"buffer-full\",\"bytes\":3,\"payload\":\"YWJj\"},"
+        "{\"reason\":\"publish-failed\",\"bytes\":10,\"payload\":\"ZGU=\"}]}",
+        messages[0]);
+
+    task.stop();
+    ASSERT_FALSE(task.started());
+}
+
+TEST_F(DeadLetterTaskTest, RecordsDroppedWhenMessageIsFull)
+{
+    // Records which do not fit in the message are counted as dropped.
+    CapturingDeadLetterTask task(settings, pending, connection, eventLoop);
+    task.start();
+
+    string data(DeadLetterTask::MAX_RECORD_PAYLOAD_BYTES, 'x');
+    aws_byte_cursor payload = aws_byte_cursor_from_array(data.data(), data.size());
+    for (int i = 0; i < 20; ++i)
+    {
+        task.add(DeadLetterTask::REASON_BUFFER_FULL, payload, payload.len);
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(DeadLetterTask::PUBLISH_INTERVAL_MS + 500));
+    vector<string> messages = task.getMessages();
+    ASSERT_EQ(1, messages.size());
+    ASSERT_LE(messages[0].size(), DeadLetterTask::MAX_MESSAGE_BYTES);
+    ASSERT_NE(string::npos, messages[0].find("\"dropped\":9,"));
+
+    task.stop();
+}
+
+TEST_F(DeadLetterTaskTest, PendingRecordsPublishedOnStop)
+{
+    // When the task is stopped before the publish interval ends, then the pending records are published at once.
+    CapturingDeadLetterTask task(settings, pending, connection, eventLoop);
+    task.start();
+
+    aws_byte_cursor payload = aws_byte_cursor_from_c_str("abc");
+    task.add(DeadLetterTask::REASON_BUFFER_FULL, payload, payload.len);
+    task.stop();
+    ASSERT_FALSE(task.started());
+    ASSERT_EQ(1, task.getMessages().size());
+
+    // The scheduled task publishes nothing more once it runs.
+    this_thread::sleep_for(chrono::milliseconds(DeadLetterTask::PUBLISH_INTERVAL_MS + 500));
+    vector<string> messages = task.getMessages();
+    ASSERT_EQ(1, messages.size());
+    ASSERT_EQ(
+        "{\"sensor\":\"my-sensor\",\"dropped\":0,\"records\":["
+        "{\"reason\":\"buffer-full\",\"bytes\":3,\"payload\":\"YWJj\"}]}",
+        messages[0]);
+}
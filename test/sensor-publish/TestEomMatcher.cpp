@@ -0,0 +1,151 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/EomMatcher.h"
+#include "gtest/gtest.h"
+
+#include <queue>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    vector<size_t> findAll(const EomMatcher &matcher, const string &data, size_t offset = 0)
+    {
+        queue<size_t> bounds;
+        matcher.findAll(data.data() + offset, data.data() + data.size(), offset, bounds);
+        vector<size_t> result;
+        while (!bounds.empty())
+        {
+            result.push_back(bounds.front());
+            bounds.pop();
+        }
+        return result;
+    }
+
+    /**
+     * \brief Returns the end of each match found by std::cregex_iterator, the reference behavior
+     */
+    vector<size_t> findAllWithRegex(const string &pattern, const string &data, size_t offset = 0)
+    {
+        regex re(pattern);
+        vector<size_t> result;
+        const char *begin = data.data() + offset;
+        for (auto m = cregex_iterator(begin, data.data() + data.size(), re), mend = cregex_iterator(); m != mend; ++m)
+        {
+            result.push_back(offset + (*m).position() + (*m).length());
+        }
+        return result;
+    }
+} // namespace
+
+TEST(EomMatcher, CompilesLiteralPatterns)
+{
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("\\n").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("\n").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher(",").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("\\x1e").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("\\.").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("[,]+").getKind());
+    ASSERT_TRUE(EomMatcher("[,]+").isRepeated());
+    ASSERT_EQ(EomMatcher::Kind::Byte, EomMatcher("\\n+").getKind());
+    ASSERT_EQ(EomMatcher::Kind::ByteSet, EomMatcher("[\r\n]+").getKind());
+    ASSERT_EQ(EomMatcher::Kind::ByteSet, EomMatcher("[\\r\\n]").getKind());
+    ASSERT_FALSE(EomMatcher("[\\r\\n]").isRepeated());
+    ASSERT_EQ(EomMatcher::Kind::Literal, EomMatcher("\\r\\n").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Literal, EomMatcher("<EOM>").getKind());
+}
+
+TEST(EomMatcher, CompilesRegexPatterns)
+{
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("\\r?\\n").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("[^,]").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("[a-z]").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("x[,;]").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("[,;]x").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("[,;]+x").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("\\s").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("ab+").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("a|b").getKind());
+    ASSERT_EQ(EomMatcher::Kind::Regex, EomMatcher("}$").getKind());
+}
+
+TEST(EomMatcher, ThrowsOnInvalidRegex)
+{
+    ASSERT_THROW(EomMatcher("[,"), regex_error);
+    ASSERT_THROW(EomMatcher("(a"), regex_error);
+}
+
+TEST(EomMatcher, MatchesLikeRegex)
+{
+    vector<string> patterns = {
+        "\\n", ",", "[,]+", "\\n+", "\\r\\n", "<EOM>", "aa", "\\r?\\n", "[,;]", "[,;]+", "[\r\n]+", "[\\r\\n]"};
+    vector<string> inputs = {
+        "",
+        "no delimiter",
+        "msg1\nmsg2\n",
+        "\n\n\nmsg\n",
+        "msg1,,msg2,",
+        "msg1\r\nmsg2\r\n\r\n",
+        "msg1<EOM><EOM>msg2<EOM",
+        "aaaaa",
+        "msg1;,msg2\n\r\n"};
+    for (const auto &pattern : patterns)
+    {
+        EomMatcher matcher(pattern);
+        for (const auto &input : inputs)
+        {
+            for (size_t offset = 0; offset <= input.size(); ++offset)
+            {
+                ASSERT_EQ(findAllWithRegex(pattern, input, offset), findAll(matcher, input, offset))
+                    << "pattern: " << pattern << " input: " << input << " offset: " << offset;
+            }
+        }
+    }
+}
+
+TEST(EomMatcher, FindsDelimiterAtEndOfRange)
+{
+    EomMatcher matcher("\\r\\n");
+    string data = "msg1\r\nmsg2\r";
+    ASSERT_EQ(vector<size_t>({6}), findAll(matcher, data));
+}
+
+TEST(EomMatcher, FindsNulDelimiter)
+{
+    EomMatcher matcher("\\0");
+    ASSERT_EQ(EomMatcher::Kind::Byte, matcher.getKind());
+    string data("msg1\0msg2\0", 10);
+    ASSERT_EQ(vector<size_t>({5, 10}), findAll(matcher, data));
+}
+
+TEST(EomMatcher, MessageLengthExcludesDelimiter)
+{
+    vector<string> patterns = {"\\n", "[,]+", "\\r\\n", "<EOM>", "[,;]+", "[\\r\\n]", "\\r?\\n"};
+    vector<string> inputs = {
+        "msg1\nmsg2\n", "\n\n\nmsg\n", "msg1,,msg2,", "msg1\r\nmsg2\r\n\r\n", "m1<EOM><EOM>m2<EOM>", "a;b,;c"};
+    for (const auto &pattern : patterns)
+    {
+        EomMatcher matcher(pattern);
+        regex re(pattern);
+        for (const auto &input : inputs)
+        {
+            size_t start = 0;
+            for (size_t bound : findAll(matcher, input))
+            {
+                // The message ends where the leftmost match in it starts.
+                cmatch m;
+                ASSERT_TRUE(regex_search(input.data() + start, input.data() + bound, m, re));
+                ASSERT_EQ(
+                    static_cast<size_t>(m.position(0)),
+                    matcher.messageLength(input.data() + start, input.data() + bound))
+                    << "pattern: " << pattern << " input: " << input << " bound: " << bound;
+                start = bound;
+            }
+        }
+    }
+}
@@ -7,10 +7,12 @@
 
 #include <aws/common/allocator.h>
 #include <aws/common/clock.h>
+#include <aws/crt/JsonObject.h>
 #include <aws/crt/Types.h>
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -23,6 +25,8 @@ using namespace Aws::Iot::DeviceClient::SensorPublish;
 
 using ::testing::_;
 using ::testing::AtLeast;
+using ::testing::Invoke;
+using ::testing::Return;
 
 void wait(std::int64_t delay_ms)
 {
@@ -56,6 +60,8 @@ class HeartbeatTaskTest : public ::testing::Test
 
     SensorState state;
     PlainConfig::SensorPublish::SensorSettings settings;
+    SensorCounters counters;
+    PendingPublishes pending;
     std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection;
     aws_event_loop_group *eventLoopGroup;
     aws_event_loop *eventLoop;
@@ -67,9 +73,11 @@ struct MockHeartbeatTask : public HeartbeatTask
     MockHeartbeatTask(
         const SensorState &state,
         const PlainConfig::SensorPublish::SensorSettings &settings,
+        SensorCounters &counters,
+        PendingPublishes &pending,
         std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
         aws_event_loop *eventLoop)
-        : HeartbeatTask(state, settings, connection, eventLoop)
+        : HeartbeatTask(state, settings, counters, pending, connection, eventLoop)
     {
     }
 
@@ -81,7 +89,7 @@ TEST_F(HeartbeatTaskTest, TopicNotSpecified)
     // When a heartbeat topic is not specified, then task is never started.
     settings.mqttHeartbeatTopic = std::string{};
 
-    MockHeartbeatTask task(state, settings, connection, eventLoop);
+    MockHeartbeatTask task(state, settings, counters, pending, connection, eventLoop);
     EXPECT_CALL(task, publish()).Times(0);
 
     task.start();
@@ -98,7 +106,7 @@ TEST_F(HeartbeatTaskTest, TaskStartedAndNoHeartbeat)
     // When sensor state is not connected, the task is started and but no heartbeat is published.
     state = SensorState::NotConnected;
 
-    MockHeartbeatTask task(state, settings, connection, eventLoop);
+    MockHeartbeatTask task(state, settings, counters, pending, connection, eventLoop);
     EXPECT_CALL(task, publish()).Times(0);
 
     task.start();
@@ -115,7 +123,7 @@ TEST_F(HeartbeatTaskTest, TaskStartedAndHeartbeat)
     // When sensor state is connected, the task is started and heartbeat is published.
     state = SensorState::Connected;
 
-    MockHeartbeatTask task(state, settings, connection, eventLoop);
+    MockHeartbeatTask task(state, settings, counters, pending, connection, eventLoop);
     EXPECT_CALL(task, publish()).Times(AtLeast(1));
 
     task.start();
@@ -126,3 +134,75 @@ TEST_F(HeartbeatTaskTest, TaskStartedAndHeartbeat)
     task.stop();
     ASSERT_FALSE(task.started());
 }
+
+TEST_F(HeartbeatTaskTest, StopCancelsNextHeartbeat)
+{
+    // When the task is stopped from another thread, then the heartbeat scheduled before the publish is canceled.
+    MockHeartbeatTask task(state, settings, counters, pending, connection, eventLoop);
+    std::atomic<int> published{0};
+    EXPECT_CALL(task, publish()).WillRepeatedly(Invoke([&published]() { ++published; }));
+
+    task.start();
+    wait(100);
+    task.stop();
+
+    int stopped = published.load();
+    ASSERT_GE(stopped, 1);
+    wait(100);
+    ASSERT_EQ(published.load(), stopped);
+}
+
+TEST_F(HeartbeatTaskTest, HeartbeatCarriesCountersAsJson)
+{
+    // When the heartbeat format is json, then the heartbeat holds the counters since the last heartbeat and takes
+    // them.
+    settings.heartbeatFormat = std::string(PlainConfig::SensorPublish::HEARTBEAT_FORMAT_JSON);
+    SensorCounters::add(counters.bytesRead, 300);
+    SensorCounters::add(counters.messages, 3);
+    SensorCounters::add(counters.batches, 2);
+    counters.addPublishError();
+    counters.recordBufferFill(200);
+
+    MockHeartbeatTask task(state, settings, counters, pending, connection, eventLoop);
+    std::string payload;
+    EXPECT_CALL(task, publish())
+        .WillOnce(Invoke(
+            [&task, &payload]()
+            { payload.assign(reinterpret_cast<const char *>(task.getPayload().ptr), task.getPayload().len); }))
+        .WillRepeatedly(Return());
+
+    task.start();
+    wait(100);
+    task.stop();
+
+    Aws::Crt::JsonObject object(payload.c_str());
+    ASSERT_TRUE(object.WasParseSuccessful());
+    Aws::Crt::JsonView view = object.View();
+    ASSERT_EQ(view.GetString("name"), "my-sensor");
+    ASSERT_EQ(view.GetInt64("bytes_read"), 300);
+    ASSERT_EQ(view.GetInt64("messages"), 3);
+    ASSERT_EQ(view.GetInt64("batches"), 2);
+    ASSERT_EQ(view.GetInt64("publish_errors"), 1);
+    ASSERT_EQ(view.GetInt64("discarded_bytes"), 0);
+    ASSERT_EQ(view.GetInt64("reconnects"), 0);
+    ASSERT_EQ(view.GetInt64("max_buffer_fill"), 200);
+    ASSERT_GE(view.GetInt64("interval_ms"), 0);
+    ASSERT_EQ(counters.bytesRead.load(), 0);
+    ASSERT_EQ(counters.maxBufferFill.load(), 0);
+}
+
+TEST(HeartbeatTaskFormatTest, BinaryCounters)
+{
+    // The binary heartbeat is the version followed by each field in network byte order.
+    SensorCounters::Snapshot snapshot;
+    snapshot.bytesRead = 0x0102;
+    snapshot.maxBufferFill = 7;
+
+    std::string payload = HeartbeatTask::formatCounters(
+        HeartbeatTask::Format::Binary, "my-sensor", snapshot, std::chrono::milliseconds(1000));
+    ASSERT_EQ(payload.size(), HeartbeatTask::BINARY_SIZE);
+    ASSERT_EQ(static_cast<uint8_t>(payload[0]), HeartbeatTask::BINARY_VERSION);
+    ASSERT_EQ(payload.substr(1, 8), std::string("\0\0\0\0\0\0\x03\xe8", 8)); // interval_ms
+    ASSERT_EQ(payload.substr(9, 8), std::string("\0\0\0\0\0\0\x01\x02", 8)); // bytes_read
+    ASSERT_EQ(payload.substr(57, 8), std::string("\0\0\0\0\0\0\0\x07", 8));   // max_buffer_fill
+}
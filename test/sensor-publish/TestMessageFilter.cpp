@@ -0,0 +1,166 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/MessageFilter.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    using TimePoint = chrono::high_resolution_clock::time_point;
+
+    /**
+     * \brief Returns which messages are kept, the nth message is read n * stepMs after the first
+     */
+    vector<string> filter(MessageFilter &messageFilter, const vector<string> &messages, int64_t stepMs = 0)
+    {
+        TimePoint start;
+        vector<string> kept;
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            const string &message = messages[i];
+            TimePoint now = start + chrono::milliseconds(stepMs * static_cast<int64_t>(i));
+            if (messageFilter.accept(reinterpret_cast<const uint8_t *>(message.data()), message.size(), now))
+            {
+                kept.push_back(message);
+            }
+        }
+        return kept;
+    }
+} // namespace
+
+TEST(MessageFilter, NotConfigured)
+{
+    PlainConfig::SensorPublish::SensorSettings settings;
+    ASSERT_FALSE(MessageFilter::configured(settings));
+
+    settings.filterKeepEvery = 1;
+    settings.filterMinIntervalMs = 0;
+    settings.filterDedup = false;
+    ASSERT_FALSE(MessageFilter::configured(settings));
+}
+
+TEST(MessageFilter, DropDuplicates)
+{
+    // Only a message identical to the last message kept is dropped.
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterDedup = true;
+    ASSERT_TRUE(MessageFilter::configured(settings));
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(messageFilter, {"21.5", "21.5", "21.5", "21.6", "21.5", "21.5", "21.50"});
+    ASSERT_EQ(kept, (vector<string>{"21.5", "21.6", "21.5", "21.50"}));
+    ASSERT_EQ(messageFilter.getCounters().kept, 4);
+    ASSERT_EQ(messageFilter.getCounters().duplicate, 3);
+    ASSERT_EQ(messageFilter.getCounters().dropped(), 3);
+}
+
+TEST(MessageFilter, DeadbandJsonKey)
+{
+    // Changes of the field within the deadband of the last message kept are dropped, even when they add up.
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterDeadband = 0.5;
+    settings.filterJsonKey = string("temperature");
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(
+        messageFilter,
+        {R"({"temperature": 20.0, "humidity": 40})",
+         R"({"humidity": 90, "temperature": 20.3})",
+         R"({"temperature": 20.5})",
+         R"({"temperature": 20.6})",
+         R"({"temperature": "19.9"})",
+         R"({"status": "ok"})",
+         R"({"nested": {"temperature": 50}, "temperature": 19.8})"});
+    ASSERT_EQ(
+        kept,
+        (vector<string>{
+            R"({"temperature": 20.0, "humidity": 40})",
+            R"({"temperature": 20.6})",
+            R"({"temperature": "19.9"})",
+            R"({"status": "ok"})"}));
+    ASSERT_EQ(messageFilter.getCounters().deadband, 3);
+}
+
+TEST(MessageFilter, DeadbandCsvColumn)
+{
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterDeadband = 1.0;
+    settings.filterCsvColumn = 1;
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(messageFilter, {"a,10,x", "b,10.9,x", "c, 11.5,x", "d", "e,-1e1"});
+    ASSERT_EQ(kept, (vector<string>{"a,10,x", "c, 11.5,x", "d", "e,-1e1"}));
+}
+
+TEST(MessageFilter, FindJsonValue)
+{
+    string message = R"({"a\"b": 1, "list": [{"x": 2}], "x": -3.5e2, "s": "x"})";
+    double value = 0;
+    ASSERT_TRUE(MessageFilter::jsonValue(message.data(), message.data() + message.size(), "x", value));
+    ASSERT_EQ(value, -350.0);
+    ASSERT_FALSE(MessageFilter::jsonValue(message.data(), message.data() + message.size(), "s", value));
+    ASSERT_FALSE(MessageFilter::jsonValue(message.data(), message.data() + message.size(), "y", value));
+
+    // The value stops at the end of the message, which is not null terminated.
+    string truncated = R"({"x": 12345})";
+    ASSERT_TRUE(MessageFilter::jsonValue(truncated.data(), truncated.data() + 9, "x", value));
+    ASSERT_EQ(value, 123.0);
+}
+
+TEST(MessageFilter, FindCsvValue)
+{
+    string message = "1,2.5,,abc";
+    double value = 0;
+    ASSERT_TRUE(MessageFilter::csvValue(message.data(), message.data() + message.size(), 0, value));
+    ASSERT_EQ(value, 1.0);
+    ASSERT_TRUE(MessageFilter::csvValue(message.data(), message.data() + message.size(), 1, value));
+    ASSERT_EQ(value, 2.5);
+    ASSERT_FALSE(MessageFilter::csvValue(message.data(), message.data() + message.size(), 2, value));
+    ASSERT_FALSE(MessageFilter::csvValue(message.data(), message.data() + message.size(), 3, value));
+    ASSERT_FALSE(MessageFilter::csvValue(message.data(), message.data() + message.size(), 4, value));
+}
+
+TEST(MessageFilter, KeepEvery)
+{
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterKeepEvery = 3;
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(messageFilter, {"m1", "m2", "m3", "m4", "m5", "m6", "m7"});
+    ASSERT_EQ(kept, (vector<string>{"m1", "m4", "m7"}));
+    ASSERT_EQ(messageFilter.getCounters().sampled, 4);
+}
+
+TEST(MessageFilter, MinInterval)
+{
+    // Messages read every 40 ms are kept at most once every 100 ms.
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterMinIntervalMs = 100;
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(messageFilter, {"m0", "m40", "m80", "m120", "m160", "m200", "m240"}, 40);
+    ASSERT_EQ(kept, (vector<string>{"m0", "m120", "m240"}));
+}
+
+TEST(MessageFilter, StagesCompareWithLastKept)
+{
+    // A message dropped by sampling does not become the reference of the duplicate stage.
+    PlainConfig::SensorPublish::SensorSettings settings;
+    settings.filterDedup = true;
+    settings.filterKeepEvery = 2;
+    MessageFilter messageFilter(settings);
+
+    auto kept = filter(messageFilter, {"a", "b", "b", "b", "c"});
+    ASSERT_EQ(kept, (vector<string>{"a", "b"}));
+    ASSERT_EQ(messageFilter.getCounters().sampled, 2);
+    ASSERT_EQ(messageFilter.getCounters().duplicate, 1);
+}
@@ -12,9 +12,15 @@
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 
+#include <algorithm>
 #include <chrono>
+#include <dirent.h>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 using namespace Aws::Iot;
@@ -137,10 +143,26 @@ class FakeSocket : public Socket
         return AWS_OP_SUCCESS;
     }
 
+    int bind(const struct aws_socket_endpoint *local_endpoint) override { return AWS_OP_SUCCESS; }
+
+    int assign_to_event_loop(struct aws_event_loop *event_loop) override { return AWS_OP_SUCCESS; }
+
     bool is_open() override { return true; }
 
     int read(aws_byte_buf *buf, std::size_t *amount_read) override { return AWS_OP_SUCCESS; }
 
+    int peek_datagram_size(std::size_t *size) override { return aws_raise_error(AWS_IO_READ_WOULD_BLOCK); }
+
+    int read_datagram(aws_byte_buf *first, aws_byte_buf *second, std::size_t *amount_read) override
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    int read_with_fds(aws_byte_buf *buf, std::size_t *amount_read, int *fds, std::size_t *num_fds) override
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
     int close() override { return AWS_OP_SUCCESS; }
 
     void clean_up() override {}
@@ -572,3 +594,689 @@ TEST_F(SensorTest, NeedPublishNoMessages)
     ASSERT_EQ(bufferSize, 0);
     ASSERT_EQ(numBatches, 0);
 }
+
+class FakeSocketStream : public FakeSocket
+{
+  public:
+    int read(aws_byte_buf *buf, std::size_t *amount_read) override
+    {
+        // Like a stream socket, only read as many bytes as there is space for.
+        size_t count = std::min(buf->capacity - buf->len, data.size() - pos);
+        if (!chunks.empty())
+        {
+            count = std::min(count, chunks.front());
+            chunks.erase(chunks.begin());
+        }
+        if (count == 0)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        aws_byte_buf_write(buf, reinterpret_cast<const uint8_t *>(data.data() + pos), count);
+        pos += count;
+        *amount_read = count;
+        return AWS_OP_SUCCESS;
+    }
+    std::string data;
+    size_t pos{0};
+    std::vector<size_t> chunks;
+};
+
+class PublishingSensor : public Sensor
+{
+  public:
+    PublishingSensor(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        aws_allocator *allocator,
+        std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
+        aws_event_loop *eventLoop,
+        std::shared_ptr<Socket> socket)
+        : Sensor(settings, allocator, connection, eventLoop, socket)
+    {
+    }
+
+    void call_onConnectionResultCallback(int error_code) { onConnectionResultCallback(error_code); }
+
+    void call_onReadableCallback(int error_code) { onReadableCallback(error_code); }
+
+    size_t getReadBufLen() const { return mReadBuf.len; }
+
+    void nextPublishTimeout(int64_t delay_ms)
+    {
+        mNextPublishTimeout = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds{delay_ms};
+    }
+
+    void setState(SensorState state) { mState = state; }
+
+    void setInFlight(size_t count) { mInFlight = count; }
+
+    static constexpr size_t getSpoolInFlightLimit() { return SPOOL_IN_FLIGHT_LIMIT; }
+
+    size_t getSpoolSize() const { return mSpool ? mSpool->size() : 0; }
+
+    void call_onPublishComplete() { onPublishComplete(); }
+
+    void call_runOnEventLoop(const std::function<void()> &callback) { runOnEventLoop(callback); }
+
+    bool isFlushScheduled() const { return mFlushScheduled; }
+
+    bool isResumeScheduled() const { return mResumeScheduled; }
+
+    // Run the flush task now rather than at the publish timeout, must be called from the event loop.
+    void runFlushTask()
+    {
+        if (mFlushScheduled)
+        {
+            aws_event_loop_cancel_task(mEventLoop, &mFlushTask);
+        }
+        onFlushTaskCallback();
+    }
+
+    // Run the drain task now rather than at the drain interval, must be called from the event loop.
+    void runDrainTask()
+    {
+        if (mDrainScheduled)
+        {
+            aws_event_loop_cancel_task(mEventLoop, &mDrainTask);
+        }
+        onDrainTaskCallback();
+    }
+
+    void publishOneMessage(const aws_byte_cursor *payload) override
+    {
+        if (countInFlight)
+        {
+            ++mInFlight;
+        }
+        std::lock_guard<std::mutex> lock(payloadsLock);
+        payloads.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+        publishTimes.push_back(std::chrono::steady_clock::now());
+    }
+
+    std::vector<std::string> getPayloads()
+    {
+        std::lock_guard<std::mutex> lock(payloadsLock);
+        return payloads;
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> getPublishTimes()
+    {
+        std::lock_guard<std::mutex> lock(payloadsLock);
+        return publishTimes;
+    }
+
+    void connect(bool delay) override {}
+
+    void close() override {}
+
+    std::vector<std::string> payloads;
+    std::vector<std::chrono::steady_clock::time_point> publishTimes;
+    std::mutex payloadsLock;
+    bool countInFlight{false};
+};
+
+TEST_F(SensorTest, PublishEachBatchOnce)
+{
+    // When several batches are published at once, then each batch holds only its own messages.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 2;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,m4,m5,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("m1,m2,", "m3,m4,"));
+    ASSERT_EQ(sensor.getReadBufLen(), 3); // "m5," is still buffered.
+}
+
+TEST_F(SensorTest, PublishBatchAsJsonArray)
+{
+    // When a batch format is configured, then each batch holds its messages without their delimiter.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 2;
+    settings.batchFormat = std::string(PlainConfig::SensorPublish::BATCH_FORMAT_JSON);
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,\"m3\",m4,m5,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("[\"m1\",\"m2\"]", "[\"\\\"m3\\\"\",\"m4\"]"));
+    ASSERT_EQ(sensor.getReadBufLen(), 3); // "m5," is still buffered.
+}
+
+TEST_F(SensorTest, FilterDuplicatesFromRawBatch)
+{
+    // When duplicates are filtered, then the batch holds only the messages kept,
+    // and dropped messages after the batch stay buffered until the messages before them are published.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 3;
+    settings.filterDedup = true;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "a,a,b,b,b,c,a,a,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("a,b,c,"));
+    ASSERT_EQ(sensor.getReadBufLen(), 4); // "a,a," is still buffered.
+    ASSERT_EQ(sensor.getFilterCounters().kept, 4);
+    ASSERT_EQ(sensor.getFilterCounters().duplicate, 3);
+}
+
+TEST_F(SensorTest, FilterSampledMessagesFromFormattedBatch)
+{
+    // When messages are sampled, then dropped messages at the start of the buffer are released at once.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 2;
+    settings.batchFormat = std::string(PlainConfig::SensorPublish::BATCH_FORMAT_JSON);
+    settings.filterKeepEvery = 2;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,m4,m5,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("[\"m1\",\"m3\"]"));
+    ASSERT_EQ(sensor.getReadBufLen(), 3); // "m5," is still buffered.
+    ASSERT_EQ(sensor.getFilterCounters().sampled, 2);
+}
+
+TEST_F(SensorTest, AdaptiveBatchingPublishesEachMessageUntilRateIsKnown)
+{
+    // When adaptive batching is configured, then buffer_size is not used,
+    // and messages are published on their own until the arrival rate is measured.
+    settings.bufferTimeMs = 5000;
+    settings.bufferSize = 10;
+    settings.adaptiveLatencyMs = 200;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value()); // Time is not breached.
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("m1,", "m2,", "m3,"));
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+}
+
+TEST_F(SensorTest, PublishMessageWrappingAroundReadBuffer)
+{
+    // When a message straddles the end of the read buffer, then it is published whole,
+    // and the space released by published messages is reused without discarding data.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+    settings.bufferCapacity = 1024;
+
+    std::string first = std::string(1000, 'a') + ",";
+    std::string second = std::string(100, 'b') + ",";
+    std::string third = std::string(50, 'c') + ",";
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = first + second + third;
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre(first, second, third));
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+}
+
+TEST_F(SensorTest, ScanEomWrappingAroundReadBuffer)
+{
+    // When a multi-byte delimiter straddles the end of the read buffer, then the end of message is found
+    // and the batch holding it is published whole.
+    settings.bufferTimeMs = 5000;
+    settings.bufferSize = 2;
+    settings.bufferCapacity = 1024;
+    settings.eomDelimiter = "<EOM>";
+
+    std::string x = std::string(100, 'x') + "<EOM>";
+    std::string y = std::string(100, 'y') + "<EOM>";
+    std::string z = std::string(100, 'z') + "<EOM>";
+    std::string w = std::string(707, 'w') + "<EOM>"; // Delimiter starts 2 bytes before the end of the buffer.
+    std::string v = std::string(10, 'v') + "<EOM>";
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = x + y + z + w + v;
+    socket->chunks = {315, 709};
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value()); // Time is not breached.
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre(x + y, z + w));
+    ASSERT_EQ(sensor.getReadBufLen(), v.size());
+}
+
+TEST_F(SensorTest, FlushTaskPublishesAfterBufferTime)
+{
+    // When a sensor goes quiet with messages buffered, then they are published once bufferTimeMs expires.
+    // The buffer time outlasts the test, the flush task is run from the event loop by the test instead.
+    settings.bufferTimeMs = 60000;
+    settings.bufferSize = 10;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "msg1,msg2,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.setState(SensorState::Connected);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value());
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_TRUE(sensor.getPayloads().empty()); // Below the size limit and within the time limit.
+    ASSERT_TRUE(sensor.isFlushScheduled());
+
+    // The task runs before the timeout, it publishes nothing and is scheduled again.
+    sensor.call_runOnEventLoop([&sensor]() { sensor.runFlushTask(); });
+    ASSERT_TRUE(sensor.getPayloads().empty());
+    ASSERT_TRUE(sensor.isFlushScheduled());
+
+    // The timeout expires, the task publishes the buffered messages and is not scheduled again.
+    sensor.nextPublishTimeout(-1);
+    sensor.call_runOnEventLoop([&sensor]() { sensor.runFlushTask(); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("msg1,msg2,"));
+    ASSERT_FALSE(sensor.isFlushScheduled());
+}
+
+TEST_F(SensorTest, FlushTaskRearmedAfterPublish)
+{
+    // When messages keep arriving after a flush, then each of them is published within bufferTimeMs.
+    settings.bufferTimeMs = 60000;
+    settings.bufferSize = 10;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "msg1,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.setState(SensorState::Connected);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value());
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_TRUE(sensor.getPayloads().empty());
+    sensor.nextPublishTimeout(-1);
+    sensor.call_runOnEventLoop([&sensor]() { sensor.runFlushTask(); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("msg1,"));
+
+    // The flush moved the timeout bufferTimeMs past the first publish, once it expires a read publishes directly.
+    sensor.nextPublishTimeout(-1);
+    socket->data += "msg2,";
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("msg1,", "msg2,"));
+    ASSERT_FALSE(sensor.isFlushScheduled());
+
+    // A message arriving within the new timeout is published by the task rather than on read.
+    socket->data += "msg3,";
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("msg1,", "msg2,"));
+    ASSERT_TRUE(sensor.isFlushScheduled());
+    sensor.nextPublishTimeout(-1);
+    sensor.call_runOnEventLoop([&sensor]() { sensor.runFlushTask(); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("msg1,", "msg2,", "msg3,"));
+}
+
+TEST_F(SensorTest, StopCancelsFlushTask)
+{
+    // When a sensor is stopped from another thread with messages buffered, then the flush task is canceled.
+    settings.bufferTimeMs = 60000;
+    settings.bufferSize = 10;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "msg1,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.setState(SensorState::Connected);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value());
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_TRUE(sensor.isFlushScheduled());
+
+    sensor.stop();
+    ASSERT_FALSE(sensor.isFlushScheduled());
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+}
+
+namespace
+{
+    void removeDirectory(const std::string &path)
+    {
+        DIR *dir = opendir(path.c_str());
+        if (dir == nullptr)
+        {
+            return;
+        }
+        for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..")
+            {
+                unlink((path + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+        rmdir(path.c_str());
+    }
+} // namespace
+
+TEST_F(SensorTest, SpoolBatchesWhileInFlightLimitReached)
+{
+    // When too many publishes are waiting for a PUBACK, then batches are spooled and published in order once
+    // publishes are acknowledged again.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+    settings.spoolDir = "/tmp/aws-iot-device-client-test-sensor-spool";
+    removeDirectory(settings.spoolDir.value());
+
+    {
+        auto socket = std::make_shared<FakeSocketStream>();
+        socket->data = "m1,m2,m3,";
+        PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+        sensor.setInFlight(PublishingSensor::getSpoolInFlightLimit());
+        sensor.start();
+
+        sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+        ASSERT_TRUE(sensor.getPayloads().empty());
+        ASSERT_EQ(sensor.getSpoolSize(), 3 * (Spool::RECORD_HEADER_BYTES + 3));
+
+        // PUBACKs arrive, the spool is drained.
+        sensor.setInFlight(0);
+        sensor.call_runOnEventLoop([&sensor]() { sensor.runDrainTask(); });
+        ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m2,", "m3,"));
+        ASSERT_EQ(sensor.getSpoolSize(), 0);
+    }
+
+    removeDirectory(settings.spoolDir.value());
+}
+
+TEST_F(SensorTest, StoppedSensorKeepsSpool)
+{
+    // When a sensor is stopped with batches spooled, then the drain task no longer publishes them.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+    settings.spoolDir = "/tmp/aws-iot-device-client-test-sensor-spool";
+    removeDirectory(settings.spoolDir.value());
+
+    {
+        auto socket = std::make_shared<FakeSocketStream>();
+        socket->data = "m1,m2,";
+        PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+        sensor.setInFlight(PublishingSensor::getSpoolInFlightLimit());
+        sensor.start();
+
+        sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+        ASSERT_EQ(sensor.getSpoolSize(), 2 * (Spool::RECORD_HEADER_BYTES + 3));
+
+        sensor.stop();
+        sensor.setInFlight(0);
+        sensor.call_runOnEventLoop([&sensor]() { sensor.runDrainTask(); });
+        ASSERT_TRUE(sensor.getPayloads().empty());
+        ASSERT_EQ(sensor.getSpoolSize(), 2 * (Spool::RECORD_HEADER_BYTES + 3));
+    }
+
+    removeDirectory(settings.spoolDir.value());
+}
+
+TEST_F(SensorTest, PauseReadingWhenInFlightWindowFull)
+{
+    // When maxInFlight publishes are waiting for a PUBACK, then messages stay buffered and the socket is not read,
+    // until PUBACKs arrive.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+    settings.maxInFlight = 2;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,m4,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.countInFlight = true;
+    sensor.setState(SensorState::Connected);
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m2,"));
+    ASSERT_EQ(sensor.getReadBufLen(), 6); // "m3,m4," is still buffered.
+
+    // Data arriving while the window is full is left in the socket.
+    socket->data += "m5,";
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_EQ(socket->pos, 12);
+
+    // PUBACKs arrive, the buffered messages are published by the resume task and the window is full again. The
+    // resume task runs before the empty callback scheduled after it.
+    sensor.call_onPublishComplete();
+    sensor.call_onPublishComplete();
+    sensor.call_runOnEventLoop([]() {});
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m2,", "m3,", "m4,"));
+    ASSERT_EQ(socket->pos, 12);
+}
+
+TEST_F(SensorTest, PublishHeldBackBatchOnceWindowHasRoom)
+{
+    // When the in-flight window holds back a batch past the publish timeout, then it is published as soon as a
+    // publish is acknowledged rather than bufferTimeMs later.
+    settings.bufferTimeMs = 60000;
+    settings.bufferSize = 10;
+    settings.maxInFlight = 1;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.countInFlight = true;
+    sensor.setState(SensorState::Connected);
+    sensor.nextPublishTimeout(settings.bufferTimeMs.value());
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_TRUE(sensor.getPayloads().empty());
+
+    // The timeout expires while the window is full, the flush task leaves the batch to the resume task.
+    sensor.setInFlight(1);
+    sensor.nextPublishTimeout(-1);
+    sensor.call_runOnEventLoop([&sensor]() { sensor.runFlushTask(); });
+    ASSERT_TRUE(sensor.getPayloads().empty());
+    ASSERT_FALSE(sensor.isFlushScheduled());
+
+    sensor.call_onPublishComplete();
+    sensor.call_runOnEventLoop([]() {});
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,"));
+}
+
+TEST_F(SensorTest, StopCancelsResumeTask)
+{
+    // When a sensor is stopped with the resume task scheduled, then the task is canceled and reads resume once the
+    // sensor is started again.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+    settings.maxInFlight = 1;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.countInFlight = true;
+    sensor.setState(SensorState::Connected);
+
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,"));
+
+    // The PUBACK schedules the resume task, the sensor is stopped before it runs.
+    bool resumeScheduled = false;
+    sensor.call_runOnEventLoop(
+        [&sensor, &resumeScheduled]()
+        {
+            sensor.call_onPublishComplete();
+            resumeScheduled = sensor.isResumeScheduled();
+            sensor.stop();
+        });
+    ASSERT_TRUE(resumeScheduled);
+    ASSERT_FALSE(sensor.isResumeScheduled());
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,"));
+
+    sensor.start();
+    sensor.setState(SensorState::Connected);
+    socket->data += "m3,";
+    sensor.call_runOnEventLoop([&sensor]() { sensor.call_onReadableCallback(AWS_OP_SUCCESS); });
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m3,"));
+}
+
+TEST_F(SensorTest, DrainPublishesBufferedMessages)
+{
+    // When a sensor is drained, then the complete messages are published regardless of the batch settings and the
+    // in-flight window, and an incomplete message stays in the read buffer.
+    settings.bufferTimeMs = 60000;
+    settings.bufferSize = 10;
+    settings.maxInFlight = 1;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,m4";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.setInFlight(1);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_TRUE(sensor.getPayloads().empty());
+
+    sensor.drain();
+    ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,m2,m3,"));
+    ASSERT_EQ(sensor.getReadBufLen(), 2); // "m4" is incomplete.
+    ASSERT_EQ(sensor.getInFlight(), 1);
+}
+
+TEST_F(SensorTest, CountersTrackReadsAndBatches)
+{
+    // Bytes read, complete messages, batches and the buffer fill are counted until the counters are taken.
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 2;
+
+    auto socket = std::make_shared<FakeSocketStream>();
+    socket->data = "m1,m2,m3,m4";
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    SensorCounters::Snapshot counters = sensor.getCounters().take();
+    ASSERT_EQ(counters.bytesRead, 11);
+    ASSERT_EQ(counters.messages, 3);
+    ASSERT_EQ(counters.batches, 1);
+    ASSERT_EQ(counters.maxBufferFill, 11);
+    ASSERT_EQ(counters.publishErrors, 0);
+    ASSERT_EQ(counters.discardedBytes, 0);
+    ASSERT_EQ(sensor.getCounters().take().bytesRead, 0);
+}
+
+class FakeSocketDatagram : public FakeSocket
+{
+  public:
+    int bind(const struct aws_socket_endpoint *local_endpoint) override
+    {
+        ++bindCount;
+        return AWS_OP_SUCCESS;
+    }
+
+    int peek_datagram_size(std::size_t *size) override
+    {
+        if (datagrams.empty())
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        *size = datagrams.front().size();
+        return AWS_OP_SUCCESS;
+    }
+
+    int read_datagram(aws_byte_buf *first, aws_byte_buf *second, std::size_t *amount_read) override
+    {
+        if (datagrams.empty())
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        // Like a datagram socket, the part of the datagram which does not fit is discarded.
+        std::string datagram = datagrams.front();
+        datagrams.erase(datagrams.begin());
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(datagram.data());
+        size_t firstCount = std::min(datagram.size(), first->capacity - first->len);
+        size_t secondCount = std::min(datagram.size() - firstCount, second->capacity - second->len);
+        aws_byte_buf_write(first, src, firstCount);
+        aws_byte_buf_write(second, src + firstCount, secondCount);
+        *amount_read = firstCount + secondCount;
+        return AWS_OP_SUCCESS;
+    }
+
+    std::vector<std::string> datagrams;
+    int bindCount{0};
+};
+
+TEST_F(SensorTest, DatagramSocketBindSuccess)
+{
+    // When the transport is a Unix datagram socket, then the address is bound instead of connected to,
+    // and the sensor subscribes to readable events right away.
+    settings.transport = std::string(PlainConfig::SensorPublish::TRANSPORT_UNIX_DATAGRAM);
+    auto socket = std::make_shared<FakeSocketDatagram>();
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+    EXPECT_CALL(sensor, connect(true)).Times(0); // No reconnect.
+
+    sensor.call_onConnectTaskCallback();
+    ASSERT_EQ(socket->bindCount, 1);
+    ASSERT_EQ(sensor.getState(), SensorState::Connected);
+}
+
+TEST_F(SensorTest, PublishDatagramsAsMessages)
+{
+    // When the transport is a Unix datagram socket, then every datagram is one message, buffered messages are
+    // published early to make room for a datagram, and a datagram larger than the buffer is discarded.
+    settings.transport = std::string(PlainConfig::SensorPublish::TRANSPORT_UNIX_DATAGRAM);
+    settings.eomDelimiter = Aws::Crt::Optional<std::string>();
+    settings.batchFormat = std::string(PlainConfig::SensorPublish::BATCH_FORMAT_JSON);
+    settings.bufferTimeMs = 5000;
+    settings.bufferSize = 3;
+    settings.bufferCapacity = 16;
+
+    auto socket = std::make_shared<FakeSocketDatagram>();
+    socket->datagrams = {"a,b", "cc", std::string(19, 'x'), std::string(12, 'd'), "ee"};
+    PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.nextPublishTimeout(5000);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.payloads, ElementsAre("[\"a,b\",\"cc\"]"));
+    ASSERT_EQ(sensor.getReadBufLen(), 14); // The 12 "d" and "ee" are still buffered.
+    ASSERT_TRUE(socket->datagrams.empty());
+}
+
+class FakeSocketPassRing : public FakeSocket
+{
+  public:
+    int read_with_fds(aws_byte_buf *buf, std::size_t *amount_read, int *fds, std::size_t *num_fds) override
+    {
+        if (passed)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        // Like dc_shm_ring_send, one byte carrying the memory and eventfd file descriptors.
+        passed = true;
+        aws_byte_buf_write_u8(buf, 'R');
+        *amount_read = 1;
+        fds[0] = dup(ring->mem_fd);
+        fds[1] = dup(ring->event_fd);
+        *num_fds = 2;
+        return AWS_OP_SUCCESS;
+    }
+
+    dc_shm_ring *ring{nullptr};
+    bool passed{false};
+};
+
+TEST_F(SensorTest, PublishFromSharedMemoryRing)
+{
+    // When the transport is a shared memory ring, then messages are published from the ring and their space is
+    // released to the producer, and data written later is read once the producer signals the eventfd.
+    settings.transport = std::string(PlainConfig::SensorPublish::TRANSPORT_SHM);
+    settings.bufferTimeMs = 0;
+    settings.bufferSize = 1;
+
+    dc_shm_ring ring;
+    ASSERT_EQ(0, dc_shm_ring_create(&ring, "my-sensor", 4096));
+    ASSERT_EQ(0, dc_shm_ring_write(&ring, "m1,m2,", 6));
+
+    auto socket = std::make_shared<FakeSocketPassRing>();
+    socket->ring = &ring;
+    {
+        PublishingSensor sensor(settings, allocator, connection, eventLoop, socket);
+        sensor.call_onConnectionResultCallback(AWS_OP_SUCCESS);
+        ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m2,"));
+        ASSERT_EQ(ring.header->tail, 6);
+
+        ASSERT_EQ(0, dc_shm_ring_write(&ring, "m3,", 3));
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        ASSERT_THAT(sensor.getPayloads(), ElementsAre("m1,", "m2,", "m3,"));
+        ASSERT_EQ(ring.header->tail, 9);
+
+        sensor.setState(SensorState::NotConnected);
+    }
+    dc_shm_ring_destroy(&ring);
+}
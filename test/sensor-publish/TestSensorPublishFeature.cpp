@@ -12,6 +12,8 @@
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -29,7 +31,7 @@ class FakeSharedCrtResourceManager : public SharedCrtResourceManager
         allocator = aws_default_allocator();
         aws_event_loop_group_options elg_options;
         AWS_ZERO_STRUCT(elg_options);
-        elg_options.loop_count = 1;
+        elg_options.loop_count = 2;
         elg_options.shutdown_options = nullptr;
         eventLoopGroup = aws_event_loop_group_new(allocator, &elg_options);
         eventLoop = aws_event_loop_group_get_next_loop(eventLoopGroup);
@@ -41,6 +43,14 @@ class FakeSharedCrtResourceManager : public SharedCrtResourceManager
 
     aws_event_loop *getNextEventLoop() override { return eventLoop; }
 
+    std::size_t getEventLoopCount() override { return aws_event_loop_group_get_loop_count(eventLoopGroup); }
+
+    aws_event_loop *getEventLoop(std::size_t index) override
+    {
+        eventLoops.push_back(index);
+        return aws_event_loop_group_get_loop_at(eventLoopGroup, index);
+    }
+
     aws_allocator *getAllocator() override { return allocator; }
 
     std::unique_ptr<Aws::Crt::ApiHandle> apiHandle;
@@ -48,6 +58,7 @@ class FakeSharedCrtResourceManager : public SharedCrtResourceManager
     std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection; // No connection.
     aws_event_loop_group *eventLoopGroup;
     aws_event_loop *eventLoop;
+    std::vector<std::size_t> eventLoops; // Index of each event loop handed to a sensor.
 };
 
 class FakeNotifier : public ClientBaseNotifier
@@ -91,10 +102,26 @@ class FakeSocket : public Socket
         return AWS_OP_SUCCESS;
     }
 
+    int bind(const struct aws_socket_endpoint *local_endpoint) override { return AWS_OP_SUCCESS; }
+
+    int assign_to_event_loop(struct aws_event_loop *event_loop) override { return AWS_OP_SUCCESS; }
+
     bool is_open() override { return true; }
 
     int read(aws_byte_buf *buf, std::size_t *amount_read) override { return AWS_OP_SUCCESS; }
 
+    int peek_datagram_size(std::size_t *size) override { return aws_raise_error(AWS_IO_READ_WOULD_BLOCK); }
+
+    int read_datagram(aws_byte_buf *first, aws_byte_buf *second, std::size_t *amount_read) override
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
+    int read_with_fds(aws_byte_buf *buf, std::size_t *amount_read, int *fds, std::size_t *num_fds) override
+    {
+        return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+    }
+
     int close() override { return AWS_OP_SUCCESS; }
 
     void clean_up() override {}
@@ -116,9 +143,23 @@ class FakeSensor : public Sensor
     {
     }
 
+    ~FakeSensor() override
+    {
+        if (destroyed != nullptr)
+        {
+            destroyed->set_value();
+        }
+    }
+
     int start() override { return Feature::SUCCESS; }
 
     int stop() override { return Feature::SUCCESS; }
+
+    void addPendingPublish() { mPending.add(); }
+
+    void completePendingPublish() { mPending.complete(); }
+
+    std::promise<void> *destroyed{nullptr}; // Set once the sensor is destroyed.
 };
 
 class SensorPublishFeatureTest : public ::testing::Test
@@ -203,6 +244,45 @@ TEST_F(SensorPublishFeatureTest, InitSensorDisabled)
     ASSERT_EQ(feature.getSensorsSize(), 1); // config.sensorPublish.settings.size()-1
 }
 
+TEST_F(SensorPublishFeatureTest, InitSensorPlacedByWeight)
+{
+    // Sensors are placed on the event loops so that the weight on each loop is balanced.
+    config.sensorPublish.settings[0].eventLoopWeight = 3;
+    config.sensorPublish.settings[1].eventLoopWeight = 1;
+    {
+        PlainConfig::SensorPublish::SensorSettings settings = config.sensorPublish.settings[1];
+        settings.name = "my-sensor-03";
+        settings.eventLoopWeight = 2;
+        config.sensorPublish.settings.push_back(settings);
+    }
+
+    MockSensorPublishFeature feature;
+
+    int result = feature.init(manager, notifier, config);
+    ASSERT_EQ(result, Feature::SUCCESS);
+    ASSERT_EQ(feature.getSensorsSize(), 3);
+    ASSERT_EQ(manager->eventLoops, std::vector<std::size_t>({0, 1, 1}));
+}
+
+TEST(SensorPublishFeaturePlacementTest, BalancesWeights)
+{
+    // The heaviest sensors are placed first, each on the least loaded loop.
+    ASSERT_EQ(SensorPublishFeature::placeSensors({1, 1, 1, 1, 1}, 2), std::vector<std::size_t>({0, 1, 0, 1, 0}));
+    ASSERT_EQ(SensorPublishFeature::placeSensors({1, 5, 2, 2, 1}, 2), std::vector<std::size_t>({1, 0, 1, 1, 0}));
+    ASSERT_EQ(SensorPublishFeature::placeSensors({4, 4}, 4), std::vector<std::size_t>({0, 1}));
+    ASSERT_EQ(SensorPublishFeature::placeSensors({4, 4}, 0), std::vector<std::size_t>({0, 0}));
+    ASSERT_TRUE(SensorPublishFeature::placeSensors({}, 2).empty());
+}
+
+TEST(SensorPublishFeaturePlacementTest, BalancesExistingLoads)
+{
+    // Sensors added to running event loops are placed on top of the weight those loops already carry.
+    using Loads = std::vector<int64_t>;
+    ASSERT_EQ(SensorPublishFeature::placeSensors({1, 1}, Loads({3, 0})), std::vector<std::size_t>({1, 1}));
+    ASSERT_EQ(SensorPublishFeature::placeSensors({2, 1}, Loads({1, 1})), std::vector<std::size_t>({0, 1}));
+    ASSERT_EQ(SensorPublishFeature::placeSensors({1}, Loads()), std::vector<std::size_t>({0}));
+}
+
 class MockSensorPublishFeatureCreateSensorThrows : public SensorPublishFeature
 {
   public:
@@ -256,3 +336,141 @@ TEST_F(SensorPublishFeatureTest, StopSensorSuccess)
     ASSERT_EQ(notifier->count_started, 0);
     ASSERT_EQ(notifier->count_stopped, 1);
 }
+
+class MockSensorPublishFeatureRecordsSensors : public SensorPublishFeature
+{
+  public:
+    std::unique_ptr<Sensor> createSensor(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        aws_allocator *allocator,
+        std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
+        aws_event_loop *eventLoop) const override
+    {
+        created.push_back(settings.name.value());
+        return std::unique_ptr<FakeSensor>(new FakeSensor(settings, mResourceManager));
+    }
+
+    mutable std::vector<std::string> created; // Name of each sensor created.
+};
+
+TEST_F(SensorPublishFeatureTest, ReconfigureKeepsUnchangedSensors)
+{
+    // When the settings of every sensor are unchanged, then no sensor is created again.
+    config.sensorPublish.enabled = true;
+    MockSensorPublishFeatureRecordsSensors feature;
+    ASSERT_EQ(feature.init(manager, notifier, config), Feature::SUCCESS);
+    ASSERT_EQ(feature.start(), Feature::SUCCESS);
+
+    ASSERT_EQ(feature.reconfigure(config), Feature::SUCCESS);
+    ASSERT_EQ(feature.getSensorsSize(), 2);
+    ASSERT_EQ(feature.created, std::vector<std::string>({"my-sensor-01", "my-sensor-02"}));
+    ASSERT_EQ(notifier->count_started, 1);
+    ASSERT_EQ(notifier->count_stopped, 0);
+}
+
+TEST_F(SensorPublishFeatureTest, ReconfigureAddsRemovesAndReplacesSensors)
+{
+    // A changed sensor is created again on its event loop, a removed sensor is dropped and a new sensor is placed on
+    // the least loaded event loop.
+    config.sensorPublish.enabled = true;
+    MockSensorPublishFeatureRecordsSensors feature;
+    ASSERT_EQ(feature.init(manager, notifier, config), Feature::SUCCESS);
+    ASSERT_EQ(feature.start(), Feature::SUCCESS);
+    ASSERT_EQ(manager->eventLoops, std::vector<std::size_t>({0, 1}));
+
+    {
+        // The reloaded configuration does not outlive reconfigure.
+        PlainConfig reloaded = config;
+        reloaded.sensorPublish.settings[0].mqttTopic = "my-sensor-data-01-v2";
+        reloaded.sensorPublish.settings[1].name = "my-sensor-03";
+        ASSERT_EQ(feature.reconfigure(reloaded), Feature::SUCCESS);
+    }
+
+    ASSERT_EQ(feature.getSensorsSize(), 2);
+    ASSERT_EQ(
+        feature.created, std::vector<std::string>({"my-sensor-01", "my-sensor-02", "my-sensor-01", "my-sensor-03"}));
+    ASSERT_EQ(manager->eventLoops, std::vector<std::size_t>({0, 1, 0, 1}));
+    ASSERT_EQ(feature.stop(), Feature::SUCCESS);
+}
+
+TEST_F(SensorPublishFeatureTest, ReconfigureDisabledRemovesSensors)
+{
+    // When the feature is disabled by the reloaded configuration, then every sensor is removed.
+    config.sensorPublish.enabled = true;
+    MockSensorPublishFeatureRecordsSensors feature;
+    ASSERT_EQ(feature.init(manager, notifier, config), Feature::SUCCESS);
+
+    PlainConfig reloaded = config;
+    reloaded.sensorPublish.enabled = false;
+    ASSERT_EQ(feature.reconfigure(reloaded), Feature::SUCCESS);
+    ASSERT_EQ(feature.getSensorsSize(), 0);
+    ASSERT_EQ(feature.created.size(), 2);
+}
+
+class MockSensorPublishFeatureKeepsSensors : public SensorPublishFeature
+{
+  public:
+    std::unique_ptr<Sensor> createSensor(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        aws_allocator *allocator,
+        std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
+        aws_event_loop *eventLoop) const override
+    {
+        auto *sensor = new FakeSensor(settings, mResourceManager);
+        created.push_back(sensor);
+        return std::unique_ptr<FakeSensor>(sensor);
+    }
+
+    mutable std::vector<FakeSensor *> created; // Each sensor created, owned by the feature.
+};
+
+TEST_F(SensorPublishFeatureTest, ReconfigureReleasesRemovedSensorOncePublishCompletes)
+{
+    // When a removed sensor waits for a publish to complete, then it is destroyed once the publish completes, without
+    // another reconfigure.
+    config.sensorPublish.enabled = true;
+    MockSensorPublishFeatureKeepsSensors feature;
+    ASSERT_EQ(feature.init(manager, notifier, config), Feature::SUCCESS);
+    ASSERT_EQ(feature.start(), Feature::SUCCESS);
+
+    std::promise<void> destroyed;
+    std::future<void> released = destroyed.get_future();
+    FakeSensor *removed = feature.created[1];
+    removed->destroyed = &destroyed;
+    removed->addPendingPublish();
+
+    PlainConfig reloaded = config;
+    reloaded.sensorPublish.settings.pop_back();
+    ASSERT_EQ(feature.reconfigure(reloaded), Feature::SUCCESS);
+    ASSERT_EQ(feature.getSensorsSize(), 1);
+    ASSERT_EQ(released.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    // The completion callback of the publish schedules the release task on an event loop.
+    removed->completePendingPublish();
+    ASSERT_EQ(released.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(feature.stop(), Feature::SUCCESS);
+}
+
+TEST_F(SensorPublishFeatureTest, DestroyWaitsForPendingPublishes)
+{
+    // When a sensor waits for a publish to complete, then the feature destroys it only once the publish completes.
+    config.sensorPublish.enabled = true;
+    std::unique_ptr<MockSensorPublishFeatureKeepsSensors> feature(new MockSensorPublishFeatureKeepsSensors());
+    ASSERT_EQ(feature->init(manager, notifier, config), Feature::SUCCESS);
+    ASSERT_EQ(feature->start(), Feature::SUCCESS);
+    ASSERT_EQ(feature->stop(), Feature::SUCCESS);
+
+    std::promise<void> destroyed;
+    std::future<void> released = destroyed.get_future();
+    FakeSensor *pending = feature->created[0];
+    pending->destroyed = &destroyed;
+    pending->addPendingPublish();
+
+    std::future<void> closed = std::async(std::launch::async, [&feature]() { feature.reset(); });
+    ASSERT_EQ(closed.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    ASSERT_EQ(released.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    pending->completePendingPublish();
+    ASSERT_EQ(closed.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    ASSERT_EQ(released.wait_for(std::chrono::milliseconds(0)), std::future_status::ready);
+}
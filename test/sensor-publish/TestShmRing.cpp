@@ -0,0 +1,115 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/ShmRing.h"
+#include "gtest/gtest.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class ShmRingTest : public ::testing::Test
+{
+  public:
+    void SetUp() override { ASSERT_EQ(0, dc_shm_ring_create(&producer, "test-sensor", 4096)); }
+
+    void TearDown() override { dc_shm_ring_destroy(&producer); }
+
+    /**
+     * \brief Attach a consumer to the producer ring, as if the descriptors were passed over the socket
+     */
+    bool attach(ShmRing &ring) { return ring.attach(dup(producer.mem_fd), dup(producer.event_fd)); }
+
+    int write(const string &data) { return dc_shm_ring_write(&producer, data.data(), data.size()); }
+
+    dc_shm_ring producer;
+};
+
+TEST_F(ShmRingTest, ReadsDataInPlace)
+{
+    ShmRing ring;
+    ASSERT_TRUE(attach(ring));
+    ASSERT_EQ(4096, ring.capacity());
+
+    size_t readable = 1;
+    ASSERT_TRUE(ring.readable(readable));
+    ASSERT_EQ(0, readable);
+
+    ASSERT_EQ(0, write("msg1\n"));
+    ASSERT_TRUE(ring.readable(readable));
+    ASSERT_EQ(5, readable);
+    ASSERT_EQ("msg1\n", string(reinterpret_cast<const char *>(ring.data()), readable));
+
+    // Released space is visible to the producer.
+    ring.release(5);
+    ASSERT_EQ(5, producer.header->tail);
+    ASSERT_TRUE(ring.readable(readable));
+    ASSERT_EQ(0, readable);
+}
+
+TEST_F(ShmRingTest, ProducerWaitsForSpace)
+{
+    ShmRing ring;
+    ASSERT_TRUE(attach(ring));
+
+    string data(3000, 'a');
+    ASSERT_EQ(0, write(data));
+    ASSERT_EQ(-1, write(data));
+    ASSERT_EQ(EAGAIN, errno);
+
+    // Once released, the space is reused and the data wraps around the end of the ring.
+    ring.release(data.size());
+    ASSERT_EQ(0, write(data));
+    size_t readable = 0;
+    ASSERT_TRUE(ring.readable(readable));
+    ASSERT_EQ(data.size(), readable);
+    ASSERT_EQ('a', ring.data()[4095]);
+    ASSERT_EQ('a', ring.data()[0]);
+}
+
+TEST_F(ShmRingTest, SignalsEventFdOnlyWhenRequested)
+{
+    ShmRing ring;
+    ASSERT_TRUE(attach(ring));
+
+    uint64_t count;
+    ASSERT_EQ(0, write("msg1\n"));
+    ASSERT_EQ(-1, read(ring.eventFd(), &count, sizeof(count)));
+
+    ring.requestWakeup();
+    ASSERT_EQ(0, write("msg2\n"));
+    ASSERT_EQ(sizeof(count), read(ring.eventFd(), &count, sizeof(count)));
+
+    // The request is cleared by the write which signaled it.
+    ASSERT_EQ(0, write("msg3\n"));
+    ASSERT_EQ(-1, read(ring.eventFd(), &count, sizeof(count)));
+}
+
+TEST_F(ShmRingTest, RejectsUnsealedMemory)
+{
+    // Memory which the producer could shrink is rejected, the descriptors are closed.
+    int memFd = memfd_create("test-sensor", MFD_CLOEXEC);
+    ASSERT_EQ(0, ftruncate(memFd, DC_SHM_RING_HEADER_BYTES + 4096));
+    ShmRing ring;
+    ASSERT_FALSE(ring.attach(memFd, eventfd(0, EFD_CLOEXEC)));
+    ASSERT_FALSE(ring.attached());
+    ASSERT_EQ(-1, fcntl(memFd, F_GETFD));
+}
+
+TEST_F(ShmRingTest, RejectsInvalidPositions)
+{
+    ShmRing ring;
+    ASSERT_TRUE(attach(ring));
+
+    // A head more than one ring ahead of the tail is rejected.
+    producer.header->head = 4097;
+    size_t readable;
+    ASSERT_FALSE(ring.readable(readable));
+}
@@ -0,0 +1,167 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/Spool.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class SpoolTest : public ::testing::Test
+{
+  public:
+    void SetUp() override { removeDir(); }
+
+    void TearDown() override { removeDir(); }
+
+    const string dir{"/tmp/aws-iot-device-client-test-spool"};
+
+    vector<string> listSegments() const
+    {
+        vector<string> names;
+        DIR *d = opendir(dir.c_str());
+        if (d == nullptr)
+        {
+            return names;
+        }
+        for (struct dirent *entry = readdir(d); entry != nullptr; entry = readdir(d))
+        {
+            string name = entry->d_name;
+            if (name != "." && name != "..")
+            {
+                names.push_back(name);
+            }
+        }
+        closedir(d);
+        return names;
+    }
+
+    void removeDir() const
+    {
+        for (const auto &name : listSegments())
+        {
+            unlink((dir + "/" + name).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    static bool append(Spool &spool, const string &record)
+    {
+        return spool.append(aws_byte_cursor_from_array(record.data(), record.size()));
+    }
+
+    static vector<string> drain(Spool &spool)
+    {
+        vector<string> records;
+        aws_byte_cursor payload;
+        while (spool.front(payload))
+        {
+            records.emplace_back(reinterpret_cast<const char *>(payload.ptr), payload.len);
+            spool.pop();
+        }
+        return records;
+    }
+};
+
+TEST_F(SpoolTest, ReadsRecordsInOrder)
+{
+    Spool spool(dir, 1024, 1024);
+    ASSERT_TRUE(spool.open());
+    ASSERT_TRUE(spool.empty());
+
+    ASSERT_TRUE(append(spool, "msg1\n"));
+    ASSERT_TRUE(append(spool, "msg2\nmsg3\n"));
+    ASSERT_EQ(2 * Spool::RECORD_HEADER_BYTES + 15, spool.size());
+
+    aws_byte_cursor payload;
+    ASSERT_TRUE(spool.front(payload));
+    ASSERT_EQ("msg1\n", string(reinterpret_cast<const char *>(payload.ptr), payload.len));
+    spool.pop();
+
+    // Records appended to the segment being read are visible to the reader.
+    ASSERT_TRUE(append(spool, "msg4\n"));
+    ASSERT_EQ(vector<string>({"msg2\nmsg3\n", "msg4\n"}), drain(spool));
+    ASSERT_TRUE(spool.empty());
+    ASSERT_FALSE(spool.front(payload));
+}
+
+TEST_F(SpoolTest, DeletesConsumedSegments)
+{
+    // Every record fills a segment.
+    Spool spool(dir, 1024, 32);
+    ASSERT_TRUE(spool.open());
+
+    vector<string> records;
+    for (int i = 0; i < 5; ++i)
+    {
+        records.push_back(string(20, static_cast<char>('a' + i)));
+        ASSERT_TRUE(append(spool, records.back()));
+    }
+    ASSERT_EQ(5, listSegments().size());
+
+    ASSERT_EQ(records, drain(spool));
+    ASSERT_EQ(1, listSegments().size()); // The segment being appended to is kept.
+}
+
+TEST_F(SpoolTest, EvictsOldestRecordsWhenFull)
+{
+    Spool spool(dir, 100, 32);
+    ASSERT_TRUE(spool.open());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(append(spool, string(20, static_cast<char>('a' + i))));
+        ASSERT_LE(spool.size(), 100);
+    }
+    // Only three records of 28 bytes fit.
+    ASSERT_EQ(7 * 28, spool.getEvictedBytes());
+    ASSERT_EQ(vector<string>({string(20, 'h'), string(20, 'i'), string(20, 'j')}), drain(spool));
+
+    // A record larger than the spool is rejected.
+    ASSERT_FALSE(append(spool, string(100, 'x')));
+}
+
+TEST_F(SpoolTest, RecoversRecordsAfterReopen)
+{
+    {
+        Spool spool(dir, 1024, 32);
+        ASSERT_TRUE(spool.open());
+        ASSERT_TRUE(append(spool, "msg1\n"));
+        ASSERT_TRUE(append(spool, string(30, 'a')));
+        ASSERT_TRUE(append(spool, "msg2\n"));
+    }
+
+    Spool spool(dir, 1024, 32);
+    ASSERT_TRUE(spool.open());
+    ASSERT_FALSE(spool.empty());
+    ASSERT_TRUE(append(spool, "msg3\n"));
+    ASSERT_EQ(vector<string>({"msg1\n", string(30, 'a'), "msg2\n", "msg3\n"}), drain(spool));
+}
+
+TEST_F(SpoolTest, DiscardsIncompleteRecordOnRecovery)
+{
+    {
+        Spool spool(dir, 1024, 1024);
+        ASSERT_TRUE(spool.open());
+        ASSERT_TRUE(append(spool, "msg1\n"));
+        ASSERT_TRUE(append(spool, "msg2\n"));
+    }
+
+    // Cut the last record short, as a power loss would.
+    vector<string> segments = listSegments();
+    ASSERT_EQ(1, segments.size());
+    string path = dir + "/" + segments[0];
+    ASSERT_EQ(0, truncate(path.c_str(), 2 * Spool::RECORD_HEADER_BYTES + 8));
+
+    Spool spool(dir, 1024, 1024);
+    ASSERT_TRUE(spool.open());
+    ASSERT_EQ(vector<string>({"msg1\n"}), drain(spool));
+}